@@ -37,6 +37,7 @@ apt-get install -y \
     libxml2-dev \
     libcairo2-dev \
     libtiff-dev \
+    libpng-dev \
     libgtk-3-dev \
     sqlite3 \
     libsqlite3-dev \
@@ -11,6 +11,7 @@ class Wsi2dcm < Formula
   depends_on "gcc@9" => :build
   depends_on "openslide" => :build
   depends_on "openjpeg" => :build
+  depends_on "libpng" => :build
 
   def install
     mkdir "wsi-build" do
@@ -0,0 +1,76 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/batchManifest.h"
+
+#include <boost/algorithm/string.hpp>
+
+#include <fstream>
+#include <sstream>
+#include <utility>
+
+namespace wsiToDicomConverter {
+
+bool readBatchManifest(absl::string_view path,
+                       std::vector<BatchManifestRow> *rows,
+                       std::string *errorMsg) {
+  rows->clear();
+  std::ifstream manifest(static_cast<std::string>(path));
+  if (!manifest.is_open()) {
+    *errorMsg = "Could not open batch manifest.";
+    return false;
+  }
+  std::string line;
+  int64_t lineNumber = 0;
+  while (std::getline(manifest, line)) {
+    lineNumber += 1;
+    if (!line.empty() && line.back() == '\r') {
+      line.pop_back();
+    }
+    if (boost::algorithm::trim_copy(line).empty() || line[0] == '#') {
+      continue;
+    }
+    std::vector<std::string> columns;
+    boost::algorithm::split(columns, line, boost::is_any_of("\t"));
+    for (std::string &column : columns) {
+      boost::algorithm::trim(column);
+    }
+    if (columns.size() < 2 || columns[0].empty() || columns[1].empty() ||
+        columns.size() > 4) {
+      *errorMsg = "Invalid batch manifest row at line " +
+                  std::to_string(lineNumber) + "; expected input file, "
+                  "output folder, and optional json file and options "
+                  "separated by tabs.";
+      return false;
+    }
+    BatchManifestRow row;
+    row.lineNumber = lineNumber;
+    row.inputFile = columns[0];
+    row.outputFolder = columns[1];
+    if (columns.size() > 2) {
+      row.jsonFile = columns[2];
+    }
+    if (columns.size() > 3) {
+      std::istringstream options(columns[3]);
+      std::string option;
+      while (options >> option) {
+        row.options.push_back(option);
+      }
+    }
+    rows->push_back(std::move(row));
+  }
+  return true;
+}
+
+}  // namespace wsiToDicomConverter
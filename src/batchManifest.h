@@ -0,0 +1,53 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SRC_BATCHMANIFEST_H_
+#define SRC_BATCHMANIFEST_H_
+
+#include <absl/strings/string_view.h>
+
+#include <string>
+#include <vector>
+
+namespace wsiToDicomConverter {
+
+// Slide of a batch manifest.
+struct BatchManifestRow {
+  // Line of row in manifest, for error messages.
+  int64_t lineNumber;
+  std::string inputFile;
+  std::string outputFolder;
+  // Empty if slide has no additional DICOM metadata.
+  std::string jsonFile;
+  // Command line options applied to slide, overriding options of batch.
+  std::vector<std::string> options;
+};
+
+/* Reads batch manifest of slides to convert.
+
+   Each line holds tab separated columns:
+     input file, output folder, DICOM metadata json file, options
+   Metadata and options columns are optional and may be empty. Options are
+   command line options separated by whitespace, e.g.
+   "--tileWidth 256 --tileHeight 256". Empty lines and lines starting with
+   '#' are skipped. Returns false and sets errorMsg if manifest can not be
+   read or a row is missing input file or output folder.
+*/
+bool readBatchManifest(absl::string_view path,
+                       std::vector<BatchManifestRow> *rows,
+                       std::string *errorMsg);
+
+}  // namespace wsiToDicomConverter
+
+#endif  // SRC_BATCHMANIFEST_H_
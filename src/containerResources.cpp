@@ -0,0 +1,202 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/containerResources.h"
+
+#include <sched.h>
+#include <boost/thread/thread.hpp>
+
+#include <absl/strings/str_split.h>
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace wsiToDicomConverter {
+
+static const char CGROUP_ROOT[] = "/sys/fs/cgroup";
+static const char PROC_SELF_CGROUP[] = "/proc/self/cgroup";
+// cgroup v1 reports an unlimited memory limit as a page aligned maximum.
+static const int64_t CGROUP_V1_UNLIMITED_MEMORY = int64_t(1) << 60;
+static const double CGROUP_MEMORY_BUDGET_FRACTION = 0.5;
+
+// Reads first whitespace separated values of file. Returns false if file
+// can not be read.
+static bool readValues(const std::string &path, std::string *first,
+                       std::string *second) {
+  std::ifstream file(path);
+  if (!file.is_open() || !(file >> *first)) {
+    return false;
+  }
+  if (second != nullptr && !(file >> *second)) {
+    second->clear();
+  }
+  return true;
+}
+
+static int64_t parseInt64(const std::string &value) {
+  try {
+    return std::stoll(value);
+  } catch (...) {
+    return 0;
+  }
+}
+
+static int32_t cpusFromQuota(int64_t quota, int64_t period) {
+  if (quota <= 0 || period <= 0) {
+    return 0;
+  }
+  return static_cast<int32_t>((quota + period - 1) / period);
+}
+
+// cgroup paths of process by hierarchy; "/" if not known.
+struct CgroupPaths {
+  // cgroup v2 unified hierarchy.
+  std::string unified = "/";
+  // cgroup v1 cpu and memory controller hierarchies.
+  std::string cpu = "/";
+  std::string memory = "/";
+};
+
+static CgroupPaths readCgroupPaths(const std::string &procCgroup) {
+  CgroupPaths paths;
+  if (procCgroup.empty()) {
+    return paths;
+  }
+  std::ifstream file(procCgroup);
+  std::string line;
+  while (std::getline(file, line)) {
+    const std::vector<std::string> fields = absl::StrSplit(line,
+                                                      absl::MaxSplits(':', 2));
+    if (fields.size() != 3 || fields[2].empty()) {
+      continue;
+    }
+    if (fields[0] == "0" && fields[1].empty()) {
+      paths.unified = fields[2];
+      continue;
+    }
+    for (absl::string_view controller : absl::StrSplit(fields[1], ',')) {
+      if (controller == "cpu") {
+        paths.cpu = fields[2];
+      } else if (controller == "memory") {
+        paths.memory = fields[2];
+      }
+    }
+  }
+  return paths;
+}
+
+// Directories of cgroup at path and of its ancestors in hierarchy mounted
+// at mount, from cgroup to mount.
+static std::vector<std::string> cgroupDirectories(const std::string &mount,
+                                                  std::string path) {
+  std::vector<std::string> directories;
+  while (!path.empty() && path != "/") {
+    directories.push_back(mount + path);
+    path = path.substr(0, path.find_last_of('/'));
+  }
+  directories.push_back(mount);
+  return directories;
+}
+
+// Smallest positive of current and limit; 0 is unlimited.
+static int64_t smallestLimit(int64_t current, int64_t limit) {
+  if (limit <= 0) {
+    return current;
+  }
+  return current <= 0 ? limit : std::min(current, limit);
+}
+
+CgroupLimits readCgroupLimits(absl::string_view cgroupRoot,
+                              absl::string_view procCgroup) {
+  const std::string root = static_cast<std::string>(cgroupRoot);
+  const CgroupPaths paths = readCgroupPaths(
+                                      static_cast<std::string>(procCgroup));
+  CgroupLimits limits;
+  bool unified = false;
+  std::string quota, period;
+  for (const std::string &dir : cgroupDirectories(root, paths.unified)) {
+    // cgroup v2: "max 100000" or "<quota> <period>".
+    if (readValues(dir + "/cpu.max", &quota, &period)) {
+      unified = true;
+      if (quota != "max") {
+        limits.cpus = static_cast<int32_t>(smallestLimit(limits.cpus,
+            cpusFromQuota(parseInt64(quota), parseInt64(period))));
+      }
+    }
+    std::string memory;
+    if (readValues(dir + "/memory.max", &memory, nullptr)) {
+      unified = true;
+      if (memory != "max") {
+        limits.memoryBytes = smallestLimit(limits.memoryBytes,
+                                           parseInt64(memory));
+      }
+    }
+  }
+  if (unified) {
+    return limits;
+  }
+  for (const std::string &dir : cgroupDirectories(root + "/cpu",
+                                                  paths.cpu)) {
+    // cgroup v1: quota is -1 if unlimited.
+    if (readValues(dir + "/cpu.cfs_quota_us", &quota, nullptr) &&
+        readValues(dir + "/cpu.cfs_period_us", &period, nullptr)) {
+      limits.cpus = static_cast<int32_t>(smallestLimit(limits.cpus,
+          cpusFromQuota(parseInt64(quota), parseInt64(period))));
+    }
+  }
+  for (const std::string &dir : cgroupDirectories(root + "/memory",
+                                                  paths.memory)) {
+    std::string memory;
+    if (readValues(dir + "/memory.limit_in_bytes", &memory, nullptr)) {
+      const int64_t memoryBytes = parseInt64(memory);
+      if (memoryBytes < CGROUP_V1_UNLIMITED_MEMORY) {
+        limits.memoryBytes = smallestLimit(limits.memoryBytes, memoryBytes);
+      }
+    }
+  }
+  return limits;
+}
+
+const CgroupLimits &processCgroupLimits() {
+  static const CgroupLimits limits = readCgroupLimits(CGROUP_ROOT,
+                                                      PROC_SELF_CGROUP);
+  return limits;
+}
+
+int64_t defaultMemoryBudgetMB() {
+  const CgroupLimits &limits = processCgroupLimits();
+  if (limits.memoryBytes <= 0) {
+    return 0;
+  }
+  return std::max<int64_t>(static_cast<int64_t>(
+      limits.memoryBytes * CGROUP_MEMORY_BUDGET_FRACTION) / (1024 * 1024), 1);
+}
+
+int32_t availableCpuCount() {
+  int32_t cpus = std::max<int32_t>(boost::thread::hardware_concurrency(), 1);
+  cpu_set_t cpuSet;
+  CPU_ZERO(&cpuSet);
+  if (sched_getaffinity(0, sizeof(cpuSet), &cpuSet) == 0) {
+    cpus = std::min<int32_t>(cpus, std::max(CPU_COUNT(&cpuSet), 1));
+  }
+  const CgroupLimits &limits = processCgroupLimits();
+  if (limits.cpus > 0) {
+    cpus = std::min(cpus, limits.cpus);
+  }
+  return cpus;
+}
+
+}  // namespace wsiToDicomConverter
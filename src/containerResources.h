@@ -0,0 +1,63 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SRC_CONTAINERRESOURCES_H_
+#define SRC_CONTAINERRESOURCES_H_
+
+#include <absl/strings/string_view.h>
+
+#include <cstdint>
+
+namespace wsiToDicomConverter {
+
+// CPU and memory limits of a cgroup; 0 if unlimited or not known.
+struct CgroupLimits {
+  // CPU quota rounded up to whole cores.
+  int32_t cpus = 0;
+  int64_t memoryBytes = 0;
+};
+
+/* Reads CPU quota and memory limit of a process's cgroup.
+
+   cgroupRoot - mount point of the cgroup hierarchy, e.g. /sys/fs/cgroup
+   procCgroup - cgroup membership of the process, e.g. /proc/self/cgroup,
+                lines of "hierarchy-ID:controller-list:cgroup-path". The
+                process is in the root cgroup if empty or not readable.
+
+   cgroup v2 (cpu.max, memory.max) is read if present, otherwise cgroup v1
+   (cpu/cpu.cfs_quota_us, cpu/cpu.cfs_period_us,
+   memory/memory.limit_in_bytes). Limits are read from the process's
+   cgroup and its ancestors up to the root of the mount, taking the
+   smallest, so limits of a parent cgroup apply and containers which see
+   their own cgroup at the root of the mount are read from the root.
+*/
+CgroupLimits readCgroupLimits(absl::string_view cgroupRoot,
+                              absl::string_view procCgroup = "");
+
+// Limits of process's cgroup, read once.
+const CgroupLimits &processCgroupLimits();
+
+// Memory budget in MB of frames and files sized from the container:
+// half of cgroup memory limit, 0 if cgroup memory is unlimited. Remainder
+// of the limit is left to libraries' caches, prior level frames and the
+// process.
+int64_t defaultMemoryBudgetMB();
+
+// Cores process may run on: the least of the host's cores, the process's
+// CPU affinity mask and its cgroup's CPU quota. At least 1.
+int32_t availableCpuCount();
+
+}  // namespace wsiToDicomConverter
+
+#endif  // SRC_CONTAINERRESOURCES_H_
@@ -0,0 +1,299 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/conversionCheckpoint.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <boost/algorithm/string.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/log/trivial.hpp>
+#include <boost/thread/lock_guard.hpp>
+#include <boost/uuid/name_generator_sha1.hpp>
+#include <boost/uuid/uuid_io.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <utility>
+
+namespace wsiToDicomConverter {
+
+static const char CHECKPOINT_MANIFEST_NAME[] = "wsi2dcm-checkpoint.tsv";
+// Bytes read from start and end of input to identify it.
+static const int64_t INPUT_SAMPLE_BYTES = 1024 * 1024;
+
+namespace {
+
+boost::uuids::uuid nameUuid(absl::string_view name) {
+  boost::uuids::name_generator_sha1 generator(boost::uuids::ns::oid());
+  return generator(name.data(), name.size());
+}
+
+bool readSample(std::ifstream *input, int64_t offset, int64_t size,
+                std::string *content) {
+  std::string sample(size, '\0');
+  input->seekg(offset);
+  if (!input->read(&sample[0], size)) {
+    return false;
+  }
+  content->append(sample);
+  return true;
+}
+
+// Writes file's data to disk.
+bool syncFile(const std::string &path) {
+  const int fd = open(path.c_str(), O_RDONLY);
+  if (fd == -1) {
+    return false;
+  }
+  const bool synced = fsync(fd) == 0;
+  close(fd);
+  return synced;
+}
+
+}  // namespace
+
+std::string deterministicUid(absl::string_view seed) {
+  const boost::uuids::uuid uuid = nameUuid(seed);
+  // UUID is a 128 bit big endian integer; digits by long division.
+  std::vector<uint8_t> value(uuid.begin(), uuid.end());
+  std::string digits;
+  bool isZero = false;
+  while (!isZero) {
+    uint32_t remainder = 0;
+    isZero = true;
+    for (uint8_t &byte : value) {
+      const uint32_t current = (remainder << 8) | byte;
+      byte = static_cast<uint8_t>(current / 10);
+      remainder = current % 10;
+      isZero = isZero && byte == 0;
+    }
+    digits.push_back(static_cast<char>('0' + remainder));
+  }
+  std::reverse(digits.begin(), digits.end());
+  return "2.25." + digits;
+}
+
+std::string checkpointKey(absl::string_view inputPath,
+                          absl::string_view options) {
+  const boost::filesystem::path path(static_cast<std::string>(inputPath));
+  boost::system::error_code error;
+  std::string content;
+  if (boost::filesystem::is_directory(path, error)) {
+    std::vector<std::string> entries;
+    for (const boost::filesystem::directory_entry &entry :
+         boost::filesystem::directory_iterator(path, error)) {
+      if (boost::filesystem::is_regular_file(entry.path())) {
+        entries.push_back(entry.path().filename().string() + "\t" +
+            std::to_string(boost::filesystem::file_size(entry.path())));
+      }
+    }
+    std::sort(entries.begin(), entries.end());
+    content = boost::algorithm::join(entries, "\n");
+  } else {
+    const int64_t size = boost::filesystem::file_size(path, error);
+    std::ifstream input(path.string(), std::ios::binary);
+    if (error || !input.is_open()) {
+      return "";
+    }
+    content = std::to_string(size) + "\n";
+    const int64_t sampleBytes = std::min(size, INPUT_SAMPLE_BYTES);
+    if (!readSample(&input, 0, sampleBytes, &content) ||
+        !readSample(&input, size - sampleBytes, sampleBytes, &content)) {
+      return "";
+    }
+  }
+  if (error) {
+    return "";
+  }
+  content += "\n";
+  content.append(options.data(), options.size());
+  return boost::uuids::to_string(nameUuid(content));
+}
+
+ConversionCheckpoint::ConversionCheckpoint(absl::string_view outputFolder,
+                                           absl::string_view key) :
+    outputFolder_(static_cast<std::string>(outputFolder)),
+    key_(static_cast<std::string>(key)),
+    manifestPath_((boost::filesystem::path(outputFolder_) /
+                   CHECKPOINT_MANIFEST_NAME).string()),
+    valid_(false) {
+  readManifest();
+  // Manifest is rewritten with the records kept; drops stale records and
+  // any record truncated when conversion was interrupted.
+  const std::string tempPath = manifestPath_ + ".tmp";
+  {
+    std::ofstream manifest(tempPath, std::ios::trunc);
+    manifest << "key\t" << key_ << "\n";
+    for (const auto &file : files_) {
+      manifest << "file\t" << file.first << "\t" << file.second << "\n";
+    }
+    for (const auto &level : levels_) {
+      manifest << "level\t" << level.first;
+      for (const std::string &fileName : level.second) {
+        manifest << "\t" << fileName;
+      }
+      manifest << "\n";
+    }
+    if (!manifest.flush()) {
+      BOOST_LOG_TRIVIAL(error) << "Could not write checkpoint: " << tempPath;
+      return;
+    }
+  }
+  boost::system::error_code error;
+  boost::filesystem::rename(tempPath, manifestPath_, error);
+  if (error || !syncFile(manifestPath_)) {
+    BOOST_LOG_TRIVIAL(error) << "Could not write checkpoint: " <<
+                                manifestPath_;
+    return;
+  }
+  valid_ = true;
+  if (!files_.empty()) {
+    BOOST_LOG_TRIVIAL(info) << "Resuming conversion; complete files: " <<
+                               files_.size() << ", complete levels: " <<
+                               levels_.size();
+  }
+}
+
+void ConversionCheckpoint::readManifest() {
+  std::ifstream manifest(manifestPath_);
+  if (!manifest.is_open()) {
+    return;
+  }
+  std::string line;
+  if (!std::getline(manifest, line) || line != "key\t" + key_) {
+    BOOST_LOG_TRIVIAL(info) << "Checkpoint was written for a different "
+                               "input or options; starting over.";
+    return;
+  }
+  std::vector<std::pair<int64_t, std::vector<std::string>>> levels;
+  while (std::getline(manifest, line)) {
+    std::vector<std::string> columns;
+    boost::algorithm::split(columns, line, boost::is_any_of("\t"));
+    try {
+      if (columns.size() == 3 && columns[0] == "file") {
+        const int64_t size = std::stoll(columns[2]);
+        boost::system::error_code error;
+        const int64_t fileSize = boost::filesystem::file_size(
+            boost::filesystem::path(outputFolder_) / columns[1], error);
+        if (!error && fileSize == size) {
+          files_[columns[1]] = size;
+        }
+      } else if (columns.size() > 2 && columns[0] == "level") {
+        levels.push_back(std::make_pair(std::stoll(columns[1]),
+            std::vector<std::string>(columns.begin() + 2, columns.end())));
+      }
+    } catch (const std::exception &) {
+      // Record truncated by interruption.
+    }
+  }
+  // Levels are kept if all of their files are.
+  for (auto &level : levels) {
+    bool complete = true;
+    for (const std::string &fileName : level.second) {
+      complete = complete && files_.count(fileName) > 0;
+    }
+    if (complete) {
+      levels_[level.first] = std::move(level.second);
+    }
+  }
+}
+
+bool ConversionCheckpoint::appendRecord(const std::string &record) {
+  {
+    std::ofstream manifest(manifestPath_, std::ios::app);
+    manifest << record << "\n";
+    if (!manifest.flush()) {
+      return false;
+    }
+  }
+  return syncFile(manifestPath_);
+}
+
+bool ConversionCheckpoint::isValid() const {
+  return valid_;
+}
+
+std::string ConversionCheckpoint::uid(absl::string_view name) const {
+  return deterministicUid(key_ + "/" + static_cast<std::string>(name));
+}
+
+std::string ConversionCheckpoint::path(absl::string_view fileName) const {
+  return (boost::filesystem::path(outputFolder_) /
+          static_cast<std::string>(fileName)).string();
+}
+
+bool ConversionCheckpoint::isFileComplete(absl::string_view fileName) const {
+  boost::lock_guard<boost::mutex> lock(mutex_);
+  return files_.count(static_cast<std::string>(fileName)) > 0;
+}
+
+void ConversionCheckpoint::markFileComplete(absl::string_view filePath) {
+  const boost::filesystem::path path(static_cast<std::string>(filePath));
+  boost::system::error_code error;
+  const int64_t size = boost::filesystem::file_size(path, error);
+  // File is synced before it is recorded so a recorded file is never lost
+  // with the page cache.
+  if (error || !syncFile(path.string())) {
+    BOOST_LOG_TRIVIAL(warning) << "Could not checkpoint: " << filePath;
+    return;
+  }
+  const std::string fileName = path.filename().string();
+  boost::lock_guard<boost::mutex> lock(mutex_);
+  if (!appendRecord("file\t" + fileName + "\t" + std::to_string(size))) {
+    BOOST_LOG_TRIVIAL(warning) << "Could not write checkpoint: " <<
+                                  manifestPath_;
+    return;
+  }
+  files_[fileName] = size;
+}
+
+bool ConversionCheckpoint::isLevelComplete(int64_t downsample) const {
+  boost::lock_guard<boost::mutex> lock(mutex_);
+  return levels_.count(downsample) > 0;
+}
+
+void ConversionCheckpoint::markLevelComplete(
+                                  int64_t downsample,
+                                  const std::vector<std::string> &fileNames) {
+  boost::lock_guard<boost::mutex> lock(mutex_);
+  for (const std::string &fileName : fileNames) {
+    if (files_.count(fileName) == 0) {
+      return;
+    }
+  }
+  if (fileNames.empty() ||
+      !appendRecord("level\t" + std::to_string(downsample) + "\t" +
+                    boost::algorithm::join(fileNames, "\t"))) {
+    return;
+  }
+  levels_[downsample] = fileNames;
+}
+
+std::vector<std::string> ConversionCheckpoint::levelFiles(
+                                                int64_t downsample) const {
+  boost::lock_guard<boost::mutex> lock(mutex_);
+  auto level = levels_.find(downsample);
+  if (level == levels_.end()) {
+    return {};
+  }
+  return level->second;
+}
+
+size_t ConversionCheckpoint::completeFileCount() const {
+  boost::lock_guard<boost::mutex> lock(mutex_);
+  return files_.size();
+}
+
+}  // namespace wsiToDicomConverter
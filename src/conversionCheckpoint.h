@@ -0,0 +1,90 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SRC_CONVERSIONCHECKPOINT_H_
+#define SRC_CONVERSIONCHECKPOINT_H_
+
+#include <absl/strings/string_view.h>
+#include <boost/thread/mutex.hpp>
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace wsiToDicomConverter {
+
+// Returns DICOM UID 2.25.<integer> of the name based (SHA-1) UUID of seed.
+// Equal seeds return equal UIDs.
+std::string deterministicUid(absl::string_view seed);
+
+// Returns key identifying conversion of input with options. Input file is
+// identified by its size and its first and last MiB, rather than a hash of
+// the whole slide; a directory by the names and sizes of its files.
+// Returns empty string if input can not be read.
+std::string checkpointKey(absl::string_view inputPath,
+                          absl::string_view options);
+
+/* Manifest of the DICOM files completed by a conversion, used to resume
+   the conversion if it is interrupted.
+
+   Manifest is written to the output folder. Files are recorded once they
+   are written and synced to disk, and levels once all of their files are
+   written. On open, records are kept only if manifest was written for
+   the same key and the recorded files exist with their recorded sizes;
+   otherwise manifest is started over.
+*/
+class ConversionCheckpoint {
+ public:
+  ConversionCheckpoint(absl::string_view outputFolder, absl::string_view key);
+  ConversionCheckpoint(const ConversionCheckpoint &) = delete;
+  ConversionCheckpoint &operator =(const ConversionCheckpoint &) = delete;
+
+  // True if manifest could be written.
+  bool isValid() const;
+
+  // UID of name, deterministic for key.
+  std::string uid(absl::string_view name) const;
+
+  // Path in output folder of file name.
+  std::string path(absl::string_view fileName) const;
+
+  bool isFileComplete(absl::string_view fileName) const;
+  // Records file written to path; file name is path's file name.
+  void markFileComplete(absl::string_view filePath);
+
+  bool isLevelComplete(int64_t downsample) const;
+  // Records level complete; fileNames are its files in frame order.
+  void markLevelComplete(int64_t downsample,
+                         const std::vector<std::string> &fileNames);
+  // File names of complete level in frame order.
+  std::vector<std::string> levelFiles(int64_t downsample) const;
+
+  size_t completeFileCount() const;
+
+ private:
+  void readManifest();
+  bool appendRecord(const std::string &record);
+
+  const std::string outputFolder_;
+  const std::string key_;
+  const std::string manifestPath_;
+  bool valid_;
+  mutable boost::mutex mutex_;
+  // File sizes of complete files by name.
+  std::map<std::string, int64_t> files_;
+  std::map<int64_t, std::vector<std::string>> levels_;
+};
+
+}  // namespace wsiToDicomConverter
+#endif  // SRC_CONVERSIONCHECKPOINT_H_
@@ -0,0 +1,459 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/conversionDaemon.h"
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <boost/filesystem.hpp>
+#include <boost/log/trivial.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
+#include "src/dcmtkUtils.h"
+
+namespace wsiToDicomConverter {
+
+// Requests are a single short line; longer input is rejected.
+static const size_t MAX_REQUEST_BYTES = 1024 * 1024;
+static const int LISTEN_BACKLOG = 16;
+// Requests are read on the accept thread; a client which connects and
+// does not send a request is dropped after this time.
+static const int REQUEST_TIMEOUT_SECONDS = 10;
+
+struct ConversionDaemon::Job {
+  int64_t id;
+  int32_t priority;
+  int connection;
+  std::unique_ptr<WsiRequest> request;
+  std::shared_ptr<DcmTags> jsonTags;
+};
+
+namespace {
+
+std::string jsonLine(const Json::Value &value) {
+  Json::StreamWriterBuilder builder;
+  builder["indentation"] = "";
+  return Json::writeString(builder, value) + "\n";
+}
+
+// True if peer of connection runs as the daemon's user.
+bool peerIsDaemonUser(int connection) {
+#ifdef SO_PEERCRED
+  ucred credentials;
+  socklen_t length = sizeof(credentials);
+  if (getsockopt(connection, SOL_SOCKET, SO_PEERCRED, &credentials,
+                 &length) != 0) {
+    return false;
+  }
+  return credentials.uid == geteuid();
+#else
+  uid_t uid;
+  gid_t gid;
+  if (getpeereid(connection, &uid, &gid) != 0) {
+    return false;
+  }
+  return uid == geteuid();
+#endif
+}
+
+// Writes event to client. Client may have disconnected; job continues
+// regardless.
+void sendEvent(int connection, const Json::Value &event) {
+  const std::string line = jsonLine(event);
+  size_t sent = 0;
+  while (sent < line.size()) {
+    const ssize_t count = send(connection, line.data() + sent,
+                               line.size() - sent, MSG_NOSIGNAL);
+    if (count <= 0) {
+      return;
+    }
+    sent += count;
+  }
+}
+
+void sendError(int connection, absl::string_view message) {
+  Json::Value event;
+  event["event"] = "error";
+  event["message"] = static_cast<std::string>(message);
+  sendEvent(connection, event);
+}
+
+// Reads request terminated by newline or end of stream.
+bool readRequestLine(int connection, std::string *line) {
+  char buffer[4096];
+  while (line->size() < MAX_REQUEST_BYTES) {
+    const ssize_t count = recv(connection, buffer, sizeof(buffer), 0);
+    if (count < 0) {
+      return false;
+    }
+    if (count == 0) {
+      return !line->empty();
+    }
+    const char *end = static_cast<const char *>(
+                                            std::memchr(buffer, '\n', count));
+    if (end != nullptr) {
+      line->append(buffer, end - buffer);
+      return true;
+    }
+    line->append(buffer, count);
+  }
+  return false;
+}
+
+}  // namespace
+
+bool parseDaemonJobSpec(absl::string_view json, DaemonJobSpec *spec,
+                        std::string *errorMsg) {
+  Json::Value root;
+  Json::CharReaderBuilder builder;
+  std::string parseErrors;
+  std::istringstream stream{static_cast<std::string>(json)};
+  if (!Json::parseFromStream(builder, stream, &root, &parseErrors)) {
+    *errorMsg = "Request is not valid JSON: " + parseErrors;
+    return false;
+  }
+  if (!root.isObject()) {
+    *errorMsg = "Request is not a JSON object.";
+    return false;
+  }
+  *spec = DaemonJobSpec();
+  if (root.isMember("command")) {
+    if (!root["command"].isString()) {
+      *errorMsg = "command is not a string.";
+      return false;
+    }
+    spec->command = root["command"].asString();
+    if (spec->command != "convert" && spec->command != "status" &&
+        spec->command != "shutdown") {
+      *errorMsg = "Unknown command: " + spec->command;
+      return false;
+    }
+    if (spec->command != "convert") {
+      return true;
+    }
+  }
+  const char *stringFields[] = {"input", "outFolder", "jsonFile"};
+  std::string *stringValues[] = {&spec->inputFile, &spec->outputFolder,
+                                 &spec->jsonFile};
+  for (size_t idx = 0; idx < 3; ++idx) {
+    if (!root.isMember(stringFields[idx])) {
+      continue;
+    }
+    if (!root[stringFields[idx]].isString()) {
+      *errorMsg = std::string(stringFields[idx]) + " is not a string.";
+      return false;
+    }
+    *stringValues[idx] = root[stringFields[idx]].asString();
+  }
+  if (spec->inputFile.empty() || spec->outputFolder.empty()) {
+    *errorMsg = "Request requires input and outFolder.";
+    return false;
+  }
+  if (root.isMember("options")) {
+    const Json::Value &options = root["options"];
+    if (!options.isArray()) {
+      *errorMsg = "options is not an array.";
+      return false;
+    }
+    for (const Json::Value &option : options) {
+      if (!option.isString()) {
+        *errorMsg = "options must be strings.";
+        return false;
+      }
+      spec->options.push_back(option.asString());
+    }
+  }
+  if (root.isMember("priority")) {
+    if (!root["priority"].isInt()) {
+      *errorMsg = "priority is not an integer.";
+      return false;
+    }
+    spec->priority = root["priority"].asInt();
+  }
+  return true;
+}
+
+bool ConversionDaemon::JobOrder::operator()(
+                                      const std::shared_ptr<Job> &a,
+                                      const std::shared_ptr<Job> &b) const {
+  // priority_queue pops greatest; higher priority, then lower id first.
+  if (a->priority != b->priority) {
+    return a->priority < b->priority;
+  }
+  return a->id > b->id;
+}
+
+ConversionDaemon::ConversionDaemon(absl::string_view socketPath,
+                                   size_t concurrentJobs, int64_t maxMemoryMB,
+                                   RequestParser requestParser) :
+                          socketPath_(static_cast<std::string>(socketPath)),
+                          concurrentJobs_(std::max<size_t>(concurrentJobs, 1)),
+                          requestParser_(std::move(requestParser)),
+                          listenSocket_(-1), nextJobId_(1), runningJobs_(0),
+                          stopping_(false) {
+  if (maxMemoryMB > 0) {
+    memoryGovernor_ = std::make_unique<MemoryGovernor>(
+                                                  maxMemoryMB * 1024 * 1024);
+  }
+}
+
+ConversionDaemon::~ConversionDaemon() {
+  if (listenSocket_ != -1) {
+    close(listenSocket_);
+    unlink(socketPath_.c_str());
+  }
+}
+
+int ConversionDaemon::run() {
+  sockaddr_un address;
+  std::memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  if (socketPath_.size() >= sizeof(address.sun_path)) {
+    BOOST_LOG_TRIVIAL(error) << "Daemon socket path is too long: " <<
+                                socketPath_;
+    return 1;
+  }
+  std::strncpy(address.sun_path, socketPath_.c_str(),
+               sizeof(address.sun_path) - 1);
+  // Remove socket left by a daemon which did not exit cleanly.
+  struct stat socketStat;
+  if (stat(socketPath_.c_str(), &socketStat) == 0 &&
+      S_ISSOCK(socketStat.st_mode)) {
+    unlink(socketPath_.c_str());
+  }
+  listenSocket_ = socket(AF_UNIX, SOCK_STREAM, 0);
+  // Jobs read and write files as the daemon's user; socket is created
+  // accessible to the user only, so it is never briefly open to others.
+  const mode_t previousUmask = umask(S_IRWXG | S_IRWXO);
+  const bool bound = listenSocket_ != -1 &&
+      bind(listenSocket_, reinterpret_cast<sockaddr *>(&address),
+           sizeof(address)) == 0;
+  umask(previousUmask);
+  if (!bound || chmod(socketPath_.c_str(), S_IRUSR | S_IWUSR) != 0 ||
+      listen(listenSocket_, LISTEN_BACKLOG) != 0) {
+    BOOST_LOG_TRIVIAL(error) << "Could not open daemon socket " <<
+                                socketPath_ << ": " << std::strerror(errno);
+    return 1;
+  }
+  // Loaded once so jobs do not contend for the dictionary lock.
+  DcmtkUtils::loadDataDictionary();
+  BOOST_LOG_TRIVIAL(info) << "Daemon listening on " << socketPath_ <<
+                             ", " << concurrentJobs_ << " concurrent jobs";
+
+  boost::thread_group workers;
+  for (size_t idx = 0; idx < concurrentJobs_; ++idx) {
+    workers.create_thread([this]() { runJobs(); });
+  }
+  while (true) {
+    const int connection = accept(listenSocket_, nullptr, nullptr);
+    if (connection == -1) {
+      boost::lock_guard<boost::mutex> lock(mutex_);
+      if (stopping_) {
+        break;
+      }
+      if (errno == EINTR || errno == ECONNABORTED) {
+        continue;
+      }
+      BOOST_LOG_TRIVIAL(error) << "Daemon accept failed: " <<
+                                  std::strerror(errno);
+      stopping_ = true;
+      break;
+    }
+    if (!peerIsDaemonUser(connection)) {
+      BOOST_LOG_TRIVIAL(warning) << "Daemon rejected connection of another "
+                                    "user.";
+      close(connection);
+      continue;
+    }
+    timeval timeout = {REQUEST_TIMEOUT_SECONDS, 0};
+    setsockopt(connection, SOL_SOCKET, SO_RCVTIMEO, &timeout,
+               sizeof(timeout));
+    handleConnection(connection);
+  }
+  jobQueued_.notify_all();
+  workers.join_all();
+  BOOST_LOG_TRIVIAL(info) << "Daemon stopped.";
+  return 0;
+}
+
+void ConversionDaemon::requestShutdown() {
+  boost::lock_guard<boost::mutex> lock(mutex_);
+  if (stopping_) {
+    return;
+  }
+  stopping_ = true;
+  // Wakes accept; queued jobs still complete.
+  shutdown(listenSocket_, SHUT_RDWR);
+  jobQueued_.notify_all();
+}
+
+std::shared_ptr<DcmTags> ConversionDaemon::jsonTags(const std::string &path) {
+  boost::system::error_code error;
+  const std::time_t modified = boost::filesystem::last_write_time(path, error);
+  if (error || !boost::filesystem::is_regular_file(path)) {
+    return nullptr;
+  }
+  boost::lock_guard<boost::mutex> lock(jsonTagsMutex_);
+  std::pair<std::time_t, std::shared_ptr<DcmTags>> &cached = jsonTags_[path];
+  if (cached.second == nullptr || cached.first != modified) {
+    // Jobs running with previous tags keep their reference.
+    cached.second = std::make_shared<DcmTags>();
+    cached.second->readJsonFile(path);
+    cached.first = modified;
+  }
+  return cached.second;
+}
+
+void ConversionDaemon::handleConnection(int connection) {
+  std::string line;
+  DaemonJobSpec spec;
+  std::string errorMsg;
+  if (!readRequestLine(connection, &line)) {
+    sendError(connection, "Could not read request.");
+    close(connection);
+    return;
+  }
+  if (!parseDaemonJobSpec(line, &spec, &errorMsg)) {
+    sendError(connection, errorMsg);
+    close(connection);
+    return;
+  }
+  if (spec.command == "shutdown") {
+    Json::Value event;
+    event["event"] = "shutdown";
+    sendEvent(connection, event);
+    close(connection);
+    requestShutdown();
+    return;
+  }
+  if (spec.command == "status") {
+    Json::Value event;
+    event["event"] = "status";
+    {
+      boost::lock_guard<boost::mutex> lock(mutex_);
+      event["queued"] = static_cast<Json::Int64>(jobs_.size());
+      event["running"] = static_cast<Json::Int64>(runningJobs_);
+    }
+    if (memoryGovernor_ != nullptr) {
+      event["reservedMB"] = static_cast<Json::Int64>(
+                          memoryGovernor_->reservedBytes() / (1024 * 1024));
+    }
+    sendEvent(connection, event);
+    close(connection);
+    return;
+  }
+
+  std::vector<std::string> args = {"--input", spec.inputFile,
+                                   "--outFolder", spec.outputFolder};
+  if (!spec.jsonFile.empty()) {
+    args.push_back("--jsonFile");
+    args.push_back(spec.jsonFile);
+  }
+  args.insert(args.end(), spec.options.begin(), spec.options.end());
+  std::shared_ptr<Job> job = std::make_shared<Job>();
+  job->priority = spec.priority;
+  job->connection = connection;
+  job->request = std::make_unique<WsiRequest>();
+  if (!requestParser_(args, job->request.get())) {
+    sendError(connection, "Invalid job options.");
+    close(connection);
+    return;
+  }
+  if (!job->request->jsonFile.empty()) {
+    job->jsonTags = jsonTags(job->request->jsonFile);
+    if (job->jsonTags == nullptr) {
+      sendError(connection, "Could not read json file: " +
+                            job->request->jsonFile);
+      close(connection);
+      return;
+    }
+    job->request->jsonTags = job->jsonTags.get();
+  }
+  job->request->memoryGovernor = memoryGovernor_.get();
+
+  Json::Value event;
+  event["event"] = "queued";
+  {
+    boost::lock_guard<boost::mutex> lock(mutex_);
+    if (stopping_) {
+      sendError(connection, "Daemon is shutting down.");
+      close(connection);
+      return;
+    }
+    job->id = nextJobId_++;
+    jobs_.push(job);
+    event["job"] = static_cast<Json::Int64>(job->id);
+    event["position"] = static_cast<Json::Int64>(jobs_.size());
+    // Sent under lock so queued always precedes started.
+    sendEvent(connection, event);
+  }
+  jobQueued_.notify_one();
+}
+
+void ConversionDaemon::runJobs() {
+  while (true) {
+    std::shared_ptr<Job> job;
+    {
+      boost::unique_lock<boost::mutex> lock(mutex_);
+      jobQueued_.wait(lock, [this]() { return stopping_ || !jobs_.empty(); });
+      if (jobs_.empty()) {
+        return;
+      }
+      job = jobs_.top();
+      jobs_.pop();
+      runningJobs_ += 1;
+    }
+    if (memoryGovernor_ != nullptr) {
+      memoryGovernor_->waitForBudget(memoryGovernor_->budgetBytes() / 2);
+    }
+    const int connection = job->connection;
+    const Json::Int64 jobId = job->id;
+    Json::Value event;
+    event["job"] = jobId;
+    event["event"] = "started";
+    sendEvent(connection, event);
+    BOOST_LOG_TRIVIAL(info) << "Starting job " << jobId << ": " <<
+                               job->request->inputFile;
+    job->request->levelDoneCallback = [connection, jobId](int64_t levels,
+                                                          int64_t levelCount) {
+      Json::Value progress;
+      progress["event"] = "progress";
+      progress["job"] = jobId;
+      progress["levels"] = static_cast<Json::Int64>(levels);
+      progress["levelCount"] = static_cast<Json::Int64>(levelCount);
+      sendEvent(connection, progress);
+    };
+    WsiToDcm converter(job->request.get());
+    const int status = converter.wsi2dcm();
+    BOOST_LOG_TRIVIAL(info) << "Finished job " << jobId << " status " <<
+                               status;
+    event["event"] = "done";
+    event["status"] = status;
+    sendEvent(connection, event);
+    close(connection);
+    {
+      boost::lock_guard<boost::mutex> lock(mutex_);
+      runningJobs_ -= 1;
+    }
+  }
+}
+
+}  // namespace wsiToDicomConverter
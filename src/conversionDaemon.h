@@ -0,0 +1,126 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SRC_CONVERSIONDAEMON_H_
+#define SRC_CONVERSIONDAEMON_H_
+
+#include <absl/strings/string_view.h>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <json/json.h>
+
+#include <ctime>
+#include <functional>
+#include <map>
+#include <memory>
+#include <queue>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "src/dcmTags.h"
+#include "src/memoryGovernor.h"
+#include "src/wsiToDcm.h"
+
+namespace wsiToDicomConverter {
+
+// Request read from a daemon connection.
+struct DaemonJobSpec {
+  // "convert", "status" or "shutdown".
+  std::string command = "convert";
+  std::string inputFile;
+  std::string outputFolder;
+  std::string jsonFile;
+  // Command line options of job, overriding options of daemon.
+  std::vector<std::string> options;
+  // Jobs of higher priority are started first.
+  int32_t priority = 0;
+};
+
+// Parses JSON request, e.g.
+// {"input": "slide.svs", "outFolder": "out", "jsonFile": "tags.json",
+//  "options": ["--tileWidth", "256"], "priority": 1}
+// or {"command": "shutdown"}. Returns false and sets errorMsg if request
+// is not valid.
+bool parseDaemonJobSpec(absl::string_view json, DaemonJobSpec *spec,
+                        std::string *errorMsg);
+
+/* Resident converter serving jobs submitted over a Unix domain socket.
+
+   A client connects, writes one JSON request terminated by a newline and
+   reads newline delimited JSON events until the connection is closed:
+     {"event": "queued", "job": 1, "position": 1}
+     {"event": "started", "job": 1}
+     {"event": "progress", "job": 1, "levels": 2, "levelCount": 6}
+     {"event": "done", "job": 1, "status": 0}
+   Invalid requests receive {"event": "error", "message": ...}. A "status"
+   request receives the number of queued and running jobs; a "shutdown"
+   request stops accepting connections once queued jobs complete.
+
+   Up to concurrentJobs jobs run at once; queued jobs start in priority
+   order, then in order received. Jobs share one memory governor and the
+   process's loaded codecs and DICOM dictionary; DICOM metadata json
+   files are parsed once until they are modified.
+*/
+class ConversionDaemon {
+ public:
+  // Builds job's request from its command line options. Returns false if
+  // options are invalid.
+  typedef std::function<bool(const std::vector<std::string> &,
+                             WsiRequest *)> RequestParser;
+
+  ConversionDaemon(absl::string_view socketPath, size_t concurrentJobs,
+                   int64_t maxMemoryMB, RequestParser requestParser);
+  ConversionDaemon(const ConversionDaemon &) = delete;
+  ConversionDaemon &operator =(const ConversionDaemon &) = delete;
+  virtual ~ConversionDaemon();
+
+  // Serves jobs until shutdown is requested. Returns 0 after shutdown,
+  // 1 if socket can not be opened.
+  int run();
+
+ private:
+  struct Job;
+  struct JobOrder {
+    bool operator()(const std::shared_ptr<Job> &a,
+                    const std::shared_ptr<Job> &b) const;
+  };
+
+  void handleConnection(int connection);
+  void runJobs();
+  void requestShutdown();
+  std::shared_ptr<DcmTags> jsonTags(const std::string &path);
+
+  const std::string socketPath_;
+  const size_t concurrentJobs_;
+  const RequestParser requestParser_;
+  std::unique_ptr<MemoryGovernor> memoryGovernor_;
+  int listenSocket_;
+
+  boost::mutex mutex_;
+  boost::condition_variable jobQueued_;
+  std::priority_queue<std::shared_ptr<Job>, std::vector<std::shared_ptr<Job>>,
+                      JobOrder> jobs_;
+  int64_t nextJobId_;
+  int64_t runningJobs_;
+  bool stopping_;
+
+  boost::mutex jsonTagsMutex_;
+  std::map<std::string, std::pair<std::time_t, std::shared_ptr<DcmTags>>>
+      jsonTags_;
+};
+
+}  // namespace wsiToDicomConverter
+#endif  // SRC_CONVERSIONDAEMON_H_
@@ -34,6 +34,7 @@
 #include <string>
 #include <utility>
 #include <vector>
+#include "src/dcmOutputDirectFileStream.h"
 #include "src/dcmtkUtils.h"
 
 namespace wsiToDicomConverter {
@@ -125,7 +126,7 @@ Frame* DcmFileDraft::frame(int64_t idx) const {
   return framesData_.at(idx).get();
 }
 
-void DcmFileDraft::write(DcmOutputStream* outStream) {
+OFCondition DcmFileDraft::write(DcmOutputStream* outStream) {
   std::unique_ptr<DcmPixelData> pixelData =
       std::make_unique<DcmPixelData>(DCM_PixelData);
   DcmOffsetList offsetList;
@@ -156,9 +157,7 @@ void DcmFileDraft::write(DcmOutputStream* outStream) {
   // get general state from first frame.
   if (frameDataSize > 0) {
     const int firstFrameNumber = 0;
-    while (!framesData_[firstFrameNumber]->isDone()) {
-      boost::this_thread::sleep_for(boost::chrono::milliseconds(100));
-    }
+    framesData_[firstFrameNumber]->waitDone();
     Frame *frame = framesData_[firstFrameNumber].get();
     framePhotoMetrIntrp =
                     std::move(static_cast<std::string>(frame->photoMetrInt()));
@@ -173,9 +172,7 @@ void DcmFileDraft::write(DcmOutputStream* outStream) {
   // memory to speed addition of data to raw write buffer.
   uint64_t totalFrameByteSize = 0;
   for (size_t frameNumber = 0; frameNumber < frameDataSize; ++frameNumber) {
-    while (!framesData_[frameNumber]->isDone()) {
-      boost::this_thread::sleep_for(boost::chrono::milliseconds(100));
-    }
+    framesData_[frameNumber]->waitDone();
     Frame *frame = framesData_[frameNumber].get();
     if (frame->hasDcmPixelItem()) {
       break;  // Jpeg or JPeg2000 encoded data.
@@ -188,9 +185,7 @@ void DcmFileDraft::write(DcmOutputStream* outStream) {
   }
 
   for (size_t frameNumber = 0; frameNumber < frameDataSize; ++frameNumber) {
-    while (!framesData_[frameNumber]->isDone()) {
-      boost::this_thread::sleep_for(boost::chrono::milliseconds(100));
-    }
+    framesData_[frameNumber]->waitDone();
     Frame *frame = framesData_[frameNumber].get();
     if (frame->hasDcmPixelItem()) {  // Jpeg or JPeg2000 encoded data.
       // if currentSize is odd this will be fixed by dcmtk during
@@ -261,35 +256,122 @@ void DcmFileDraft::write(DcmOutputStream* outStream) {
   uint32_t rowSize = 1 + ((imageWidth_ - 1) / frameWidth_);
   uint32_t totalNumberOfFrames =
       rowSize * (1 + ((imageHeight_ - 1) / frameHeight_));
-  DcmtkUtils::startConversion(
+  return DcmtkUtils::startConversion(
       imageHeight_, imageWidth_, rowSize, studyId_, seriesId_, imageName_,
       std::move(pixelData), imgInfo, batchSize, row_, column_, instanceNumber_,
       downsample_, batchNumber_, numberOfFrames - batchSize,
       totalNumberOfFrames, tiled_, additionalTags_, firstLevelWidthMm_,
-      firstLevelHeightMm_, outStream);
+      firstLevelHeightMm_, outStream, instanceUid_);
 }
 
-void DcmFileDraft::saveFile() {
+int64_t DcmFileDraft::encodedFrameBytes() const {
+  int64_t encodedBytes = 0;
+  for (const std::unique_ptr<Frame> &frame : framesData_) {
+    frame->waitDone();
+    encodedBytes += frame->dicomFrameBytesSize();
+  }
+  return encodedBytes;
+}
+
+bool DcmFileDraft::saveFile() {
   if (!saveDicomInstanceToDisk_) {
     const int64_t  frameDataSize = framesData_.size();
     for (size_t frameNumber = 0; frameNumber < frameDataSize; ++frameNumber) {
-      while (!framesData_[frameNumber]->isDone()) {
-        boost::this_thread::sleep_for(boost::chrono::milliseconds(100));
-      }
+      framesData_[frameNumber]->waitDone();
     }
-    return;
+    return true;
+  }
+  const std::string fileName = outputFileName();
+  // Estimate file size from encoded frames; 8 bytes for pixel item header.
+  const int64_t estimatedFileSize = 1024 * 1024 + encodedFrameBytes() +
+                                    8 * framesData_.size();
+  std::unique_ptr<DcmOutputStream> fileStream;
+  // Written through file descriptor to bypass or drop page cache.
+  DcmOutputDirectFileStream *directFileStream = nullptr;
+  if (directIOWrite_ || dropPageCache_) {
+    std::unique_ptr<DcmOutputDirectFileStream> stream =
+        std::make_unique<DcmOutputDirectFileStream>(
+            fileName, estimatedFileSize, directIOWrite_, dropPageCache_);
+    directFileStream = stream.get();
+    fileStream = std::move(stream);
+  } else {
+    fileStream = std::make_unique<DcmOutputFileStream>(
+                                                 OFString(fileName.c_str()));
+  }
+  const boost::chrono::steady_clock::time_point start =
+      boost::chrono::steady_clock::now();
+  OFCondition cond = write(fileStream.get());
+  fileStream->flush();
+  if (cond.good()) {
+    cond = fileStream->status();
+  }
+  const offile_off_t bytesWritten = fileStream->tell();
+  if (directFileStream != nullptr) {
+    const OFCondition closeCond = directFileStream->close();
+    if (cond.good()) {
+      cond = closeCond;
+    }
+  }
+  fileStream.reset();
+  if (cond.bad()) {
+    BOOST_LOG_TRIVIAL(error) << "Could not write " << fileName << ": " <<
+                                cond.text();
+    return false;
+  }
+  const double seconds = boost::chrono::duration<double>(
+      boost::chrono::steady_clock::now() - start).count();
+  if (seconds > 0) {
+    BOOST_LOG_TRIVIAL(debug) << "Wrote " << fileName << " " << bytesWritten <<
+        " bytes, " << (static_cast<double>(bytesWritten) / 1048576.0) / seconds
+        << " MB/s";
   }
+  return true;
+}
+
+void DcmFileDraft::setOutputFileWriteMode(bool directIO, bool dropPageCache) {
+  directIOWrite_ = directIO;
+  dropPageCache_ = dropPageCache;
+}
+
+void DcmFileDraft::setInstanceUid(absl::string_view instanceUid) {
+  instanceUid_ = static_cast<std::string>(instanceUid);
+}
+
+std::string DcmFileDraft::outputFileName() const {
   const int64_t batchSize = fileFrameCount();
   const int64_t numberOfFrames = batchSize + prior_batch_frames_;
-  OFString fileName =
-      OFString((outputFileMask_ + "/downsample-" +
-                std::to_string(downsample_) +
-                "-frames-" + std::to_string(numberOfFrames - batchSize) +
-                "-" + std::to_string(numberOfFrames) + ".dcm")
-                  .c_str());
-  std::unique_ptr<DcmOutputFileStream> fileStream =
-      std::make_unique<DcmOutputFileStream>(fileName);
-  write(fileStream.get());
+  return outputFileMask_ + "/" + levelFileName(downsample_,
+                                               numberOfFrames - batchSize,
+                                               numberOfFrames);
+}
+
+std::string DcmFileDraft::levelFileName(int64_t downsample,
+                                        int64_t firstFrame,
+                                        int64_t endFrame) {
+  return "downsample-" + std::to_string(downsample) + "-frames-" +
+         std::to_string(firstFrame) + "-" + std::to_string(endFrame) +
+         ".dcm";
+}
+
+bool DcmFileDraft::updateConcatenationTotalNumber(
+    int64_t concatenationTotalNumber) {
+  if (!saveDicomInstanceToDisk_) {
+    return true;
+  }
+  if (concatenationTotalNumber < 1 || concatenationTotalNumber > 0xFFFF) {
+    BOOST_LOG_TRIVIAL(error) << "Concatenation total number out of range: " <<
+                                concatenationTotalNumber;
+    return false;
+  }
+  OFCondition cond = DcmtkUtils::updateInConcatenationTotalNumber(
+      outputFileName(), static_cast<uint16_t>(concatenationTotalNumber));
+  if (cond.bad()) {
+    BOOST_LOG_TRIVIAL(error) << "Could not update concatenation total "
+                                "number of " << outputFileName() << ": " <<
+                                cond.text();
+    return false;
+  }
+  return true;
 }
 
 }  // namespace wsiToDicomConverter
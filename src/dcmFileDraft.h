@@ -69,8 +69,10 @@ class DcmFileDraft : public AbstractDcmFile {
               bool saveDicomInstanceToDisk);
 
   virtual ~DcmFileDraft();
-  virtual void saveFile();
-  virtual void write(DcmOutputStream* outStream);
+  // Writes file to output folder. Returns false if file could not be
+  // written.
+  virtual bool saveFile();
+  virtual OFCondition write(DcmOutputStream* outStream);
   virtual int64_t frameWidth() const;
   virtual int64_t frameHeight() const;
   virtual int64_t imageWidth() const;
@@ -81,13 +83,40 @@ class DcmFileDraft : public AbstractDcmFile {
   virtual double imageWidthMM() const;
   virtual Frame* frame(int64_t idx) const;
 
+  // Waits for frames to be encoded and returns their encoded size.
+  int64_t encodedFrameBytes() const;
+
+  // Updates InConcatenationTotalNumber of file written by saveFile.
+  // Concatenation parts sized by encoded byte budget do not know the
+  // number of parts in the level until the last part is drafted.
+  bool updateConcatenationTotalNumber(int64_t concatenationTotalNumber);
+
+  // Configures how saveFile writes file.
+  // directIO - write preallocated file in large aligned chunks bypassing
+  //            page cache.
+  // dropPageCache - drop written file from page cache after write.
+  void setOutputFileWriteMode(bool directIO, bool dropPageCache);
+
+  // SOPInstanceUID written to file; generated when file is written if not
+  // set.
+  void setInstanceUid(absl::string_view instanceUid);
+
+  // Path of file written by saveFile.
+  std::string outputFileName() const;
+
+  // Name of file holding frames [firstFrame, endFrame) of level.
+  static std::string levelFileName(int64_t downsample, int64_t firstFrame,
+                                   int64_t endFrame);
+
  private:
+
   std::vector<std::unique_ptr<Frame> > framesData_;
   std::string outputFileMask_;
   std::string studyId_;
   std::string seriesId_;
   std::string imageName_;
   std::string sourceImageDescription_;
+  std::string instanceUid_;
   DcmTags* additionalTags_;
   DCM_Compression compression_;
   int64_t prior_batch_frames_;
@@ -104,6 +133,8 @@ class DcmFileDraft : public AbstractDcmFile {
   int64_t downsample_;
   bool tiled_;
   bool saveDicomInstanceToDisk_;
+  bool directIOWrite_ = false;
+  bool dropPageCache_ = false;
 };
 }  // namespace wsiToDicomConverter
 #endif  // SRC_DCMFILEDRAFT_H_
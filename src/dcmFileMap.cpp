@@ -0,0 +1,326 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/dcmFileMap.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <boost/log/trivial.hpp>
+
+#include <cstring>
+
+namespace wsiToDicomConverter {
+
+static const uint64_t DICOM_PREAMBLE_SIZE = 128;
+static const uint32_t UNDEFINED_LENGTH = 0xFFFFFFFF;
+static const uint32_t ITEM_TAG = 0xFFFEE000;
+static const uint32_t ITEM_DELIMITATION_TAG = 0xFFFEE00D;
+static const uint32_t SEQUENCE_DELIMITATION_TAG = 0xFFFEE0DD;
+static const uint32_t TRANSFER_SYNTAX_UID_TAG = 0x00020010;
+static const uint32_t PIXEL_DATA_TAG = 0x7FE00010;
+static const char IMPLICIT_VR_LITTLE_ENDIAN[] = "1.2.840.10008.1.2";
+static const char EXPLICIT_VR_BIG_ENDIAN[] = "1.2.840.10008.1.2.2";
+static const char DEFLATED_EXPLICIT_VR_LITTLE_ENDIAN[] =
+                                                    "1.2.840.10008.1.2.1.99";
+
+// Explicit VR encoded with 2 reserved bytes and 32 bit length.
+static bool isLongVR(const uint8_t *vr) {
+  static const char *longVRs[] = {"OB", "OD", "OF", "OL", "OV", "OW", "SQ",
+                                  "SV", "UC", "UN", "UR", "UT", "UV"};
+  for (const char *longVR : longVRs) {
+    if (vr[0] == longVR[0] && vr[1] == longVR[1]) {
+      return true;
+    }
+  }
+  return false;
+}
+
+DcmFileMap::DcmFileMap(absl::string_view filePath) : map_(nullptr),
+                                                     mapSize_(0),
+                                                     encapsulated_(false),
+                                                     pixelDataOffset_(0),
+                                                     pixelDataSize_(0) {
+  if (!mapFile(static_cast<std::string>(filePath))) {
+    return;
+  }
+  uint64_t offset;
+  if (!readFileMetaInformation(&offset)) {
+    return;
+  }
+  if (transferSyntaxUID_ == EXPLICIT_VR_BIG_ENDIAN ||
+      transferSyntaxUID_ == DEFLATED_EXPLICIT_VR_LITTLE_ENDIAN) {
+    setErrorMsg("DICOM transfer syntax can not be memory mapped.");
+    return;
+  }
+  findPixelData(offset, transferSyntaxUID_ != IMPLICIT_VR_LITTLE_ENDIAN);
+}
+
+DcmFileMap::~DcmFileMap() {
+  if (map_ != nullptr) {
+    munmap(const_cast<uint8_t *>(map_), mapSize_);
+  }
+}
+
+bool DcmFileMap::isValid() const {
+  return errorMsg_.empty();
+}
+
+std::string DcmFileMap::errorMsg() const {
+  return errorMsg_;
+}
+
+std::string DcmFileMap::transferSyntaxUID() const {
+  return transferSyntaxUID_;
+}
+
+bool DcmFileMap::encapsulated() const {
+  return encapsulated_;
+}
+
+size_t DcmFileMap::fragmentCount() const {
+  return fragmentOffsets_.size();
+}
+
+const uint8_t *DcmFileMap::fragment(size_t index, uint64_t *size) const {
+  if (index >= fragmentOffsets_.size()) {
+    *size = 0;
+    return nullptr;
+  }
+  *size = fragmentSizes_[index];
+  return map_ + fragmentOffsets_[index];
+}
+
+const uint8_t *DcmFileMap::pixelData() const {
+  if (!isValid() || encapsulated_) {
+    return nullptr;
+  }
+  return map_ + pixelDataOffset_;
+}
+
+uint64_t DcmFileMap::pixelDataSize() const {
+  return pixelDataSize_;
+}
+
+bool DcmFileMap::mapFile(const std::string &filename) {
+  const int fd = open(filename.c_str(), O_RDONLY);
+  if (fd == -1) {
+    setErrorMsg("Could not open DICOM file.");
+    return false;
+  }
+  struct stat fileStat;
+  if (fstat(fd, &fileStat) != 0 || fileStat.st_size <= 0) {
+    close(fd);
+    setErrorMsg("Could not read DICOM file size.");
+    return false;
+  }
+  void *map = mmap(nullptr, fileStat.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  // Mapping remains valid after descriptor is closed.
+  close(fd);
+  if (map == MAP_FAILED) {
+    setErrorMsg("Could not memory map DICOM file.");
+    return false;
+  }
+  map_ = reinterpret_cast<const uint8_t *>(map);
+  mapSize_ = fileStat.st_size;
+  return true;
+}
+
+bool DcmFileMap::readFileMetaInformation(uint64_t *offset) {
+  if (mapSize_ < DICOM_PREAMBLE_SIZE + 4 ||
+      std::memcmp(map_ + DICOM_PREAMBLE_SIZE, "DICM", 4) != 0) {
+    setErrorMsg("DICOM file is missing preamble.");
+    return false;
+  }
+  // File meta information is always explicit VR little endian.
+  *offset = DICOM_PREAMBLE_SIZE + 4;
+  while (*offset + 4 <= mapSize_ && readUint16(*offset) == 0x0002) {
+    uint32_t tag, length;
+    uint64_t valueOffset;
+    if (!skipElement(offset, true, &tag, &length, &valueOffset)) {
+      return false;
+    }
+    if (tag == TRANSFER_SYNTAX_UID_TAG) {
+      transferSyntaxUID_.assign(reinterpret_cast<const char *>(map_) +
+                                valueOffset, length);
+      // UI values are padded to even length with null.
+      while (!transferSyntaxUID_.empty() &&
+             (transferSyntaxUID_.back() == '\0' ||
+              transferSyntaxUID_.back() == ' ')) {
+        transferSyntaxUID_.pop_back();
+      }
+    }
+  }
+  if (transferSyntaxUID_.empty()) {
+    setErrorMsg("DICOM file is missing transfer syntax.");
+    return false;
+  }
+  return true;
+}
+
+bool DcmFileMap::findPixelData(uint64_t offset, bool explicitVR) {
+  while (offset < mapSize_) {
+    uint32_t tag, length;
+    uint64_t valueOffset;
+    if (!skipElement(&offset, explicitVR, &tag, &length, &valueOffset)) {
+      return false;
+    }
+    if (tag != PIXEL_DATA_TAG) {
+      continue;
+    }
+    if (length == UNDEFINED_LENGTH) {
+      encapsulated_ = true;
+      return indexFragments(valueOffset);
+    }
+    pixelDataOffset_ = valueOffset;
+    pixelDataSize_ = length;
+    return true;
+  }
+  setErrorMsg("DICOM missing PixelData");
+  return false;
+}
+
+// Reads element header at offset and advances offset past the element.
+// Elements of undefined length are skipped by walking their items, except
+// for pixel data which is left for the caller to walk.
+bool DcmFileMap::skipElement(uint64_t *offset, bool explicitVR,
+                             uint32_t *tag, uint32_t *length,
+                             uint64_t *valueOffset) {
+  if (*offset + 8 > mapSize_) {
+    setErrorMsg("DICOM file is truncated.");
+    return false;
+  }
+  *tag = (static_cast<uint32_t>(readUint16(*offset)) << 16) |
+         readUint16(*offset + 2);
+  bool nestedExplicitVR = explicitVR;
+  if ((*tag >> 16) == 0xFFFE || !explicitVR) {
+    *length = readUint32(*offset + 4);
+    *valueOffset = *offset + 8;
+  } else if (isLongVR(map_ + *offset + 4)) {
+    if (*offset + 12 > mapSize_) {
+      setErrorMsg("DICOM file is truncated.");
+      return false;
+    }
+    // Undefined length UN is encoded as implicit VR little endian.
+    if (map_[*offset + 4] == 'U' && map_[*offset + 5] == 'N') {
+      nestedExplicitVR = false;
+    }
+    *length = readUint32(*offset + 8);
+    *valueOffset = *offset + 12;
+  } else {
+    *length = readUint16(*offset + 6);
+    *valueOffset = *offset + 8;
+  }
+  if (*length == UNDEFINED_LENGTH) {
+    *offset = *valueOffset;
+    if (*tag == PIXEL_DATA_TAG) {
+      return true;
+    }
+    return skipUndefinedLengthSequence(offset, nestedExplicitVR);
+  }
+  if (*valueOffset + *length > mapSize_) {
+    setErrorMsg("DICOM file is truncated.");
+    return false;
+  }
+  *offset = *valueOffset + *length;
+  return true;
+}
+
+bool DcmFileMap::skipUndefinedLengthSequence(uint64_t *offset,
+                                             bool explicitVR) {
+  while (*offset + 8 <= mapSize_) {
+    const uint32_t tag = (static_cast<uint32_t>(readUint16(*offset)) << 16) |
+                         readUint16(*offset + 2);
+    const uint32_t length = readUint32(*offset + 4);
+    *offset += 8;
+    if (tag == SEQUENCE_DELIMITATION_TAG) {
+      return true;
+    }
+    if (tag != ITEM_TAG) {
+      setErrorMsg("Invalid DICOM sequence item.");
+      return false;
+    }
+    if (length != UNDEFINED_LENGTH) {
+      *offset += length;
+      continue;
+    }
+    // Item of undefined length; walk its dataset to the item delimiter.
+    while (true) {
+      uint32_t itemTag, itemLength;
+      uint64_t itemValueOffset;
+      if (!skipElement(offset, explicitVR, &itemTag, &itemLength,
+                       &itemValueOffset)) {
+        return false;
+      }
+      if (itemTag == ITEM_DELIMITATION_TAG) {
+        break;
+      }
+      if (itemTag == PIXEL_DATA_TAG && itemLength == UNDEFINED_LENGTH &&
+          !skipUndefinedLengthSequence(offset, explicitVR)) {
+        // Encapsulated pixel data nested in item, e.g. icon image.
+        return false;
+      }
+    }
+  }
+  setErrorMsg("DICOM file is truncated.");
+  return false;
+}
+
+bool DcmFileMap::indexFragments(uint64_t offset) {
+  bool basicOffsetTable = true;
+  while (offset + 8 <= mapSize_) {
+    const uint32_t tag = (static_cast<uint32_t>(readUint16(offset)) << 16) |
+                         readUint16(offset + 2);
+    const uint32_t length = readUint32(offset + 4);
+    offset += 8;
+    if (tag == SEQUENCE_DELIMITATION_TAG) {
+      return true;
+    }
+    if (tag != ITEM_TAG || length == UNDEFINED_LENGTH ||
+        offset + length > mapSize_) {
+      setErrorMsg("Invalid DICOM pixel data fragment.");
+      return false;
+    }
+    // First item is basic offset table. Fragments are indexed by scanning
+    // item headers, which does not depend on the table being present.
+    if (!basicOffsetTable) {
+      fragmentOffsets_.push_back(offset);
+      fragmentSizes_.push_back(length);
+    }
+    basicOffsetTable = false;
+    offset += length;
+  }
+  setErrorMsg("DICOM file is truncated.");
+  return false;
+}
+
+uint16_t DcmFileMap::readUint16(uint64_t offset) const {
+  uint16_t value;
+  std::memcpy(&value, map_ + offset, sizeof(value));
+  return value;
+}
+
+uint32_t DcmFileMap::readUint32(uint64_t offset) const {
+  uint32_t value;
+  std::memcpy(&value, map_ + offset, sizeof(value));
+  return value;
+}
+
+void DcmFileMap::setErrorMsg(absl::string_view msg) {
+  errorMsg_ = static_cast<std::string>(msg);
+  BOOST_LOG_TRIVIAL(debug) << errorMsg_;
+}
+
+}  // namespace wsiToDicomConverter
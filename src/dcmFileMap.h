@@ -0,0 +1,83 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SRC_DCMFILEMAP_H_
+#define SRC_DCMFILEMAP_H_
+
+#include <absl/strings/string_view.h>
+
+#include <string>
+#include <vector>
+
+namespace wsiToDicomConverter {
+
+/* Read only memory map of a DICOM Part 10 file's pixel data.
+
+   Elements preceding PixelData are walked without being decoded to find
+   the pixel data offset. Encapsulated pixel data is indexed with a single
+   scan of the fragment item headers; native pixel data is a single
+   contiguous range. Only little endian transfer syntaxes are supported.
+
+   Mapped memory is backed by the file and is not copied; memory use is
+   proportional to the number of fragments. Map holds no mutable state
+   after construction and may be read from any number of threads.
+*/
+class DcmFileMap {
+ public:
+  explicit DcmFileMap(absl::string_view filePath);
+  DcmFileMap(const DcmFileMap &) = delete;
+  DcmFileMap &operator =(const DcmFileMap &) = delete;
+  virtual ~DcmFileMap();
+
+  // True if file is mapped and pixel data was located.
+  bool isValid() const;
+  std::string errorMsg() const;
+
+  // Transfer syntax UID from file meta information.
+  std::string transferSyntaxUID() const;
+  bool encapsulated() const;
+
+  // Encapsulated pixel data fragments, excluding basic offset table.
+  size_t fragmentCount() const;
+  const uint8_t *fragment(size_t index, uint64_t *size) const;
+
+  // Native pixel data.
+  const uint8_t *pixelData() const;
+  uint64_t pixelDataSize() const;
+
+ private:
+  bool mapFile(const std::string &filename);
+  bool readFileMetaInformation(uint64_t *offset);
+  bool findPixelData(uint64_t offset, bool explicitVR);
+  bool skipElement(uint64_t *offset, bool explicitVR, uint32_t *tag,
+                   uint32_t *length, uint64_t *valueOffset);
+  bool skipUndefinedLengthSequence(uint64_t *offset, bool explicitVR);
+  bool indexFragments(uint64_t offset);
+  uint16_t readUint16(uint64_t offset) const;
+  uint32_t readUint32(uint64_t offset) const;
+  void setErrorMsg(absl::string_view msg);
+
+  const uint8_t *map_;
+  uint64_t mapSize_;
+  std::string transferSyntaxUID_;
+  bool encapsulated_;
+  uint64_t pixelDataOffset_;
+  uint64_t pixelDataSize_;
+  std::vector<uint64_t> fragmentOffsets_;
+  std::vector<uint64_t> fragmentSizes_;
+  std::string errorMsg_;
+};
+
+}  // namespace wsiToDicomConverter
+#endif  // SRC_DCMFILEMAP_H_
@@ -24,10 +24,14 @@
 #include <boost/log/trivial.hpp>
 #include <boost/thread.hpp>
 #include <opencv2/opencv.hpp>
+#include <algorithm>
 #include <string>
 #include <memory>
 #include <utility>
+#include "src/containerResources.h"
+#include "src/dcmRleDecoder.h"
 #include "src/jpegUtil.h"
+#include "src/pixelUtil.h"
 
 namespace wsiToDicomConverter {
 
@@ -102,7 +106,7 @@ int64_t DICOMImageFrame::rawABGRFrameBytes(uint8_t *rawMemory,
 
 JpegDicomFileFrame::JpegDicomFileFrame(int64_t locationX,
                                        int64_t locationY,
-                                       uint8_t *dicomMem,
+                                       const uint8_t *dicomMem,
                                        uint64_t dicomMemSize,
                                        DcmFilePyramidSource *pyramidSource) :
                   AbstractDicomFileFrame(locationX, locationY, pyramidSource),
@@ -110,6 +114,10 @@ JpegDicomFileFrame::JpegDicomFileFrame(int64_t locationX,
   size_ = dicomMemSize;
 }
 
+const uint8_t *JpegDicomFileFrame::dicomFrameMemory() const {
+  return dicomFrameMemory_;
+}
+
 J_COLOR_SPACE JpegDicomFileFrame::jpegDecodeColorSpace() const {
   return photoMetrInt() == "RGB" ? JCS_RGB : JCS_YCbCr;
 }
@@ -128,7 +136,7 @@ int64_t JpegDicomFileFrame::rawABGRFrameBytes(uint8_t *rawMemory,
 
 Jp2KDicomFileFrame::Jp2KDicomFileFrame(int64_t locationX,
                                        int64_t locationY,
-                                       uint8_t *dicomMem,
+                                       const uint8_t *dicomMem,
                                        uint64_t dicomMemSize,
                                        DcmFilePyramidSource *pyramidSource) :
                    AbstractDicomFileFrame(locationX, locationY, pyramidSource),
@@ -139,7 +147,7 @@ Jp2KDicomFileFrame::Jp2KDicomFileFrame(int64_t locationX,
 int64_t Jp2KDicomFileFrame::rawABGRFrameBytes(uint8_t *rawMemory,
                                               int64_t memorySize) {
   cv::Mat rawData(1, size_, CV_8UC1,
-                  reinterpret_cast<void*>(dicomFrameMemory_));
+                  const_cast<uint8_t *>(dicomFrameMemory_));
   cv::Mat decodedImage = cv::imdecode(rawData, cv::IMREAD_COLOR);
   if ( decodedImage.data == NULL ) {
     return 0;
@@ -151,6 +159,48 @@ int64_t Jp2KDicomFileFrame::rawABGRFrameBytes(uint8_t *rawMemory,
   return width * height * 4;
 }
 
+NativeDicomFileFrame::NativeDicomFileFrame(
+                                      int64_t locationX,
+                                      int64_t locationY,
+                                      const uint8_t *dicomMem,
+                                      uint64_t dicomMemSize,
+                                      DcmFilePyramidSource *pyramidSource) :
+                  AbstractDicomFileFrame(locationX, locationY, pyramidSource),
+                  dicomFrameMemory_(dicomMem) {
+  size_ = dicomMemSize;
+}
+
+int64_t NativeDicomFileFrame::rawABGRFrameBytes(uint8_t *rawMemory,
+                                                int64_t memorySize) {
+  const uint64_t pixelCount = frameWidth() * frameHeight();
+  if (memorySize < static_cast<int64_t>(pixelCount * 4)) {
+    return 0;
+  }
+  pixelUtil::rgbToABGR(dicomFrameMemory_, rawMemory, pixelCount);
+  return pixelCount * 4;
+}
+
+RleDicomFileFrame::RleDicomFileFrame(int64_t locationX,
+                                     int64_t locationY,
+                                     const uint8_t *dicomMem,
+                                     uint64_t dicomMemSize,
+                                     DcmFilePyramidSource *pyramidSource) :
+                  AbstractDicomFileFrame(locationX, locationY, pyramidSource),
+                  dicomFrameMemory_(dicomMem) {
+  size_ = dicomMemSize;
+}
+
+int64_t RleDicomFileFrame::rawABGRFrameBytes(uint8_t *rawMemory,
+                                             int64_t memorySize) {
+  const uint64_t pixelCount = frameWidth() * frameHeight();
+  if (memorySize < static_cast<int64_t>(pixelCount * 4) ||
+      !DcmRleDecoder::decodeRGBToABGR(dicomFrameMemory_, size_, pixelCount,
+                                      rawMemory)) {
+    return 0;
+  }
+  return pixelCount * 4;
+}
+
 DcmFilePyramidSource::DcmFilePyramidSource(absl::string_view filePath,
                                            bool loadframes) :
                       BaseFilePyramidSource<AbstractDicomFileFrame>(filePath) {
@@ -162,20 +212,12 @@ DcmFilePyramidSource::DcmFilePyramidSource(absl::string_view filePath,
   seriesInstanceUID_ = "";
   seriesDescription_ = "";
   std::string filename = static_cast<std::string>(filePath);
-  dcmFile_.loadFile(filename.c_str());
-
+  // Parse header only, pixel data is read on demand.
+  dcmFile_.loadFileUntilTag(filename.c_str(), EXS_Unknown, EGL_noChange,
+                            DCM_MaxReadLength, ERM_autoDetect,
+                            DCM_PixelData);
   frameReaderIndex_ = 0;
-  if (!loadframes) {
-    maxFrameReaderIndex_ = 0;
-  } else {
-    maxFrameReaderIndex_ = 30;
-    dicomDatasetSpeedReader_.reserve(maxFrameReaderIndex_);
-    for (int idx = 0; idx < maxFrameReaderIndex_; ++idx) {
-      std::unique_ptr<DICOMDatasetReader> reader =
-                                std::make_unique<DICOMDatasetReader>(filename);
-      dicomDatasetSpeedReader_.push_back(std::move(reader));
-    }
-  }
+  maxFrameReaderIndex_ = 0;
   dataset_ = dcmFile_.getDataset();
   frameWidth_ = getTagValueUI16(DCM_Columns);
   if (frameWidth_ <= 0) {
@@ -259,30 +301,149 @@ DcmFilePyramidSource::DcmFilePyramidSource(absl::string_view filePath,
   seriesInstanceUID_ = getTagValueStringArray(DCM_SeriesInstanceUID);
   seriesDescription_ = getTagValueStringArray(DCM_SeriesDescription);
 
+  xfer_ = dataset_->getOriginalXfer();
+  if (xfer_ == EXS_Unknown) {
+    setErrorMsg("Unknown DICOM transfer syntax");
+    return;
+  }
+  if (!loadframes) {
+    return;
+  }
+  framesData_.reserve(frameCount);
+  const bool decodeLossyJPEG = (EXS_JPEGProcess1 == xfer_ &&
+    3 == samplesPerPixel_ &&
+    0 == planarConfiguration_ &&
+    0 == pixelRepresentation_ &&
+    8 == bitsAllocated_ &&
+    8 == bitsStored_ &&
+    7 == highBit_ &&
+    (photometric_ == "RGB" ||
+     photometric_ == "YBR_FULL" ||
+     photometric_ == "YBR_FULL_422"));
+  const bool decodeJPEG2K = (EXS_JPEG2000LosslessOnly == xfer_ ||
+    EXS_JPEG2000 == xfer_ ||
+    EXS_JPEG2000MulticomponentLosslessOnly == xfer_ ||
+    EXS_JPEG2000Multicomponent == xfer_);
+  // 8 bit RGB frames are expanded to raw frame bytes without DCMTK.
+  const bool rgb8 = (3 == samplesPerPixel_ &&
+    0 == planarConfiguration_ &&
+    8 == bitsAllocated_ &&
+    8 == bitsStored_ &&
+    photometric_ == "RGB");
+  const bool decodeRLE = (EXS_RLELossless == xfer_ && rgb8);
+  const bool decodeNative = ((EXS_LittleEndianExplicit == xfer_ ||
+                              EXS_LittleEndianImplicit == xfer_) && rgb8);
+  if (decodeLossyJPEG || decodeJPEG2K || decodeRLE || decodeNative) {
+    // Frames decoded outside of DCMTK are read from memory mapped file.
+    fileMap_ = std::make_unique<DcmFileMap>(filePath);
+    if (fileMap_->isValid() &&
+        initFramesFromFileMap(frameCount, decodeLossyJPEG, decodeJPEG2K,
+                              decodeRLE)) {
+      BOOST_LOG_TRIVIAL(info) << "Done Queueing Frames";
+      return;
+    }
+    if (!isValid()) {
+      return;
+    }
+    BOOST_LOG_TRIVIAL(debug) << "DICOM pixel data can not be read from "
+                                "memory map; reading frames with DCMTK.";
+    fileMap_ = nullptr;
+  }
+  // Frames decoded by DCMTK require pixel data in dataset.
+  dcmFile_.loadFile(filename.c_str());
+  dataset_ = dcmFile_.getDataset();
+  if (initFramesFromDataset(frameCount, decodeLossyJPEG, decodeJPEG2K)) {
+    BOOST_LOG_TRIVIAL(info) << "Done Queueing Frames";
+  }
+}
+
+// Returns false without adding frames if frames are not stored as
+// expected; i.e. one fragment per frame or whole frames of native pixels.
+bool DcmFilePyramidSource::initFramesFromFileMap(int64_t frameCount,
+                                                 bool decodeLossyJPEG,
+                                                 bool decodeJPEG2K,
+                                                 bool decodeRLE) {
+  const bool encapsulated = decodeLossyJPEG || decodeJPEG2K || decodeRLE;
+  const uint64_t nativeFrameSize = frameWidth_ * frameHeight_ * 3;
+  if (encapsulated) {
+    if (!fileMap_->encapsulated() ||
+        fileMap_->fragmentCount() != static_cast<size_t>(frameCount)) {
+      return false;
+    }
+  } else if (fileMap_->encapsulated() ||
+             fileMap_->pixelDataSize() < frameCount * nativeFrameSize) {
+    return false;
+  }
+  uint64_t locationX = 0;
+  uint64_t locationY = 0;
+  for (size_t idx = 0; idx < frameCount; ++idx) {
+    if (locationX > imageWidth_) {
+      locationX = 0;
+      locationY += frameHeight_;
+    }
+    uint64_t dicomFrameMemorySize;
+    const uint8_t *dicomFrameMemory;
+    if (encapsulated) {
+      dicomFrameMemory = fileMap_->fragment(idx, &dicomFrameMemorySize);
+    } else {
+      dicomFrameMemorySize = nativeFrameSize;
+      dicomFrameMemory = fileMap_->pixelData() + idx * nativeFrameSize;
+    }
+    if (dicomFrameMemory == nullptr) {
+      setErrorMsg("Error getting DICOM Frame Memory.");
+      return false;
+    }
+    if (decodeLossyJPEG) {
+      framesData_.push_back(std::make_unique<JpegDicomFileFrame>(locationX,
+                                                        locationY,
+                                                        dicomFrameMemory,
+                                                        dicomFrameMemorySize,
+                                                        this));
+    } else if (decodeRLE) {
+      framesData_.push_back(std::make_unique<RleDicomFileFrame>(locationX,
+                                                        locationY,
+                                                        dicomFrameMemory,
+                                                        dicomFrameMemorySize,
+                                                        this));
+    } else if (!decodeJPEG2K) {
+      framesData_.push_back(std::make_unique<NativeDicomFileFrame>(locationX,
+                                                        locationY,
+                                                        dicomFrameMemory,
+                                                        dicomFrameMemorySize,
+                                                        this));
+    } else {
+      framesData_.push_back(std::make_unique<Jp2KDicomFileFrame>(locationX,
+                                                        locationY,
+                                                        dicomFrameMemory,
+                                                        dicomFrameMemorySize,
+                                                        this));
+    }
+    locationX += frameWidth_;
+  }
+  return true;
+}
+
+bool DcmFilePyramidSource::initFramesFromDataset(int64_t frameCount,
+                                                 bool decodeLossyJPEG,
+                                                 bool decodeJPEG2K) {
   // Get pixel data sequence
   DcmStack stack;
   if (!dataset_->search(DCM_PixelData, stack, ESM_fromHere, OFFalse).good()) {
     setErrorMsg("DICOM missing PixelData");
-    return;
+    return false;
   }
   DcmPixelData *pixelData = reinterpret_cast<DcmPixelData *>(stack.top());
   if (pixelData == nullptr || !pixelData->verify().good() ||
       !pixelData->checkValue().good()) {
     setErrorMsg("DICOM PixelData is invalid.");
-    return;
+    return false;
   }
   const DcmRepresentationParameter *repParam = nullptr;
   pixelData->getOriginalRepresentationKey(xfer_, repParam);
   if (xfer_ == EXS_Unknown) {
     setErrorMsg("Unknown DICOM transfer syntax");
-    return;
+    return false;
   }
-  if (!loadframes) {
-    return;
-  }
-  framesData_.reserve(frameCount);
-  bool DecodeLossyJPEG  = false;
-  bool DecodeJPEG2K = false;
   DcmPixelSequence *pixelSeq = nullptr;
   if (DcmXfer(xfer_).isEncapsulated()) {
     if (!pixelData->getEncapsulatedRepresentation(xfer_,
@@ -290,38 +451,28 @@ DcmFilePyramidSource::DcmFilePyramidSource(absl::string_view filePath,
                                                 pixelSeq).good() ||
       (pixelSeq == nullptr)) {
       setErrorMsg("Error getting pixel data.");
-      return;
+      return false;
     }
-    DecodeLossyJPEG = (EXS_JPEGProcess1 == xfer_ &&
-      3 == samplesPerPixel_ &&
-      0 == planarConfiguration_ &&
-      0 == pixelRepresentation_ &&
-      8 == bitsAllocated_ &&
-      24 == bitsStored_ &&
-      7 == highBit_ &&
-      (photometric_ == "RGB" ||
-       photometric_ == "YBR_FULL" ||
-       photometric_ == "YBR_FULL_422"));
-    DecodeJPEG2K = (EXS_JPEG2000LosslessOnly == xfer_ ||
-      EXS_JPEG2000 == xfer_ ||
-      EXS_JPEG2000MulticomponentLosslessOnly == xfer_ ||
-      EXS_JPEG2000Multicomponent == xfer_);
-    if (!DecodeLossyJPEG && !DecodeJPEG2K) {
+    if (!decodeLossyJPEG && !decodeJPEG2K) {
       DJDecoderRegistration::registerCodecs();
       DcmRLEDecoderRegistration::registerCodecs();
       dcmtkCodecRegistered_ = true;
     }
   }
   int outputDicomImageSize = 0;
-  if (!DecodeLossyJPEG && !DecodeJPEG2K) {
+  if (!decodeLossyJPEG && !decodeJPEG2K) {
     const uint64_t flags = CIF_UsePartialAccessToPixelData;
     DicomImage img(dataset_, xfer_, flags, static_cast<uint64_t>(0),
                    static_cast<uint64_t>(1));
     outputDicomImageSize = img.getOutputDataSize();
     if (outputDicomImageSize == 0) {
       setErrorMsg("Error getting output image size.");
-      return;
+      return false;
     }
+    // Dataset readers are created on first use; one per decoding thread.
+    maxFrameReaderIndex_ = std::max<int>(1, std::min<int>(
+                                                    availableCpuCount(), 30));
+    dicomDatasetSpeedReader_.resize(maxFrameReaderIndex_);
   }
   uint64_t locationX = 0;
   uint64_t locationY = 0;
@@ -330,19 +481,19 @@ DcmFilePyramidSource::DcmFilePyramidSource(absl::string_view filePath,
       locationX = 0;
       locationY += frameHeight_;
     }
-    if (DecodeLossyJPEG || DecodeJPEG2K) {
+    if (decodeLossyJPEG || decodeJPEG2K) {
       DcmPixelItem *pixelItem;
       if (!pixelSeq->getItem(pixelItem, idx+1).good()) {
         setErrorMsg("Error getting DICOM Frame.");
-        return;
+        return false;
       }
       uint64_t dicomFrameMemorySize = pixelItem->getLength();
       uint8_t *dicomFrameMemory;
       if (!pixelItem->getUint8Array(dicomFrameMemory).good()) {
         setErrorMsg("Error getting DICOM Frame Memory.");
-        return;
+        return false;
       }
-      if (DecodeLossyJPEG) {
+      if (decodeLossyJPEG) {
         framesData_.push_back(std::make_unique<JpegDicomFileFrame>(locationX,
                                                           locationY,
                                                           dicomFrameMemory,
@@ -364,7 +515,7 @@ DcmFilePyramidSource::DcmFilePyramidSource(absl::string_view filePath,
     }
     locationX += frameWidth_;
   }
-  BOOST_LOG_TRIVIAL(info) << "Done Queueing Frames";
+  return true;
 }
 
 void DcmFilePyramidSource::setErrorMsg(absl::string_view msg) {
@@ -381,6 +532,11 @@ std::string DcmFilePyramidSource::errorMsg() const {
 }
 
 DICOMDatasetReader * DcmFilePyramidSource::dicomDatasetReader(int index) {
+  boost::lock_guard<boost::mutex> guard(*datasetMutex());
+  if (dicomDatasetSpeedReader_[index] == nullptr) {
+    dicomDatasetSpeedReader_[index] = std::make_unique<DICOMDatasetReader>(
+                                        static_cast<std::string>(filename()));
+  }
   return dicomDatasetSpeedReader_[index].get();
 }
 
@@ -24,6 +24,7 @@
 #include <memory>
 #include <vector>
 #include "src/baseFilePyramidSource.h"
+#include "src/dcmFileMap.h"
 
 namespace wsiToDicomConverter {
 
@@ -46,11 +47,13 @@ class JpegDicomFileFrame : public AbstractDicomFileFrame {
  public:
   JpegDicomFileFrame(int64_t locationX,
                 int64_t locationY,
-                uint8_t *dicomMem,
+                const uint8_t *dicomMem,
                 uint64_t dicomMemSize,
                 DcmFilePyramidSource *pyramidSource);
   virtual J_COLOR_SPACE jpegDecodeColorSpace() const;
   virtual int64_t rawABGRFrameBytes(uint8_t *raw_memory, int64_t memorysize);
+  // Encoded JPEG frame; size returned by dicomFrameBytesSize.
+  const uint8_t *dicomFrameMemory() const;
 
  private:
   const uint8_t *dicomFrameMemory_;
@@ -60,13 +63,41 @@ class Jp2KDicomFileFrame : public AbstractDicomFileFrame {
  public:
   Jp2KDicomFileFrame(int64_t locationX,
                 int64_t locationY,
-                uint8_t *dicomMem,
+                const uint8_t *dicomMem,
                 uint64_t dicomMemSize,
                 DcmFilePyramidSource *pyramidSource);
   virtual int64_t rawABGRFrameBytes(uint8_t *raw_memory, int64_t memorysize);
 
  private:
-  uint8_t *dicomFrameMemory_;
+  const uint8_t *dicomFrameMemory_;
+};
+
+// Uncompressed 8 bit RGB frame read from memory mapped pixel data.
+class NativeDicomFileFrame : public AbstractDicomFileFrame {
+ public:
+  NativeDicomFileFrame(int64_t locationX,
+                int64_t locationY,
+                const uint8_t *dicomMem,
+                uint64_t dicomMemSize,
+                DcmFilePyramidSource *pyramidSource);
+  virtual int64_t rawABGRFrameBytes(uint8_t *raw_memory, int64_t memorysize);
+
+ private:
+  const uint8_t *dicomFrameMemory_;
+};
+
+// RLE Lossless 8 bit RGB frame read from memory mapped pixel data.
+class RleDicomFileFrame : public AbstractDicomFileFrame {
+ public:
+  RleDicomFileFrame(int64_t locationX,
+                int64_t locationY,
+                const uint8_t *dicomMem,
+                uint64_t dicomMemSize,
+                DcmFilePyramidSource *pyramidSource);
+  virtual int64_t rawABGRFrameBytes(uint8_t *raw_memory, int64_t memorysize);
+
+ private:
+  const uint8_t *dicomFrameMemory_;
 };
 
 class DICOMImageFrame : public AbstractDicomFileFrame {
@@ -95,6 +126,11 @@ class DICOMDatasetReader {
 };
 
 // Represents single DICOM file with metadata
+//
+// Only the DICOM header is parsed into memory. JPEG, JPEG2000, RLE and
+// uncompressed 8 bit RGB frames are read directly from a memory map of the
+// file. Frames of other transfer syntaxes and pixel formats are decoded by
+// DCMTK through DICOMDatasetReaders created on first use.
 class DcmFilePyramidSource :
                         public BaseFilePyramidSource<AbstractDicomFileFrame> {
  public:
@@ -124,6 +160,7 @@ class DcmFilePyramidSource :
  private:
   int frameReaderIndex_, maxFrameReaderIndex_;
   std::vector<std::unique_ptr<DICOMDatasetReader>> dicomDatasetSpeedReader_;
+  std::unique_ptr<DcmFileMap> fileMap_;
 
   DcmFileFormat dcmFile_;
   E_TransferSyntax xfer_;
@@ -149,6 +186,10 @@ class DcmFilePyramidSource :
   std::string getTagValueStringArray(const DcmTagKey &dcmTag);
   int64_t getTagValueI64(const DcmTagKey &dcmTag);
   void setErrorMsg(absl::string_view msg);
+  bool initFramesFromFileMap(int64_t frameCount, bool decodeLossyJPEG,
+                             bool decodeJPEG2K, bool decodeRLE);
+  bool initFramesFromDataset(int64_t frameCount, bool decodeLossyJPEG,
+                             bool decodeJPEG2K);
 };
 
 }  // namespace wsiToDicomConverter
@@ -0,0 +1,222 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/dcmOutputDirectFileStream.h"
+
+#include <dcmtk/dcmdata/dcerror.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <boost/log/trivial.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+namespace wsiToDicomConverter {
+
+// Alignment of buffer, file offsets, and write sizes required by O_DIRECT.
+static const size_t DIRECT_IO_ALIGNMENT = 4096;
+
+// Size of chunks written to file.
+static const size_t DIRECT_IO_CHUNK_SIZE = 8 * 1024 * 1024;
+
+DcmDirectFileConsumer::DcmDirectFileConsumer(absl::string_view filename,
+                                             int64_t preallocateBytes,
+                                             bool directIO,
+                                             bool dropPageCache) :
+                                  filename_(static_cast<std::string>(filename)),
+                                             fd_(-1),
+                                             directIO_(false),
+                                             dropPageCache_(dropPageCache),
+                                             status_(EC_Normal),
+                                             buffer_(nullptr),
+                                             bufferSize_(DIRECT_IO_CHUNK_SIZE),
+                                             bufferUsed_(0),
+                                             fileOffset_(0) {
+  const int flags = O_WRONLY | O_CREAT | O_TRUNC;
+  const mode_t mode = S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH;
+#ifdef O_DIRECT
+  if (directIO) {
+    fd_ = ::open(filename_.c_str(), flags | O_DIRECT, mode);
+    directIO_ = fd_ != -1;
+  }
+#endif
+  if (fd_ == -1) {
+    // Buffered I/O, or file system does not support O_DIRECT (e.g. tmpfs).
+    fd_ = ::open(filename_.c_str(), flags, mode);
+#ifdef F_NOCACHE
+    if (fd_ != -1 && directIO) {
+      directIO_ = fcntl(fd_, F_NOCACHE, 1) != -1;
+    }
+#endif
+  }
+  if (fd_ == -1) {
+    BOOST_LOG_TRIVIAL(error) << "Could not open " << filename_ << ": " <<
+                                std::strerror(errno);
+    status_ = EC_InvalidStream;
+    return;
+  }
+#ifdef __linux__
+  if (preallocateBytes > 0) {
+    // Reserve extents without changing file size. File size is set by the
+    // bytes written; preallocation avoids fragmenting large files.
+    if (fallocate(fd_, FALLOC_FL_KEEP_SIZE, 0, preallocateBytes) != 0) {
+      BOOST_LOG_TRIVIAL(debug) << "fallocate not supported for " <<
+                                  filename_;
+    }
+  }
+#endif
+  if (posix_memalign(reinterpret_cast<void **>(&buffer_),
+                     DIRECT_IO_ALIGNMENT, bufferSize_) != 0) {
+    buffer_ = nullptr;
+    BOOST_LOG_TRIVIAL(error) << "Could not allocate write buffer.";
+    status_ = EC_MemoryExhausted;
+  }
+}
+
+DcmDirectFileConsumer::~DcmDirectFileConsumer() {
+  close();
+  free(buffer_);
+}
+
+OFBool DcmDirectFileConsumer::good() const {
+  return status_.good();
+}
+
+OFCondition DcmDirectFileConsumer::status() const {
+  return status_;
+}
+
+OFBool DcmDirectFileConsumer::isFlushed() const {
+  // Buffered bytes are written on close.
+  return OFTrue;
+}
+
+offile_off_t DcmDirectFileConsumer::avail() const {
+  return OFstatic_cast(offile_off_t, -1);
+}
+
+bool DcmDirectFileConsumer::isDirectIO() const {
+  return directIO_;
+}
+
+bool DcmDirectFileConsumer::writeBuffer(size_t bytes) {
+  size_t written = 0;
+  while (written < bytes) {
+    const ssize_t result = pwrite(fd_, buffer_ + written, bytes - written,
+                                  fileOffset_ + written);
+    if (result < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      BOOST_LOG_TRIVIAL(error) << "Error writing " << filename_ << ": " <<
+                                  std::strerror(errno);
+      status_ = EC_InvalidStream;
+      return false;
+    }
+    written += result;
+  }
+  fileOffset_ += written;
+  return true;
+}
+
+offile_off_t DcmDirectFileConsumer::write(const void *buf,
+                                          offile_off_t buflen) {
+  if (status_.bad() || buflen <= 0) {
+    return 0;
+  }
+  const uint8_t *source = reinterpret_cast<const uint8_t *>(buf);
+  offile_off_t consumed = 0;
+  while (consumed < buflen) {
+    const size_t copySize = std::min<size_t>(bufferSize_ - bufferUsed_,
+                                             buflen - consumed);
+    std::memcpy(buffer_ + bufferUsed_, source + consumed, copySize);
+    bufferUsed_ += copySize;
+    consumed += copySize;
+    if (bufferUsed_ == bufferSize_) {
+      if (!writeBuffer(bufferUsed_)) {
+        return consumed;
+      }
+      bufferUsed_ = 0;
+    }
+  }
+  return consumed;
+}
+
+void DcmDirectFileConsumer::flush() {
+  // Writing partial chunks would break I/O alignment. Full chunks are
+  // written as they fill; remaining bytes are written on close.
+}
+
+OFCondition DcmDirectFileConsumer::close() {
+  if (fd_ == -1) {
+    return status_;
+  }
+  const int64_t fileSize = fileOffset_ + bufferUsed_;
+  if (status_.good() && bufferUsed_ > 0) {
+    size_t tailSize = bufferUsed_;
+    if (directIO_) {
+      // Pad tail to alignment; file is truncated to actual size below.
+      tailSize = ((bufferUsed_ + DIRECT_IO_ALIGNMENT - 1) /
+                   DIRECT_IO_ALIGNMENT) * DIRECT_IO_ALIGNMENT;
+      std::memset(buffer_ + bufferUsed_, 0, tailSize - bufferUsed_);
+    }
+    if (writeBuffer(tailSize)) {
+      bufferUsed_ = 0;
+    }
+  }
+  if (status_.good() && ftruncate(fd_, fileSize) != 0) {
+    BOOST_LOG_TRIVIAL(error) << "Error truncating " << filename_ << ": " <<
+                                std::strerror(errno);
+    status_ = EC_InvalidStream;
+  }
+#ifdef POSIX_FADV_DONTNEED
+  if (dropPageCache_) {
+    // Dirty pages must be written before they can be dropped.
+    if (!directIO_ && fdatasync(fd_) != 0 && status_.good()) {
+      BOOST_LOG_TRIVIAL(error) << "Error syncing " << filename_ << ": " <<
+                                  std::strerror(errno);
+      status_ = EC_InvalidStream;
+    }
+    posix_fadvise(fd_, 0, 0, POSIX_FADV_DONTNEED);
+  }
+#endif
+  if (::close(fd_) != 0 && status_.good()) {
+    BOOST_LOG_TRIVIAL(error) << "Error closing " << filename_ << ": " <<
+                                std::strerror(errno);
+    status_ = EC_InvalidStream;
+  }
+  fd_ = -1;
+  return status_;
+}
+
+DcmOutputDirectFileStream::DcmOutputDirectFileStream(
+    absl::string_view filename, int64_t preallocateBytes, bool directIO,
+    bool dropPageCache)
+    : DcmOutputStream(&consumer_),
+      consumer_(filename, preallocateBytes, directIO, dropPageCache) {}
+
+DcmOutputDirectFileStream::~DcmOutputDirectFileStream() {
+  close();
+}
+
+OFCondition DcmOutputDirectFileStream::close() {
+  flush();
+  return consumer_.close();
+}
+
+}  // namespace wsiToDicomConverter
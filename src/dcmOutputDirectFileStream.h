@@ -0,0 +1,92 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SRC_DCMOUTPUTDIRECTFILESTREAM_H_
+#define SRC_DCMOUTPUTDIRECTFILESTREAM_H_
+
+#include <absl/strings/string_view.h>
+#include <dcmtk/dcmdata/dcostrma.h>
+#include <dcmtk/ofstd/ofcond.h>
+
+#include <string>
+
+namespace wsiToDicomConverter {
+
+/* DCMTK consumer which writes a file in large chunks, optionally
+   bypassing the page cache (O_DIRECT on Linux, F_NOCACHE on macOS).
+
+   File is preallocated to the expected size. With direct I/O, tail of
+   file is written padded to the I/O alignment and truncated to the
+   written size on close. Optionally drops written pages from the page
+   cache on close. Falls back to buffered I/O if file system does not
+   support direct I/O.
+*/
+class DcmDirectFileConsumer : public DcmConsumer {
+ public:
+  // filename : path of file to write.
+  // preallocateBytes : expected file size, <= 0 disables preallocation.
+  // directIO : bypass page cache; otherwise file is written buffered.
+  // dropPageCache : posix_fadvise(DONTNEED) file on close.
+  DcmDirectFileConsumer(absl::string_view filename, int64_t preallocateBytes,
+                        bool directIO, bool dropPageCache);
+  virtual ~DcmDirectFileConsumer();
+
+  virtual OFBool good() const;
+  virtual OFCondition status() const;
+  virtual OFBool isFlushed() const;
+  virtual offile_off_t avail() const;
+  virtual offile_off_t write(const void *buf, offile_off_t buflen);
+  virtual void flush();
+
+  // Writes buffered tail, truncates file to written size and closes file.
+  // Returns status of file.
+  OFCondition close();
+
+  // Returns true if file was opened for direct I/O.
+  bool isDirectIO() const;
+
+ private:
+  // Writes first bytes of buffer to file at current file offset.
+  // bytes must be a multiple of the I/O alignment if direct I/O is used.
+  bool writeBuffer(size_t bytes);
+
+  std::string filename_;
+  int fd_;
+  bool directIO_;
+  bool dropPageCache_;
+  OFCondition status_;
+  uint8_t *buffer_;
+  size_t bufferSize_;
+  size_t bufferUsed_;
+  int64_t fileOffset_;
+};
+
+// DCMTK output stream writing file through DcmDirectFileConsumer.
+class DcmOutputDirectFileStream : public DcmOutputStream {
+ public:
+  DcmOutputDirectFileStream(absl::string_view filename,
+                            int64_t preallocateBytes, bool directIO,
+                            bool dropPageCache);
+  virtual ~DcmOutputDirectFileStream();
+
+  // Flushes stream and closes file. Returns status of file; errors of
+  // writing the buffered tail or closing the file are only known here.
+  OFCondition close();
+
+ private:
+  DcmDirectFileConsumer consumer_;
+};
+
+}  // namespace wsiToDicomConverter
+#endif  // SRC_DCMOUTPUTDIRECTFILESTREAM_H_
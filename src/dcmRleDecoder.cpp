@@ -0,0 +1,105 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/dcmRleDecoder.h"
+
+#include <boost/log/trivial.hpp>
+
+#include <cstring>
+
+namespace wsiToDicomConverter {
+
+// RLE header; segment count followed by 15 segment offsets.
+static const uint64_t RLE_HEADER_SIZE = 64;
+static const uint32_t RLE_MAX_SEGMENTS = 15;
+
+static uint32_t readUint32(const uint8_t *memory) {
+  uint32_t value;
+  std::memcpy(&value, memory, sizeof(value));
+  return value;
+}
+
+bool DcmRleDecoder::decodeRGBToABGR(const uint8_t *frame, uint64_t frameSize,
+                                    uint64_t pixelCount, uint8_t *dest) {
+  if (frameSize < RLE_HEADER_SIZE) {
+    BOOST_LOG_TRIVIAL(error) << "RLE frame is missing header.";
+    return false;
+  }
+  const uint32_t segmentCount = readUint32(frame);
+  if (segmentCount != 3) {
+    BOOST_LOG_TRIVIAL(error) << "RLE frame has " << segmentCount <<
+                                " segments; expected 3.";
+    return false;
+  }
+  uint64_t segmentOffsets[RLE_MAX_SEGMENTS + 1];
+  for (uint32_t segment = 0; segment < segmentCount; ++segment) {
+    segmentOffsets[segment] = readUint32(frame + 4 * (segment + 1));
+  }
+  segmentOffsets[segmentCount] = frameSize;
+  for (uint32_t segment = 0; segment < segmentCount; ++segment) {
+    const uint64_t start = segmentOffsets[segment];
+    const uint64_t end = segmentOffsets[segment + 1];
+    if (start < RLE_HEADER_SIZE || end < start || end > frameSize) {
+      BOOST_LOG_TRIVIAL(error) << "RLE segment offset is invalid.";
+      return false;
+    }
+    if (!decodeSegment(frame + start, end - start, pixelCount, 4,
+                       dest + segment)) {
+      return false;
+    }
+  }
+  uint8_t *alpha = dest + 3;
+  for (uint64_t idx = 0; idx < pixelCount; ++idx) {
+    *alpha = 0xff;
+    alpha += 4;
+  }
+  return true;
+}
+
+bool DcmRleDecoder::decodeSegment(const uint8_t *segment,
+                                  uint64_t segmentSize, uint64_t pixelCount,
+                                  uint64_t stride, uint8_t *dest) {
+  uint64_t in = 0;
+  uint64_t out = 0;
+  while (out < pixelCount && in < segmentSize) {
+    const int8_t header = static_cast<int8_t>(segment[in++]);
+    if (header >= 0) {
+      // Literal run of header + 1 bytes.
+      uint64_t count = static_cast<uint64_t>(header) + 1;
+      if (in + count > segmentSize || out + count > pixelCount) {
+        break;
+      }
+      for (; count > 0; --count) {
+        dest[out++ * stride] = segment[in++];
+      }
+    } else if (header != -128) {
+      // Next byte repeated 1 - header times.
+      uint64_t count = 1 - static_cast<int64_t>(header);
+      if (in >= segmentSize || out + count > pixelCount) {
+        break;
+      }
+      const uint8_t value = segment[in++];
+      for (; count > 0; --count) {
+        dest[out++ * stride] = value;
+      }
+    }
+  }
+  if (out != pixelCount) {
+    BOOST_LOG_TRIVIAL(error) << "RLE segment is truncated.";
+    return false;
+  }
+  return true;
+}
+
+}  // namespace wsiToDicomConverter
@@ -0,0 +1,50 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SRC_DCMRLEDECODER_H_
+#define SRC_DCMRLEDECODER_H_
+
+#include <cstdint>
+
+namespace wsiToDicomConverter {
+
+/* Decoder for DICOM RLE Lossless frames (PS3.5 Annex G).
+
+   Decoder is stateless; frames may be decoded concurrently from any number
+   of threads.
+*/
+class DcmRleDecoder {
+ public:
+  // Decodes 8 bit per sample RGB frame (3 segments; R, G, B) to 4 byte
+  // pixels with opaque alpha (R, G, B, A bytes; raw ABGR frame layout).
+  // Each segment is decoded directly into its byte of the output pixels.
+  //
+  // frame : encoded frame; RLE header followed by segments.
+  // frameSize : bytes in frame.
+  // pixelCount : frame width * height.
+  // dest : pixelCount * 4 bytes.
+  //
+  // Returns false if frame is not 3 segment RLE or segments are truncated.
+  static bool decodeRGBToABGR(const uint8_t *frame, uint64_t frameSize,
+                              uint64_t pixelCount, uint8_t *dest);
+
+ private:
+  // Decodes PackBits segment writing every stride'th byte of dest.
+  static bool decodeSegment(const uint8_t *segment, uint64_t segmentSize,
+                            uint64_t pixelCount, uint64_t stride,
+                            uint8_t *dest);
+};
+
+}  // namespace wsiToDicomConverter
+#endif  // SRC_DCMRLEDECODER_H_
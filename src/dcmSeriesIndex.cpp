@@ -0,0 +1,325 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/dcmSeriesIndex.h"
+
+#include <boost/filesystem.hpp>
+#include <boost/log/trivial.hpp>
+#include <dcmtk/dcmdata/dcdeftag.h>
+#include <dcmtk/dcmdata/dcfilefo.h>
+#include <dcmtk/dcmdata/dcuid.h>
+#include <dcmtk/dcmdata/dcxfer.h>
+
+#include <algorithm>
+#include <map>
+#include <utility>
+
+#include "src/dcmFilePyramidSource.h"
+
+namespace wsiToDicomConverter {
+
+namespace {
+
+// Header values of a single instance used to group instances into levels.
+struct DcmSeriesInstance {
+  std::string path;
+  std::string studyInstanceUID;
+  std::string seriesInstanceUID;
+  std::string transferSyntaxUID;
+  std::string concatenationUID;
+  std::string dimensionOrganizationType;
+  int64_t inConcatenationNumber;
+  int64_t imageWidth;
+  int64_t imageHeight;
+  int64_t frameWidth;
+  int64_t frameHeight;
+  int64_t frameCount;
+};
+
+std::string getString(DcmDataset *dataset, const DcmTagKey &tag,
+                      uint32_t position = 0) {
+  OFString value;
+  if (dataset->findAndGetOFString(tag, value, position,
+                                  OFFalse /*searchIntoSub*/).good()) {
+    return value.c_str();
+  }
+  return "";
+}
+
+int64_t getUint16(DcmDataset *dataset, const DcmTagKey &tag) {
+  uint16_t value;
+  if (dataset->findAndGetUint16(tag, value, 0,
+                                OFFalse /*searchIntoSub*/).good()) {
+    return value;
+  }
+  return 0;
+}
+
+int64_t getUint32(DcmDataset *dataset, const DcmTagKey &tag) {
+  uint32_t value;
+  if (dataset->findAndGetUint32(tag, value, 0,
+                                OFFalse /*searchIntoSub*/).good()) {
+    return value;
+  }
+  return 0;
+}
+
+int64_t getLongInt(DcmDataset *dataset, const DcmTagKey &tag) {
+  int64_t value;
+  if (dataset->findAndGetLongInt(tag, value, 0,
+                                 OFFalse /*searchIntoSub*/).good()) {
+    return value;
+  }
+  return 0;
+}
+
+// Reads DICOM header of file. Returns false if file is not a TILED_FULL
+// VOLUME instance of a VL whole slide microscopy image.
+bool readInstance(const std::string &path, DcmSeriesInstance *instance) {
+  DcmFileFormat dcmFile;
+  if (dcmFile.loadFileUntilTag(path.c_str(), EXS_Unknown, EGL_noChange,
+                               DCM_MaxReadLength, ERM_autoDetect,
+                               DCM_PixelData).bad()) {
+    return false;
+  }
+  DcmDataset *dataset = dcmFile.getDataset();
+  if (getString(dataset, DCM_SOPClassUID) !=
+          UID_VLWholeSlideMicroscopyImageStorage ||
+      getString(dataset, DCM_ImageType, 2) != "VOLUME" ||
+      getString(dataset, DCM_DimensionOrganizationType) != "TILED_FULL") {
+    return false;
+  }
+  instance->path = path;
+  instance->studyInstanceUID = getString(dataset, DCM_StudyInstanceUID);
+  instance->seriesInstanceUID = getString(dataset, DCM_SeriesInstanceUID);
+  instance->transferSyntaxUID =
+                        DcmXfer(dataset->getOriginalXfer()).getXferID();
+  instance->concatenationUID = getString(dataset, DCM_ConcatenationUID);
+  instance->dimensionOrganizationType = getString(dataset,
+                                            DCM_DimensionOrganizationType);
+  instance->inConcatenationNumber = getUint16(dataset,
+                                              DCM_InConcatenationNumber);
+  instance->imageWidth = getUint32(dataset, DCM_TotalPixelMatrixColumns);
+  instance->imageHeight = getUint32(dataset, DCM_TotalPixelMatrixRows);
+  instance->frameWidth = getUint16(dataset, DCM_Columns);
+  instance->frameHeight = getUint16(dataset, DCM_Rows);
+  instance->frameCount = getLongInt(dataset, DCM_NumberOfFrames);
+  return (instance->imageWidth > 0 && instance->imageHeight > 0 &&
+          instance->frameWidth > 0 && instance->frameHeight > 0 &&
+          instance->frameCount > 0);
+}
+
+// Returns true if instances, ordered by InConcatenationNumber, hold every
+// frame of a level with consistent frame dimensions and encoding.
+bool isCompleteLevel(const std::vector<DcmSeriesInstance> &instances) {
+  const DcmSeriesInstance &first = instances[0];
+  const int64_t framesPerRow = (first.imageWidth + first.frameWidth - 1) /
+                               first.frameWidth;
+  const int64_t framesPerColumn = (first.imageHeight + first.frameHeight -
+                                   1) / first.frameHeight;
+  int64_t frameCount = 0;
+  for (const DcmSeriesInstance &instance : instances) {
+    if (instance.frameWidth != first.frameWidth ||
+        instance.frameHeight != first.frameHeight ||
+        instance.transferSyntaxUID != first.transferSyntaxUID) {
+      return false;
+    }
+    frameCount += instance.frameCount;
+  }
+  return frameCount == framesPerRow * framesPerColumn;
+}
+
+}  // namespace
+
+DcmSeriesIndex::DcmSeriesIndex(absl::string_view directory) {
+  const boost::filesystem::path dirPath(static_cast<std::string>(directory));
+  if (!boost::filesystem::is_directory(dirPath)) {
+    setErrorMsg("DICOM series path is not a directory.");
+    return;
+  }
+  // Sorted to make selection among duplicate encodings deterministic.
+  std::vector<std::string> paths;
+  for (const boost::filesystem::directory_entry &entry :
+       boost::filesystem::directory_iterator(dirPath)) {
+    if (boost::filesystem::is_regular_file(entry.path())) {
+      paths.push_back(entry.path().string());
+    }
+  }
+  std::sort(paths.begin(), paths.end());
+
+  // Instances grouped by level dimensions and then by concatenation.
+  // Instances which are not part of a concatenation are grouped by path.
+  std::map<std::pair<int64_t, int64_t>,
+           std::map<std::string, std::vector<DcmSeriesInstance>>> groups;
+  std::vector<std::string> groupOrder;
+  for (const std::string &path : paths) {
+    DcmSeriesInstance instance;
+    if (!readInstance(path, &instance)) {
+      BOOST_LOG_TRIVIAL(debug) << "Skipping file not part of DICOM WSI "
+                                  "pyramid: " << path;
+      continue;
+    }
+    if (seriesInstanceUID_.empty()) {
+      studyInstanceUID_ = instance.studyInstanceUID;
+      seriesInstanceUID_ = instance.seriesInstanceUID;
+    } else if (seriesInstanceUID_ != instance.seriesInstanceUID) {
+      setErrorMsg("Directory contains instances of more than one DICOM "
+                  "series.");
+      return;
+    }
+    const std::string groupKey = instance.concatenationUID.empty() ?
+                                 path : instance.concatenationUID;
+    std::vector<DcmSeriesInstance> *group =
+        &groups[std::make_pair(instance.imageWidth, instance.imageHeight)]
+               [groupKey];
+    if (group->empty()) {
+      groupOrder.push_back(groupKey);
+    }
+    group->push_back(std::move(instance));
+  }
+  for (auto &levelGroups : groups) {
+    // Select first complete encoding of level in path order.
+    for (const std::string &groupKey : groupOrder) {
+      auto group = levelGroups.second.find(groupKey);
+      if (group == levelGroups.second.end()) {
+        continue;
+      }
+      std::vector<DcmSeriesInstance> &instances = group->second;
+      std::sort(instances.begin(), instances.end(),
+                [](const DcmSeriesInstance &a, const DcmSeriesInstance &b) {
+                  return a.inConcatenationNumber < b.inConcatenationNumber;
+                });
+      if (!isCompleteLevel(instances)) {
+        BOOST_LOG_TRIVIAL(warning) << "Skipping incomplete DICOM level: " <<
+                                      instances[0].path;
+        continue;
+      }
+      DcmSeriesLevel level;
+      level.imageWidth = instances[0].imageWidth;
+      level.imageHeight = instances[0].imageHeight;
+      level.frameWidth = instances[0].frameWidth;
+      level.frameHeight = instances[0].frameHeight;
+      level.frameCount = 0;
+      level.transferSyntaxUID = instances[0].transferSyntaxUID;
+      level.concatenationUID = instances[0].concatenationUID;
+      level.dimensionOrganizationType =
+                                    instances[0].dimensionOrganizationType;
+      for (const DcmSeriesInstance &instance : instances) {
+        level.frameCount += instance.frameCount;
+        level.files.push_back(instance.path);
+        level.fileFrameCounts.push_back(instance.frameCount);
+      }
+      levels_.push_back(std::move(level));
+      break;
+    }
+  }
+  if (levels_.empty()) {
+    setErrorMsg("Directory does not contain a DICOM WSI pyramid level.");
+    return;
+  }
+  std::sort(levels_.begin(), levels_.end(),
+            [](const DcmSeriesLevel &a, const DcmSeriesLevel &b) {
+              return a.imageWidth * a.imageHeight >
+                     b.imageWidth * b.imageHeight;
+            });
+  for (const DcmSeriesLevel &level : levels_) {
+    BOOST_LOG_TRIVIAL(debug) << "DICOM series level: " << level.imageWidth <<
+                                ", " << level.imageHeight << " instances: " <<
+                                level.files.size();
+  }
+}
+
+bool DcmSeriesIndex::isValid() const {
+  return errorMsg_.empty();
+}
+
+std::string DcmSeriesIndex::errorMsg() const {
+  return errorMsg_;
+}
+
+absl::string_view DcmSeriesIndex::studyInstanceUID() const {
+  return studyInstanceUID_;
+}
+
+absl::string_view DcmSeriesIndex::seriesInstanceUID() const {
+  return seriesInstanceUID_;
+}
+
+size_t DcmSeriesIndex::levelCount() const {
+  return levels_.size();
+}
+
+const DcmSeriesLevel &DcmSeriesIndex::level(size_t index) const {
+  return levels_.at(index);
+}
+
+int32_t DcmSeriesIndex::closestLevel(int64_t width, int64_t height) const {
+  // Levels are ordered largest to smallest.
+  int32_t closest = -1;
+  for (size_t idx = 0; idx < levels_.size(); ++idx) {
+    if (levels_[idx].imageWidth < width || levels_[idx].imageHeight < height) {
+      break;
+    }
+    closest = static_cast<int32_t>(idx);
+  }
+  return closest;
+}
+
+std::vector<std::unique_ptr<AbstractDcmFile>> DcmSeriesIndex::loadLevel(
+                                                        size_t index) const {
+  std::vector<std::unique_ptr<AbstractDcmFile>> dcmFiles;
+  for (const std::string &path : levels_.at(index).files) {
+    std::unique_ptr<DcmFilePyramidSource> dcmFile =
+                                 std::make_unique<DcmFilePyramidSource>(path);
+    if (!dcmFile->isValid() || dcmFile->fileFrameCount() <= 0) {
+      BOOST_LOG_TRIVIAL(error) << "Error reading DICOM frames: " << path;
+      dcmFiles.clear();
+      return dcmFiles;
+    }
+    dcmFiles.push_back(std::move(dcmFile));
+  }
+  return dcmFiles;
+}
+
+bool DcmSeriesIndex::copyInstance(absl::string_view inputFile,
+                                  absl::string_view outputFile,
+                                  int32_t instanceNumber) {
+  const std::string inputPath = static_cast<std::string>(inputFile);
+  const std::string outputPath = static_cast<std::string>(outputFile);
+  // Large elements, e.g. pixel data, are read from input as they are
+  // written.
+  DcmFileFormat dcmFile;
+  OFCondition cond = dcmFile.loadFile(inputPath.c_str());
+  if (cond.good()) {
+    DcmDataset *dataset = dcmFile.getDataset();
+    cond = dataset->putAndInsertString(DCM_InstanceNumber,
+                                 std::to_string(instanceNumber).c_str());
+    if (cond.good()) {
+      cond = dcmFile.saveFile(outputPath.c_str(), dataset->getOriginalXfer());
+    }
+  }
+  if (cond.bad()) {
+    BOOST_LOG_TRIVIAL(error) << "Error copying " << inputPath << " to " <<
+                                outputPath << ": " << cond.text();
+    return false;
+  }
+  return true;
+}
+
+void DcmSeriesIndex::setErrorMsg(absl::string_view msg) {
+  errorMsg_ = static_cast<std::string>(msg);
+  BOOST_LOG_TRIVIAL(error) << errorMsg_;
+}
+
+}  // namespace wsiToDicomConverter
@@ -0,0 +1,94 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SRC_DCMSERIESINDEX_H_
+#define SRC_DCMSERIESINDEX_H_
+
+#include <absl/strings/string_view.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "src/abstractDcmFile.h"
+
+namespace wsiToDicomConverter {
+
+// Pyramid level of a DICOM VL whole slide imaging series. Level may be
+// stored as a single instance or as a concatenation of instances.
+struct DcmSeriesLevel {
+  int64_t imageWidth;
+  int64_t imageHeight;
+  int64_t frameWidth;
+  int64_t frameHeight;
+  int64_t frameCount;
+  std::string transferSyntaxUID;
+  std::string concatenationUID;
+  // DimensionOrganizationType of level instances.
+  std::string dimensionOrganizationType;
+  // Instance paths ordered by InConcatenationNumber.
+  std::vector<std::string> files;
+  std::vector<int64_t> fileFrameCounts;
+};
+
+/* Index of the pyramid levels of a DICOM series stored in a directory.
+
+   Only DICOM headers are read to build the index. Instances are grouped
+   into levels by TotalPixelMatrixColumns and TotalPixelMatrixRows and,
+   within a level, by ConcatenationUID. Levels which are not TILED_FULL or
+   which are missing frames are not indexed. If a level is encoded more
+   than once the first complete encoding found is indexed.
+*/
+class DcmSeriesIndex {
+ public:
+  explicit DcmSeriesIndex(absl::string_view directory);
+
+  // True if directory holds at least one level of a single series.
+  bool isValid() const;
+  std::string errorMsg() const;
+
+  absl::string_view studyInstanceUID() const;
+  absl::string_view seriesInstanceUID() const;
+
+  // Levels ordered from largest to smallest image dimensions.
+  size_t levelCount() const;
+  const DcmSeriesLevel &level(size_t index) const;
+
+  // Returns index of smallest level with dimensions greater than or equal
+  // to width and height. Returns -1 if no level is large enough.
+  int32_t closestLevel(int64_t width, int64_t height) const;
+
+  // Loads level instances for reading frames with
+  // DICOMFileFrameRegionReader. Returns empty vector on error.
+  std::vector<std::unique_ptr<AbstractDcmFile>> loadLevel(
+                                                        size_t index) const;
+
+  // Writes instance to outputFile with InstanceNumber set to
+  // instanceNumber. Pixel data is written without decoding. Returns false
+  // on error.
+  static bool copyInstance(absl::string_view inputFile,
+                           absl::string_view outputFile,
+                           int32_t instanceNumber);
+
+ private:
+  void setErrorMsg(absl::string_view msg);
+
+  std::vector<DcmSeriesLevel> levels_;
+  std::string studyInstanceUID_;
+  std::string seriesInstanceUID_;
+  std::string errorMsg_;
+};
+
+}  // namespace wsiToDicomConverter
+#endif  // SRC_DCMSERIESINDEX_H_
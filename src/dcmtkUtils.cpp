@@ -23,6 +23,7 @@
 #include <dcmtk/dcmdata/dcuid.h>
 #include <dcmtk/dcmdata/dcvrat.h>
 #include <dcmtk/dcmdata/dcwcache.h>
+#include <dcmtk/dcmdata/dcxfer.h>
 #include <dcmtk/dcmdata/libi2d/i2d.h>
 #include <dcmtk/dcmdata/libi2d/i2doutpl.h>
 #include <dcmtk/dcmdata/libi2d/i2dplsc.h>
@@ -30,7 +31,9 @@
 #include <boost/lexical_cast.hpp>
 #include <boost/log/trivial.hpp>
 #include <boost/thread/thread.hpp>
+#include <cstring>
 #include <ctime>
+#include <fstream>
 #include <iomanip>
 #include <string>
 #include <utility>
@@ -117,14 +120,21 @@ inline std::unique_ptr<DcmItem> pointerItem(char* dimensionOrganizationUIDstr) {
   return pointerItem;
 }
 
-inline OFCondition generateDimensionIndexSequence(DcmDataset* resultObject) {
+inline OFCondition generateDimensionIndexSequence(
+    DcmDataset* resultObject, absl::string_view instanceUid) {
   std::unique_ptr<DcmItem> dimensionOrganizationUID =
       std::make_unique<DcmItem>();
   char dimensionOrganizationUIDstr[100];
+  if (instanceUid.empty()) {
+    dcmGenerateUniqueIdentifier(dimensionOrganizationUIDstr,
+                                SITE_STUDY_UID_ROOT);
+  } else {
+    // Derived from instance UID so instances written again are identical.
+    snprintf(dimensionOrganizationUIDstr, sizeof(dimensionOrganizationUIDstr),
+             "%s.1", static_cast<std::string>(instanceUid).c_str());
+  }
   dimensionOrganizationUID->putAndInsertOFStringArray(
-      DCM_DimensionOrganizationUID,
-      dcmGenerateUniqueIdentifier(dimensionOrganizationUIDstr,
-                                  SITE_STUDY_UID_ROOT));
+      DCM_DimensionOrganizationUID, dimensionOrganizationUIDstr);
   std::unique_ptr<DcmSequenceOfItems> dimensionOrganizationSequence =
       std::make_unique<DcmSequenceOfItems>(DCM_DimensionOrganizationSequence);
   dimensionOrganizationSequence->insert(dimensionOrganizationUID.release());
@@ -238,7 +248,8 @@ OFCondition DcmtkUtils::populateDataSet(
     const int32_t downsample, const int batchNumber, const uint32_t offset,
     const uint32_t totalNumberOfFrames, const bool tiled,
     DcmTags* additionalTags, const double firstLevelWidthMm,
-    const double firstLevelHeightMm, DcmDataset* dataSet) {
+    const double firstLevelHeightMm, DcmDataset* dataSet,
+    absl::string_view instanceUid) {
   std::unique_ptr<I2DOutputPlug> outPlug;
 
   OFString pixDataFile, outputFile;
@@ -252,10 +263,7 @@ OFCondition DcmtkUtils::populateDataSet(
 
   outPlug->setValidityChecking(doChecks, insertType2, inventType1);
 
-  if (!dcmDataDict.isDictionaryLoaded()) {
-    dcmDataDict.wrlock().reloadDictionaries(true, false);
-    dcmDataDict.wrunlock();
-  }
+  loadDataDictionary();
 
   OFCondition cond =
       generateDcmDataset(outPlug.get(), dataSet, imgInfo, numberOfFrames);
@@ -269,7 +277,7 @@ OFCondition DcmtkUtils::populateDataSet(
 
   if (cond.bad()) return cond;
 
-  cond = insertIds(studyId, seriesId, dataSet);
+  cond = insertIds(studyId, seriesId, dataSet, instanceUid);
 
   if (cond.bad()) return cond;
 
@@ -292,7 +300,7 @@ OFCondition DcmtkUtils::populateDataSet(
                firstLevelHeightMm / static_cast<double>(imageHeight));
   if (cond.bad()) return cond;
 
-  cond = generateDimensionIndexSequence(dataSet);
+  cond = generateDimensionIndexSequence(dataSet, instanceUid);
 
   if (cond.bad()) return cond;
 
@@ -303,6 +311,19 @@ OFCondition DcmtkUtils::populateDataSet(
   return cond;
 }
 
+void DcmtkUtils::loadDataDictionary() {
+  if (dcmDataDict.isDictionaryLoaded()) {
+    return;
+  }
+  DcmDataDictionary &dictionary = dcmDataDict.wrlock();
+  // Checked again under lock; dictionary may have been loaded by another
+  // thread.
+  if (!dictionary.isDictionaryLoaded()) {
+    dictionary.reloadDictionaries(true, false);
+  }
+  dcmDataDict.wrunlock();
+}
+
 OFCondition DcmtkUtils::generateDateTags(DcmDataset* dataSet) {
   OFCondition cond = dataSet->putAndInsertOFStringArray(DCM_ContentDate,
                                                         currentDate().c_str());
@@ -336,9 +357,15 @@ OFCondition DcmtkUtils::insertStaticTags(DcmDataset* dataSet, int downsample) {
 
 OFCondition DcmtkUtils::insertIds(absl::string_view studyId,
                                   absl::string_view seriesId,
-                                  DcmDataset* dataSet) {
+                                  DcmDataset* dataSet,
+                                  absl::string_view instanceUid) {
   char instanceUidGenerated[100];
-  dcmGenerateUniqueIdentifier(instanceUidGenerated, SITE_INSTANCE_UID_ROOT);
+  if (instanceUid.empty()) {
+    dcmGenerateUniqueIdentifier(instanceUidGenerated, SITE_INSTANCE_UID_ROOT);
+  } else {
+    snprintf(instanceUidGenerated, sizeof(instanceUidGenerated), "%s",
+             static_cast<std::string>(instanceUid).c_str());
+  }
   OFCondition cond = dataSet->putAndInsertOFStringArray(DCM_SOPInstanceUID,
                                                         instanceUidGenerated);
   if (cond.bad()) return cond;
@@ -453,7 +480,8 @@ OFCondition DcmtkUtils::startConversion(
     uint32_t column, const int32_t instanceNumber, const int32_t downsample,
     int batchNumber, unsigned int offset, uint32_t totalNumberOfFrames,
     bool tiled, DcmTags* additionalTags, double firstLevelWidthMm,
-    double firstLevelHeightMm, DcmOutputStream* outStream) {
+    double firstLevelHeightMm, DcmOutputStream* outStream,
+    absl::string_view instanceUid) {
   E_GrpLenEncoding grpLenEncoding = EGL_recalcGL;
   E_EncodingType encodingType = EET_ExplicitLength;
   E_PaddingEncoding paddingEncoding = EPD_noChange;
@@ -468,7 +496,7 @@ OFCondition DcmtkUtils::startConversion(
       std::move(pixelData), imgInfo, numberOfFrames, row, column,
       instanceNumber, downsample, batchNumber, offset, totalNumberOfFrames,
       tiled, additionalTags, firstLevelWidthMm, firstLevelHeightMm,
-      resultObject.get());
+      resultObject.get(), instanceUid);
 
   DcmFileFormat dcmFileFormat(resultObject.get());
 
@@ -489,4 +517,72 @@ OFCondition DcmtkUtils::startConversion(
   return cond;
 }
 
+OFCondition DcmtkUtils::updateInConcatenationTotalNumber(
+    absl::string_view fileName, uint16_t concatenationTotalNumber) {
+  const std::string path = static_cast<std::string>(fileName);
+  // Offset of element is found by parsing header; pixel data is not read.
+  DcmFileFormat dcmFile;
+  OFCondition cond = dcmFile.loadFileUntilTag(path.c_str(), EXS_Unknown,
+                                              EGL_noChange, DCM_MaxReadLength,
+                                              ERM_autoDetect, DCM_PixelData);
+  if (cond.bad()) {
+    BOOST_LOG_TRIVIAL(error) << "Could not read: " << fileName << ": " <<
+                                cond.text();
+    return cond;
+  }
+  DcmDataset *dataset = dcmFile.getDataset();
+  const E_TransferSyntax xfer = dataset->getOriginalXfer();
+  // Datasets are written with explicit VR little endian encoding
+  // (JPEG, JPEG2000, and uncompressed transfer syntaxes) and explicit
+  // lengths. The element (0020,9162) US has a fixed 10 byte encoding.
+  const DcmXfer xferInfo(xfer);
+  if (!xferInfo.isExplicitVR() || !xferInfo.isLittleEndian() ||
+      xferInfo.isDeflated()) {
+    return EC_UnsupportedEncoding;
+  }
+  // File meta information follows 128 byte preamble and "DICM" prefix.
+  uint64_t elementOffset = 132 + dcmFile.getMetaInfo()->getLength(
+                                      EXS_LittleEndianExplicit,
+                                      EET_ExplicitLength);
+  bool found = false;
+  for (unsigned long idx = 0; idx < dataset->card(); ++idx) {
+    DcmElement *element = dataset->getElement(idx);
+    if (element->getTag() == DCM_InConcatenationTotalNumber) {
+      found = true;
+      break;
+    }
+    elementOffset += element->calcElementLength(xfer, EET_ExplicitLength);
+  }
+  if (!found) {
+    return EC_TagNotFound;
+  }
+  const char elementHeader[8] = {0x20, 0x00, 0x62, static_cast<char>(0x91),
+                                 'U', 'S', 0x02, 0x00};
+  std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+  if (!file.is_open()) {
+    BOOST_LOG_TRIVIAL(error) << "Could not open: " << fileName;
+    return EC_InvalidStream;
+  }
+  // Element is only patched if computed offset holds its header.
+  char header[sizeof(elementHeader)];
+  file.seekg(elementOffset);
+  if (!file.read(header, sizeof(header)) ||
+      std::memcmp(header, elementHeader, sizeof(header)) != 0) {
+    BOOST_LOG_TRIVIAL(error) << "Unexpected encoding of "
+                                "InConcatenationTotalNumber in: " << fileName;
+    return EC_InvalidStream;
+  }
+  const char value[2] = {
+      static_cast<char>(concatenationTotalNumber & 0xFF),
+      static_cast<char>(concatenationTotalNumber >> 8)};
+  file.seekp(elementOffset + sizeof(elementHeader));
+  file.write(value, sizeof(value));
+  file.flush();
+  if (!file.good()) {
+    BOOST_LOG_TRIVIAL(error) << "Error writing: " << fileName;
+    return EC_InvalidStream;
+  }
+  return EC_Normal;
+}
+
 }  // namespace wsiToDicomConverter
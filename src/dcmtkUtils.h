@@ -51,6 +51,7 @@ class DcmtkUtils {
   // additionalTags - additional DICOM metadata
   // firstLevelWidthMm, firstLevelHeightMm - physical size
   // of first level
+  // instanceUid - SOPInstanceUID, generated if empty
   static OFCondition startConversion(
       int64_t imageHeight, int64_t imageWidth, uint32_t rowSize,
       absl::string_view studyId, absl::string_view seriesId,
@@ -59,7 +60,8 @@ class DcmtkUtils {
       uint32_t column, const int32_t instanceNumber, const int32_t downsample,
       int batchNumber, unsigned int offset, uint32_t totalNumberOfFrames,
       bool tiled, DcmTags* additionalTags, double firstLevelWidthMm,
-      double firstLevelHeightMm, DcmOutputStream* outStream);
+      double firstLevelHeightMm, DcmOutputStream* outStream,
+      absl::string_view instanceUid = "");
 
   // Wrapper for startConversion without additional parameters.
   static OFCondition startConversion(
@@ -82,17 +84,24 @@ class DcmtkUtils {
       const int batchNumber, const uint32_t offset,
       const uint32_t totalNumberOfFrames, const bool tiled,
       DcmTags* additionalTags, const double firstLevelWidthMm,
-      const double firstLevelHeightMm, DcmDataset* dataSet);
+      const double firstLevelHeightMm, DcmDataset* dataSet,
+      absl::string_view instanceUid = "");
+
+  // Loads DCMTK data dictionary if it is not loaded. Called before
+  // datasets are generated; resident processes call it once at startup.
+  static void loadDataDictionary();
 
   // Inserts current date/time into DCM_ContentDate/Time.
   static OFCondition generateDateTags(DcmDataset* dataSet);
 
   // Inserts which is same for pathology DICOMs.
   static OFCondition insertStaticTags(DcmDataset* dataSet, int downsample);
-  // Inserts studyId and seriesId by params and generated instanceId.
+  // Inserts studyId and seriesId by params and instanceUid, generated if
+  // empty.
   static OFCondition insertIds(absl::string_view studyId,
                                absl::string_view seriesId,
-                               DcmDataset* dataSet);
+                               DcmDataset* dataSet,
+                               absl::string_view instanceUid = "");
   // Inserts tags related to base image.
   static OFCondition insertBaseImageTags(absl::string_view imageName,
                                          const int64_t imageHeight,
@@ -107,6 +116,15 @@ class DcmtkUtils {
       const int instanceNumber, const int batchNumber, const uint32_t offset,
       const uint32_t totalNumberOfFrames, const bool tiled,
       absl::string_view seriesId, DcmDataset* dataSet);
+
+  // Rewrites InConcatenationTotalNumber of a DICOM file previously written
+  // by startConversion. Value is patched in place; file is not re-encoded.
+  // Offset of element is computed from the parsed header and checked
+  // against the element's encoding before it is written. Used when number
+  // of concatenation parts is not known until after earlier parts were
+  // written.
+  static OFCondition updateInConcatenationTotalNumber(
+      absl::string_view fileName, uint16_t concatenationTotalNumber);
 };
 }  // namespace wsiToDicomConverter
 #endif  // SRC_DCMTKUTILS_H_
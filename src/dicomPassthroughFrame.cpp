@@ -0,0 +1,113 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/dicomPassthroughFrame.h"
+
+#include <boost/log/trivial.hpp>
+#include <dcmtk/dcmdata/dcdeftag.h>
+#include <dcmtk/dcmdata/dcpxitem.h>
+
+#include <cstring>
+#include <string>
+#include <utility>
+
+#include "src/jpegUtil.h"
+
+namespace wsiToDicomConverter {
+
+DicomPassthroughFrame::DicomPassthroughFrame(
+    int64_t locationX, int64_t locationY,
+    const JpegDicomFileFrame *sourceFrame, bool storeRawBytes) :
+    Frame(locationX, locationY, sourceFrame->frameWidth(),
+          sourceFrame->frameHeight(), NONE, -1, subsample_420,
+          storeRawBytes),
+    sourceFrame_(sourceFrame),
+    photometric_(static_cast<std::string>(sourceFrame->photoMetrInt())),
+    jpegDecodeColorSpace_(sourceFrame->jpegDecodeColorSpace()) {
+}
+
+DicomPassthroughFrame::~DicomPassthroughFrame() {}
+
+absl::string_view DicomPassthroughFrame::photoMetrInt() const {
+  return photometric_;
+}
+
+void DicomPassthroughFrame::incSourceFrameReadCounter() {
+  // Frame is copied; no source frame counter to increment.
+}
+
+int64_t DicomPassthroughFrame::rawABGRFrameBytes(uint8_t *rawMemory,
+                                                 int64_t memorySize) {
+  // Retained frame is jpeg encoded.
+  // uncompress and return # of bytes read.
+  // return 0 if error occures.
+  uint64_t abgrBufferSizeRead = 0;
+  const uint64_t width = frameWidth();
+  const uint64_t height = frameHeight();
+  if (jpegUtil::decodeJpeg(width, height, jpegDecodeColorSpace_,
+                           rawCompressedBytes_.get(), rawCompressedBytesSize_,
+                           rawMemory, memorySize)) {
+    abgrBufferSizeRead = width * height * 4;
+  }
+  decReadCounter();
+  return abgrBufferSizeRead;
+}
+
+bool DicomPassthroughFrame::hasYCbCrFrameBytes() const {
+  return jpegDecodeColorSpace_ == JCS_YCbCr;
+}
+
+bool DicomPassthroughFrame::ycbcrFrameBytes(YCbCrImage *image) {
+  const bool result = jpegUtil::decodeJpegToYCbCr(jpegDecodeColorSpace_,
+                                                  rawCompressedBytes_.get(),
+                                                  rawCompressedBytesSize_,
+                                                  image);
+  decReadCounter();
+  return result;
+}
+
+void DicomPassthroughFrame::setDicomFrameBytes(
+                            std::unique_ptr<uint8_t[]> dcmdata, uint64_t size) {
+  size_ = size;
+  // Store a copy of the data for downsampling.
+  rawCompressedBytesSize_ = size;
+  rawCompressedBytes_ = std::move(dcmdata);
+  // Pointer will be handed to DCMTK when frame is written.  DCMTK will take
+  // ownership of pointer.
+  dcmPixelItem_ = std::make_unique<DcmPixelItem>(DcmTag(DCM_Item, EVR_OB));
+  dcmPixelItem_->putUint8Array(rawCompressedBytes_.get(), size_);
+  if (!storeRawBytes_) {
+    rawCompressedBytes_ = nullptr;
+  }
+}
+
+std::string DicomPassthroughFrame::derivationDescription() const {
+  // Returns frame component of DCM_DerivationDescription
+  // describes in text how frame imaging data was saved in frame.
+  return std::string("embedded as encapsulated JPEG; Imaging bytes"
+                     " unchanged.");
+}
+
+void DicomPassthroughFrame::sliceFrame() {
+  const uint64_t size = sourceFrame_->dicomFrameBytesSize();
+  std::unique_ptr<uint8_t[]> mem = std::make_unique<uint8_t[]>(size);
+  std::memcpy(mem.get(), sourceFrame_->dicomFrameMemory(), size);
+  setDicomFrameBytes(std::move(mem), size);
+  sourceFrame_ = nullptr;
+  BOOST_LOG_TRIVIAL(debug) << " DICOM extracted frame size: " << size /
+                                                                 1024 << "kb";
+  setDone();
+}
+
+}  // namespace wsiToDicomConverter
@@ -0,0 +1,65 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SRC_DICOMPASSTHROUGHFRAME_H_
+#define SRC_DICOMPASSTHROUGHFRAME_H_
+#include <absl/strings/string_view.h>
+#include <jpeglib.h>
+
+#include <memory>
+#include <string>
+
+#include "src/dcmFilePyramidSource.h"
+#include "src/frame.h"
+
+namespace wsiToDicomConverter {
+
+// DicomPassthroughFrame represents a JPEG frame copied without
+// decompression from a DICOM instance into a generated instance; avoiding
+// image uncompression & recompression artifacts. If storeRawBytes is set
+// the JPEG is retained to enable progressive downsampling from the frame.
+//
+// Source frame must remain valid until sliceFrame is called.
+class DicomPassthroughFrame : public Frame {
+ public:
+  DicomPassthroughFrame(int64_t locationX, int64_t locationY,
+                        const JpegDicomFileFrame *sourceFrame,
+                        bool storeRawBytes);
+  DicomPassthroughFrame(const DicomPassthroughFrame &frame) = delete;
+  DicomPassthroughFrame &operator =(const DicomPassthroughFrame &frame) =
+                                                                      delete;
+  virtual ~DicomPassthroughFrame();
+
+  virtual void sliceFrame();
+  virtual absl::string_view photoMetrInt() const;
+  virtual int64_t rawABGRFrameBytes(uint8_t *raw_memory, int64_t memorysize);
+  virtual bool hasYCbCrFrameBytes() const;
+  virtual bool ycbcrFrameBytes(YCbCrImage *image);
+  virtual void incSourceFrameReadCounter();
+  virtual void setDicomFrameBytes(std::unique_ptr<uint8_t[]> dcmdata,
+                                  uint64_t size);
+
+  // Returns frame component of DCM_DerivationDescription
+  // describes in text how frame imaging data was saved in frame.
+  virtual std::string derivationDescription() const;
+
+ private:
+  const JpegDicomFileFrame *sourceFrame_;
+  const std::string photometric_;
+  const J_COLOR_SPACE jpegDecodeColorSpace_;
+};
+
+}  // namespace wsiToDicomConverter
+
+#endif  // SRC_DICOMPASSTHROUGHFRAME_H_
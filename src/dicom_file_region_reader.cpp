@@ -99,6 +99,15 @@ Frame* DICOMFileFrameRegionReader::framePtr(int64_t index) {
     return nullptr;
   }
 
+Frame* DICOMFileFrameRegionReader::frame(int64_t layerX, int64_t layerY) {
+  if (dcmFiles_.size() == 0 || layerX < 0 || layerY < 0 ||
+      layerX >= imageWidth_ || layerY >= imageHeight_) {
+    return nullptr;
+  }
+  return framePtr((layerY / frameHeight_) * framesPerRow_ +
+                  (layerX / frameWidth_));
+}
+
 bool DICOMFileFrameRegionReader::frameBytes(int64_t index,
                                             uint32_t* frameMemory,
                                 const int64_t frameBufferSizeBytes) {
@@ -226,6 +235,103 @@ bool DICOMFileFrameRegionReader::frameBytes(int64_t index,
     return true;
   }
 
+  bool DICOMFileFrameRegionReader::downsampleRegionYCbCr(int64_t layerX,
+                                               int64_t layerY,
+                                               int64_t regionWidth,
+                                               int64_t regionHeight,
+                                               YCbCrImage *image) {
+    if (dicomFileCount() <= 0) {
+      return false;
+    }
+    image->clear();
+    // Level coordinate sampled by each image plane column and row.
+    // Coordinates are monotonic; samples which fall in a frame are found
+    // by binary search.
+    std::vector<int64_t> planeLevelX[3];
+    std::vector<int64_t> planeLevelY[3];
+    const double scaleX = static_cast<double>(regionWidth) /
+                          static_cast<double>(image->width());
+    const double scaleY = static_cast<double>(regionHeight) /
+                          static_cast<double>(image->height());
+    for (int plane = 0; plane < 3; ++plane) {
+      const int subsampleX = plane == 0 ? 1 : image->chromaSubsampleX();
+      const int subsampleY = plane == 0 ? 1 : image->chromaSubsampleY();
+      for (int64_t px = 0; px < image->planeWidth(plane); ++px) {
+        const int64_t offset = static_cast<int64_t>(
+                        (static_cast<double>(px) + 0.5) * subsampleX * scaleX);
+        planeLevelX[plane].push_back(layerX +
+                        std::min<int64_t>(offset, regionWidth - 1));
+      }
+      for (int64_t py = 0; py < image->planeHeight(plane); ++py) {
+        const int64_t offset = static_cast<int64_t>(
+                        (static_cast<double>(py) + 0.5) * subsampleY * scaleY);
+        planeLevelY[plane].push_back(layerY +
+                        std::min<int64_t>(offset, regionHeight - 1));
+      }
+    }
+    int64_t firstFrameX, firstFrameY, lastFrameX, lastFrameY;
+    xyFrameSpan(layerX, layerY, regionWidth, regionHeight, &firstFrameX,
+                &firstFrameY, &lastFrameX, &lastFrameY);
+    YCbCrImage frameImage;
+    for (int64_t frameYC = firstFrameY; frameYC <= lastFrameY; ++frameYC) {
+      for (int64_t frameXC = firstFrameX; frameXC <= lastFrameX; ++frameXC) {
+        if ((frameXC >= framesPerRow_) || (frameYC >= framesPerColumn_)) {
+          continue;
+        }
+        // Every frame in span is read to decrement frame read counters
+        // incremented by incSourceFrameReadCounter.
+        Frame* fptr = framePtr(frameXC + frameYC * framesPerRow_);
+        if (fptr == nullptr || !fptr->ycbcrFrameBytes(&frameImage)) {
+          return false;
+        }
+        const int64_t frameX = frameXC * frameWidth_;
+        const int64_t frameY = frameYC * frameHeight_;
+        const int64_t frameEndX = std::min<int64_t>(frameX + frameWidth_,
+                                                    imageWidth_);
+        const int64_t frameEndY = std::min<int64_t>(frameY + frameHeight_,
+                                                    imageHeight_);
+        for (int plane = 0; plane < 3; ++plane) {
+          const std::vector<int64_t> &levelX = planeLevelX[plane];
+          const std::vector<int64_t> &levelY = planeLevelY[plane];
+          const int64_t startX = std::lower_bound(levelX.begin(),
+                                         levelX.end(), frameX) - levelX.begin();
+          const int64_t endX = std::lower_bound(levelX.begin(), levelX.end(),
+                                                frameEndX) - levelX.begin();
+          const int64_t startY = std::lower_bound(levelY.begin(),
+                                         levelY.end(), frameY) - levelY.begin();
+          const int64_t endY = std::lower_bound(levelY.begin(), levelY.end(),
+                                                frameEndY) - levelY.begin();
+          if (startX >= endX || startY >= endY) {
+            continue;
+          }
+          const int sourceSubsampleX = plane == 0 ? 1 :
+                                       frameImage.chromaSubsampleX();
+          const int sourceSubsampleY = plane == 0 ? 1 :
+                                       frameImage.chromaSubsampleY();
+          const int64_t sourceWidth = frameImage.planeWidth(plane);
+          const int64_t sourceHeight = frameImage.planeHeight(plane);
+          const uint8_t *source = frameImage.plane(plane);
+          const int64_t destWidth = image->planeWidth(plane);
+          uint8_t *dest = image->plane(plane);
+          for (int64_t py = startY; py < endY; ++py) {
+            const int64_t sy = std::min<int64_t>(
+                        (levelY[py] - frameY) / sourceSubsampleY,
+                        sourceHeight - 1);
+            const uint8_t *sourceRow = source + sy * sourceWidth;
+            uint8_t *destRow = dest + py * destWidth;
+            for (int64_t px = startX; px < endX; ++px) {
+              const int64_t sx = std::min<int64_t>(
+                        (levelX[px] - frameX) / sourceSubsampleX,
+                        sourceWidth - 1);
+              destRow[px] = sourceRow[sx];
+            }
+          }
+        }
+      }
+    }
+    return true;
+  }
+
   bool DICOMFileFrameRegionReader::readRegion(int64_t layerX,
                                               int64_t layerY,
                                               int64_t memWidth,
@@ -20,6 +20,7 @@
 
 #include "src/abstractDcmFile.h"
 #include "src/tiffFile.h"
+#include "src/ycbcrImage.h"
 
 namespace wsiToDicomConverter {
 
@@ -79,6 +80,28 @@ class DICOMFileFrameRegionReader {
   bool incSourceFrameReadCounter(int64_t layerX, int64_t layerY,
                                  int64_t memWidth, int64_t memHeight);
 
+  // Nearest neighbor downsamples a sub region of the frames into image
+  // without converting frames to RGB. Each plane of image is sampled from
+  // the same plane of the frames. Region is scaled to the dimensions of
+  // image; planes are sampled at the center of each image sample.
+  // Image samples outside image dim. are black.
+  //
+  // Args:
+  //   layerX : upper left X coordinate in image coordinates.
+  //   layerY : upper left Y coordinate in image coordinates.
+  //   regionWidth : Width of region to downsample.
+  //   regionHeight : Height of region to downsample.
+  //   image : Allocated image to downsample into.
+  //
+  // Returns: False if no DICOM files set or a frame could not be read as
+  //          YCbCr.
+  bool downsampleRegionYCbCr(int64_t layerX, int64_t layerY,
+                             int64_t regionWidth, int64_t regionHeight,
+                             YCbCrImage *image);
+
+  // Returns frame containing image coordinate, nullptr if outside image.
+  Frame* frame(int64_t layerX, int64_t layerY);
+
  private:
   // Reads a frame from as set of loaded DICOM files.
   //
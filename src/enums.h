@@ -41,4 +41,25 @@ inline DCM_Compression dcmCompressionFromString(std::string compressionStr) {
   return compression;
 }
 
+// Order frames of a level are dispatched to workers.
+typedef enum { UNKNOWN_ORDER = -1,
+               RASTER_ORDER = 0,
+               MORTON_ORDER = 1,
+               HILBERT_ORDER = 2 } FrameOrder;
+
+inline FrameOrder frameOrderFromString(std::string orderStr) {
+  std::transform(orderStr.begin(), orderStr.end(), orderStr.begin(),
+                 ::tolower);
+  if (orderStr.compare("raster") == 0) {
+    return RASTER_ORDER;
+  }
+  if (orderStr.compare("morton") == 0) {
+    return MORTON_ORDER;
+  }
+  if (orderStr.compare("hilbert") == 0) {
+    return HILBERT_ORDER;
+  }
+  return UNKNOWN_ORDER;
+}
+
 #endif  // SRC_ENUMS_H_
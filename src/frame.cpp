@@ -73,10 +73,27 @@ void Frame::incReadCounter() {
     readCounter_ += 1;
 }
 
+void Frame::readFrameSource() {}
+
 bool Frame::isDone() const {
     return done_;
 }
 
+void Frame::waitDone() {
+  boost::unique_lock<boost::mutex> lock(doneMutex_);
+  while (!done_) {
+    doneCondition_.wait(lock);
+  }
+}
+
+void Frame::setDone() {
+  {
+    boost::lock_guard<boost::mutex> lock(doneMutex_);
+    done_ = true;
+  }
+  doneCondition_.notify_all();
+}
+
 void Frame::clearDicomMem() {
   data_ = nullptr;
 }
@@ -148,6 +165,14 @@ std::string Frame::derivationDescription() const {
 
 size_t Frame::dicomFrameBytesSize() const { return size_; }
 
+bool Frame::hasYCbCrFrameBytes() const {
+  return false;
+}
+
+bool Frame::ycbcrFrameBytes(YCbCrImage *image) {
+  return false;
+}
+
 bool Frame::hasRawABGRFrameBytes() const {
   return (rawCompressedBytes_ != nullptr && rawCompressedBytesSize_ > 0);
 }
@@ -15,6 +15,7 @@
 #ifndef SRC_FRAME_H_
 #define SRC_FRAME_H_
 #include <absl/strings/string_view.h>
+#include <boost/thread/condition_variable.hpp>
 #include <boost/thread/mutex.hpp>
 #include <dcmtk/dcmdata/dcpxitem.h>
 
@@ -24,6 +25,7 @@
 #include "src/enums.h"
 #include "src/compressor.h"
 #include "src/jpegCompression.h"
+#include "src/ycbcrImage.h"
 
 namespace wsiToDicomConverter {
 
@@ -37,7 +39,13 @@ class Frame {
 
   // Gets frame by openslide library, performs scaling it and compressing
   virtual void sliceFrame() = 0;
+  // Reads frame's source pixels ahead of sliceFrame so that reading and
+  // compressing frames can run on separate workers. Frames which do not
+  // separate the stages read their source in sliceFrame.
+  virtual void readFrameSource();
   virtual bool isDone() const;
+  // Blocks until frame is done.
+  virtual void waitDone();
   virtual uint8_t *dicomFrameBytes();
   virtual size_t dicomFrameBytesSize() const;
   virtual void incReadCounter();
@@ -48,6 +56,14 @@ class Frame {
   virtual void clearDicomMem();
   virtual void clearRawABGRMem();
   virtual bool hasRawABGRFrameBytes() const;
+
+  // True if frame pixels can be read as planar YCbCr by ycbcrFrameBytes.
+  virtual bool hasYCbCrFrameBytes() const;
+
+  // Reads frame pixels as planar YCbCr; image is resized to frame.
+  // Decrements read counter as rawABGRFrameBytes does. Returns false if
+  // frame could not be read.
+  virtual bool ycbcrFrameBytes(YCbCrImage *image);
   virtual void incSourceFrameReadCounter() = 0;
   virtual int64_t locationX() const;
   virtual int64_t locationY() const;
@@ -69,7 +85,12 @@ class Frame {
   virtual std::string derivationDescription() const;
 
  protected:
+  // Marks frame done and wakes threads blocked in waitDone.
+  void setDone();
+
   bool done_ = false;
+  boost::mutex doneMutex_;
+  boost::condition_variable doneCondition_;
 
   // data to be written to dicom file
   std::unique_ptr<uint8_t[]> data_;  // raw compression
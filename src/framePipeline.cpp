@@ -0,0 +1,156 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/framePipeline.h"
+
+#include <absl/strings/str_format.h>
+#include <boost/asio/post.hpp>
+#include <boost/thread/lock_guard.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <utility>
+
+namespace wsiToDicomConverter {
+
+static double secondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                       start).count();
+}
+
+FramePipeline::Stage::Stage(size_t threads) :
+                                        workers_(std::max<size_t>(threads, 1)),
+                                        queued_(0) {}
+
+void FramePipeline::Stage::post(std::function<void()> task) {
+  {
+    boost::lock_guard<boost::mutex> lock(mutex_);
+    queued_ += 1;
+    stats_.maxQueueDepth = std::max(stats_.maxQueueDepth, queued_);
+  }
+  boost::asio::post(workers_, [this, task = std::move(task)]() {
+    {
+      boost::lock_guard<boost::mutex> lock(mutex_);
+      queued_ -= 1;
+    }
+    const std::chrono::steady_clock::time_point start =
+                                              std::chrono::steady_clock::now();
+    task();
+    const double busy = secondsSince(start);
+    boost::lock_guard<boost::mutex> lock(mutex_);
+    stats_.tasks += 1;
+    stats_.busySeconds += busy;
+  });
+}
+
+void FramePipeline::Stage::join() {
+  workers_.join();
+}
+
+void FramePipeline::Stage::addBlockedTime(double seconds) {
+  boost::lock_guard<boost::mutex> lock(mutex_);
+  stats_.blockedSeconds += seconds;
+}
+
+FramePipelineStageStats FramePipeline::Stage::stats() const {
+  boost::lock_guard<boost::mutex> lock(mutex_);
+  return stats_;
+}
+
+FramePipeline::FramePipeline(size_t readThreads, size_t sliceThreads,
+                             size_t writeThreads, size_t queueDepth) :
+                               queueDepth_(std::max<size_t>(queueDepth, 1)),
+                               sliceQueued_(0) {
+  read_ = std::make_unique<Stage>(readThreads);
+  slice_ = std::make_unique<Stage>(sliceThreads);
+  write_ = std::make_unique<Stage>(writeThreads);
+}
+
+FramePipeline::~FramePipeline() {
+  join();
+}
+
+void FramePipeline::addFrame(Frame *frame, std::function<void()> sliced) {
+  read_->post([this, frame, sliced = std::move(sliced)]() {
+    const std::chrono::steady_clock::time_point start =
+                                              std::chrono::steady_clock::now();
+    acquireSliceSlot();
+    read_->addBlockedTime(secondsSince(start));
+    frame->readFrameSource();
+    slice_->post([this, frame, sliced]() {
+      frame->sliceFrame();
+      releaseSliceSlot();
+      if (sliced) {
+        sliced();
+      }
+    });
+  });
+}
+
+void FramePipeline::addWrite(std::function<void()> write) {
+  write_->post(std::move(write));
+}
+
+void FramePipeline::join() {
+  // Stages are joined in order; a stage receives no tasks after the stage
+  // before it is joined.
+  read_->join();
+  slice_->join();
+  write_->join();
+}
+
+void FramePipeline::acquireSliceSlot() {
+  boost::unique_lock<boost::mutex> lock(sliceQueueMutex_);
+  while (sliceQueued_ >= queueDepth_) {
+    sliceSlotReleased_.wait(lock);
+  }
+  sliceQueued_ += 1;
+}
+
+void FramePipeline::releaseSliceSlot() {
+  {
+    boost::lock_guard<boost::mutex> lock(sliceQueueMutex_);
+    sliceQueued_ -= 1;
+  }
+  sliceSlotReleased_.notify_one();
+}
+
+FramePipelineStageStats FramePipeline::readStats() const {
+  return read_->stats();
+}
+
+FramePipelineStageStats FramePipeline::sliceStats() const {
+  return slice_->stats();
+}
+
+FramePipelineStageStats FramePipeline::writeStats() const {
+  return write_->stats();
+}
+
+std::string FramePipeline::statsString() const {
+  std::string result;
+  const char *names[] = {"read", "slice", "write"};
+  const FramePipelineStageStats stats[] = {readStats(), sliceStats(),
+                                           writeStats()};
+  for (int idx = 0; idx < 3; ++idx) {
+    result += absl::StrFormat(
+        "%s%s: tasks %d, max queue depth %d, busy %.2fs, blocked %.2fs",
+        idx == 0 ? "" : "; ", names[idx], stats[idx].tasks,
+        stats[idx].maxQueueDepth, stats[idx].busySeconds,
+        stats[idx].blockedSeconds);
+  }
+  return result;
+}
+
+}  // namespace wsiToDicomConverter
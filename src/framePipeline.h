@@ -0,0 +1,106 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SRC_FRAMEPIPELINE_H_
+#define SRC_FRAMEPIPELINE_H_
+
+#include <boost/asio/thread_pool.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "src/frame.h"
+
+namespace wsiToDicomConverter {
+
+struct FramePipelineStageStats {
+  // Tasks run by stage.
+  int64_t tasks = 0;
+  // Largest number of tasks waiting for a stage worker.
+  int64_t maxQueueDepth = 0;
+  // Time stage workers spent running tasks.
+  double busySeconds = 0.0;
+  // Time stage workers spent blocked waiting for the next stage's queue.
+  double blockedSeconds = 0.0;
+};
+
+/* Runs frames through separate worker groups for each stage.
+
+   read  - frame's source pixels are read and decoded, Frame::readFrameSource
+   slice - frame is resampled and compressed, Frame::sliceFrame
+   write - DICOM files are written
+
+   Readers block when queueDepth frames are waiting to be sliced, so
+   frames read ahead of slicing are bounded. Per stage statistics show
+   which stage limits throughput: a stage whose queue stays deep, or
+   whose upstream stage is blocked on it, is the bottleneck.
+*/
+class FramePipeline {
+ public:
+  FramePipeline(size_t readThreads, size_t sliceThreads, size_t writeThreads,
+                size_t queueDepth);
+  FramePipeline(const FramePipeline &) = delete;
+  FramePipeline &operator =(const FramePipeline &) = delete;
+  virtual ~FramePipeline();
+
+  // Reads and then slices frame. sliced, if set, runs on the slice worker
+  // after frame is sliced.
+  void addFrame(Frame *frame, std::function<void()> sliced = nullptr);
+  // Runs write on a write stage worker.
+  void addWrite(std::function<void()> write);
+
+  // Waits for all stages to finish.
+  void join();
+
+  FramePipelineStageStats readStats() const;
+  FramePipelineStageStats sliceStats() const;
+  FramePipelineStageStats writeStats() const;
+  // Stage statistics formatted for logging.
+  std::string statsString() const;
+
+ private:
+  class Stage {
+   public:
+    explicit Stage(size_t threads);
+    void post(std::function<void()> task);
+    void join();
+    void addBlockedTime(double seconds);
+    FramePipelineStageStats stats() const;
+
+   private:
+    boost::asio::thread_pool workers_;
+    mutable boost::mutex mutex_;
+    int64_t queued_;
+    FramePipelineStageStats stats_;
+  };
+
+  // Blocks until a slot in the slice queue is free.
+  void acquireSliceSlot();
+  void releaseSliceSlot();
+
+  const size_t queueDepth_;
+  size_t sliceQueued_;
+  boost::mutex sliceQueueMutex_;
+  boost::condition_variable sliceSlotReleased_;
+  std::unique_ptr<Stage> read_;
+  std::unique_ptr<Stage> slice_;
+  std::unique_ptr<Stage> write_;
+};
+
+}  // namespace wsiToDicomConverter
+
+#endif  // SRC_FRAMEPIPELINE_H_
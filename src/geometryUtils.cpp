@@ -13,6 +13,7 @@
 #include <stdlib.h>
 
 #include <algorithm>
+#include <utility>
 
 #include "src/geometryUtils.h"
 
@@ -35,4 +36,63 @@ void dimensionDownsampling(
                                                    *downsampledLevelHeight);
 }
 
+// Interleaves bits of x and y; x in even bits.
+static uint64_t mortonIndex(uint64_t x, uint64_t y) {
+  uint64_t index = 0;
+  for (int bit = 0; bit < 32; ++bit) {
+    index |= ((x >> bit) & 1) << (2 * bit);
+    index |= ((y >> bit) & 1) << (2 * bit + 1);
+  }
+  return index;
+}
+
+// Distance of x, y along Hilbert curve filling n x n grid; n is a power
+// of two.
+static uint64_t hilbertIndex(uint64_t n, uint64_t x, uint64_t y) {
+  uint64_t index = 0;
+  for (uint64_t s = n / 2; s > 0; s /= 2) {
+    const uint64_t rx = (x & s) > 0 ? 1 : 0;
+    const uint64_t ry = (y & s) > 0 ? 1 : 0;
+    index += s * s * ((3 * rx) ^ ry);
+    // Rotate quadrant.
+    if (ry == 0) {
+      if (rx == 1) {
+        x = n - 1 - x;
+        y = n - 1 - y;
+      }
+      std::swap(x, y);
+    }
+  }
+  return index;
+}
+
+std::vector<int64_t> frameDispatchOrder(int64_t framesPerRow,
+                                        int64_t framesPerColumn,
+                                        FrameOrder order) {
+  const int64_t frameCount = framesPerRow * framesPerColumn;
+  std::vector<int64_t> frames(frameCount);
+  for (int64_t idx = 0; idx < frameCount; ++idx) {
+    frames[idx] = idx;
+  }
+  if (order != MORTON_ORDER && order != HILBERT_ORDER) {
+    return frames;
+  }
+  uint64_t gridSize = 1;
+  while (gridSize < static_cast<uint64_t>(std::max(framesPerRow,
+                                                   framesPerColumn))) {
+    gridSize *= 2;
+  }
+  std::vector<uint64_t> curveIndex(frameCount);
+  for (int64_t idx = 0; idx < frameCount; ++idx) {
+    const uint64_t x = idx % framesPerRow;
+    const uint64_t y = idx / framesPerRow;
+    curveIndex[idx] = order == MORTON_ORDER ? mortonIndex(x, y) :
+                                              hilbertIndex(gridSize, x, y);
+  }
+  std::sort(frames.begin(), frames.end(), [&](int64_t a, int64_t b) {
+    return curveIndex[a] < curveIndex[b];
+  });
+  return frames;
+}
+
 }  // namespace wsiToDicomConverter
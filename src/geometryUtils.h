@@ -15,6 +15,7 @@
 #ifndef SRC_GEOMETRYUTILS_H_
 #define SRC_GEOMETRYUTILS_H_
 #include <cstdint>
+#include <vector>
 
 #include "src/enums.h"
 
@@ -26,5 +27,12 @@ void dimensionDownsampling(
     int64_t *downsampledLevelWidth, int64_t *downsampledLevelHeight,
     int64_t *downsampledLevelFrameWidth, int64_t *downsampledLevelFrameHeight);
 
+// Returns raster indexes of the frames of a level in the order frames are
+// dispatched. Morton and Hilbert orders visit frames along a space filling
+// curve so that frames processed together lie close together.
+std::vector<int64_t> frameDispatchOrder(int64_t framesPerRow,
+                                        int64_t framesPerColumn,
+                                        FrameOrder order);
+
 }  // namespace wsiToDicomConverter
 #endif  // SRC_GEOMETRYUTILS_H_
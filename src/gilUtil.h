@@ -0,0 +1,43 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SRC_GILUTIL_H_
+#define SRC_GILUTIL_H_
+
+#include <boost/gil/typedefs.hpp>
+
+namespace wsiToDicomConverter {
+
+// Converts openslide ARGB words, read as B, G, R, A bytes, to RGB pixels
+// premultiplied by alpha.
+class convert_rgba_to_rgb {
+ public:
+  void operator()(
+      const boost::gil::rgba8c_pixel_t &src,
+      boost::gil::rgb8_pixel_t &dst) const {  // NOLINT, boost template
+    boost::gil::get_color(dst, boost::gil::blue_t()) =
+        boost::gil::channel_multiply(get_color(src, boost::gil::red_t()),
+                                     get_color(src, boost::gil::alpha_t()));
+    boost::gil::get_color(dst, boost::gil::green_t()) =
+        boost::gil::channel_multiply(get_color(src, boost::gil::green_t()),
+                                     get_color(src, boost::gil::alpha_t()));
+    boost::gil::get_color(dst, boost::gil::red_t()) =
+        boost::gil::channel_multiply(get_color(src, boost::gil::blue_t()),
+                                     get_color(src, boost::gil::alpha_t()));
+  }
+};
+
+}  // namespace wsiToDicomConverter
+
+#endif  // SRC_GILUTIL_H_
@@ -13,6 +13,7 @@
 // limitations under the License.
 #include "src/imageFilePyramidSource.h"
 #include <boost/log/trivial.hpp>
+#include <boost/thread/lock_guard.hpp>
 #include <opencv2/opencv.hpp>
 #include <algorithm>
 #include <string>
@@ -30,6 +31,14 @@ ImageFileFrame::ImageFileFrame(int64_t locationX,
 
 int64_t ImageFileFrame::rawABGRFrameBytes(uint8_t *rawMemory,
                                           int64_t memorySize) {
+  if (pyramidSource_->isStreamed()) {
+    if (!pyramidSource_->readStreamedFrame(locationX(), locationY(),
+                                           rawMemory)) {
+      return 0;
+    }
+    decReadCounter();
+    return memorySize;
+  }
   const uint64_t locX = locationX();
   const uint64_t locY = locationY();
   const uint64_t fWidth = frameWidth();
@@ -54,6 +63,19 @@ int64_t ImageFileFrame::rawABGRFrameBytes(uint8_t *rawMemory,
   return memorySize;
 }
 
+void ImageFileFrame::decReadCounter() {
+  {
+    boost::lock_guard<boost::mutex> guard(readCounterMutex_);
+    readCounter_ -= 1;
+    if (readCounter_ != 0) {
+      return;
+    }
+  }
+  if (pyramidSource_->isStreamed()) {
+    pyramidSource_->releaseStreamedFrame(locationY());
+  }
+}
+
 void ImageFileFrame::debugLog() const {
   BOOST_LOG_TRIVIAL(info) << "Image File Frame: ";
 }
@@ -69,33 +91,43 @@ ImageFilePyramidSource::ImageFilePyramidSource(absl::string_view filePath,
                                                uint64_t frameWidth,
                                                uint64_t frameHeight,
                                                double HeightMm) :
-                              BaseFilePyramidSource<ImageFileFrame>(filePath) {
+                              BaseFilePyramidSource<ImageFileFrame>(filePath),
+                              nextBand_(0) {
   frameWidth_ = frameWidth;
   frameHeight_ = frameHeight;
   std::string filename = std::move(static_cast<std::string>(filePath));
-  wholeimage_ = cv::imread(filename.c_str(), cv::IMREAD_COLOR);
-  if (wholeimage_.depth() != CV_8U) {
-    BOOST_LOG_TRIVIAL(error) << "Cannot build DICOM Pyramid from image: " <<
-                                filename <<
-                                ". Image does not have unsigned 8-bit "
-                                "channels.";
-    return;
+  stripReader_ = StripImageReader::open(filename);
+  if (stripReader_ != nullptr) {
+    BOOST_LOG_TRIVIAL(debug) << "Streaming image decode: " << filename;
+    imageWidth_ = stripReader_->width();
+    imageHeight_ = stripReader_->height();
+  } else {
+    wholeimage_ = cv::imread(filename.c_str(), cv::IMREAD_COLOR);
+    if (wholeimage_.depth() != CV_8U) {
+      BOOST_LOG_TRIVIAL(error) << "Cannot build DICOM Pyramid from image: " <<
+                                  filename <<
+                                  ". Image does not have unsigned 8-bit "
+                                  "channels.";
+      return;
+    }
+    imageWidth_ = wholeimage_.cols;
+    imageHeight_ = wholeimage_.rows;
   }
-  imageWidth_ = wholeimage_.cols;
-  imageHeight_ = wholeimage_.rows;
   firstLevelHeightMm_ = HeightMm;
   firstLevelWidthMm_ = (HeightMm * static_cast<double>(imageWidth_)) /
          static_cast<double>(imageHeight_);
   int64_t locationX = 0;
   int64_t locationY = 0;
-  uint64_t frameCount =
+  const uint64_t framesPerRow =
                 static_cast<uint64_t>(ceil(static_cast<double>(imageWidth_) /
-                                           static_cast<double>(frameWidth_))) *
+                                           static_cast<double>(frameWidth_)));
+  const uint64_t framesPerColumn =
                 static_cast<uint64_t>(ceil(static_cast<double>(imageHeight_) /
                                            static_cast<double>(frameHeight_)));
+  const uint64_t frameCount = framesPerRow * framesPerColumn;
   framesData_.reserve(frameCount);
   for (size_t idx = 0; idx < frameCount; ++idx) {
-    if (locationX > imageWidth_) {
+    if (locationX >= imageWidth_) {
       locationX = 0;
       locationY += frameHeight_;
     }
@@ -104,12 +136,116 @@ ImageFilePyramidSource::ImageFilePyramidSource(absl::string_view filePath,
                                                            this));
     locationX += frameWidth_;
   }
+  if (stripReader_ != nullptr) {
+    bandPendingFrames_.assign(framesPerColumn, framesPerRow);
+  }
 }
 
 cv::Mat *ImageFilePyramidSource::image() {
   return &wholeimage_;
 }
 
+bool ImageFilePyramidSource::isStreamed() const {
+  return !bandPendingFrames_.empty();
+}
+
+std::shared_ptr<const std::vector<uint8_t>> ImageFilePyramidSource::band(
+                                                           int64_t bandIndex) {
+  {
+    boost::lock_guard<boost::mutex> guard(bandMutex_);
+    auto decoded = bands_.find(bandIndex);
+    if (decoded != bands_.end()) {
+      return decoded->second;
+    }
+  }
+  boost::lock_guard<boost::mutex> decodeGuard(decodeMutex_);
+  if (bandIndex < nextBand_) {
+    {
+      // Band decoded by another thread while waiting.
+      boost::lock_guard<boost::mutex> guard(bandMutex_);
+      auto decoded = bands_.find(bandIndex);
+      if (decoded != bands_.end()) {
+        return decoded->second;
+      }
+    }
+    // Band was read after being released; decode image again from the top.
+    BOOST_LOG_TRIVIAL(warning) << "Decoding released image rows again: " <<
+                                  bandIndex * frameHeight_;
+    stripReader_ = StripImageReader::open(filename_);
+    nextBand_ = 0;
+    if (stripReader_ == nullptr) {
+      return nullptr;
+    }
+  }
+  std::shared_ptr<std::vector<uint8_t>> rows;
+  while (nextBand_ <= bandIndex) {
+    const int64_t rowCount = std::min(frameHeight_,
+                                      imageHeight_ - nextBand_ * frameHeight_);
+    rows = std::make_shared<std::vector<uint8_t>>(rowCount * imageWidth_ * 3);
+    if (!stripReader_->readRows(rowCount, rows->data())) {
+      BOOST_LOG_TRIVIAL(error) << "Error decoding image: " << filename_;
+      return nullptr;
+    }
+    boost::lock_guard<boost::mutex> guard(bandMutex_);
+    // Released bands decoded again to reach bandIndex are not kept.
+    if (bandPendingFrames_[nextBand_] > 0) {
+      bands_[nextBand_] = rows;
+    }
+    ++nextBand_;
+  }
+  return rows;
+}
+
+bool ImageFilePyramidSource::readStreamedFrame(int64_t locationX,
+                                               int64_t locationY,
+                                               uint8_t *rawMemory) {
+  std::shared_ptr<const std::vector<uint8_t>> rows =
+                                               band(locationY / frameHeight_);
+  if (rows == nullptr) {
+    return false;
+  }
+  const int64_t width = std::min(frameWidth_, imageWidth_ - locationX);
+  const int64_t height = std::min(frameHeight_, imageHeight_ - locationY);
+  uint8_t *dest = rawMemory;
+  for (int64_t y = 0; y < frameHeight_; ++y) {
+    int64_t x = 0;
+    if (y < height) {
+      const uint8_t *source = rows->data() + (y * imageWidth_ + locationX) * 3;
+      for (; x < width; ++x) {
+        dest[0] = source[0];
+        dest[1] = source[1];
+        dest[2] = source[2];
+        dest[3] = 0xFF;
+        dest += 4;
+        source += 3;
+      }
+    }
+    // Padding matches cv::copyMakeBorder black border converted to RGBA.
+    for (; x < frameWidth_; ++x) {
+      dest[0] = 0;
+      dest[1] = 0;
+      dest[2] = 0;
+      dest[3] = 0xFF;
+      dest += 4;
+    }
+  }
+  return true;
+}
+
+void ImageFilePyramidSource::releaseStreamedFrame(int64_t locationY) {
+  const int64_t bandIndex = locationY / frameHeight_;
+  boost::lock_guard<boost::mutex> guard(bandMutex_);
+  bandPendingFrames_[bandIndex] -= 1;
+  if (bandPendingFrames_[bandIndex] == 0) {
+    bands_.erase(bandIndex);
+  }
+}
+
+size_t ImageFilePyramidSource::decodedBandCount() {
+  boost::lock_guard<boost::mutex> guard(bandMutex_);
+  return bands_.size();
+}
+
 void ImageFilePyramidSource::debugLog() const {
   BOOST_LOG_TRIVIAL(info) << "Image Dim: " << imageWidth() << ", " <<
                              imageHeight() <<  "\n" << "Dim mm: " <<
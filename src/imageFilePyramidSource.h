@@ -17,11 +17,14 @@
 
 #include <absl/strings/string_view.h>
 #include <jpeglib.h>
+#include <boost/thread/mutex.hpp>
 #include <opencv2/opencv.hpp>
+#include <map>
 #include <string>
 #include <memory>
 #include <vector>
 #include "src/baseFilePyramidSource.h"
+#include "src/stripImageReader.h"
 
 namespace wsiToDicomConverter {
 
@@ -38,9 +41,19 @@ class ImageFileFrame : public BaseFileFrame<ImageFilePyramidSource> {
   // describes in text how frame imaging data was saved in frame.
   virtual std::string derivationDescription() const;
   virtual int64_t rawABGRFrameBytes(uint8_t *rawMemory, int64_t memorySize);
+  // Releases frame's band of decoded rows when last read is done.
+  virtual void decReadCounter();
 };
 
-// Represents single DICOM file with metadata
+/* Untiled image read as a pyramid level.
+
+   Images StripImageReader can decode are streamed; rows are decoded in
+   bands of frame height rows as frames are read and a band is freed after
+   every frame in it has been read as many times as its read counter was
+   incremented, e.g. by the first downsampled level. Memory is proportional
+   to image width * frame height * bands being read. Other images are
+   decoded whole with cv::imread.
+*/
 class ImageFilePyramidSource : public BaseFilePyramidSource<ImageFileFrame> {
  public:
   explicit ImageFilePyramidSource(absl::string_view filePath,
@@ -49,8 +62,29 @@ class ImageFilePyramidSource : public BaseFilePyramidSource<ImageFileFrame> {
   virtual void debugLog() const;
   cv::Mat *image();
 
+  // True if image is decoded a band of rows at a time.
+  bool isStreamed() const;
+  // Copies frame at location from streamed image into rawMemory as RGBA.
+  // Pixels outside image are black. Returns false if band decode failed.
+  bool readStreamedFrame(int64_t locationX, int64_t locationY,
+                         uint8_t *rawMemory);
+  // Called when all reads of frame at locationY are done.
+  void releaseStreamedFrame(int64_t locationY);
+  // Number of decoded bands held in memory.
+  size_t decodedBandCount();
+
  private:
+  std::shared_ptr<const std::vector<uint8_t>> band(int64_t bandIndex);
+
   cv::Mat wholeimage_;
+  std::unique_ptr<StripImageReader> stripReader_;
+  // Bands are decoded in order under decodeMutex_.
+  boost::mutex decodeMutex_;
+  int64_t nextBand_;
+  // Guards bands_ and bandPendingFrames_.
+  boost::mutex bandMutex_;
+  std::map<int64_t, std::shared_ptr<const std::vector<uint8_t>>> bands_;
+  std::vector<int64_t> bandPendingFrames_;
 };
 
 }  // namespace wsiToDicomConverter
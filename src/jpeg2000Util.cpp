@@ -0,0 +1,188 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "src/jpeg2000Util.h"
+
+#include <boost/log/trivial.hpp>
+#include <openjpeg.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+#include "src/ycbcrImage.h"
+
+namespace jpeg2000Util {
+
+namespace {
+
+std::atomic<int32_t> openJpegDecodeThreads(1);
+
+// Compressed image in memory read by OpenJPEG stream callbacks.
+struct MemoryStream {
+  const uint8_t *data;
+  uint64_t size;
+  uint64_t offset;
+};
+
+OPJ_SIZE_T readMemoryStream(void *buffer, OPJ_SIZE_T bytes, void *userData) {
+  MemoryStream *stream = reinterpret_cast<MemoryStream *>(userData);
+  if (stream->offset >= stream->size) {
+    // End of stream.
+    return static_cast<OPJ_SIZE_T>(-1);
+  }
+  const uint64_t count = std::min<uint64_t>(bytes,
+                                            stream->size - stream->offset);
+  std::memcpy(buffer, stream->data + stream->offset, count);
+  stream->offset += count;
+  return count;
+}
+
+OPJ_OFF_T skipMemoryStream(OPJ_OFF_T bytes, void *userData) {
+  MemoryStream *stream = reinterpret_cast<MemoryStream *>(userData);
+  const int64_t offset = std::min<int64_t>(
+      std::max<int64_t>(static_cast<int64_t>(stream->offset) + bytes, 0),
+      stream->size);
+  const OPJ_OFF_T skipped = offset - static_cast<int64_t>(stream->offset);
+  stream->offset = offset;
+  return skipped;
+}
+
+OPJ_BOOL seekMemoryStream(OPJ_OFF_T offset, void *userData) {
+  MemoryStream *stream = reinterpret_cast<MemoryStream *>(userData);
+  if (offset < 0 || static_cast<uint64_t>(offset) > stream->size) {
+    return OPJ_FALSE;
+  }
+  stream->offset = offset;
+  return OPJ_TRUE;
+}
+
+void openJpegError(const char *msg, void *clientData) {
+  BOOST_LOG_TRIVIAL(debug) << "JPEG 2000 Error: " << msg;
+}
+
+// Codestreams start with SOC and SIZ markers; otherwise JP2 file format.
+OPJ_CODEC_FORMAT codecFormat(const uint8_t *rawBuffer,
+                             const uint64_t rawBufferSize) {
+  if (rawBufferSize >= 4 && rawBuffer[0] == 0xFF && rawBuffer[1] == 0x4F &&
+      rawBuffer[2] == 0xFF && rawBuffer[3] == 0x51) {
+    return OPJ_CODEC_J2K;
+  }
+  return OPJ_CODEC_JP2;
+}
+
+// Returns component value of pixel as 8 bit unsigned value. Components may
+// be subsampled (e.g. 4:2:2 chroma).
+inline int32_t componentValue(const opj_image_comp_t &comp, int64_t x,
+                              int64_t y) {
+  const int64_t compX = std::min<int64_t>(x / comp.dx, comp.w - 1);
+  const int64_t compY = std::min<int64_t>(y / comp.dy, comp.h - 1);
+  int32_t value = comp.data[compY * comp.w + compX];
+  if (comp.sgnd) {
+    value += 1 << (comp.prec - 1);
+  }
+  if (comp.prec > 8) {
+    value >>= comp.prec - 8;
+  } else if (comp.prec < 8) {
+    value <<= 8 - comp.prec;
+  }
+  return value;
+}
+
+inline uint8_t clampByte(int32_t value) {
+  return static_cast<uint8_t>(std::min<int32_t>(std::max<int32_t>(value, 0),
+                                                255));
+}
+
+}  // namespace
+
+void setDecodeThreads(const int32_t threads) {
+  openJpegDecodeThreads = std::max<int32_t>(threads, 1);
+}
+
+int32_t decodeThreads() {
+  return openJpegDecodeThreads;
+}
+
+bool decodeJpeg2000(const int64_t width,
+                    const int64_t height,
+                    const bool ycbcr,
+                    const int32_t reduce,
+                    const uint8_t* rawBuffer,
+                    const uint64_t rawBufferSize,
+                    uint8_t *returnMemoryBuffer,
+                    const int64_t returnMemoryBufferSize) {
+  if (returnMemoryBufferSize < 4 * width * height) {
+    // size of memory buffer passed in is to small
+    BOOST_LOG_TRIVIAL(error) <<  "Error insufficent memory hold "
+                                 "decoded image.";
+    return false;
+  }
+  opj_codec_t *codec = opj_create_decompress(codecFormat(rawBuffer,
+                                                         rawBufferSize));
+  opj_set_error_handler(codec, openJpegError, nullptr);
+  opj_dparameters_t parameters;
+  opj_set_default_decoder_parameters(&parameters);
+  parameters.cp_reduce = reduce;
+  opj_setup_decoder(codec, &parameters);
+  const int32_t threads = openJpegDecodeThreads;
+  if (threads > 1 && !opj_codec_set_threads(codec, threads)) {
+    BOOST_LOG_TRIVIAL(debug) << "OpenJPEG built without thread support.";
+  }
+
+  MemoryStream memoryStream = {rawBuffer, rawBufferSize, 0};
+  opj_stream_t *stream = opj_stream_create(OPJ_J2K_STREAM_CHUNK_SIZE,
+                                           OPJ_TRUE);
+  opj_stream_set_user_data(stream, &memoryStream, nullptr);
+  opj_stream_set_user_data_length(stream, rawBufferSize);
+  opj_stream_set_read_function(stream, readMemoryStream);
+  opj_stream_set_skip_function(stream, skipMemoryStream);
+  opj_stream_set_seek_function(stream, seekMemoryStream);
+
+  opj_image_t *image = nullptr;
+  bool result = opj_read_header(stream, codec, &image) &&
+                opj_decode(codec, stream, image) &&
+                opj_end_decompress(codec, stream);
+  opj_stream_destroy(stream);
+  opj_destroy_codec(codec);
+  if (!result || image == nullptr || image->numcomps < 3 ||
+      image->comps[0].w != width || image->comps[0].h != height) {
+    BOOST_LOG_TRIVIAL(error) <<  "Error occured decompressing JPEG 2000.";
+    if (image != nullptr) {
+      opj_image_destroy(image);
+    }
+    return false;
+  }
+  const opj_image_comp_t *comps = image->comps;
+  uint8_t *pixel = returnMemoryBuffer;
+  for (int64_t y = 0; y < height; ++y) {
+    for (int64_t x = 0; x < width; ++x) {
+      const int32_t c0 = componentValue(comps[0], x, y);
+      const int32_t c1 = componentValue(comps[1], x, y);
+      const int32_t c2 = componentValue(comps[2], x, y);
+      if (ycbcr) {
+        wsiToDicomConverter::ycbcrToRGB(c0, c1, c2, pixel);
+      } else {
+        pixel[0] = clampByte(c0);
+        pixel[1] = clampByte(c1);
+        pixel[2] = clampByte(c2);
+      }
+      pixel[3] = 0xFF;
+      pixel += 4;
+    }
+  }
+  opj_image_destroy(image);
+  return true;
+}
+
+}  // namespace jpeg2000Util
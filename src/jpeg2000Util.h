@@ -0,0 +1,56 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef SRC_JPEG2000UTIL_H_
+#define SRC_JPEG2000UTIL_H_
+
+#include <stdint.h>
+
+namespace jpeg2000Util {
+
+/* Sets number of threads OpenJPEG uses to decode a single image. Frames are
+   decoded concurrently by the converter's thread pool; threads set here
+   are in addition to the pool's. Default 1.
+*/
+void setDecodeThreads(const int32_t threads);
+int32_t decodeThreads();
+
+/* Decodes JPEG 2000 codestream or JP2 image.
+   Prameters:
+    width  : width of decoded image
+    height : height of decoded image
+    ycbcr  : true if components are encoded as Y, Cb, Cr (e.g. Aperio
+             33003) and are converted to RGB.
+    reduce : number of highest resolution levels to discard; image is
+             decoded at 1 / 2^reduce of its encoded dimensions. Width and
+             height are dimensions of reduced image.
+    rawBuffer: byte array holding compressed image.
+    rawBufferSize: # of bytes in rawBuffer
+    returnMemoryBuffer: preallocated buffer to return decompressed image
+                        bytes, R, G, B, A (A = 0xFF) per pixel.
+    returnMemoryBufferSize: size of return buffer in bytes.
+
+  Returns: true if image decoded successfully.
+*/
+bool decodeJpeg2000(const int64_t width,
+                    const int64_t height,
+                    const bool ycbcr,
+                    const int32_t reduce,
+                    const uint8_t* rawBuffer,
+                    const uint64_t rawBufferSize,
+                    uint8_t *returnMemoryBuffer,
+                    const int64_t returnMemoryBufferSize);
+
+}  // namespace jpeg2000Util
+
+#endif  // SRC_JPEG2000UTIL_H_
@@ -17,6 +17,8 @@
 #include "src/jpegCompression.h"
 #include <boost/bind/bind.hpp>
 #include <boost/gil/extension/io/jpeg/old.hpp>
+#include <stdlib.h>
+
 #include <algorithm>
 #include <string>
 #include <utility>
@@ -86,8 +88,77 @@ std::unique_ptr<uint8_t[]> JpegCompression::compress(
   jpeg_finish_compress(&_cinfo);
   std::unique_ptr<uint8_t[]> output = std::make_unique<uint8_t[]>(outlen);
   std::move(imgd, imgd + outlen, output.get());
+  // Buffer allocated by jpeg_mem_dest is owned by caller.
+  free(imgd);
   jpeg_destroy_compress(&_cinfo);
   *size = outlen;
   return output;
 }
 
+
+std::unique_ptr<uint8_t[]> JpegCompression::compressYCbCr(
+    const wsiToDicomConverter::YCbCrImage &image, size_t *size) {
+  _cinfo.image_width = (JDIMENSION)image.width();
+  _cinfo.image_height = (JDIMENSION)image.height();
+  _cinfo.input_components = 3;
+  _cinfo.in_color_space = JCS_YCbCr;
+
+  size_t outlen = 0;
+  unsigned char *imgd = 0;
+  jpeg_mem_dest(&_cinfo, &imgd, &outlen);
+  jpeg_set_defaults(&_cinfo);
+  jpeg_set_quality(&_cinfo, _quality, TRUE);
+  _cinfo.comp_info[0].h_samp_factor = image.chromaSubsampleX();
+  _cinfo.comp_info[0].v_samp_factor = image.chromaSubsampleY();
+  _cinfo.raw_data_in = TRUE;
+
+  jpeg_start_compress(&_cinfo, TRUE);
+  // jpeg_write_raw_data consumes one row of MCU per call. Component rows
+  // are padded to a multiple of the block size by replicating the last
+  // column and row of each plane.
+  const int maxVSampFactor = image.chromaSubsampleY();
+  std::vector<std::vector<uint8_t>> rowMem(3);
+  std::vector<std::vector<JSAMPROW>> rows(3);
+  JSAMPARRAY componentRows[3];
+  for (int component = 0; component < 3; ++component) {
+    const int64_t rowCount = _cinfo.comp_info[component].v_samp_factor *
+                             DCTSIZE;
+    const int64_t rowWidth = _cinfo.comp_info[component].width_in_blocks *
+                             DCTSIZE;
+    rowMem[component].resize(rowCount * rowWidth);
+    for (int64_t row = 0; row < rowCount; ++row) {
+      rows[component].push_back(&rowMem[component][row * rowWidth]);
+    }
+    componentRows[component] = rows[component].data();
+  }
+  while (_cinfo.next_scanline < _cinfo.image_height) {
+    for (int component = 0; component < 3; ++component) {
+      const int vSampFactor = _cinfo.comp_info[component].v_samp_factor;
+      const int64_t planeWidth = image.planeWidth(component);
+      const int64_t planeHeight = image.planeHeight(component);
+      const int64_t rowWidth = _cinfo.comp_info[component].width_in_blocks *
+                               DCTSIZE;
+      const int64_t firstRow = static_cast<int64_t>(_cinfo.next_scanline) *
+                               vSampFactor / maxVSampFactor;
+      const uint8_t *plane = image.plane(component);
+      for (int64_t row = 0; row < vSampFactor * DCTSIZE; ++row) {
+        const uint8_t *planeRow = plane + std::min(firstRow + row,
+                                                   planeHeight - 1) *
+                                          planeWidth;
+        JSAMPROW dest = rows[component][row];
+        std::copy(planeRow, planeRow + planeWidth, dest);
+        std::fill(dest + planeWidth, dest + rowWidth,
+                  planeRow[planeWidth - 1]);
+      }
+    }
+    jpeg_write_raw_data(&_cinfo, componentRows, maxVSampFactor * DCTSIZE);
+  }
+  jpeg_finish_compress(&_cinfo);
+  std::unique_ptr<uint8_t[]> output = std::make_unique<uint8_t[]>(outlen);
+  std::move(imgd, imgd + outlen, output.get());
+  // Buffer allocated by jpeg_mem_dest is owned by caller.
+  free(imgd);
+  jpeg_destroy_compress(&_cinfo);
+  *size = outlen;
+  return output;
+}
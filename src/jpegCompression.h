@@ -20,6 +20,7 @@
 
 #include "src/enums.h"
 #include "src/compressor.h"
+#include "src/ycbcrImage.h"
 
 enum JpegSubsampling {subsample_444,
                       subsample_440,
@@ -39,6 +40,12 @@ class JpegCompression : public Compressor {
   virtual std::unique_ptr<uint8_t[]> compress(
                             const boost::gil::rgb8_view_t& view, size_t* size);
 
+  // Compresses planar YCbCr image without color conversion or chroma
+  // downsampling (jpeg_write_raw_data). Jpeg is encoded with the chroma
+  // subsampling of the image.
+  std::unique_ptr<uint8_t[]> compressYCbCr(
+                  const wsiToDicomConverter::YCbCrImage &image, size_t* size);
+
  private:
   jpeg_compress_struct _cinfo;
   jpeg_error_mgr _jerr;
@@ -14,11 +14,15 @@
 #include <boost/log/trivial.hpp>
 
 #include <jpeglib.h>
+#include <algorithm>
 #include <csetjmp>
+#include <cstring>
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "src/jpegUtil.h"
+#include "src/pixelUtil.h"
 
 namespace jpegUtil {
 
@@ -90,30 +94,14 @@ bool decodeJpeg(const int64_t width,
   jpeg_finish_decompress(&cinfo);
   jpeg_destroy_decompress(&cinfo);
 
-  std::unique_ptr<uint8_t[]> abgrBuffer;
-  uint64_t sourceCounter = 0;
-  uint64_t destCounter = 0;
-  const uint64_t sourceSize = height * width * 3;
-
   // Aperio imaging encoded with colorspace == JCS_RGB
   // requires colorspace  setting for correct decoding.
   // imaging is BGR.  Does not require byte reording.
   if (returnMemoryBuffer == nullptr) {
     return true;
   }
-  for (uint64_t sourceCounter = 0;
-      sourceCounter < sourceSize;
-      sourceCounter += 3) {
-    // color generated in BGR ordering
-    const uint8_t blue = bmp_buffer[sourceCounter];
-    const uint8_t green = bmp_buffer[sourceCounter+1];
-    const uint8_t red = bmp_buffer[sourceCounter+2];
-    returnMemoryBuffer[destCounter] = blue;
-    returnMemoryBuffer[destCounter+1] = green;
-    returnMemoryBuffer[destCounter+2] = red;
-    returnMemoryBuffer[destCounter+3] = 0xff;  // alpha
-    destCounter += 4;
-  }
+  // color generated in BGR ordering
+  pixelUtil::rgbToABGR(bmp_buffer.get(), returnMemoryBuffer, height * width);
   return true;
 }
 
@@ -125,4 +113,327 @@ bool canDecodeJpeg(const int64_t width, const int64_t height,
                     nullptr, size);
 }
 
+bool decodeJpegToYCbCr(const J_COLOR_SPACE colorSpace,
+                       const uint8_t* rawBuffer, const uint64_t rawBufferSize,
+                       wsiToDicomConverter::YCbCrImage *image) {
+  struct jpeg_decompress_struct cinfo;
+  jpegErrorManager jerr;
+
+  cinfo.err = jpeg_std_error(&jerr.pub);
+  jerr.pub.error_exit = jpegErrorExit;
+  if (setjmp(jerr.setjmp_buffer)) {
+    BOOST_LOG_TRIVIAL(error) <<  "Error occured decompressing jpeg";
+    jpeg_destroy_decompress(&cinfo);
+    return false;
+  }
+  jpeg_create_decompress(&cinfo);
+  jpeg_mem_src(&cinfo, rawBuffer, rawBufferSize);
+  if (jpeg_read_header(&cinfo, TRUE) != JPEG_HEADER_OK) {
+    BOOST_LOG_TRIVIAL(error) <<  "Not valid jpeg.";
+    jpeg_destroy_decompress(&cinfo);
+    return false;
+  }
+  cinfo.jpeg_color_space = colorSpace;
+  const jpeg_component_info *comp = cinfo.comp_info;
+  if (cinfo.jpeg_color_space != JCS_YCbCr || cinfo.num_components != 3 ||
+      cinfo.data_precision != 8 ||
+      comp[0].h_samp_factor > 2 || comp[0].v_samp_factor > 2 ||
+      comp[1].h_samp_factor != 1 || comp[1].v_samp_factor != 1 ||
+      comp[2].h_samp_factor != 1 || comp[2].v_samp_factor != 1) {
+    BOOST_LOG_TRIVIAL(debug) <<  "Jpeg can not be decoded to planar YCbCr.";
+    jpeg_destroy_decompress(&cinfo);
+    return false;
+  }
+  cinfo.raw_data_out = TRUE;
+  jpeg_start_decompress(&cinfo);
+  image->resize(cinfo.output_width, cinfo.output_height,
+                comp[0].h_samp_factor, comp[0].v_samp_factor);
+  const int maxVSampFactor = comp[0].v_samp_factor;
+  // jpeg_read_raw_data returns one row of MCU; component rows are padded
+  // to a multiple of the block size.
+  std::vector<std::vector<uint8_t>> rowMem(3);
+  std::vector<std::vector<JSAMPROW>> rows(3);
+  JSAMPARRAY componentRows[3];
+  for (int component = 0; component < 3; ++component) {
+    const int64_t rowCount = comp[component].v_samp_factor * DCTSIZE;
+    const int64_t rowWidth = comp[component].width_in_blocks * DCTSIZE;
+    rowMem[component].resize(rowCount * rowWidth);
+    for (int64_t row = 0; row < rowCount; ++row) {
+      rows[component].push_back(&rowMem[component][row * rowWidth]);
+    }
+    componentRows[component] = rows[component].data();
+  }
+  while (cinfo.output_scanline < cinfo.output_height) {
+    const int64_t scanline = cinfo.output_scanline;
+    jpeg_read_raw_data(&cinfo, componentRows, maxVSampFactor * DCTSIZE);
+    for (int component = 0; component < 3; ++component) {
+      const int vSampFactor = comp[component].v_samp_factor;
+      const int64_t planeWidth = image->planeWidth(component);
+      const int64_t firstRow = scanline * vSampFactor / maxVSampFactor;
+      const int64_t rowCount = std::min<int64_t>(vSampFactor * DCTSIZE,
+                                image->planeHeight(component) - firstRow);
+      uint8_t *plane = image->plane(component);
+      for (int64_t row = 0; row < rowCount; ++row) {
+        std::memcpy(plane + (firstRow + row) * planeWidth,
+                    rows[component][row], planeWidth);
+      }
+    }
+  }
+  jpeg_finish_decompress(&cinfo);
+  jpeg_destroy_decompress(&cinfo);
+  return true;
+}
+
+bool jpegMCUSize(const uint8_t* rawBuffer, const uint64_t rawBufferSize,
+                 int64_t *mcuWidth, int64_t *mcuHeight) {
+  struct jpeg_decompress_struct cinfo;
+  jpegErrorManager jerr;
+
+  cinfo.err = jpeg_std_error(&jerr.pub);
+  jerr.pub.error_exit = jpegErrorExit;
+  if (setjmp(jerr.setjmp_buffer)) {
+    BOOST_LOG_TRIVIAL(error) <<  "Error occured reading jpeg header";
+    jpeg_destroy_decompress(&cinfo);
+    return false;
+  }
+  jpeg_create_decompress(&cinfo);
+  jpeg_mem_src(&cinfo, rawBuffer, rawBufferSize);
+  if (jpeg_read_header(&cinfo, TRUE) != JPEG_HEADER_OK) {
+    BOOST_LOG_TRIVIAL(error) <<  "Not valid jpeg.";
+    jpeg_destroy_decompress(&cinfo);
+    return false;
+  }
+  int maxHSampFactor = 1;
+  int maxVSampFactor = 1;
+  for (int component = 0; component < cinfo.num_components; ++component) {
+    maxHSampFactor = std::max(maxHSampFactor,
+                              cinfo.comp_info[component].h_samp_factor);
+    maxVSampFactor = std::max(maxVSampFactor,
+                              cinfo.comp_info[component].v_samp_factor);
+  }
+  *mcuWidth = maxHSampFactor * DCTSIZE;
+  *mcuHeight = maxVSampFactor * DCTSIZE;
+  jpeg_destroy_decompress(&cinfo);
+  return true;
+}
+
+// libjpeg destination manager which writes compressed jpeg to a vector.
+struct jpegVectorDestination {
+  struct jpeg_destination_mgr pub;
+  std::vector<uint8_t> *buffer;
+};
+
+static const size_t JPEG_DESTINATION_BUFFER_SIZE = 65536;
+
+void initVectorDestination(j_compress_ptr cinfo) {
+  jpegVectorDestination *dest =
+                       reinterpret_cast<jpegVectorDestination*>(cinfo->dest);
+  dest->buffer->resize(JPEG_DESTINATION_BUFFER_SIZE);
+  dest->pub.next_output_byte = dest->buffer->data();
+  dest->pub.free_in_buffer = dest->buffer->size();
+}
+
+boolean emptyVectorDestination(j_compress_ptr cinfo) {
+  // Called when buffer is full; free_in_buffer is not reliable.
+  jpegVectorDestination *dest =
+                       reinterpret_cast<jpegVectorDestination*>(cinfo->dest);
+  const size_t used = dest->buffer->size();
+  dest->buffer->resize(used * 2);
+  dest->pub.next_output_byte = dest->buffer->data() + used;
+  dest->pub.free_in_buffer = dest->buffer->size() - used;
+  return TRUE;
+}
+
+void termVectorDestination(j_compress_ptr cinfo) {
+  jpegVectorDestination *dest =
+                       reinterpret_cast<jpegVectorDestination*>(cinfo->dest);
+  dest->buffer->resize(dest->buffer->size() - dest->pub.free_in_buffer);
+}
+
+// Coefficients can only be copied between jpeg encoded with the same
+// dimensions, sampling and quantization.
+bool sameJpegCoding(const jpeg_decompress_struct &first,
+                    const jpeg_decompress_struct &second) {
+  if (first.image_width != second.image_width ||
+      first.image_height != second.image_height ||
+      first.num_components != second.num_components ||
+      first.data_precision != second.data_precision) {
+    return false;
+  }
+  for (int component = 0; component < first.num_components; ++component) {
+    const jpeg_component_info *firstComp = &first.comp_info[component];
+    const jpeg_component_info *secondComp = &second.comp_info[component];
+    if (firstComp->h_samp_factor != secondComp->h_samp_factor ||
+        firstComp->v_samp_factor != secondComp->v_samp_factor ||
+        firstComp->quant_table == nullptr ||
+        secondComp->quant_table == nullptr ||
+        std::memcmp(firstComp->quant_table->quantval,
+                    secondComp->quant_table->quantval,
+                    sizeof(firstComp->quant_table->quantval)) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Quantized DC coefficient of block filled with white. Chroma components
+// of YCbCr are left zero (neutral).
+JCOEF whiteDCCoefficient(const jpeg_compress_struct &cinfo, int component) {
+  if (component != 0 && cinfo.jpeg_color_space != JCS_RGB) {
+    return 0;
+  }
+  const JQUANT_TBL *table =
+          cinfo.quant_tbl_ptrs[cinfo.comp_info[component].quant_tbl_no];
+  const int maxSample = (1 << cinfo.data_precision) - 1;
+  const int centerSample = 1 << (cinfo.data_precision - 1);
+  const int dc = DCTSIZE * (maxSample - centerSample);
+  return static_cast<JCOEF>((dc + table->quantval[0] / 2) /
+                            table->quantval[0]);
+}
+
+std::unique_ptr<uint8_t[]> stitchJpegTiles(
+                                const std::vector<const uint8_t*> &tiles,
+                                const std::vector<uint64_t> &tileSizes,
+                                const int64_t tilesX, const int64_t tilesY,
+                                const J_COLOR_SPACE colorSpace,
+                                uint64_t *size) {
+  *size = 0;
+  const size_t tileCount = tiles.size();
+  if (tilesX <= 0 || tilesY <= 0 ||
+      tileCount != static_cast<size_t>(tilesX * tilesY) ||
+      tileSizes.size() != tileCount) {
+    BOOST_LOG_TRIVIAL(error) << "Invalid jpeg tile grid.";
+    return nullptr;
+  }
+  // Zero initialized; jpeg_destroy does nothing for structures which were
+  // not created.
+  std::vector<jpeg_decompress_struct> srcInfo(tileCount);
+  std::vector<jvirt_barray_ptr *> srcCoefficients(tileCount, nullptr);
+  std::vector<jvirt_barray_ptr> dstCoefficients;
+  std::vector<uint8_t> dstBuffer;
+  struct jpeg_compress_struct dstInfo;
+  std::memset(&dstInfo, 0, sizeof(dstInfo));
+  jpegErrorManager jerr;
+  dstInfo.err = jpeg_std_error(&jerr.pub);
+  jerr.pub.error_exit = jpegErrorExit;
+  for (jpeg_decompress_struct &info : srcInfo) {
+    info.err = &jerr.pub;
+  }
+  auto destroy = [&]() {
+    jpeg_destroy_compress(&dstInfo);
+    for (jpeg_decompress_struct &info : srcInfo) {
+      jpeg_destroy_decompress(&info);
+    }
+  };
+  if (setjmp(jerr.setjmp_buffer)) {
+    BOOST_LOG_TRIVIAL(error) << "Error occured joining jpeg tiles: " <<
+                                jpegLastErrorMsg;
+    destroy();
+    return nullptr;
+  }
+  int64_t firstTile = -1;
+  for (size_t idx = 0; idx < tileCount; ++idx) {
+    if (tiles[idx] == nullptr) {
+      continue;
+    }
+    jpeg_create_decompress(&srcInfo[idx]);
+    jpeg_mem_src(&srcInfo[idx], tiles[idx], tileSizes[idx]);
+    if (jpeg_read_header(&srcInfo[idx], TRUE) != JPEG_HEADER_OK) {
+      BOOST_LOG_TRIVIAL(error) <<  "Not valid jpeg.";
+      destroy();
+      return nullptr;
+    }
+    srcInfo[idx].jpeg_color_space = colorSpace;
+    srcCoefficients[idx] = jpeg_read_coefficients(&srcInfo[idx]);
+    if (firstTile == -1) {
+      firstTile = idx;
+    } else if (!sameJpegCoding(srcInfo[firstTile], srcInfo[idx])) {
+      BOOST_LOG_TRIVIAL(debug) << "Jpeg tiles encoded with different "
+                                  "dimensions, sampling or quantization.";
+      destroy();
+      return nullptr;
+    }
+  }
+  if (firstTile == -1) {
+    BOOST_LOG_TRIVIAL(error) << "No jpeg tiles to join.";
+    destroy();
+    return nullptr;
+  }
+  jpeg_decompress_struct *tileInfo = &srcInfo[firstTile];
+  int maxHSampFactor = 1;
+  int maxVSampFactor = 1;
+  for (int component = 0; component < tileInfo->num_components;
+       ++component) {
+    maxHSampFactor = std::max(maxHSampFactor,
+                              tileInfo->comp_info[component].h_samp_factor);
+    maxVSampFactor = std::max(maxVSampFactor,
+                              tileInfo->comp_info[component].v_samp_factor);
+  }
+  // Partial MCU at tile edge would be decoded inside joined image.
+  if (tileInfo->image_width % (maxHSampFactor * DCTSIZE) != 0 ||
+      tileInfo->image_height % (maxVSampFactor * DCTSIZE) != 0) {
+    BOOST_LOG_TRIVIAL(debug) << "Jpeg tile dimensions are not a multiple "
+                                "of MCU size.";
+    destroy();
+    return nullptr;
+  }
+  jpeg_create_compress(&dstInfo);
+  jpegVectorDestination dest;
+  dest.pub.init_destination = initVectorDestination;
+  dest.pub.empty_output_buffer = emptyVectorDestination;
+  dest.pub.term_destination = termVectorDestination;
+  dest.buffer = &dstBuffer;
+  dstInfo.dest = &dest.pub;
+  jpeg_copy_critical_parameters(tileInfo, &dstInfo);
+  dstInfo.image_width = tileInfo->image_width * tilesX;
+  dstInfo.image_height = tileInfo->image_height * tilesY;
+  dstCoefficients.resize(tileInfo->num_components);
+  for (int component = 0; component < tileInfo->num_components;
+       ++component) {
+    const jpeg_component_info *comp = &tileInfo->comp_info[component];
+    dstCoefficients[component] = (*dstInfo.mem->request_virt_barray)(
+        reinterpret_cast<j_common_ptr>(&dstInfo), JPOOL_IMAGE, TRUE,
+        comp->width_in_blocks * tilesX, comp->height_in_blocks * tilesY,
+        comp->v_samp_factor);
+  }
+  jpeg_write_coefficients(&dstInfo, dstCoefficients.data());
+  // Virtual array rows must be written in order; each row of blocks is
+  // assembled across the tiles in a row of the grid.
+  for (int component = 0; component < tileInfo->num_components;
+       ++component) {
+    const JDIMENSION blocksX = tileInfo->comp_info[component].width_in_blocks;
+    const JDIMENSION blocksY =
+                             tileInfo->comp_info[component].height_in_blocks;
+    const JCOEF whiteDC = whiteDCCoefficient(dstInfo, component);
+    for (int64_t tileY = 0; tileY < tilesY; ++tileY) {
+      for (JDIMENSION row = 0; row < blocksY; ++row) {
+        JBLOCKARRAY dstRow = (*dstInfo.mem->access_virt_barray)(
+            reinterpret_cast<j_common_ptr>(&dstInfo),
+            dstCoefficients[component], tileY * blocksY + row, 1, TRUE);
+        for (int64_t tileX = 0; tileX < tilesX; ++tileX) {
+          const size_t idx = tileY * tilesX + tileX;
+          JBLOCKROW dstBlocks = dstRow[0] + tileX * blocksX;
+          if (tiles[idx] == nullptr) {
+            std::memset(dstBlocks, 0, blocksX * sizeof(JBLOCK));
+            for (JDIMENSION block = 0; block < blocksX; ++block) {
+              dstBlocks[block][0] = whiteDC;
+            }
+            continue;
+          }
+          JBLOCKARRAY srcRow = (*srcInfo[idx].mem->access_virt_barray)(
+              reinterpret_cast<j_common_ptr>(&srcInfo[idx]),
+              srcCoefficients[idx][component], row, 1, FALSE);
+          std::memcpy(dstBlocks, srcRow[0], blocksX * sizeof(JBLOCK));
+        }
+      }
+    }
+  }
+  jpeg_finish_compress(&dstInfo);
+  destroy();
+  *size = dstBuffer.size();
+  std::unique_ptr<uint8_t[]> jpegMem = std::make_unique<uint8_t[]>(*size);
+  std::memcpy(jpegMem.get(), dstBuffer.data(), *size);
+  return jpegMem;
+}
+
 }  // namespace jpegUtil
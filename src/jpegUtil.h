@@ -15,6 +15,9 @@
 #define SRC_JPEGUTIL_H_
 
 #include <memory>
+#include <vector>
+
+#include "src/ycbcrImage.h"
 
 namespace jpegUtil {
 
@@ -43,6 +46,59 @@ bool decodeJpeg(const int64_t width,
                 uint8_t *returnMemoryBuffer,
                 const int64_t returnMemoryBufferSize);
 
+/* Decodes YCbCr jpeg to planar YCbCr without color conversion or chroma
+   upsampling; chroma planes are returned at the resolution encoded.
+   Prameters:
+    colorSpace: jpeg color space to decode image as.
+    rawBuffer: byte array holding compressed image.
+    rawBufferSize: # of bytes in rawBuffer
+    image: returns decoded image.
+
+  Returns: true if image decoded successfully. False if jpeg is not YCbCr
+           or uses chroma sampling other than 4:4:4, 4:4:0, 4:2:2, 4:2:0.
+*/
+bool decodeJpegToYCbCr(const J_COLOR_SPACE colorSpace,
+                       const uint8_t* rawBuffer, const uint64_t rawBufferSize,
+                       wsiToDicomConverter::YCbCrImage *image);
+
+/* Reads size of jpeg minimum coded unit from jpeg header.
+   Prameters:
+    rawBuffer: byte array holding compressed image.
+    rawBufferSize: # of bytes in rawBuffer
+    mcuWidth: returns MCU width in pixels.
+    mcuHeight: returns MCU height in pixels.
+
+  Returns: true if header read successfully.
+*/
+bool jpegMCUSize(const uint8_t* rawBuffer, const uint64_t rawBufferSize,
+                 int64_t *mcuWidth, int64_t *mcuHeight);
+
+/* Joins a grid of jpeg tiles into one jpeg without decompression. Quantized
+   DCT coefficients of each tile are copied into the coefficient array of the
+   joined image and entropy coded again (as jpegtran does); coefficients are
+   not changed. Decoded pixels are identical to the decoded tiles, except
+   where a decoder's chroma upsampling interpolates across tile edges.
+
+   Tiles must have the same dimensions, a multiple of the MCU size, and the
+   same component sampling and quantization tables.
+   Prameters:
+    tiles: tilesX * tilesY tiles in row major order. nullptr tiles, e.g.
+           past the edge of the image, are filled with white.
+    tileSizes: # of bytes in each tile.
+    tilesX: tiles per row.
+    tilesY: tiles per column.
+    colorSpace: jpeg color space of tiles e.g. RGB
+    size: returns # of bytes in joined jpeg.
+
+  Returns: joined jpeg or nullptr if tiles can not be joined.
+*/
+std::unique_ptr<uint8_t[]> stitchJpegTiles(
+                                const std::vector<const uint8_t*> &tiles,
+                                const std::vector<uint64_t> &tileSizes,
+                                const int64_t tilesX, const int64_t tilesY,
+                                const J_COLOR_SPACE colorSpace,
+                                uint64_t *size);
+
 }  // namespace jpegUtil
 
 #endif  // SRC_JPEGUTIL_H_
@@ -15,18 +15,46 @@
 
 #include <algorithm>
 #include <iostream>
+#include <map>
+#include <memory>
+#include <set>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "src/batchManifest.h"
+#include "src/containerResources.h"
+#include "src/conversionDaemon.h"
+#include "src/wsiBatch.h"
 #include "src/wsiToDcm.h"
 namespace {
 const size_t ERROR_IN_COMMAND_LINE = 1;
 const size_t SUCCESS = 0;
 const size_t ERROR_UNHANDLED_EXCEPTION = 2;
+// Returned by parseCommandLines if help was printed.
+const size_t HELP_PRINTED = 3;
 
-}  // namespace
-int main(int argc, char *argv[]) {
+// Options which do not change output; a conversion may be resumed with
+// different values. Input is identified by its content.
+const std::set<std::string> RESUME_IGNORED_OPTIONS = {
+    "input", "outFolder", "resume", "threads", "debug", "readThreads",
+    "sliceThreads", "writeThreads", "stageQueueDepth", "maxMemoryMB",
+    "containerMemoryBudget", "numaPinning", "directIOWrite",
+    "dropOutputPageCache", "tilePrefetchQueueDepth", "openslideCacheMB",
+    "batchManifest", "batchSlidesInFlight", "daemonSocket"};
+
+// Options for converting more than one slide in a process.
+struct BatchOptions {
+  std::string manifest;
+  int slidesInFlight;
+  std::string daemonSocket;
+};
+
+// Parses command lines into request. Options set by a command line take
+// precedence over the same options set by the command lines following it.
+int parseCommandLines(
+    const std::vector<std::vector<std::string>> &commandLines,
+    wsiToDicomConverter::WsiRequest *request, BatchOptions *batchOptions) {
   std::string inputFile;
   std::string jsonFile;
   std::string outputFolder;
@@ -43,6 +71,22 @@ int main(int argc, char *argv[]) {
   int start;
   int stop;
   int batch;
+  int64_t batchBytes;
+  int tilePrefetchQueueDepth;
+  int64_t openslideCacheMB;
+  int64_t openslideRegionBandFrames;
+  bool fusedPyramid;
+  std::string frameOrder;
+  int readThreads;
+  int sliceThreads;
+  int writeThreads;
+  int stageQueueDepth;
+  int64_t maxMemoryMB;
+  bool containerMemoryBudget;
+  bool numaPinning;
+  bool resume;
+  // Options set by command lines, by name.
+  std::map<std::string, std::string> setOptions;
   int threads;
   bool debug;
   bool dropFirstRowAndColumn;
@@ -51,18 +95,23 @@ int main(int argc, char *argv[]) {
   bool preferProgressiveDownsampling;
   bool SVSImportPreferScannerTileingForLargestLevel;
   bool SVSImportPreferScannerTileingForAllLevels;
+  bool SVSImportLosslessRetile;
+  bool jpegYCbCrDownsampling;
+  bool jpeg2000ReducedResolution;
   int compressionQuality;
   bool readUntiledImage;
   double untiledImageHeightMM;
   std::vector<int> downsamples;
   bool sparse;
   bool includeSingleFrameDownsample;
+  bool directIOWrite;
+  bool dropOutputPageCache;
   try {
     namespace programOptions = boost::program_options;
     programOptions::options_description desc("Options", 90, 20);
     desc.add_options()("help", "Print help messages")(
-        "input", programOptions::value<std::string>(&inputFile)->required(),
-        "input file")("outFolder",
+        "input", programOptions::value<std::string>(&inputFile),
+        "input file or DICOM series directory")("outFolder",
                       programOptions::value<std::string>(&outputFolder)
                           ->required()
                           ->default_value("./"),
@@ -112,6 +161,76 @@ int main(int argc, char *argv[]) {
         "\nhttps://www.dicomstandard.org/dicomweb/dicom-json-format/")(
         "batch", programOptions::value<int>(&batch)->default_value(0),
         "maximum frames in one file")(
+        "batchBytes",
+        programOptions::value<int64_t>(&batchBytes)->default_value(0),
+        "maximum encoded frame bytes in one file, batch caps frame count")(
+        "directIOWrite",
+        programOptions::bool_switch(&directIOWrite)->default_value(false),
+        "write preallocated output files with direct I/O, bypassing the "
+        "page cache")(
+        "dropOutputPageCache",
+        programOptions::bool_switch(&dropOutputPageCache)->default_value(false),
+        "drop written output files from the page cache")(
+        "tilePrefetchQueueDepth",
+        programOptions::value<int>(&tilePrefetchQueueDepth)->default_value(0),
+        "number of raw tiff tiles read ahead of frame workers, 0 disables")(
+        "openslideCacheMB",
+        programOptions::value<int64_t>(&openslideCacheMB)->default_value(0),
+        "size of tile cache shared by openslide reader threads in MB")(
+        "openslideRegionBandFrames",
+        programOptions::value<int64_t>(&openslideRegionBandFrames)->
+        default_value(0),
+        "frames in a row read from openslide with a single region read, "
+        "0 reads each frame separately")(
+        "fusedPyramid",
+        programOptions::bool_switch(&fusedPyramid)->default_value(false),
+        "generate levels read from openslide in one pass over level 0")(
+        "frameOrder",
+        programOptions::value<std::string>(&frameOrder)->
+        default_value("raster"),
+        "order frames are generated in: raster, morton, or hilbert")(
+        "readThreads",
+        programOptions::value<int>(&readThreads)->default_value(0),
+        "threads reading frame sources in a staged pipeline, 0 disables")(
+        "sliceThreads",
+        programOptions::value<int>(&sliceThreads)->default_value(0),
+        "threads resampling and compressing frames in staged pipeline")(
+        "writeThreads",
+        programOptions::value<int>(&writeThreads)->default_value(0),
+        "threads writing DICOM files in staged pipeline")(
+        "stageQueueDepth",
+        programOptions::value<int>(&stageQueueDepth)->default_value(0),
+        "frames read ahead of slicing in staged pipeline")(
+        "maxMemoryMB",
+        programOptions::value<int64_t>(&maxMemoryMB)->default_value(0),
+        "memory budget of frames and files being generated in MB, "
+        "0 = unbounded")(
+        "containerMemoryBudget",
+        programOptions::bool_switch(&containerMemoryBudget)->
+            default_value(false),
+        "if maxMemoryMB is 0, use half of the container memory limit as "
+        "memory budget")(
+        "resume",
+        programOptions::bool_switch(&resume)->default_value(false),
+        "resume interrupted conversion, skipping files completed before it "
+        "was interrupted; generated UIDs are derived from input and options")(
+        "numaPinning",
+        programOptions::bool_switch(&numaPinning)->default_value(false),
+        "pin frame workers to NUMA nodes and generate a row on one node")(
+        "batchManifest",
+        programOptions::value<std::string>(&batchOptions->manifest)->
+            default_value(""),
+        "tab separated file of slides to convert: input, output folder, "
+        "json file, options")(
+        "batchSlidesInFlight",
+        programOptions::value<int>(&batchOptions->slidesInFlight)->
+            default_value(2),
+        "slides of batchManifest or jobs of daemonSocket converted at the "
+        "same time")(
+        "daemonSocket",
+        programOptions::value<std::string>(&batchOptions->daemonSocket)->
+            default_value(""),
+        "run as daemon converting jobs submitted to Unix domain socket")(
         "threads",
         programOptions::value<int>(&threads)->required()->default_value(-1),
         "number of threads")(
@@ -154,6 +273,19 @@ int main(int argc, char *argv[]) {
         "OpenCV downsampling algorithm, supported: LANCZOS4, CUBIC, AREA, "
         "LINEAR, LINEAR_EXACT, NEAREST, NEAREST_EXACT. Default value "
         "'NONE' uses non-opencv boost::gli nearestneighbor downsampling.")
+        ("jpegYCbCrDownsample",
+        programOptions::bool_switch(
+        &jpegYCbCrDownsampling)->default_value(false),
+        "Progressively downsample jpeg levels from jpeg encoded prior levels "
+        "in YCbCr without conversion to RGB. Each YCbCr plane is nearest "
+        "neighbor downsampled. Requires progressiveDownsample and "
+        "opencvDownsampling NONE.")
+        ("jpeg2000ReducedResolution",
+        programOptions::bool_switch(
+        &jpeg2000ReducedResolution)->default_value(false),
+        "Generate power of two downsamples of JPEG 2000 encoded SVS/TIFF "
+        "levels by decoding the JPEG 2000 tiles at reduced resolution "
+        "instead of resampling the full resolution pixels.")
         ("SVSImportPreferScannerTileingForLargestLevel",
         programOptions::bool_switch(
         &SVSImportPreferScannerTileingForLargestLevel)->default_value(false),
@@ -172,6 +304,14 @@ int main(int argc, char *argv[]) {
         "all levels preferentially. Same limitations as "
         "SVSImportPreferScannerTileingForLargestLevel. Compression settings "
         "apply to generated levels only.")
+        ("SVSImportLosslessRetile",
+        programOptions::bool_switch(
+        &SVSImportLosslessRetile)->default_value(false),
+        "Join jpeg tiles of SVS into DICOM tiles of tileWidth x tileHeight "
+        "without decompression by copying jpeg DCT coefficients. Tile "
+        "dimensions must be a multiple of the SVS jpeg tile dimensions. "
+        "Requires SVSImportPreferScannerTileingForLargestLevel or "
+        "SVSImportPreferScannerTileingForAllLevels.")
         ("readImage",
         programOptions::bool_switch(&readUntiledImage)->default_value(false),
         "Generate DICOM Pyramid from untiled image.")
@@ -192,15 +332,26 @@ int main(int argc, char *argv[]) {
     positionalOptions.add("outFolder", 1);
     programOptions::variables_map vm;
     try {
-      programOptions::store(programOptions::command_line_parser(argc, argv)
-                                .options(desc)
-                                .positional(positionalOptions)
-                                .run(),
-                            vm);
+      for (const std::vector<std::string> &commandLine : commandLines) {
+        const programOptions::parsed_options parsedOptions =
+            programOptions::command_line_parser(commandLine)
+                .options(desc)
+                .positional(positionalOptions)
+                .run();
+        programOptions::store(parsedOptions, vm);
+        for (const programOptions::option &option : parsedOptions.options) {
+          // Option of first command line setting it takes precedence.
+          std::string value;
+          for (const std::string &token : option.value) {
+            value += token + " ";
+          }
+          setOptions.insert(std::make_pair(option.string_key, value));
+        }
+      }
 
       if (vm.count("help")) {
         std::cout << "Wsi2dcm" << std::endl << desc << std::endl;
-        return SUCCESS;
+        return HELP_PRINTED;
       }
       programOptions::notify(vm);
     } catch (programOptions::error &e) {
@@ -222,94 +373,264 @@ int main(int argc, char *argv[]) {
               "SVSImportPreferScannerTileingForAllLevels." << std::endl;
       return ERROR_IN_COMMAND_LINE;
   }
+  if (SVSImportLosslessRetile &&
+      !(SVSImportPreferScannerTileingForLargestLevel ||
+        SVSImportPreferScannerTileingForAllLevels)) {
+    std::cerr << "Option: SVSImportLosslessRetile requires Options: " <<
+                 "SVSImportPreferScannerTileingForLargestLevel or " <<
+                 "SVSImportPreferScannerTileingForAllLevels." << std::endl;
+    return ERROR_IN_COMMAND_LINE;
+  }
+  if (jpegYCbCrDownsampling && !(preferProgressiveDownsampling ||
+                                 readUntiledImage)) {
+    std::cerr << "Option: jpegYCbCrDownsample requires Option: " <<
+                 "progressiveDownsample." << std::endl;
+    return ERROR_IN_COMMAND_LINE;
+  }
   if (readUntiledImage & !preferProgressiveDownsampling) {
     std::cerr << "Generating WSI Pyramids from un-tiled images requires "
                  "enabling progressive downsampling." << std::endl;
     return ERROR_IN_COMMAND_LINE;
   }
+  if (fusedPyramid && (preferProgressiveDownsampling || readUntiledImage ||
+                       downsamplingAlgorithm != "NONE")) {
+    std::cerr << "Option: fusedPyramid is not compatible with Options: " <<
+                 "progressiveDownsample, readImage and " <<
+                 "opencvDownsampling." << std::endl;
+    return ERROR_IN_COMMAND_LINE;
+  }
+  if (numaPinning && readThreads > 0) {
+    std::cerr << "Option: numaPinning is not compatible with Option: " <<
+                 "readThreads." << std::endl;
+    return ERROR_IN_COMMAND_LINE;
+  }
+  if (frameOrderFromString(frameOrder) == UNKNOWN_ORDER) {
+    std::cerr << "Unrecognized frameOrder: " << frameOrder << std::endl;
+    return ERROR_IN_COMMAND_LINE;
+  }
   if (downsamples.size() > 0 && levels != 0) {
     std::cerr << "Invalid configuration cannot use the combination of "
                  "downsamples and levels." << std::endl;
     return ERROR_IN_COMMAND_LINE;
   }
-  wsiToDicomConverter::WsiRequest request;
-  request.genPyramidFromUntiledImage = readUntiledImage;
-  request.untiledImageHeightMM = untiledImageHeightMM;
-  request.inputFile = inputFile;
-  request.outputFileMask = outputFolder;
-  request.frameSizeX = std::max(tileWidth, 1);
-  request.frameSizeY = std::max(tileHeight, 1);
-  request.firstlevelCompression = (firstlevelCompression == "default") ?
+  if (inputFile.empty() && batchOptions->manifest.empty() &&
+      batchOptions->daemonSocket.empty()) {
+    std::cerr << "Option: input, batchManifest or daemonSocket is required." <<
+                 std::endl;
+    return ERROR_IN_COMMAND_LINE;
+  }
+  request->genPyramidFromUntiledImage = readUntiledImage;
+  request->untiledImageHeightMM = untiledImageHeightMM;
+  request->inputFile = inputFile;
+  request->outputFileMask = outputFolder;
+  request->frameSizeX = std::max(tileWidth, 1);
+  request->frameSizeY = std::max(tileHeight, 1);
+  request->firstlevelCompression = (firstlevelCompression == "default") ?
                                dcmCompressionFromString(compression) :
                                dcmCompressionFromString(firstlevelCompression);
-  request.compression = dcmCompressionFromString(compression);
-  request.quality = std::max(std::min(100, compressionQuality), 0);
-  request.startOnLevel = std::max(start, 0);
-  request.stopOnLevel =  std::max(stop, -1);
-  request.imageName = seriesDescription;
-  request.studyId = studyId;
-  request.seriesId = seriesId;
-  request.jsonFile = jsonFile;
-  request.retileLevels = std::max(levels, 0);
-  request.includeSingleFrameDownsample = includeSingleFrameDownsample;
+  request->compression = dcmCompressionFromString(compression);
+  request->quality = std::max(std::min(100, compressionQuality), 0);
+  request->startOnLevel = std::max(start, 0);
+  request->stopOnLevel =  std::max(stop, -1);
+  request->imageName = seriesDescription;
+  request->studyId = studyId;
+  request->seriesId = seriesId;
+  request->jsonFile = jsonFile;
+  request->retileLevels = std::max(levels, 0);
+  request->includeSingleFrameDownsample = includeSingleFrameDownsample;
   for (int downsample : downsamples) {
     if (downsample > 0) {
-      request.downsamples.push_back(downsample);
+      request->downsamples.push_back(downsample);
+    }
+  }
+  request->tiled = !sparse;
+  request->batchLimit = std::max(batch, 0);
+  request->batchBytesLimit = std::max<int64_t>(batchBytes, 0);
+  request->directIOWrite = directIOWrite;
+  request->dropOutputPageCache = dropOutputPageCache;
+  request->tilePrefetchQueueDepth = std::max(tilePrefetchQueueDepth, 0);
+  request->openslideCacheMB = std::max<int64_t>(openslideCacheMB, 0);
+  request->openslideRegionBandFrames = std::max<int64_t>(
+                                                openslideRegionBandFrames, 0);
+  request->fusedPyramid = fusedPyramid;
+  request->frameOrder = frameOrderFromString(frameOrder);
+  request->readThreads = std::max(readThreads, 0);
+  request->sliceThreads = std::max(sliceThreads, 0);
+  request->writeThreads = std::max(writeThreads, 0);
+  request->stageQueueDepth = std::max(stageQueueDepth, 0);
+  request->maxMemoryMB = std::max<int64_t>(maxMemoryMB, 0);
+  if (request->maxMemoryMB == 0 && containerMemoryBudget) {
+    request->maxMemoryMB = wsiToDicomConverter::defaultMemoryBudgetMB();
+  }
+  request->numaPinning = numaPinning;
+  request->resume = resume;
+  request->resumeOptions.clear();
+  for (const auto &option : setOptions) {
+    if (RESUME_IGNORED_OPTIONS.count(option.first) == 0) {
+      request->resumeOptions += option.first + "=" + option.second + "\n";
     }
   }
-  request.tiled = !sparse;
-  request.batchLimit = std::max(batch, 0);
-  request.threads = std::max(threads, -1);
-  request.dropFirstRowAndColumn = dropFirstRowAndColumn;
-  request.stopDownsamplingAtSingleFrame = stopDownsamplingAtSingleFrame;
-  request.floorCorrectDownsampling = floorCorrectDownsampling;
-  if (request.genPyramidFromUntiledImage) {
-    request.preferProgressiveDownsampling = true;
+  request->threads = std::max(threads, -1);
+  request->dropFirstRowAndColumn = dropFirstRowAndColumn;
+  request->stopDownsamplingAtSingleFrame = stopDownsamplingAtSingleFrame;
+  request->floorCorrectDownsampling = floorCorrectDownsampling;
+  if (request->genPyramidFromUntiledImage) {
+    request->preferProgressiveDownsampling = true;
   } else {
-    request.preferProgressiveDownsampling = preferProgressiveDownsampling;
+    request->preferProgressiveDownsampling = preferProgressiveDownsampling;
   }
-  request.SVSImportPreferScannerTileingForLargestLevel =
+  request->SVSImportPreferScannerTileingForLargestLevel =
           SVSImportPreferScannerTileingForLargestLevel;
-  request.SVSImportPreferScannerTileingForAllLevels =
+  request->SVSImportPreferScannerTileingForAllLevels =
           SVSImportPreferScannerTileingForAllLevels;
-  request.useOpenCVDownsampling = true;
+  request->SVSImportLosslessRetile = SVSImportLosslessRetile;
+  request->jpegYCbCrDownsampling = jpegYCbCrDownsampling;
+  request->jpeg2000ReducedResolution = jpeg2000ReducedResolution;
+  // JPEG frames of DICOM input are re-encoded if encoding is requested.
+  request->dicomJpegPassthrough =
+      setOptions.count("jpegCompressionQuality") == 0 &&
+      setOptions.count("jpegSubsampling") == 0;
+  request->useOpenCVDownsampling = true;
   if (downsamplingAlgorithm == "LANCZOS4") {
-    request.openCVInterpolationMethod = cv::INTER_LANCZOS4;
+    request->openCVInterpolationMethod = cv::INTER_LANCZOS4;
   } else if (downsamplingAlgorithm == "CUBIC") {
-    request.openCVInterpolationMethod = cv::INTER_CUBIC;
+    request->openCVInterpolationMethod = cv::INTER_CUBIC;
   } else if (downsamplingAlgorithm == "AREA") {
-    request.openCVInterpolationMethod = cv::INTER_AREA;
+    request->openCVInterpolationMethod = cv::INTER_AREA;
   } else if (downsamplingAlgorithm == "LINEAR") {
-    request.openCVInterpolationMethod = cv::INTER_LINEAR;
+    request->openCVInterpolationMethod = cv::INTER_LINEAR;
   } else if (downsamplingAlgorithm == "LINEAR_EXACT") {
-    request.openCVInterpolationMethod = cv::INTER_LINEAR_EXACT;
+    request->openCVInterpolationMethod = cv::INTER_LINEAR_EXACT;
   } else if (downsamplingAlgorithm == "NEAREST") {
-    request.openCVInterpolationMethod = cv::INTER_NEAREST;
+    request->openCVInterpolationMethod = cv::INTER_NEAREST;
   } else if (downsamplingAlgorithm == "NEAREST_EXACT") {
-    request.openCVInterpolationMethod = cv::INTER_NEAREST_EXACT;
+    request->openCVInterpolationMethod = cv::INTER_NEAREST_EXACT;
   } else if (downsamplingAlgorithm == "NONE") {
-    request.openCVInterpolationMethod = cv::INTER_AREA;
-    request.useOpenCVDownsampling = false;
+    request->openCVInterpolationMethod = cv::INTER_AREA;
+    request->useOpenCVDownsampling = false;
   } else {
     std::cerr << "Unrecognized OpenCVDownsamplingAlgorithm: " <<
                  downsamplingAlgorithm;
     return 1;
   }
-  request.debug = debug;
+  request->debug = debug;
 
   if (jpegSubsampling == "444") {
-    request.jpegSubsampling = subsample_444;
+    request->jpegSubsampling = subsample_444;
   } else if (jpegSubsampling == "440") {
-    request.jpegSubsampling = subsample_440;
+    request->jpegSubsampling = subsample_440;
   } else if (jpegSubsampling == "422") {
-    request.jpegSubsampling = subsample_422;
+    request->jpegSubsampling = subsample_422;
   } else if (jpegSubsampling == "420") {
-    request.jpegSubsampling = subsample_420;
+    request->jpegSubsampling = subsample_420;
   } else {
     std::cerr << "Unrecognized jpegSubsampling: " <<
                  jpegSubsampling;
     return 1;
   }
-  wsiToDicomConverter::WsiToDcm converter(&request);
-  return converter.wsi2dcm();
+  return SUCCESS;
+}
+
+// True if options set threads.
+bool setsThreads(const std::vector<std::string> &options) {
+  for (const std::string &option : options) {
+    if (option == "--threads" || option.rfind("--threads=", 0) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Frame pool threads of each of slidesInFlight slides converted at the
+// same time: threads, or the available cores if not set, divided among
+// slides.
+int32_t slideThreads(int32_t threads, int slidesInFlight) {
+  const int32_t cores = threads > 0 ? threads :
+                        wsiToDicomConverter::availableCpuCount();
+  return std::max<int32_t>(cores / std::max(slidesInFlight, 1), 1);
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  const std::vector<std::string> args(argv + 1, argv + argc);
+  wsiToDicomConverter::WsiRequest request;
+  BatchOptions batchOptions;
+  const int result = parseCommandLines({args}, &request, &batchOptions);
+  if (result == HELP_PRINTED) {
+    return SUCCESS;
+  }
+  if (result != SUCCESS) {
+    return result;
+  }
+  const int64_t maxMemoryMB = request.maxMemoryMB;
+  // Cores are divided among slides converted at the same time, unless a
+  // slide sets its own threads.
+  const int32_t threadsPerSlide = slideThreads(request.threads,
+                                               batchOptions.slidesInFlight);
+  if (!batchOptions.daemonSocket.empty()) {
+    wsiToDicomConverter::WsiToDcm::setFrameCodecThreads(
+        threadsPerSlide * std::max(batchOptions.slidesInFlight, 1));
+    // Job options not set by a job are those of the daemon command line.
+    wsiToDicomConverter::ConversionDaemon daemon(batchOptions.daemonSocket,
+        batchOptions.slidesInFlight, maxMemoryMB,
+        [&args, threadsPerSlide](const std::vector<std::string> &jobArgs,
+                                 wsiToDicomConverter::WsiRequest *jobRequest) {
+          BatchOptions jobBatchOptions;
+          if (parseCommandLines({jobArgs, args}, jobRequest,
+                                &jobBatchOptions) != SUCCESS) {
+            return false;
+          }
+          if (!setsThreads(jobArgs)) {
+            jobRequest->threads = threadsPerSlide;
+          }
+          return true;
+        });
+    return daemon.run();
+  }
+  if (batchOptions.manifest.empty()) {
+    wsiToDicomConverter::WsiToDcm::setFrameCodecThreads(request.threads);
+    wsiToDicomConverter::WsiToDcm converter(&request);
+    return converter.wsi2dcm();
+  }
+  std::vector<wsiToDicomConverter::BatchManifestRow> rows;
+  std::string errorMsg;
+  if (!wsiToDicomConverter::readBatchManifest(batchOptions.manifest, &rows,
+                                              &errorMsg)) {
+    std::cerr << errorMsg << std::endl;
+    return ERROR_IN_COMMAND_LINE;
+  }
+  // Memory budget and slide options not set by manifest rows are those of
+  // the command line.
+  wsiToDicomConverter::WsiBatch batch(batchOptions.slidesInFlight,
+                                      maxMemoryMB);
+  for (const wsiToDicomConverter::BatchManifestRow &row : rows) {
+    std::vector<std::string> rowArgs = {"--input", row.inputFile,
+                                        "--outFolder", row.outputFolder};
+    if (!row.jsonFile.empty()) {
+      rowArgs.push_back("--jsonFile");
+      rowArgs.push_back(row.jsonFile);
+    }
+    rowArgs.insert(rowArgs.end(), row.options.begin(), row.options.end());
+    std::unique_ptr<wsiToDicomConverter::WsiRequest> rowRequest =
+        std::make_unique<wsiToDicomConverter::WsiRequest>();
+    BatchOptions rowBatchOptions;
+    if (parseCommandLines({rowArgs, args}, rowRequest.get(),
+                          &rowBatchOptions) != SUCCESS) {
+      std::cerr << "Invalid batch manifest row at line " << row.lineNumber <<
+                   std::endl;
+      return ERROR_IN_COMMAND_LINE;
+    }
+    if (!setsThreads(row.options)) {
+      rowRequest->threads = threadsPerSlide;
+    }
+    if (!batch.addSlide(std::move(rowRequest))) {
+      std::cerr << "Invalid batch manifest row at line " << row.lineNumber <<
+                   std::endl;
+      return ERROR_IN_COMMAND_LINE;
+    }
+  }
+  wsiToDicomConverter::WsiToDcm::setFrameCodecThreads(
+      threadsPerSlide * std::max(batchOptions.slidesInFlight, 1));
+  return batch.run() == 0 ? SUCCESS : 1;
 }
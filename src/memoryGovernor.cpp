@@ -0,0 +1,112 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/memoryGovernor.h"
+
+#include <boost/log/trivial.hpp>
+#include <boost/thread/lock_guard.hpp>
+
+#include <algorithm>
+#include <chrono>
+
+namespace wsiToDicomConverter {
+
+MemoryGovernor::MemoryGovernor(int64_t budgetBytes) :
+                                        budgetBytes_(budgetBytes),
+                                        workBytes_(0),
+                                        workReservations_(0),
+                                        heldBytes_(0),
+                                        peakReservedBytes_(0),
+                                        throttledReservations_(0),
+                                        throttledSeconds_(0.0),
+                                        serializedWarning_(false) {}
+
+void MemoryGovernor::reserveWork(int64_t bytes) {
+  boost::unique_lock<boost::mutex> lock(mutex_);
+  if (workReservations_ > 0 && workBytes_ + bytes > budgetBytes_) {
+    const std::chrono::steady_clock::time_point start =
+                                              std::chrono::steady_clock::now();
+    while (workReservations_ > 0 && workBytes_ + bytes > budgetBytes_) {
+      released_.wait(lock);
+    }
+    throttledReservations_ += 1;
+    throttledSeconds_ += std::chrono::duration<double>(
+                            std::chrono::steady_clock::now() - start).count();
+  }
+  if (bytes > budgetBytes_ && !serializedWarning_) {
+    serializedWarning_ = true;
+    BOOST_LOG_TRIVIAL(warning) << "Memory budget of " <<
+        budgetBytes_ / (1024 * 1024) << " MB is smaller than work of " <<
+        bytes / (1024 * 1024) << " MB; work runs one at a time.";
+  }
+  workBytes_ += bytes;
+  workReservations_ += 1;
+  peakReservedBytes_ = std::max(peakReservedBytes_, workBytes_ + heldBytes_);
+}
+
+void MemoryGovernor::releaseWork(int64_t bytes) {
+  {
+    boost::lock_guard<boost::mutex> lock(mutex_);
+    workBytes_ -= bytes;
+    workReservations_ -= 1;
+  }
+  released_.notify_all();
+}
+
+void MemoryGovernor::waitForBudget(int64_t bytes) {
+  boost::unique_lock<boost::mutex> lock(mutex_);
+  while (workReservations_ > 0 && workBytes_ + bytes > budgetBytes_) {
+    released_.wait(lock);
+  }
+}
+
+void MemoryGovernor::hold(int64_t bytes) {
+  boost::lock_guard<boost::mutex> lock(mutex_);
+  heldBytes_ += bytes;
+  peakReservedBytes_ = std::max(peakReservedBytes_, workBytes_ + heldBytes_);
+}
+
+void MemoryGovernor::releaseHeld(int64_t bytes) {
+  {
+    boost::lock_guard<boost::mutex> lock(mutex_);
+    heldBytes_ -= bytes;
+  }
+  released_.notify_all();
+}
+
+int64_t MemoryGovernor::budgetBytes() const {
+  return budgetBytes_;
+}
+
+int64_t MemoryGovernor::reservedBytes() const {
+  boost::lock_guard<boost::mutex> lock(mutex_);
+  return workBytes_ + heldBytes_;
+}
+
+int64_t MemoryGovernor::peakReservedBytes() const {
+  boost::lock_guard<boost::mutex> lock(mutex_);
+  return peakReservedBytes_;
+}
+
+int64_t MemoryGovernor::throttledReservations() const {
+  boost::lock_guard<boost::mutex> lock(mutex_);
+  return throttledReservations_;
+}
+
+double MemoryGovernor::throttledSeconds() const {
+  boost::lock_guard<boost::mutex> lock(mutex_);
+  return throttledSeconds_;
+}
+
+}  // namespace wsiToDicomConverter
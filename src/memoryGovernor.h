@@ -0,0 +1,74 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SRC_MEMORYGOVERNOR_H_
+#define SRC_MEMORYGOVERNOR_H_
+
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include <cstdint>
+
+namespace wsiToDicomConverter {
+
+/* Bounds memory held by frames and files of a conversion.
+
+   Work, e.g. a frame being read, resampled and compressed, reserves its
+   working memory before it starts; reserveWork blocks while reserved work
+   would exceed the budget. Memory held by completed work, e.g. encoded
+   frames of a file being written, is reported with reserved work but
+   does not block admission, since it is only released by writing files
+   and does not shrink as work completes. To guarantee progress, work is
+   admitted whenever no other work reservation is outstanding, even if it
+   alone exceeds the budget.
+*/
+class MemoryGovernor {
+ public:
+  explicit MemoryGovernor(int64_t budgetBytes);
+  MemoryGovernor(const MemoryGovernor &) = delete;
+  MemoryGovernor &operator =(const MemoryGovernor &) = delete;
+
+  void reserveWork(int64_t bytes);
+  void releaseWork(int64_t bytes);
+
+  // Blocks as reserveWork would, without reserving bytes. Admits work,
+  // e.g. a slide, which reserves its memory as it runs.
+  void waitForBudget(int64_t bytes);
+
+  void hold(int64_t bytes);
+  void releaseHeld(int64_t bytes);
+
+  int64_t budgetBytes() const;
+  int64_t reservedBytes() const;
+  int64_t peakReservedBytes() const;
+  // Number of reserveWork calls which blocked and time spent blocked.
+  int64_t throttledReservations() const;
+  double throttledSeconds() const;
+
+ private:
+  const int64_t budgetBytes_;
+  mutable boost::mutex mutex_;
+  boost::condition_variable released_;
+  int64_t workBytes_;
+  int64_t workReservations_;
+  int64_t heldBytes_;
+  int64_t peakReservedBytes_;
+  int64_t throttledReservations_;
+  double throttledSeconds_;
+  bool serializedWarning_;
+};
+
+}  // namespace wsiToDicomConverter
+
+#endif  // SRC_MEMORYGOVERNOR_H_
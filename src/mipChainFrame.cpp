@@ -0,0 +1,92 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/mipChainFrame.h"
+
+#include <boost/gil/typedefs.hpp>
+#include <boost/thread/lock_guard.hpp>
+
+#include <algorithm>
+#include <utility>
+
+#include "src/gilUtil.h"
+#include "src/zlibWrapper.h"
+
+namespace wsiToDicomConverter {
+
+MipChainFrame::MipChainFrame(int64_t locationX, int64_t locationY,
+                             int64_t frameWidth, int64_t frameHeight,
+                             DCM_Compression compression, int quality,
+                             JpegSubsampling sampling, bool storeRawBytes,
+                             int64_t pendingBlocks) : Frame(locationX,
+                                                            locationY,
+                                                            frameWidth,
+                                                            frameHeight,
+                                                            compression,
+                                                            quality,
+                                                            sampling,
+                                                            storeRawBytes),
+                                                      pendingBlocks_(
+                                                          pendingBlocks) {}
+
+MipChainFrame::~MipChainFrame() {}
+
+void MipChainFrame::sliceFrame() {}
+
+void MipChainFrame::incSourceFrameReadCounter() {}
+
+void MipChainFrame::addBlock(
+                    const std::function<void(uint32_t *pixels)> &write) {
+  {
+    boost::lock_guard<boost::mutex> lock(mutex_);
+    if (pixels_ == nullptr) {
+      // Samples outside of the level are transparent, as openslide reads
+      // them.
+      pixels_ = std::make_unique<uint32_t[]>(frameWidth_ * frameHeight_);
+      std::fill(pixels_.get(), pixels_.get() + frameWidth_ * frameHeight_,
+                0);
+    }
+    write(pixels_.get());
+    pendingBlocks_ -= 1;
+    if (pendingBlocks_ > 0) {
+      return;
+    }
+  }
+  compressPixels();
+}
+
+void MipChainFrame::compressPixels() {
+  const int64_t frameMemSize = frameWidth_ * frameHeight_;
+  boost::gil::rgba8c_view_t gil = boost::gil::interleaved_view(
+              frameWidth_, frameHeight_,
+              reinterpret_cast<const boost::gil::rgba8c_pixel_t *>(
+                                                              pixels_.get()),
+              frameWidth_ * sizeof(uint32_t));
+  if (storeRawBytes_) {
+    rawCompressedBytes_ = std::move(compress_memory(
+                reinterpret_cast<uint8_t*>(pixels_.get()), frameMemSize *
+                              sizeof(uint32_t), &rawCompressedBytesSize_));
+  }
+  boost::gil::rgb8_image_t exp(frameWidth_, frameHeight_);
+  boost::gil::rgb8_view_t rgbView = view(exp);
+  boost::gil::copy_and_convert_pixels(gil, rgbView, convert_rgba_to_rgb());
+  pixels_ = nullptr;
+  uint64_t size;
+  std::unique_ptr<uint8_t[]>mem = std::move(compressor_->compress(rgbView,
+                                                                  &size));
+  setDicomFrameBytes(std::move(mem), size);
+  setDone();
+}
+
+}  // namespace wsiToDicomConverter
@@ -0,0 +1,59 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SRC_MIPCHAINFRAME_H_
+#define SRC_MIPCHAINFRAME_H_
+
+#include <boost/thread/mutex.hpp>
+
+#include <functional>
+#include <memory>
+
+#include "src/frame.h"
+
+namespace wsiToDicomConverter {
+
+// Frame of a level generated by MipChainPyramid. Frame pixels are written
+// by the workers of the level 0 blocks the frame's samples lie in; the
+// frame is compressed by the worker which writes its last block.
+class MipChainFrame : public Frame {
+ public:
+  // locationX, locationY - top-left corner of frame in level coordinates
+  // pendingBlocks - number of level 0 blocks frame's samples lie in
+  MipChainFrame(int64_t locationX, int64_t locationY, int64_t frameWidth,
+                int64_t frameHeight, DCM_Compression compression,
+                int quality, JpegSubsampling sampling, bool storeRawBytes,
+                int64_t pendingBlocks);
+
+  virtual ~MipChainFrame();
+  // Frame is generated by MipChainPyramid workers; does nothing.
+  virtual void sliceFrame();
+  virtual void incSourceFrameReadCounter();
+
+  // Calls write with frame's openslide ARGB pixels, frameWidth x
+  // frameHeight, to add samples of a block. Compresses frame after the
+  // last pending block is added. Thread safe.
+  void addBlock(const std::function<void(uint32_t *pixels)> &write);
+
+ private:
+  void compressPixels();
+
+  boost::mutex mutex_;
+  int64_t pendingBlocks_;
+  std::unique_ptr<uint32_t[]> pixels_;
+};
+
+}  // namespace wsiToDicomConverter
+
+#endif  // SRC_MIPCHAINFRAME_H_
@@ -0,0 +1,223 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/mipChainPyramid.h"
+
+#include <boost/asio/post.hpp>
+#include <boost/log/trivial.hpp>
+
+#include <algorithm>
+#include <utility>
+
+namespace wsiToDicomConverter {
+
+MipChainPyramid::MipChainPyramid(OpenSlidePool *pool, int64_t level0X,
+                                 int64_t level0Y, int64_t level0Width,
+                                 int64_t level0Height, int64_t blockSize,
+                                 int quality, JpegSubsampling sampling) :
+                                   pool_(pool), level0X_(level0X),
+                                   level0Y_(level0Y),
+                                   level0Width_(level0Width),
+                                   level0Height_(level0Height),
+                                   minBlockSize_(std::max<int64_t>(blockSize,
+                                                                   1)),
+                                   blockSize_(0), quality_(quality),
+                                   sampling_(sampling), governor_(nullptr) {}
+
+MipChainPyramid::~MipChainPyramid() {
+  join();
+}
+
+void MipChainPyramid::addLevel(size_t levelIndex, int64_t downsample,
+                               int64_t levelWidth, int64_t levelHeight,
+                               int64_t frameWidth, int64_t frameHeight,
+                               DCM_Compression compression,
+                               bool storeRawBytes) {
+  Level &level = levels_[levelIndex];
+  level.downsample = std::max<int64_t>(downsample, 1);
+  level.width = levelWidth;
+  level.height = levelHeight;
+  level.frameWidth = frameWidth;
+  level.frameHeight = frameHeight;
+  level.compression = compression;
+  level.storeRawBytes = storeRawBytes;
+  level.framesPerRow = (levelWidth + frameWidth - 1) / frameWidth;
+}
+
+bool MipChainPyramid::hasLevel(size_t levelIndex) const {
+  return levels_.find(levelIndex) != levels_.end();
+}
+
+void MipChainPyramid::setMemoryGovernor(MemoryGovernor *governor) {
+  governor_ = governor;
+}
+
+int64_t MipChainPyramid::firstSample(int64_t level0Coord, int64_t level0Dim,
+                                     int64_t levelDim) {
+  return std::min((level0Coord * levelDim + level0Dim - 1) / level0Dim,
+                  levelDim);
+}
+
+void MipChainPyramid::initLevelFrames(Level *level) {
+  const int64_t framesPerColumn = (level->height + level->frameHeight - 1) /
+                                  level->frameHeight;
+  // Number of block columns and rows each frame column and row spans.
+  std::vector<int64_t> columnBlocks(level->framesPerRow, 0);
+  std::vector<int64_t> rowBlocks(framesPerColumn, 0);
+  for (int64_t blockX = 0; blockX < level0Width_; blockX += blockSize_) {
+    const int64_t start = firstSample(blockX, level0Width_, level->width);
+    const int64_t end = firstSample(std::min(blockX + blockSize_,
+                                             level0Width_),
+                                    level0Width_, level->width);
+    for (int64_t column = start / level->frameWidth;
+         start < end && column <= (end - 1) / level->frameWidth; ++column) {
+      columnBlocks[column] += 1;
+    }
+  }
+  for (int64_t blockY = 0; blockY < level0Height_; blockY += blockSize_) {
+    const int64_t start = firstSample(blockY, level0Height_, level->height);
+    const int64_t end = firstSample(std::min(blockY + blockSize_,
+                                             level0Height_),
+                                    level0Height_, level->height);
+    for (int64_t row = start / level->frameHeight;
+         start < end && row <= (end - 1) / level->frameHeight; ++row) {
+      rowBlocks[row] += 1;
+    }
+  }
+  level->frames.reserve(level->framesPerRow * framesPerColumn);
+  level->ownedFrames.reserve(level->framesPerRow * framesPerColumn);
+  for (int64_t row = 0; row < framesPerColumn; ++row) {
+    for (int64_t column = 0; column < level->framesPerRow; ++column) {
+      std::unique_ptr<MipChainFrame> frame = std::make_unique<MipChainFrame>(
+          column * level->frameWidth, row * level->frameHeight,
+          level->frameWidth, level->frameHeight, level->compression,
+          quality_, sampling_, level->storeRawBytes,
+          columnBlocks[column] * rowBlocks[row]);
+      level->frames.push_back(frame.get());
+      level->ownedFrames.push_back(std::move(frame));
+    }
+  }
+}
+
+void MipChainPyramid::start(size_t threads) {
+  // Blocks are aligned to the coarsest downsample so that blocks hold
+  // whole level pixels of every level.
+  int64_t coarsestDownsample = 1;
+  for (const auto &level : levels_) {
+    coarsestDownsample = std::max(coarsestDownsample,
+                                  level.second.downsample);
+  }
+  blockSize_ = ((minBlockSize_ + coarsestDownsample - 1) /
+                coarsestDownsample) * coarsestDownsample;
+  for (auto &level : levels_) {
+    initLevelFrames(&level.second);
+  }
+  BOOST_LOG_TRIVIAL(debug) << "Generating " << levels_.size() << " levels "
+                              "from " << blockCount() << " level 0 blocks of "
+                              << blockSize_ << " pixels.";
+  workers_ = std::make_unique<boost::asio::thread_pool>(
+                                          std::max<size_t>(threads, 1));
+  for (int64_t blockY = 0; blockY < level0Height_; blockY += blockSize_) {
+    for (int64_t blockX = 0; blockX < level0Width_; blockX += blockSize_) {
+      boost::asio::post(*workers_, [this, blockX, blockY]() {
+        readBlock(blockX, blockY);
+      });
+    }
+  }
+}
+
+std::vector<std::unique_ptr<Frame>> MipChainPyramid::takeLevelFrames(
+                                                          size_t levelIndex) {
+  auto level = levels_.find(levelIndex);
+  if (level == levels_.end()) {
+    return std::vector<std::unique_ptr<Frame>>();
+  }
+  return std::move(level->second.ownedFrames);
+}
+
+void MipChainPyramid::join() {
+  if (workers_ != nullptr) {
+    workers_->join();
+    workers_ = nullptr;
+  }
+}
+
+int64_t MipChainPyramid::blockSize() const {
+  return blockSize_;
+}
+
+int64_t MipChainPyramid::blockCount() const {
+  if (blockSize_ <= 0) {
+    return 0;
+  }
+  return ((level0Width_ + blockSize_ - 1) / blockSize_) *
+         ((level0Height_ + blockSize_ - 1) / blockSize_);
+}
+
+void MipChainPyramid::readBlock(int64_t blockX, int64_t blockY) {
+  const int64_t width = std::min(blockSize_, level0Width_ - blockX);
+  const int64_t height = std::min(blockSize_, level0Height_ - blockY);
+  const int64_t blockBytes = width * height * sizeof(uint32_t);
+  if (governor_ != nullptr) {
+    governor_->reserveWork(blockBytes);
+  }
+  std::unique_ptr<uint32_t[]> block = std::make_unique<uint32_t[]>(
+                                                             width * height);
+  pool_->readRegion(block.get(), level0X_ + blockX, level0Y_ + blockY, 0,
+                    width, height);
+  const uint32_t *pixels = block.get();
+  for (auto &levelEntry : levels_) {
+    const Level &level = levelEntry.second;
+    // Level pixels sampled from block.
+    const int64_t startX = firstSample(blockX, level0Width_, level.width);
+    const int64_t endX = firstSample(blockX + width, level0Width_,
+                                     level.width);
+    const int64_t startY = firstSample(blockY, level0Height_, level.height);
+    const int64_t endY = firstSample(blockY + height, level0Height_,
+                                     level.height);
+    if (startX >= endX || startY >= endY) {
+      continue;
+    }
+    for (int64_t row = startY / level.frameHeight;
+         row <= (endY - 1) / level.frameHeight; ++row) {
+      const int64_t frameY = row * level.frameHeight;
+      const int64_t firstY = std::max(startY, frameY);
+      const int64_t lastY = std::min(endY, frameY + level.frameHeight);
+      for (int64_t column = startX / level.frameWidth;
+           column <= (endX - 1) / level.frameWidth; ++column) {
+        const int64_t frameX = column * level.frameWidth;
+        const int64_t firstX = std::max(startX, frameX);
+        const int64_t lastX = std::min(endX, frameX + level.frameWidth);
+        level.frames[row * level.framesPerRow + column]->addBlock(
+            [&](uint32_t *frame) {
+              for (int64_t y = firstY; y < lastY; ++y) {
+                const uint32_t *source = pixels + ((y * level0Height_) /
+                                         level.height - blockY) * width;
+                uint32_t *dest = frame + (y - frameY) * level.frameWidth;
+                for (int64_t x = firstX; x < lastX; ++x) {
+                  dest[x - frameX] = source[(x * level0Width_) / level.width -
+                                            blockX];
+                }
+              }
+            });
+      }
+    }
+  }
+  block.reset();
+  if (governor_ != nullptr) {
+    governor_->releaseWork(blockBytes);
+  }
+}
+
+}  // namespace wsiToDicomConverter
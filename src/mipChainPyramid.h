@@ -0,0 +1,116 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SRC_MIPCHAINPYRAMID_H_
+#define SRC_MIPCHAINPYRAMID_H_
+
+#include <boost/asio/thread_pool.hpp>
+
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "src/enums.h"
+#include "src/frame.h"
+#include "src/memoryGovernor.h"
+#include "src/mipChainFrame.h"
+#include "src/openslideUtil.h"
+
+namespace wsiToDicomConverter {
+
+/* Generates the frames of several pyramid levels in one pass over level 0.
+
+   Level 0 is divided into square blocks whose size is a multiple of the
+   coarsest downsample. Workers read each block once and write the nearest
+   neighbor samples of every level which lie in the block into the level's
+   frames, so each level 0 pixel is read and decoded once for the whole
+   pyramid. Frames which straddle block edges are merged from the blocks
+   their samples lie in and are compressed when the last block is written.
+
+   Level pixel x samples level 0 pixel x * level0Width / levelWidth, the
+   mapping used to back project frames of other levels.
+*/
+class MipChainPyramid {
+ public:
+  // level0X, level0Y - origin of pyramid in level 0 coordinates
+  // level0Width, level0Height - dimensions of pyramid at level 0
+  // blockSize - minimum block dimension in level 0 pixels
+  MipChainPyramid(OpenSlidePool *pool, int64_t level0X, int64_t level0Y,
+                  int64_t level0Width, int64_t level0Height,
+                  int64_t blockSize, int quality, JpegSubsampling sampling);
+  MipChainPyramid(const MipChainPyramid &) = delete;
+  MipChainPyramid &operator =(const MipChainPyramid &) = delete;
+  virtual ~MipChainPyramid();
+
+  // Adds level, identified by levelIndex, to be generated. Levels are
+  // added before start.
+  void addLevel(size_t levelIndex, int64_t downsample, int64_t levelWidth,
+                int64_t levelHeight, int64_t frameWidth, int64_t frameHeight,
+                DCM_Compression compression, bool storeRawBytes);
+  bool hasLevel(size_t levelIndex) const;
+
+  // Blocks reserve their memory from governor, if not nullptr, before
+  // they are read. Set before start.
+  void setMemoryGovernor(MemoryGovernor *governor);
+
+  // Starts reading blocks, in raster order, with threads workers.
+  void start(size_t threads);
+
+  // Returns level's frames in raster order; frames are done when all the
+  // blocks they lie in have been read.
+  std::vector<std::unique_ptr<Frame>> takeLevelFrames(size_t levelIndex);
+
+  // Waits for all blocks to be read.
+  void join();
+
+  int64_t blockSize() const;
+  int64_t blockCount() const;
+
+ private:
+  struct Level {
+    int64_t downsample;
+    int64_t width;
+    int64_t height;
+    int64_t frameWidth;
+    int64_t frameHeight;
+    DCM_Compression compression;
+    bool storeRawBytes;
+    int64_t framesPerRow;
+    std::vector<MipChainFrame *> frames;
+    std::vector<std::unique_ptr<Frame>> ownedFrames;
+  };
+
+  // First level pixel which samples level 0 coordinate >= level0Coord.
+  static int64_t firstSample(int64_t level0Coord, int64_t level0Dim,
+                             int64_t levelDim);
+  void initLevelFrames(Level *level);
+  void readBlock(int64_t blockX, int64_t blockY);
+
+  OpenSlidePool *pool_;
+  const int64_t level0X_;
+  const int64_t level0Y_;
+  const int64_t level0Width_;
+  const int64_t level0Height_;
+  const int64_t minBlockSize_;
+  int64_t blockSize_;
+  const int quality_;
+  const JpegSubsampling sampling_;
+  std::map<size_t, Level> levels_;
+  MemoryGovernor *governor_;
+  std::unique_ptr<boost::asio::thread_pool> workers_;
+};
+
+}  // namespace wsiToDicomConverter
+
+#endif  // SRC_MIPCHAINPYRAMID_H_
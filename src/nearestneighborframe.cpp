@@ -22,6 +22,7 @@
 #include <utility>
 
 #include "src/dicom_file_region_reader.h"
+#include "src/gilUtil.h"
 #include "src/jpegCompression.h"
 #include "src/nearestneighborframe.h"
 #include "src/rawCompression.h"
@@ -30,9 +31,10 @@
 namespace wsiToDicomConverter {
 
 NearestNeighborFrame::NearestNeighborFrame(
-    OpenSlidePtr *osptr, int64_t locationX, int64_t locationY, int64_t level,
-    int64_t frameWidthDownsampled, int64_t frameHeightDownsampled,
-    double multiplicator, int64_t frameWidth, int64_t frameHeight,
+    OpenSlidePool *osPool, int64_t locationX, int64_t locationY,
+    int64_t level, int64_t frameWidthDownsampled,
+    int64_t frameHeightDownsampled, double multiplicator, int64_t frameWidth,
+    int64_t frameHeight,
     DCM_Compression compression, int quality, JpegSubsampling sampling,
     bool storeRawBytes,
     DICOMFileFrameRegionReader *frame_region_reader): Frame(locationX,
@@ -42,7 +44,7 @@ NearestNeighborFrame::NearestNeighborFrame(
                                                         compression, quality,
                                                         sampling,
                                                         storeRawBytes) {
-  osptr_ = osptr;
+  osPool_ = osPool;
   level_ = level;
   frameWidthDownsampled_ = frameWidthDownsampled;
   frameHeightDownsampled_ = frameHeightDownsampled;
@@ -52,23 +54,6 @@ NearestNeighborFrame::NearestNeighborFrame(
 
 NearestNeighborFrame::~NearestNeighborFrame() {}
 
-class convert_rgba_to_rgb {
- public:
-  void operator()(
-      const boost::gil::rgba8c_pixel_t &src,
-      boost::gil::rgb8_pixel_t &dst) const {  // NOLINT, boost template
-    boost::gil::get_color(dst, boost::gil::blue_t()) =
-        boost::gil::channel_multiply(get_color(src, boost::gil::red_t()),
-                                     get_color(src, boost::gil::alpha_t()));
-    boost::gil::get_color(dst, boost::gil::green_t()) =
-        boost::gil::channel_multiply(get_color(src, boost::gil::green_t()),
-                                     get_color(src, boost::gil::alpha_t()));
-    boost::gil::get_color(dst, boost::gil::red_t()) =
-        boost::gil::channel_multiply(get_color(src, boost::gil::blue_t()),
-                                     get_color(src, boost::gil::alpha_t()));
-  }
-};
-
 void NearestNeighborFrame::incSourceFrameReadCounter() {
   if (dcmFrameRegionReader_->dicomFileCount() != 0) {
     dcmFrameRegionReader_->incSourceFrameReadCounter(locationX_, locationY_,
@@ -77,19 +62,51 @@ void NearestNeighborFrame::incSourceFrameReadCounter() {
   }
 }
 
-void NearestNeighborFrame::sliceFrame() {
+void NearestNeighborFrame::setRegionBand(
+                              std::shared_ptr<OpenSlideRegionBand> regionBand) {
+  regionBand->addRegion(locationX_, locationY_, frameWidthDownsampled_,
+                        frameHeightDownsampled_,
+                        static_cast<int64_t>(locationX_ * multiplicator_),
+                        static_cast<int64_t>(locationY_ * multiplicator_));
+  regionBands_.push_back(std::move(regionBand));
+}
+
+void NearestNeighborFrame::setReadPlan(OpenSlideReadPlan *readPlan) {
+  regionBands_ = readPlan->addRegion(locationX_, locationY_,
+                                     frameWidthDownsampled_,
+                                     frameHeightDownsampled_);
+}
+
+void NearestNeighborFrame::readFrameSource() {
   std::unique_ptr<uint32_t[]>buf =
                           std::make_unique<uint32_t[]>(frameWidthDownsampled_ *
                                                       frameHeightDownsampled_);
+  // Dimensions of region read into buf.
+  int64_t regionWidth = frameWidthDownsampled_;
+  int64_t regionHeight = frameHeightDownsampled_;
   if (dcmFrameRegionReader_->dicomFileCount() == 0) {
-    openslide_read_region(osptr_->osr(), buf.get(),
+    if (osPool_->readDownsampledRegion(buf.get(), locationX_, locationY_,
+                                       level_, frameWidthDownsampled_,
+                                       frameHeightDownsampled_, frameWidth_,
+                                       frameHeight_)) {
+      // Read at frame resolution; region is not resized.
+      regionWidth = frameWidth_;
+      regionHeight = frameHeight_;
+      for (const auto &regionBand : regionBands_) {
+        regionBand->skipRegion();
+      }
+    } else if (!regionBands_.empty()) {
+      for (const auto &regionBand : regionBands_) {
+        regionBand->readRegion(buf.get(), locationX_, locationY_,
+                               frameWidthDownsampled_,
+                               frameHeightDownsampled_);
+      }
+    } else {
+      osPool_->readRegion(buf.get(),
                           static_cast<int64_t>(locationX_ * multiplicator_),
                           static_cast<int64_t>(locationY_ * multiplicator_),
                           level_, frameWidthDownsampled_,
                           frameHeightDownsampled_);
-    if (openslide_get_error(osptr_->osr())) {
-      BOOST_LOG_TRIVIAL(error) << openslide_get_error(osptr_->osr());
-      throw 1;
     }
   } else {
     if (!dcmFrameRegionReader_->readRegion(locationX_, locationY_,
@@ -101,15 +118,25 @@ void NearestNeighborFrame::sliceFrame() {
       throw 1;
     }
   }
+  sourcePixels_ = std::move(buf);
+  sourceWidth_ = regionWidth;
+  sourceHeight_ = regionHeight;
+}
+
+void NearestNeighborFrame::sliceFrame() {
+  if (sourcePixels_ == nullptr) {
+    readFrameSource();
+  }
+  std::unique_ptr<uint32_t[]> buf = std::move(sourcePixels_);
+  const int64_t regionWidth = sourceWidth_;
+  const int64_t regionHeight = sourceHeight_;
   boost::gil::rgba8c_view_t gil = boost::gil::interleaved_view(
-              frameWidthDownsampled_,
-              frameHeightDownsampled_,
+              regionWidth, regionHeight,
               reinterpret_cast<const boost::gil::rgba8c_pixel_t *>(buf.get()),
-              frameWidthDownsampled_ * sizeof(uint32_t));
+              regionWidth * sizeof(uint32_t));
 
   boost::gil::rgba8_image_t newFrame(frameWidth_, frameHeight_);
-  if (frameWidthDownsampled_ != frameWidth_ ||
-      frameHeightDownsampled_ != frameHeight_) {
+  if (regionWidth != frameWidth_ || regionHeight != frameHeight_) {
     boost::gil::resize_view(gil, view(newFrame),
                             boost::gil::nearest_neighbor_sampler());
     gil = view(newFrame);
@@ -141,7 +168,7 @@ void NearestNeighborFrame::sliceFrame() {
   std::unique_ptr<uint8_t[]>mem = std::move(compressor_->compress(rgbView,
                                                                   &size));
   setDicomFrameBytes(std::move(mem), size);
-  done_ = true;
+  setDone();
 }
 
 }  // namespace wsiToDicomConverter
@@ -30,7 +30,7 @@ namespace wsiToDicomConverter {
 // downsampled from level captured at higher magnification.
 class NearestNeighborFrame : public Frame {
  public:
-  // osr - openslide
+  // osPool - pool of openslide handles to read from
   // locationX, locationY - top-left corner of frame in level coordinates
   // frameWidthDownsampled, frameHeightDownsampled - size of frame to get
   // multiplicator - size difference between 0 level and current one
@@ -43,7 +43,7 @@ class NearestNeighborFrame : public Frame {
   // frame_region_reader - frame reader for raw frame data from prior level.
   //                       Used to generate downsamples directly from prior
   //                       downsampled level.
-  NearestNeighborFrame(OpenSlidePtr *osptr, int64_t locationX,
+  NearestNeighborFrame(OpenSlidePool *osPool, int64_t locationX,
                        int64_t locationY, int64_t level,
                        int64_t frameWidthDownsampled,
                        int64_t frameHeightDownsampled, double multiplicator,
@@ -56,15 +56,26 @@ class NearestNeighborFrame : public Frame {
   virtual ~NearestNeighborFrame();
   // Gets frame by openslide library, performs scaling it and compressing
   virtual void sliceFrame();
+  virtual void readFrameSource();
   virtual void incSourceFrameReadCounter();
+  // Reads frame's openslide region from band shared with other frames.
+  void setRegionBand(std::shared_ptr<OpenSlideRegionBand> regionBand);
+  // Reads frame's openslide region from native tile aligned blocks of
+  // plan.
+  void setReadPlan(OpenSlideReadPlan *readPlan);
 
  private:
-  OpenSlidePtr *osptr_;
+  OpenSlidePool *osPool_;
+  std::vector<std::shared_ptr<OpenSlideRegionBand>> regionBands_;
   int64_t level_;
   int64_t frameWidthDownsampled_;
   int64_t frameHeightDownsampled_;
   double multiplicator_;
   DICOMFileFrameRegionReader *dcmFrameRegionReader_;
+  // Source region read by readFrameSource.
+  std::unique_ptr<uint32_t[]> sourcePixels_;
+  int64_t sourceWidth_ = 0;
+  int64_t sourceHeight_ = 0;
 };
 
 }  // namespace wsiToDicomConverter
@@ -0,0 +1,192 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/numaWorkerPool.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <boost/asio/post.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/log/trivial.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/lock_guard.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <string>
+#include <utility>
+
+namespace wsiToDicomConverter {
+
+namespace {
+
+// Workers of a group wait for each other once pinned so that every worker
+// runs exactly one pinning task.
+struct PinLatch {
+  boost::mutex mutex;
+  boost::condition_variable allPinned;
+  size_t remaining;
+};
+
+void pinCurrentThread(const std::vector<int32_t> &cpus) {
+  cpu_set_t cpuSet;
+  CPU_ZERO(&cpuSet);
+  for (int32_t cpu : cpus) {
+    CPU_SET(cpu, &cpuSet);
+  }
+  if (pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet) != 0) {
+    BOOST_LOG_TRIVIAL(warning) << "Could not pin worker thread to NUMA node.";
+  }
+}
+
+}  // namespace
+
+bool parseCpuList(absl::string_view cpuList, std::vector<int32_t> *cpus) {
+  cpus->clear();
+  std::string list = static_cast<std::string>(cpuList);
+  list.erase(std::remove_if(list.begin(), list.end(), ::isspace), list.end());
+  if (list.empty()) {
+    return true;
+  }
+  size_t start = 0;
+  while (start <= list.size()) {
+    size_t end = list.find(',', start);
+    if (end == std::string::npos) {
+      end = list.size();
+    }
+    const std::string range = list.substr(start, end - start);
+    const size_t dash = range.find('-');
+    try {
+      size_t parsed;
+      const int32_t first = std::stoi(range, &parsed);
+      int32_t last = first;
+      if (dash != std::string::npos) {
+        if (parsed != dash) {
+          return false;
+        }
+        last = std::stoi(range.substr(dash + 1), &parsed);
+        parsed += dash + 1;
+      }
+      if (parsed != range.size() || first < 0 || last < first) {
+        return false;
+      }
+      for (int32_t cpu = first; cpu <= last; ++cpu) {
+        cpus->push_back(cpu);
+      }
+    } catch (...) {
+      return false;
+    }
+    start = end + 1;
+  }
+  return true;
+}
+
+std::vector<NumaNode> readNumaNodes(absl::string_view nodeRoot) {
+  std::vector<NumaNode> nodes;
+  const boost::filesystem::path rootPath(static_cast<std::string>(nodeRoot));
+  boost::system::error_code error;
+  if (!boost::filesystem::is_directory(rootPath, error)) {
+    return nodes;
+  }
+  cpu_set_t affinity;
+  CPU_ZERO(&affinity);
+  const bool hasAffinity = sched_getaffinity(0, sizeof(affinity),
+                                             &affinity) == 0;
+  for (const boost::filesystem::directory_entry &entry :
+       boost::filesystem::directory_iterator(rootPath, error)) {
+    const std::string name = entry.path().filename().string();
+    if (name.compare(0, 4, "node") != 0 || name.size() == 4 ||
+        name.find_first_not_of("0123456789", 4) != std::string::npos) {
+      continue;
+    }
+    std::ifstream cpuListFile((entry.path() / "cpulist").string());
+    std::string cpuList;
+    std::getline(cpuListFile, cpuList);
+    NumaNode node;
+    node.id = std::stoi(name.substr(4));
+    if (!parseCpuList(cpuList, &node.cpus)) {
+      continue;
+    }
+    if (hasAffinity) {
+      node.cpus.erase(std::remove_if(node.cpus.begin(), node.cpus.end(),
+                                     [&affinity](int32_t cpu) {
+                                       return cpu >= CPU_SETSIZE ||
+                                              !CPU_ISSET(cpu, &affinity);
+                                     }), node.cpus.end());
+    }
+    if (!node.cpus.empty()) {
+      nodes.push_back(std::move(node));
+    }
+  }
+  std::sort(nodes.begin(), nodes.end(),
+            [](const NumaNode &a, const NumaNode &b) { return a.id < b.id; });
+  return nodes;
+}
+
+NumaWorkerPool::NumaWorkerPool(const std::vector<NumaNode> &nodes,
+                               size_t threads) {
+  size_t totalCpus = 0;
+  for (const NumaNode &node : nodes) {
+    totalCpus += node.cpus.size();
+  }
+  for (const NumaNode &node : nodes) {
+    const size_t groupThreads = std::max<size_t>(
+        1, (threads * node.cpus.size() + totalCpus / 2) / totalCpus);
+    nodeThreads_.push_back(groupThreads);
+    pools_.push_back(std::make_unique<boost::asio::thread_pool>(
+                                                            groupThreads));
+    std::shared_ptr<PinLatch> latch = std::make_shared<PinLatch>();
+    latch->remaining = groupThreads;
+    for (size_t idx = 0; idx < groupThreads; ++idx) {
+      boost::asio::post(*pools_.back(), [latch, cpus = node.cpus]() {
+        pinCurrentThread(cpus);
+        boost::unique_lock<boost::mutex> lock(latch->mutex);
+        latch->remaining -= 1;
+        if (latch->remaining == 0) {
+          latch->allPinned.notify_all();
+          return;
+        }
+        while (latch->remaining > 0) {
+          latch->allPinned.wait(lock);
+        }
+      });
+    }
+  }
+}
+
+NumaWorkerPool::~NumaWorkerPool() {
+  join();
+}
+
+size_t NumaWorkerPool::nodeCount() const {
+  return pools_.size();
+}
+
+size_t NumaWorkerPool::nodeThreads(size_t node) const {
+  return nodeThreads_.at(node);
+}
+
+void NumaWorkerPool::post(size_t node, std::function<void()> task) {
+  boost::asio::post(*pools_.at(node % pools_.size()), std::move(task));
+}
+
+void NumaWorkerPool::join() {
+  for (std::unique_ptr<boost::asio::thread_pool> &pool : pools_) {
+    pool->join();
+  }
+}
+
+}  // namespace wsiToDicomConverter
@@ -0,0 +1,70 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SRC_NUMAWORKERPOOL_H_
+#define SRC_NUMAWORKERPOOL_H_
+
+#include <absl/strings/string_view.h>
+#include <boost/asio/thread_pool.hpp>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace wsiToDicomConverter {
+
+struct NumaNode {
+  int32_t id;
+  // CPUs of node the process may run on.
+  std::vector<int32_t> cpus;
+};
+
+// Parses Linux cpulist format, e.g. "0-3,8,10-11". Returns false if list
+// is malformed.
+bool parseCpuList(absl::string_view cpuList, std::vector<int32_t> *cpus);
+
+// Reads NUMA nodes from sysfs node directory, e.g.
+// /sys/devices/system/node. CPUs outside the process's affinity mask are
+// excluded; nodes without CPUs are not returned.
+std::vector<NumaNode> readNumaNodes(absl::string_view nodeRoot);
+
+/* Worker group per NUMA node; each group's threads are pinned to the
+   node's CPUs.
+
+   Buffers allocated and first written by a pinned worker are placed in
+   the node's memory by the kernel's default first touch policy, so a
+   task's reads, intermediates and encoded output stay on one node.
+*/
+class NumaWorkerPool {
+ public:
+  // threads are split across nodes in proportion to nodes' CPUs, at least
+  // one per node.
+  NumaWorkerPool(const std::vector<NumaNode> &nodes, size_t threads);
+  NumaWorkerPool(const NumaWorkerPool &) = delete;
+  NumaWorkerPool &operator =(const NumaWorkerPool &) = delete;
+  virtual ~NumaWorkerPool();
+
+  size_t nodeCount() const;
+  size_t nodeThreads(size_t node) const;
+  void post(size_t node, std::function<void()> task);
+  void join();
+
+ private:
+  std::vector<std::unique_ptr<boost::asio::thread_pool>> pools_;
+  std::vector<size_t> nodeThreads_;
+};
+
+}  // namespace wsiToDicomConverter
+
+#endif  // SRC_NUMAWORKERPOOL_H_
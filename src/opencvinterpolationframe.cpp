@@ -31,7 +31,7 @@
 namespace wsiToDicomConverter {
 
 OpenCVInterpolationFrame::OpenCVInterpolationFrame(
-    OpenSlidePtr *osptr, int64_t locationX, int64_t locationY, int32_t level,
+    OpenSlidePool *osPool, int64_t locationX, int64_t locationY, int32_t level,
     int64_t frameWidthDownsampled, int64_t frameHeightDownsampled,
     int64_t frameWidth, int64_t frameHeight, DCM_Compression compression,
     int quality,  JpegSubsampling subsampling, int64_t levelWidth,
@@ -44,7 +44,7 @@ OpenCVInterpolationFrame::OpenCVInterpolationFrame(
                                                       compression, quality,
                                                            subsampling,
                                                            storeRawBytes) {
-  osptr_ = osptr;
+  osPool_ = osPool;
   level_ = level;
   frameWidthDownsampled_ = frameWidthDownsampled;
   frameHeightDownsampled_ = frameHeightDownsampled;
@@ -123,10 +123,78 @@ void OpenCVInterpolationFrame::incSourceFrameReadCounter() {
   }
 }
 
-void OpenCVInterpolationFrame::sliceFrame() {
-  // Downsamples a rectangular region a layer of a SVS and compresses frame
-  // output.
+void OpenCVInterpolationFrame::setRegionBand(
+                              std::shared_ptr<OpenSlideRegionBand> regionBand) {
+  regionBand->addRegion(locationX_ - padLeft_, locationY_ - padTop_,
+                        frameWidthDownsampled_ + padWidth_,
+                        frameHeightDownsampled_ + padHeight_, level0X(),
+                        level0Y());
+  regionBands_.push_back(std::move(regionBand));
+}
+
+void OpenCVInterpolationFrame::setReadPlan(OpenSlideReadPlan *readPlan) {
+  regionBands_ = readPlan->addRegion(locationX_ - padLeft_,
+                                     locationY_ - padTop_,
+                                     frameWidthDownsampled_ + padWidth_,
+                                     frameHeightDownsampled_ + padHeight_);
+}
+
+int64_t OpenCVInterpolationFrame::level0X() const {
+  return ((locationX_ - padLeft_) * level0Width_) / levelWidth_;
+}
+
+int64_t OpenCVInterpolationFrame::level0Y() const {
+  return ((locationY_ - padTop_) * level0Height_) / levelHeight_;
+}
+
+// Converts openslide ARGB pixels, premultiplied by alpha, to R, G, B, A
+// bytes.
+static void openslideToRGBA(uint32_t *pixels, int64_t count) {
+  for (int64_t x = 0; x < count; ++x) {
+    const uint32_t pixel = pixels[x];  // Pixel value to be downsampled
+    const int alpha = pixel >> 24;            // Alpha value of pixel
+    if (alpha == 0) {                         // If transparent skip
+      continue;
+    }
+    uint32_t red = (pixel >> 16) & 0xFF;  // Get RGB Bytes
+    uint32_t green = (pixel >> 8) & 0xFF;
+    uint32_t blue = pixel & 0xFF;
+    // Uncommon, openslide C++ API premults RGB by alpha.
+    // if alpha is not zero reverse transform to get RGB
+    // https://openslide.org/api/openslide_8h.html
+    if (alpha != 0xFF) {
+      red = red * 255 / alpha;
+      green = green * 255 / alpha;
+      blue = blue * 255 / alpha;
+    }
+    // Swap red and blue channel for dicom compatiability.
+    pixels[x] = (alpha << 24) | (blue << 16) | (green << 8) | red;
+  }
+}
+
+std::unique_ptr<uint32_t[]> OpenCVInterpolationFrame::readDownsampledRegion() {
+  // JPEG 2000 levels may be read directly at frame resolution from the
+  // reduced resolutions of the level's tiles.
+  if (!resized_ || dcmFrameRegionReader_->dicomFileCount() != 0) {
+    return nullptr;
+  }
+  std::unique_ptr<uint32_t[]> raw_bytes = std::make_unique<uint32_t[]>(
+                              static_cast<size_t>(frameWidth_ * frameHeight_));
+  if (!osPool_->readDownsampledRegion(raw_bytes.get(), locationX_,
+                                      locationY_, level_,
+                                      frameWidthDownsampled_,
+                                      frameHeightDownsampled_, frameWidth_,
+                                      frameHeight_)) {
+    return nullptr;
+  }
+  for (const auto &regionBand : regionBands_) {
+    regionBand->skipRegion();
+  }
+  openslideToRGBA(raw_bytes.get(), frameWidth_ * frameHeight_);
+  return raw_bytes;
+}
 
+std::unique_ptr<uint32_t[]> OpenCVInterpolationFrame::readSourceRegion() {
   // Allocate memory to retrieve layer data from openslide
   std::unique_ptr<uint32_t[]> buf_bytes = std::make_unique<uint32_t[]>(
                     static_cast<size_t>((frameWidthDownsampled_ + padWidth_) *
@@ -140,53 +208,25 @@ void OpenCVInterpolationFrame::sliceFrame() {
   const bool dcmFrameRegionReaderNotInitalized =
                                 dcmFrameRegionReader_->dicomFileCount() == 0;
   if (dcmFrameRegionReaderNotInitalized) {
-    // Open slide API samples using xy coordinages from level 0 image.
-    // upsample coordinates to level 0 to compute sampleing site.
-
-    const int64_t Level0_x = ((locationX_ - padLeft_) * level0Width_) /
-                             levelWidth_;
-    const int64_t Level0_y = ((locationY_ - padTop_) * level0Height_) /
-                             levelHeight_;
     // Open slide read region returns ARGB formated pixels
     // Values are pre-multiplied with alpha
     // https://github.com/openslide/openslide/wiki/PremultipliedARGB
-    openslide_read_region(osptr_->osr(), buf_bytes.get(), Level0_x,
-                          Level0_y, level_,
-                          frameWidthDownsampled_ + padWidth_,
-                           frameHeightDownsampled_ + padHeight_);
-    if (openslide_get_error(osptr_->osr())) {
-       BOOST_LOG_TRIVIAL(error) << openslide_get_error(osptr_->osr());
-       throw 1;
-    }
-    // Uncommon, openslide C++ API premults RGB by alpha.
-    // if alpha is not zero reverse transform to get RGB
-    // https://openslide.org/api/openslide_8h.html
-    const int yend = frameHeightDownsampled_ + padHeight_;
-    int yoffset = 0;
-    for (uint32_t y = 0; y < yend; ++y) {
-      const int xend = frameWidthDownsampled_ + padWidth_ + yoffset;
-      for (uint32_t x = yoffset; x < xend; ++x) {
-        const uint32_t pixel = buf_bytes[x];  // Pixel value to be downsampled
-        const int alpha = pixel >> 24;            // Alpha value of pixel
-        if (alpha == 0) {                         // If transparent skip
-          continue;
-        }
-        uint32_t red = (pixel >> 16) & 0xFF;  // Get RGB Bytes
-        uint32_t green = (pixel >> 8) & 0xFF;
-        uint32_t blue = pixel & 0xFF;
-        // Uncommon, openslide C++ API premults RGB by alpha.
-        // if alpha is not zero reverse transform to get RGB
-        // https://openslide.org/api/openslide_8h.html
-        if (alpha != 0xFF) {
-          red = red * 255 / alpha;
-          green = green * 255 / alpha;
-          blue = blue * 255 / alpha;
-        }
-        // Swap red and blue channel for dicom compatiability.
-        buf_bytes[x] = (alpha << 24) | (blue << 16) | (green << 8) | red;
+    if (!regionBands_.empty()) {
+      for (const auto &regionBand : regionBands_) {
+        regionBand->readRegion(buf_bytes.get(), locationX_ - padLeft_,
+                               locationY_ - padTop_,
+                               frameWidthDownsampled_ + padWidth_,
+                               frameHeightDownsampled_ + padHeight_);
       }
-      yoffset += frameWidthDownsampled_ + padWidth_;
+    } else {
+      // Open slide API samples using xy coordinages from level 0 image.
+      // upsample coordinates to level 0 to compute sampleing site.
+      osPool_->readRegion(buf_bytes.get(), level0X(), level0Y(), level_,
+                          frameWidthDownsampled_ + padWidth_,
+                          frameHeightDownsampled_ + padHeight_);
     }
+    openslideToRGBA(buf_bytes.get(), (frameWidthDownsampled_ + padWidth_) *
+                                     (frameHeightDownsampled_ + padHeight_));
   } else {
     if (!dcmFrameRegionReader_->readRegion(locationX_ - padLeft_,
                                       locationY_ - padTop_,
@@ -198,6 +238,11 @@ void OpenCVInterpolationFrame::sliceFrame() {
       throw 1;
     }
   }
+  return buf_bytes;
+}
+
+std::unique_ptr<uint32_t[]> OpenCVInterpolationFrame::resizeRegion(
+                                      std::unique_ptr<uint32_t[]> buf_bytes) {
   const size_t frame_mem_size = static_cast<size_t>(frameWidth_ * frameHeight_);
   std::unique_ptr<uint32_t[]> raw_bytes;
   if  (!resized_)  {
@@ -246,6 +291,28 @@ void OpenCVInterpolationFrame::sliceFrame() {
       source_yoffset  +=  resize_width;
     }
   }
+  return raw_bytes;
+}
+
+void OpenCVInterpolationFrame::readFrameSource() {
+  sourcePixels_ = readDownsampledRegion();
+  sourceAtFrameResolution_ = sourcePixels_ != nullptr;
+  if (sourcePixels_ == nullptr) {
+    sourcePixels_ = readSourceRegion();
+  }
+}
+
+void OpenCVInterpolationFrame::sliceFrame() {
+  // Downsamples a rectangular region a layer of a SVS and compresses frame
+  // output.
+  if (sourcePixels_ == nullptr) {
+    readFrameSource();
+  }
+  std::unique_ptr<uint32_t[]> raw_bytes = std::move(sourcePixels_);
+  if (!sourceAtFrameResolution_) {
+    raw_bytes = resizeRegion(std::move(raw_bytes));
+  }
+  const size_t frame_mem_size = static_cast<size_t>(frameWidth_ * frameHeight_);
 
   // Create a boot::gil view of memory in downsample_bytes
   boost::gil::rgba8c_view_t gil = boost::gil::interleaved_view(
@@ -272,7 +339,7 @@ void OpenCVInterpolationFrame::sliceFrame() {
                                    frame_mem_size * sizeof(uint32_t),
                                    &rawCompressedBytesSize_));
   }
-  done_ = true;
+  setDone();
 }
 
 }  // namespace wsiToDicomConverter
@@ -30,7 +30,7 @@ namespace wsiToDicomConverter {
 // Frame represents a single image frame from the OpenSlide library
 class OpenCVInterpolationFrame : public Frame {
  public:
-  // osr - openslide
+  // osPool - pool of openslide handles to read from
   // locationX, locationY - top-left corner of frame in source level coords.
   // frameWidhtDownsampled, frameHeightDownsampled - size of frame to get
   // frameWidht, frameHeight - size frame is scaled to
@@ -40,7 +40,7 @@ class OpenCVInterpolationFrame : public Frame {
   //                                                level being generated.
   // levelWidth, levelHeight - dimensions of source level being downsampled.
   // level0Width, level0Height - dimensions of base level (highest mag)
-  OpenCVInterpolationFrame(OpenSlidePtr *osptr, int64_t locationX,
+  OpenCVInterpolationFrame(OpenSlidePool *osPool, int64_t locationX,
                        int64_t locationY, int32_t level,
                        int64_t frameWidthDownsampled,
                        int64_t frameHeightDownsampled, int64_t frameWidth,
@@ -55,10 +55,18 @@ class OpenCVInterpolationFrame : public Frame {
   virtual ~OpenCVInterpolationFrame();
   // Gets frame by openslide library, performs scaling it and compressing
   virtual void sliceFrame();
+  virtual void readFrameSource();
   virtual void incSourceFrameReadCounter();
+  // Reads frame's padded openslide region from band shared with other
+  // frames.
+  void setRegionBand(std::shared_ptr<OpenSlideRegionBand> regionBand);
+  // Reads frame's padded openslide region from native tile aligned blocks
+  // of plan.
+  void setReadPlan(OpenSlideReadPlan *readPlan);
 
  private:
-  OpenSlidePtr *osptr_;
+  OpenSlidePool *osPool_;
+  std::vector<std::shared_ptr<OpenSlideRegionBand>> regionBands_;
   int64_t level_;
   int64_t frameWidthDownsampled_;
   int64_t frameHeightDownsampled_;
@@ -77,6 +85,22 @@ class OpenCVInterpolationFrame : public Frame {
   cv::InterpolationFlags openCVInterpolationMethod_;
 
   inline void scalefactorNormPadding(int *padding, int scalefactor);
+  // Level 0 coordinates of padded region read from openslide.
+  int64_t level0X() const;
+  int64_t level0Y() const;
+  // Reads frame at frame resolution without resizing. Returns nullptr if
+  // source level can not be read at frame resolution.
+  std::unique_ptr<uint32_t[]> readDownsampledRegion();
+  // Reads padded source region.
+  std::unique_ptr<uint32_t[]> readSourceRegion();
+  // Resizes padded source region to frame dimensions.
+  std::unique_ptr<uint32_t[]> resizeRegion(
+                                      std::unique_ptr<uint32_t[]> buf_bytes);
+
+  // Source pixels read by readFrameSource, at frame resolution if
+  // sourceAtFrameResolution_.
+  std::unique_ptr<uint32_t[]> sourcePixels_;
+  bool sourceAtFrameResolution_ = false;
 };
 
 }  // namespace wsiToDicomConverter
@@ -11,9 +11,16 @@
 // WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 // See the License for the specific language governing permissions and
 // limitations under the License.
+#include <absl/strings/str_format.h>
 #include <boost/log/trivial.hpp>
 
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <utility>
+
 #include "src/openslideUtil.h"
+#include "src/tiffRegionReader.h"
 
 namespace wsiToDicomConverter {
 
@@ -48,4 +55,457 @@ void OpenSlidePtr::_open(const char *filename) {
   }
 }
 
+// Openslide default per handle tile cache size.
+static const int64_t OPENSLIDE_DEFAULT_CACHE_BYTES = 32 * 1024 * 1024;
+
+OpenSlidePool::OpenSlidePool(const std::string &filename, size_t maxHandles,
+                             int64_t cacheSizeBytes) :
+                             filename_(filename),
+                             maxHandles_(std::max<size_t>(maxHandles, 1)),
+                             cache_(nullptr), reducedResolutionReads_(false),
+                             tileCacheCapacity_(0) {
+  int64_t simulatedCacheBytes = OPENSLIDE_DEFAULT_CACHE_BYTES;
+  if (cacheSizeBytes > 0) {
+#ifdef HAVE_OPENSLIDE_CACHE
+    cache_ = openslide_cache_create(static_cast<size_t>(cacheSizeBytes));
+    simulatedCacheBytes = cacheSizeBytes;
+    BOOST_LOG_TRIVIAL(debug) << "Openslide shared cache size: " <<
+                                cacheSizeBytes << " bytes.";
+#else
+    BOOST_LOG_TRIVIAL(warning) << "Openslide library does not support "
+                                  "setting cache size; using default cache.";
+#endif
+  }
+  // Open first handle eagerly to surface open errors and read geometry.
+  OpenSlidePtr *handle = acquire();
+  initTileGeometry(handle->osr());
+  if (!levelTileGeometry_.empty()) {
+    int64_t tileBytes = levelTileGeometry_[0].tileWidth *
+                        levelTileGeometry_[0].tileHeight * 4;
+    tileCacheCapacity_ = static_cast<size_t>(
+                             std::max<int64_t>(simulatedCacheBytes /
+                                               tileBytes, 1));
+  }
+  release(handle);
+}
+
+OpenSlidePool::~OpenSlidePool() {
+  OpenSlideCacheStats stats = cacheStats();
+  if (stats.regionReads > 0) {
+    const int64_t tiles = stats.tileHits + stats.tileMisses;
+    BOOST_LOG_TRIVIAL(debug) << absl::StrFormat(
+        "Openslide reads: %d; handles: %d; handle waits: %d; estimated tile "
+        "cache hits: %d / %d (%.1f%%); tiles decoded / unique tiles: %d / %d",
+        stats.regionReads, handles_.size(), stats.handleWaits,
+        stats.tileHits, tiles,
+        tiles > 0 ? 100.0 * stats.tileHits / tiles : 0.0, stats.tileMisses,
+        stats.uniqueTiles);
+  }
+  tiffRegionReader_ = nullptr;
+  // Handles reference cache; close them before releasing cache.
+  freeHandles_.clear();
+  handles_.clear();
+#ifdef HAVE_OPENSLIDE_CACHE
+  if (cache_ != nullptr) {
+    openslide_cache_release(static_cast<openslide_cache_t *>(cache_));
+  }
+#endif
+}
+
+OpenSlidePtr *OpenSlidePool::acquire() {
+  boost::unique_lock<boost::mutex> lock(mutex_);
+  if (freeHandles_.empty() && handles_.size() < maxHandles_) {
+    std::unique_ptr<OpenSlidePtr> handle =
+                             std::make_unique<OpenSlidePtr>(filename_);
+#ifdef HAVE_OPENSLIDE_CACHE
+    if (cache_ != nullptr) {
+      openslide_set_cache(handle->osr(),
+                          static_cast<openslide_cache_t *>(cache_));
+    }
+#endif
+    handles_.push_back(std::move(handle));
+    return handles_.back().get();
+  }
+  if (freeHandles_.empty()) {
+    {
+      boost::lock_guard<boost::mutex> statsLock(statsMutex_);
+      stats_.handleWaits += 1;
+    }
+    handleReleased_.wait(lock, [this] { return !freeHandles_.empty(); });
+  }
+  OpenSlidePtr *handle = freeHandles_.back();
+  freeHandles_.pop_back();
+  return handle;
+}
+
+void OpenSlidePool::release(OpenSlidePtr *handle) {
+  {
+    boost::lock_guard<boost::mutex> lock(mutex_);
+    freeHandles_.push_back(handle);
+  }
+  handleReleased_.notify_one();
+}
+
+void OpenSlidePool::setTiffRegionReader(
+                                  std::unique_ptr<TiffRegionReader> reader,
+                                  bool reducedResolutionReads) {
+  tiffLevelDirectory_.clear();
+  tiffLevelDownsample_.clear();
+  tiffRegionReader_ = std::move(reader);
+  reducedResolutionReads_ = reducedResolutionReads;
+  if (tiffRegionReader_ == nullptr) {
+    return;
+  }
+  OpenSlidePoolLease lease(this);
+  const int32_t levelCount = openslide_get_level_count(lease.osr());
+  int32_t tiffLevels = 0;
+  for (int32_t level = 0; level < levelCount; ++level) {
+    int64_t width, height;
+    openslide_get_level_dimensions(lease.osr(), level, &width, &height);
+    const int32_t dirIndex = tiffRegionReader_->directoryIndex(width, height);
+    tiffLevelDirectory_.push_back(dirIndex);
+    tiffLevelDownsample_.push_back(openslide_get_level_downsample(
+                                                        lease.osr(), level));
+    if (dirIndex != -1) {
+      tiffLevels += 1;
+    }
+  }
+  BOOST_LOG_TRIVIAL(debug) << "Levels read from tiff without openslide: " <<
+                              tiffLevels << " / " << levelCount;
+}
+
+void OpenSlidePool::readRegion(uint32_t *dest, int64_t x, int64_t y,
+                               int32_t level, int64_t width, int64_t height) {
+  if (level >= 0 &&
+      static_cast<size_t>(level) < tiffLevelDirectory_.size() &&
+      tiffLevelDirectory_[level] != -1) {
+    // Region origin is in level 0 coordinates.
+    const double downsample = tiffLevelDownsample_[level];
+    if (tiffRegionReader_->readRegion(tiffLevelDirectory_[level],
+                                      std::llround(x / downsample),
+                                      std::llround(y / downsample), width,
+                                      height, dest)) {
+      return;
+    }
+    BOOST_LOG_TRIVIAL(warning) << "Reading region with openslide.";
+  }
+  {
+    OpenSlidePoolLease lease(this);
+    openslide_read_region(lease.osr(), dest, x, y, level, width, height);
+    const char *error = openslide_get_error(lease.osr());
+    if (error != nullptr) {
+      BOOST_LOG_TRIVIAL(error) << error;
+      throw 1;
+    }
+  }
+  recordRead(x, y, level, width, height);
+}
+
+bool OpenSlidePool::readDownsampledRegion(uint32_t *dest, int64_t x,
+                                          int64_t y, int32_t level,
+                                          int64_t width, int64_t height,
+                                          int64_t downsampledWidth,
+                                          int64_t downsampledHeight) {
+  if (!reducedResolutionReads_ || level < 0 ||
+      static_cast<size_t>(level) >= tiffLevelDirectory_.size() ||
+      tiffLevelDirectory_[level] == -1 || downsampledWidth <= 0 ||
+      downsampledHeight <= 0) {
+    return false;
+  }
+  int32_t reduce = 0;
+  while ((downsampledWidth << (reduce + 1)) <= width) {
+    reduce += 1;
+  }
+  const int64_t scale = static_cast<int64_t>(1) << reduce;
+  if (reduce == 0 || downsampledWidth * scale != width ||
+      downsampledHeight * scale != height || x % scale != 0 ||
+      y % scale != 0 ||
+      !tiffRegionReader_->canReadReducedRegion(tiffLevelDirectory_[level],
+                                               reduce)) {
+    return false;
+  }
+  return tiffRegionReader_->readReducedRegion(tiffLevelDirectory_[level],
+                                              reduce, x / scale, y / scale,
+                                              downsampledWidth,
+                                              downsampledHeight, dest);
+}
+
+OpenSlideCacheStats OpenSlidePool::cacheStats() const {
+  boost::lock_guard<boost::mutex> lock(statsMutex_);
+  return stats_;
+}
+
+size_t OpenSlidePool::openHandleCount() const {
+  boost::lock_guard<boost::mutex> lock(mutex_);
+  return handles_.size();
+}
+
+bool OpenSlidePool::levelTileGeometry(int32_t level, int64_t *tileWidth,
+                                      int64_t *tileHeight,
+                                      double *downsample) const {
+  if (level < 0 || static_cast<size_t>(level) >= levelTileGeometry_.size()) {
+    return false;
+  }
+  const LevelTileGeometry &geometry = levelTileGeometry_[level];
+  *tileWidth = geometry.tileWidth;
+  *tileHeight = geometry.tileHeight;
+  *downsample = geometry.downsample;
+  return true;
+}
+
+void OpenSlidePool::initTileGeometry(openslide_t *osr) {
+  const int32_t levelCount = openslide_get_level_count(osr);
+  for (int32_t level = 0; level < levelCount; ++level) {
+    const char *tileWidth = openslide_get_property_value(osr,
+        absl::StrFormat("openslide.level[%d].tile-width", level).c_str());
+    const char *tileHeight = openslide_get_property_value(osr,
+        absl::StrFormat("openslide.level[%d].tile-height", level).c_str());
+    if (tileWidth == nullptr || tileHeight == nullptr) {
+      // Native tile geometry unknown; hit statistics are not estimated.
+      levelTileGeometry_.clear();
+      return;
+    }
+    LevelTileGeometry geometry;
+    geometry.downsample = openslide_get_level_downsample(osr, level);
+    geometry.tileWidth = std::max<int64_t>(std::atoll(tileWidth), 1);
+    geometry.tileHeight = std::max<int64_t>(std::atoll(tileHeight), 1);
+    levelTileGeometry_.push_back(geometry);
+  }
+}
+
+void OpenSlidePool::recordRead(int64_t x, int64_t y, int32_t level,
+                               int64_t width, int64_t height) {
+  boost::lock_guard<boost::mutex> lock(statsMutex_);
+  stats_.regionReads += 1;
+  if (level < 0 || static_cast<size_t>(level) >= levelTileGeometry_.size() ||
+      width <= 0 || height <= 0) {
+    return;
+  }
+  const LevelTileGeometry &geometry = levelTileGeometry_[level];
+  // Region origin is in level 0 coordinates; size is in level coordinates.
+  const int64_t levelX = std::max<int64_t>(
+                          static_cast<int64_t>(x / geometry.downsample), 0);
+  const int64_t levelY = std::max<int64_t>(
+                          static_cast<int64_t>(y / geometry.downsample), 0);
+  const int64_t firstColumn = levelX / geometry.tileWidth;
+  const int64_t lastColumn = (levelX + width - 1) / geometry.tileWidth;
+  const int64_t firstRow = levelY / geometry.tileHeight;
+  const int64_t lastRow = (levelY + height - 1) / geometry.tileHeight;
+  for (int64_t row = firstRow; row <= lastRow; ++row) {
+    for (int64_t column = firstColumn; column <= lastColumn; ++column) {
+      const uint64_t key = (static_cast<uint64_t>(level) << 56) |
+                           (static_cast<uint64_t>(row) << 28) |
+                           static_cast<uint64_t>(column);
+      auto found = tileLruIndex_.find(key);
+      if (found != tileLruIndex_.end()) {
+        stats_.tileHits += 1;
+        tileLru_.splice(tileLru_.begin(), tileLru_, found->second);
+        continue;
+      }
+      stats_.tileMisses += 1;
+      if (touchedTiles_.insert(key).second) {
+        stats_.uniqueTiles += 1;
+      }
+      tileLru_.push_front(key);
+      tileLruIndex_[key] = tileLru_.begin();
+      if (tileLru_.size() > tileCacheCapacity_) {
+        tileLruIndex_.erase(tileLru_.back());
+        tileLru_.pop_back();
+      }
+    }
+  }
+}
+
+OpenSlidePoolLease::OpenSlidePoolLease(OpenSlidePool *pool) : pool_(pool) {
+  handle_ = pool_->acquire();
+}
+
+OpenSlidePoolLease::~OpenSlidePoolLease() {
+  pool_->release(handle_);
+}
+
+openslide_t *OpenSlidePoolLease::osr() {
+  return handle_->osr();
+}
+
+OpenSlideRegionBand::OpenSlideRegionBand(OpenSlidePool *pool,
+                                         int32_t level) :
+                                           pool_(pool), level_(level),
+                                           fixedBounds_(false), x_(0),
+                                           y_(0), level0X_(0), level0Y_(0),
+                                           width_(0), height_(0),
+                                           pendingRegions_(0) {}
+
+OpenSlideRegionBand::OpenSlideRegionBand(OpenSlidePool *pool, int32_t level,
+                                         int64_t x, int64_t y, int64_t width,
+                                         int64_t height, int64_t level0X,
+                                         int64_t level0Y) :
+                                           pool_(pool), level_(level),
+                                           fixedBounds_(true), x_(x), y_(y),
+                                           level0X_(level0X),
+                                           level0Y_(level0Y), width_(width),
+                                           height_(height),
+                                           pendingRegions_(0) {}
+
+OpenSlideRegionBand::~OpenSlideRegionBand() {}
+
+void OpenSlideRegionBand::addRegion(int64_t x, int64_t y, int64_t width,
+                                    int64_t height, int64_t level0X,
+                                    int64_t level0Y) {
+  if (fixedBounds_) {
+    // Band is only extended to hold padding before the level origin.
+    if (x < x_) {
+      width_ += x_ - x;
+      x_ = x;
+      level0X_ = level0X;
+    }
+    if (y < y_) {
+      height_ += y_ - y;
+      y_ = y;
+      level0Y_ = level0Y;
+    }
+    pendingRegions_ += 1;
+    return;
+  }
+  const int64_t endX = pendingRegions_ == 0 ? x + width :
+                       std::max(x_ + width_, x + width);
+  const int64_t endY = pendingRegions_ == 0 ? y + height :
+                       std::max(y_ + height_, y + height);
+  if (pendingRegions_ == 0 || x < x_) {
+    x_ = x;
+    level0X_ = level0X;
+  }
+  if (pendingRegions_ == 0 || y < y_) {
+    y_ = y;
+    level0Y_ = level0Y;
+  }
+  width_ = endX - x_;
+  height_ = endY - y_;
+  pendingRegions_ += 1;
+}
+
+void OpenSlideRegionBand::readRegion(uint32_t *dest, int64_t x, int64_t y,
+                                     int64_t width, int64_t height) {
+  boost::lock_guard<boost::mutex> lock(mutex_);
+  if (pixels_ == nullptr) {
+    std::unique_ptr<uint32_t[]> pixels = std::make_unique<uint32_t[]>(
+                                                          width_ * height_);
+    pool_->readRegion(pixels.get(), level0X_, level0Y_, level_, width_,
+                      height_);
+    pixels_ = std::move(pixels);
+  }
+  // Intersection of region and band.
+  const int64_t startX = std::max(x, x_);
+  const int64_t startY = std::max(y, y_);
+  const int64_t copyWidth = std::min(x + width, x_ + width_) - startX;
+  const int64_t copyHeight = std::min(y + height, y_ + height_) - startY;
+  if (copyWidth > 0 && copyHeight > 0) {
+    const uint32_t *source = pixels_.get() + (startY - y_) * width_ +
+                             (startX - x_);
+    dest += (startY - y) * width + (startX - x);
+    for (int64_t row = 0; row < copyHeight; ++row) {
+      std::copy(source, source + copyWidth, dest);
+      source += width_;
+      dest += width;
+    }
+  }
+  releaseRegion();
+}
+
+void OpenSlideRegionBand::skipRegion() {
+  boost::lock_guard<boost::mutex> lock(mutex_);
+  releaseRegion();
+}
+
+void OpenSlideRegionBand::releaseRegion() {
+  pendingRegions_ -= 1;
+  if (pendingRegions_ == 0) {
+    pixels_ = nullptr;
+  }
+}
+
+OpenSlideReadPlan::OpenSlideReadPlan(OpenSlidePool *pool, int32_t level,
+                                     int64_t minBlockWidth,
+                                     int64_t minBlockHeight) :
+                                       pool_(pool), level_(level),
+                                       regionTileReads_(0) {
+  valid_ = pool_->levelTileGeometry(level_, &tileWidth_, &tileHeight_,
+                                    &downsample_);
+  if (!valid_) {
+    return;
+  }
+  blockWidth_ = std::max<int64_t>((minBlockWidth + tileWidth_ - 1) /
+                                  tileWidth_, 1) * tileWidth_;
+  blockHeight_ = std::max<int64_t>((minBlockHeight + tileHeight_ - 1) /
+                                   tileHeight_, 1) * tileHeight_;
+}
+
+OpenSlideReadPlan::~OpenSlideReadPlan() {}
+
+bool OpenSlideReadPlan::isValid() const {
+  return valid_;
+}
+
+std::vector<std::shared_ptr<OpenSlideRegionBand>>
+OpenSlideReadPlan::addRegion(int64_t x, int64_t y, int64_t width,
+                             int64_t height) {
+  std::vector<std::shared_ptr<OpenSlideRegionBand>> blocks;
+  if (!valid_ || width <= 0 || height <= 0) {
+    return blocks;
+  }
+  // Padded regions may start before the level origin; blocks on the
+  // origin are extended to hold them.
+  const int64_t firstTileColumn = std::max<int64_t>(x, 0) / tileWidth_;
+  const int64_t lastTileColumn = std::max<int64_t>(x + width - 1, 0) /
+                                 tileWidth_;
+  const int64_t firstTileRow = std::max<int64_t>(y, 0) / tileHeight_;
+  const int64_t lastTileRow = std::max<int64_t>(y + height - 1, 0) /
+                              tileHeight_;
+  for (int64_t row = firstTileRow; row <= lastTileRow; ++row) {
+    for (int64_t column = firstTileColumn; column <= lastTileColumn;
+         ++column) {
+      regionTileReads_ += 1;
+      tiles_.insert((static_cast<uint64_t>(row) << 32) |
+                    static_cast<uint64_t>(column));
+    }
+  }
+  const int64_t firstBlockX = std::max<int64_t>(x, 0) / blockWidth_;
+  const int64_t lastBlockX = std::max<int64_t>(x + width - 1, 0) /
+                             blockWidth_;
+  const int64_t firstBlockY = std::max<int64_t>(y, 0) / blockHeight_;
+  const int64_t lastBlockY = std::max<int64_t>(y + height - 1, 0) /
+                             blockHeight_;
+  for (int64_t blockY = firstBlockY; blockY <= lastBlockY; ++blockY) {
+    for (int64_t blockX = firstBlockX; blockX <= lastBlockX; ++blockX) {
+      std::shared_ptr<OpenSlideRegionBand> &block =
+                                      blocks_[std::make_pair(blockY, blockX)];
+      if (block == nullptr) {
+        const int64_t levelX = blockX * blockWidth_;
+        const int64_t levelY = blockY * blockHeight_;
+        block = std::make_shared<OpenSlideRegionBand>(pool_, level_, levelX,
+            levelY, blockWidth_, blockHeight_,
+            std::llround(levelX * downsample_),
+            std::llround(levelY * downsample_));
+      }
+      block->addRegion(x, y, width, height, std::llround(x * downsample_),
+                       std::llround(y * downsample_));
+      blocks.push_back(block);
+    }
+  }
+  return blocks;
+}
+
+int64_t OpenSlideReadPlan::regionTileReads() const {
+  return regionTileReads_;
+}
+
+int64_t OpenSlideReadPlan::blockTileReads() const {
+  return static_cast<int64_t>(blocks_.size()) *
+         (blockWidth_ / tileWidth_) * (blockHeight_ / tileHeight_);
+}
+
+int64_t OpenSlideReadPlan::uniqueTiles() const {
+  return tiles_.size();
+}
+
 }  // namespace wsiToDicomConverter
@@ -16,11 +16,22 @@
 #define SRC_OPENSLIDEUTIL_H_
 
 #include <openslide.h>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
 
+#include <list>
+#include <map>
+#include <memory>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 namespace wsiToDicomConverter {
 
+class TiffRegionReader;
+
 /* Wrapper for openslide pointer.
    closes pointer when object
    is destructed.
@@ -37,6 +48,235 @@ class OpenSlidePtr {
   void _open(const char *filename);
 };
 
+// Statistics of OpenSlidePool reads.
+struct OpenSlideCacheStats {
+  // openslide_read_region calls.
+  int64_t regionReads = 0;
+  // Native tiles touched by reads which were (estimated) in cache.
+  int64_t tileHits = 0;
+  // Native tiles touched by reads which required decoding.
+  int64_t tileMisses = 0;
+  // Distinct native tiles touched by reads; tileMisses / uniqueTiles is
+  // the estimated number of times each tile was decoded.
+  int64_t uniqueTiles = 0;
+  // Reads which waited for a free handle.
+  int64_t handleWaits = 0;
+};
+
+/* Pool of openslide handles to one slide.
+
+   Each concurrent reader leases its own handle so reads do not contend on
+   a single handle's locks. Handles are opened on demand, up to maxHandles,
+   and kept open for the lifetime of the pool. If supported by the
+   openslide library (>= 4.0), handles share one decoded tile cache of
+   cacheSizeBytes.
+
+   OpenSlide does not report cache hits. Tile hit statistics are estimated
+   by replaying reads against an LRU of the slide's native tiles with the
+   same byte capacity as the cache.
+
+   Levels stored as jpeg or JPEG 2000 encoded tiled TIFF images may be read
+   with a TiffRegionReader instead of openslide; reads of other levels and
+   reads the tiff reader fails are passed to openslide.
+*/
+class OpenSlidePool {
+ public:
+  // filename - slide to open.
+  // maxHandles - maximum handles opened, typically one per worker thread.
+  // cacheSizeBytes - shared cache capacity; <= 0 uses openslide default
+  //                  per handle cache.
+  OpenSlidePool(const std::string &filename, size_t maxHandles,
+                int64_t cacheSizeBytes);
+  OpenSlidePool(const OpenSlidePool &) = delete;
+  OpenSlidePool &operator =(const OpenSlidePool &) = delete;
+  virtual ~OpenSlidePool();
+
+  // Leases a handle; blocks until a handle is free.
+  OpenSlidePtr *acquire();
+  void release(OpenSlidePtr *handle);
+
+  // Reads levels with matching tiff directories using reader.
+  // reducedResolutionReads - enables readReducedRegion.
+  void setTiffRegionReader(std::unique_ptr<TiffRegionReader> reader,
+                           bool reducedResolutionReads);
+
+  // openslide_read_region using a leased handle. Throws 1 on error.
+  void readRegion(uint32_t *dest, int64_t x, int64_t y, int32_t level,
+                  int64_t width, int64_t height);
+
+  // Reads region of level downsampled by a power of two from the reduced
+  // resolutions of JPEG 2000 tiles; full resolution is not decoded.
+  // x, y, width, height - region in level coordinates.
+  // downsampledWidth, downsampledHeight - dimensions of dest; width and
+  //     height divided by the same power of two.
+  // Returns false, without reading, if region can not be read at reduced
+  // resolution.
+  bool readDownsampledRegion(uint32_t *dest, int64_t x, int64_t y,
+                             int32_t level, int64_t width, int64_t height,
+                             int64_t downsampledWidth,
+                             int64_t downsampledHeight);
+
+  OpenSlideCacheStats cacheStats() const;
+  size_t openHandleCount() const;
+
+  // Native tile dimensions and downsample of level. Returns false if
+  // slide does not report tile dimensions.
+  bool levelTileGeometry(int32_t level, int64_t *tileWidth,
+                         int64_t *tileHeight, double *downsample) const;
+
+ private:
+  void initTileGeometry(openslide_t *osr);
+  void recordRead(int64_t x, int64_t y, int32_t level, int64_t width,
+                  int64_t height);
+
+  const std::string filename_;
+  const size_t maxHandles_;
+  std::vector<std::unique_ptr<OpenSlidePtr>> handles_;
+  std::vector<OpenSlidePtr *> freeHandles_;
+  void *cache_;
+  mutable boost::mutex mutex_;
+  boost::condition_variable handleReleased_;
+
+  // Estimated tile cache.
+  struct LevelTileGeometry {
+    double downsample;
+    int64_t tileWidth;
+    int64_t tileHeight;
+  };
+  std::vector<LevelTileGeometry> levelTileGeometry_;
+
+  // Tiff directory of each level; -1 if level is read with openslide.
+  std::unique_ptr<TiffRegionReader> tiffRegionReader_;
+  std::vector<int32_t> tiffLevelDirectory_;
+  std::vector<double> tiffLevelDownsample_;
+  bool reducedResolutionReads_;
+  size_t tileCacheCapacity_;
+  std::list<uint64_t> tileLru_;
+  std::unordered_map<uint64_t, std::list<uint64_t>::iterator> tileLruIndex_;
+  std::unordered_set<uint64_t> touchedTiles_;
+  mutable boost::mutex statsMutex_;
+  OpenSlideCacheStats stats_;
+};
+
+/* Leases handle from OpenSlidePool for the lifetime of the object. */
+class OpenSlidePoolLease {
+ public:
+  explicit OpenSlidePoolLease(OpenSlidePool *pool);
+  virtual ~OpenSlidePoolLease();
+  openslide_t *osr();
+
+ private:
+  OpenSlidePool *pool_;
+  OpenSlidePtr *handle_;
+};
+
+/* Region of an openslide level shared by a group of frames, e.g. the
+   frames of a row.
+
+   Frames add the region they sample, including padding, when they are
+   created. The band is the bounding box of the added regions, or a fixed
+   rectangle. It is read with one OpenSlidePool::readRegion call when the
+   first frame reads its region, and freed after every added region has
+   been read or skipped. Frames reading concurrently wait for the band
+   read.
+*/
+class OpenSlideRegionBand {
+ public:
+  OpenSlideRegionBand(OpenSlidePool *pool, int32_t level);
+  // Band of fixed rectangle in level coordinates read from level 0 origin
+  // level0X, level0Y. Rectangle is only extended by regions which start
+  // before it.
+  OpenSlideRegionBand(OpenSlidePool *pool, int32_t level, int64_t x,
+                      int64_t y, int64_t width, int64_t height,
+                      int64_t level0X, int64_t level0Y);
+  OpenSlideRegionBand(const OpenSlideRegionBand &) = delete;
+  OpenSlideRegionBand &operator =(const OpenSlideRegionBand &) = delete;
+  virtual ~OpenSlideRegionBand();
+
+  // Adds region, in level coordinates, to band. Regions must be added
+  // before the band is read.
+  // level0X, level0Y - region origin in level 0 coordinates; band is read
+  //                    from the level 0 origin of its top-left region.
+  void addRegion(int64_t x, int64_t y, int64_t width, int64_t height,
+                 int64_t level0X, int64_t level0Y);
+
+  // Copies part of region added to band which lies in band into dest, a
+  // width x height buffer, as openslide ARGB pixels. Throws 1 on error.
+  void readRegion(uint32_t *dest, int64_t x, int64_t y, int64_t width,
+                  int64_t height);
+
+  // Releases a region added to band which is not read.
+  void skipRegion();
+
+ private:
+  void releaseRegion();
+
+  OpenSlidePool *pool_;
+  const int32_t level_;
+  const bool fixedBounds_;
+  int64_t x_;
+  int64_t y_;
+  int64_t level0X_;
+  int64_t level0Y_;
+  int64_t width_;
+  int64_t height_;
+  int64_t pendingRegions_;
+  std::unique_ptr<uint32_t[]> pixels_;
+  boost::mutex mutex_;
+};
+
+/* Plans reads of an openslide level as blocks of whole native tiles.
+
+   Frames' source regions are back-projected from the level being
+   generated and rarely align with the slide's native tiles; reading each
+   region separately decodes tiles on region edges once per region which
+   touches them. The plan divides the level into a grid of blocks whose
+   edges lie on native tile edges. Each block is an OpenSlideRegionBand;
+   a region is read from the blocks it overlaps, so each native tile is
+   decoded once per level when blocks are read.
+
+   Regions must be added from one thread, before they are read.
+*/
+class OpenSlideReadPlan {
+ public:
+  // minBlockWidth, minBlockHeight - block dimensions are the smallest
+  //     multiple of native tile dimensions >= these dimensions.
+  OpenSlideReadPlan(OpenSlidePool *pool, int32_t level,
+                    int64_t minBlockWidth, int64_t minBlockHeight);
+  virtual ~OpenSlideReadPlan();
+
+  // False if the slide does not report level's native tile dimensions.
+  bool isValid() const;
+
+  // Adds region, in level coordinates, to blocks it overlaps. Returns the
+  // blocks to read region from.
+  std::vector<std::shared_ptr<OpenSlideRegionBand>> addRegion(int64_t x,
+                                                              int64_t y,
+                                                              int64_t width,
+                                                              int64_t height);
+
+  // Native tiles decoded if each region added is read separately.
+  int64_t regionTileReads() const;
+  // Native tiles decoded reading the plan's blocks.
+  int64_t blockTileReads() const;
+  // Distinct native tiles touched by regions added.
+  int64_t uniqueTiles() const;
+
+ private:
+  OpenSlidePool *pool_;
+  const int32_t level_;
+  bool valid_;
+  int64_t tileWidth_;
+  int64_t tileHeight_;
+  double downsample_;
+  int64_t blockWidth_;
+  int64_t blockHeight_;
+  std::map<std::pair<int64_t, int64_t>,
+           std::shared_ptr<OpenSlideRegionBand>> blocks_;
+  std::unordered_set<uint64_t> tiles_;
+  int64_t regionTileReads_;
+};
+
 }  // namespace wsiToDicomConverter
 
 #endif  // SRC_OPENSLIDEUTIL_H_
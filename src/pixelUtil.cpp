@@ -0,0 +1,90 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#if defined(__x86_64__)
+#include <tmmintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+#include "src/pixelUtil.h"
+
+namespace pixelUtil {
+
+static void rgbToABGRScalar(const uint8_t *source, uint8_t *dest,
+                            uint64_t pixelCount) {
+  for (uint64_t idx = 0; idx < pixelCount; ++idx) {
+    dest[0] = source[0];
+    dest[1] = source[1];
+    dest[2] = source[2];
+    dest[3] = 0xff;  // alpha
+    source += 3;
+    dest += 4;
+  }
+}
+
+#if defined(__x86_64__)
+// Converts 16 pixels per iteration. Each 16 byte load covers 4 pixels
+// (12 bytes) and reads 4 bytes past them; loop stops while at least 2
+// pixels of input remain beyond the block so loads stay in bounds.
+__attribute__((target("ssse3")))
+static void rgbToABGRSSSE3(const uint8_t *source, uint8_t *dest,
+                           uint64_t pixelCount) {
+  const __m128i shuffle = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1,
+                                        6, 7, 8, -1, 9, 10, 11, -1);
+  const __m128i alpha = _mm_set1_epi32(0xff000000);
+  uint64_t idx = 0;
+  for (; idx + 18 <= pixelCount; idx += 16) {
+    const uint8_t *src = source + idx * 3;
+    __m128i *dst = reinterpret_cast<__m128i *>(dest + idx * 4);
+    for (int block = 0; block < 4; ++block) {
+      const __m128i pixels = _mm_loadu_si128(
+                      reinterpret_cast<const __m128i *>(src + block * 12));
+      _mm_storeu_si128(dst + block,
+                       _mm_or_si128(_mm_shuffle_epi8(pixels, shuffle),
+                                    alpha));
+    }
+  }
+  rgbToABGRScalar(source + idx * 3, dest + idx * 4, pixelCount - idx);
+}
+
+static bool hasSSSE3() {
+  static const bool supported = __builtin_cpu_supports("ssse3");
+  return supported;
+}
+#endif
+
+void rgbToABGR(const uint8_t *source, uint8_t *dest, uint64_t pixelCount) {
+#if defined(__x86_64__)
+  if (hasSSSE3()) {
+    rgbToABGRSSSE3(source, dest, pixelCount);
+    return;
+  }
+#elif defined(__aarch64__)
+  uint64_t idx = 0;
+  uint8x16x4_t pixels;
+  pixels.val[3] = vdupq_n_u8(0xff);
+  for (; idx + 16 <= pixelCount; idx += 16) {
+    const uint8x16x3_t rgb = vld3q_u8(source + idx * 3);
+    pixels.val[0] = rgb.val[0];
+    pixels.val[1] = rgb.val[1];
+    pixels.val[2] = rgb.val[2];
+    vst4q_u8(dest + idx * 4, pixels);
+  }
+  rgbToABGRScalar(source + idx * 3, dest + idx * 4, pixelCount - idx);
+  return;
+#endif
+  rgbToABGRScalar(source, dest, pixelCount);
+}
+
+}  // namespace pixelUtil
@@ -0,0 +1,36 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef SRC_PIXELUTIL_H_
+#define SRC_PIXELUTIL_H_
+
+#include <cstdint>
+
+namespace pixelUtil {
+
+/* Expands interleaved 3 byte pixels to 4 byte pixels with opaque alpha.
+   Byte order of the color components is preserved; e.g. RGB pixels are
+   returned as R, G, B, A bytes (ABGR when read as little endian uint32),
+   the layout of raw frame bytes.
+
+   Uses SSSE3 (x86-64, detected at runtime) or NEON (arm64) when available.
+   Prameters:
+    source: pixelCount * 3 bytes.
+    dest: pixelCount * 4 bytes; must not overlap source.
+    pixelCount: number of pixels.
+*/
+void rgbToABGR(const uint8_t *source, uint8_t *dest, uint64_t pixelCount);
+
+}  // namespace pixelUtil
+
+#endif  // SRC_PIXELUTIL_H_
@@ -0,0 +1,379 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/stripImageReader.h"
+
+#include <boost/log/trivial.hpp>
+#include <png.h>
+#include <tiffio.h>
+
+#include <algorithm>
+#include <csetjmp>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <jpeglib.h>
+
+namespace wsiToDicomConverter {
+
+// Strips taller than this are not decoded a strip at a time; a strip's
+// RGBA raster would be larger than the image decoded by OpenCV.
+static const int64_t MAX_TIFF_STRIP_ROWS = 4096;
+static const uint16_t EXIF_ORIENTATION_TAG = 0x0112;
+
+namespace {
+
+struct JpegErrorManager {
+  struct jpeg_error_mgr pub;
+  jmp_buf setjmpBuffer;
+};
+
+void jpegErrorExit(j_common_ptr cinfo) {
+  char msg[JMSG_LENGTH_MAX];
+  (*(cinfo->err->format_message))(cinfo, msg);
+  BOOST_LOG_TRIVIAL(error) << "Error decoding jpeg: " << msg;
+  longjmp(reinterpret_cast<JpegErrorManager *>(cinfo->err)->setjmpBuffer, 1);
+}
+
+// Returns EXIF orientation saved in jpeg APP1 marker. 1 if not defined.
+int exifOrientation(jpeg_decompress_struct *cinfo) {
+  for (jpeg_saved_marker_ptr marker = cinfo->marker_list; marker != nullptr;
+       marker = marker->next) {
+    if (marker->marker != JPEG_APP0 + 1 || marker->data_length < 14 ||
+        std::memcmp(marker->data, "Exif\0\0", 6) != 0) {
+      continue;
+    }
+    const uint8_t *tiff = marker->data + 6;
+    const uint64_t size = marker->data_length - 6;
+    const bool littleEndian = tiff[0] == 'I';
+    auto read16 = [tiff, littleEndian](uint64_t offset) -> uint32_t {
+      return littleEndian ? tiff[offset] | (tiff[offset + 1] << 8) :
+                            (tiff[offset] << 8) | tiff[offset + 1];
+    };
+    const uint64_t ifd = littleEndian ?
+                         (read16(6) << 16) | read16(4) :
+                         (read16(4) << 16) | read16(6);
+    if (ifd + 2 > size) {
+      return 1;
+    }
+    const uint32_t entries = read16(ifd);
+    for (uint32_t idx = 0; idx < entries; ++idx) {
+      const uint64_t entry = ifd + 2 + idx * 12;
+      if (entry + 12 > size) {
+        break;
+      }
+      if (read16(entry) == EXIF_ORIENTATION_TAG) {
+        return read16(entry + 8);
+      }
+    }
+  }
+  return 1;
+}
+
+struct JpegDecoder {
+  jpeg_decompress_struct cinfo;
+  JpegErrorManager jerr;
+  FILE *file;
+
+  explicit JpegDecoder(FILE *inputFile) : file(inputFile) {
+    cinfo.err = jpeg_std_error(&jerr.pub);
+    jerr.pub.error_exit = jpegErrorExit;
+    jpeg_create_decompress(&cinfo);
+  }
+
+  ~JpegDecoder() {
+    jpeg_destroy_decompress(&cinfo);
+    fclose(file);
+  }
+};
+
+class JpegStripReader : public StripImageReader {
+ public:
+  explicit JpegStripReader(std::unique_ptr<JpegDecoder> decoder) :
+                        StripImageReader(decoder->cinfo.output_width,
+                                         decoder->cinfo.output_height),
+                        decoder_(std::move(decoder)),
+                        grayRow_(decoder_->cinfo.output_components == 1 ?
+                                 width() : 0) {}
+
+ protected:
+  bool decodeRows(int64_t rowCount, uint8_t *rgbMemory) override {
+    if (setjmp(decoder_->jerr.setjmpBuffer)) {
+      return false;
+    }
+    for (int64_t row = 0; row < rowCount; ++row) {
+      uint8_t *rgbRow = rgbMemory + row * width() * 3;
+      JSAMPROW decodeRow = grayRow_.empty() ? rgbRow : grayRow_.data();
+      if (jpeg_read_scanlines(&decoder_->cinfo, &decodeRow, 1) != 1) {
+        return false;
+      }
+      for (size_t idx = 0; idx < grayRow_.size(); ++idx) {
+        std::memset(rgbRow + idx * 3, grayRow_[idx], 3);
+      }
+    }
+    return true;
+  }
+
+ private:
+  std::unique_ptr<JpegDecoder> decoder_;
+  std::vector<uint8_t> grayRow_;
+};
+
+std::unique_ptr<StripImageReader> openJpeg(FILE *file) {
+  std::unique_ptr<JpegDecoder> decoder = std::make_unique<JpegDecoder>(file);
+  jpeg_decompress_struct *cinfo = &decoder->cinfo;
+  if (setjmp(decoder->jerr.setjmpBuffer)) {
+    return nullptr;
+  }
+  jpeg_stdio_src(cinfo, file);
+  jpeg_save_markers(cinfo, JPEG_APP0 + 1, 0xFFFF);
+  jpeg_read_header(cinfo, TRUE);
+  // Progressive jpeg buffers coefficients for the whole image.
+  if (jpeg_has_multiple_scans(cinfo) || exifOrientation(cinfo) != 1) {
+    return nullptr;
+  }
+  switch (cinfo->jpeg_color_space) {
+    case JCS_GRAYSCALE:
+      cinfo->out_color_space = JCS_GRAYSCALE;
+      break;
+    case JCS_YCbCr:
+    case JCS_RGB:
+      cinfo->out_color_space = JCS_RGB;
+      break;
+    default:
+      return nullptr;
+  }
+  jpeg_start_decompress(cinfo);
+  return std::make_unique<JpegStripReader>(std::move(decoder));
+}
+
+void pngError(png_structp png, png_const_charp msg) {
+  BOOST_LOG_TRIVIAL(error) << "Error decoding png: " << msg;
+  png_longjmp(png, 1);
+}
+
+void pngWarning(png_structp png, png_const_charp msg) {
+  BOOST_LOG_TRIVIAL(debug) << "Png warning: " << msg;
+}
+
+struct PngDecoder {
+  png_structp png;
+  png_infop info;
+  FILE *file;
+
+  explicit PngDecoder(FILE *inputFile) : info(nullptr), file(inputFile) {
+    png = png_create_read_struct(PNG_LIBPNG_VER_STRING, nullptr, pngError,
+                                 pngWarning);
+    if (png != nullptr) {
+      info = png_create_info_struct(png);
+    }
+  }
+
+  ~PngDecoder() {
+    png_destroy_read_struct(&png, &info, nullptr);
+    fclose(file);
+  }
+};
+
+class PngStripReader : public StripImageReader {
+ public:
+  explicit PngStripReader(std::unique_ptr<PngDecoder> decoder) :
+            StripImageReader(png_get_image_width(decoder->png, decoder->info),
+                            png_get_image_height(decoder->png, decoder->info)),
+            decoder_(std::move(decoder)) {}
+
+ protected:
+  bool decodeRows(int64_t rowCount, uint8_t *rgbMemory) override {
+    if (setjmp(png_jmpbuf(decoder_->png))) {
+      return false;
+    }
+    for (int64_t row = 0; row < rowCount; ++row) {
+      png_read_row(decoder_->png, rgbMemory + row * width() * 3, nullptr);
+    }
+    return true;
+  }
+
+ private:
+  std::unique_ptr<PngDecoder> decoder_;
+};
+
+std::unique_ptr<StripImageReader> openPng(FILE *file) {
+  std::unique_ptr<PngDecoder> decoder = std::make_unique<PngDecoder>(file);
+  png_structp png = decoder->png;
+  png_infop info = decoder->info;
+  if (png == nullptr || info == nullptr) {
+    return nullptr;
+  }
+  if (setjmp(png_jmpbuf(png))) {
+    return nullptr;
+  }
+  png_init_io(png, file);
+  png_read_info(png, info);
+  // Interlaced rows are not complete until the last pass is decoded.
+  if (png_get_interlace_type(png, info) != PNG_INTERLACE_NONE) {
+    return nullptr;
+  }
+  const int colorType = png_get_color_type(png, info);
+  if (png_get_bit_depth(png, info) == 16) {
+    png_set_strip_16(png);
+  }
+  if (colorType == PNG_COLOR_TYPE_PALETTE) {
+    png_set_palette_to_rgb(png);
+  }
+  if (colorType == PNG_COLOR_TYPE_GRAY ||
+      colorType == PNG_COLOR_TYPE_GRAY_ALPHA) {
+    png_set_expand_gray_1_2_4_to_8(png);
+    png_set_gray_to_rgb(png);
+  }
+  if (colorType & PNG_COLOR_MASK_ALPHA) {
+    png_set_strip_alpha(png);
+  }
+  png_read_update_info(png, info);
+  if (png_get_channels(png, info) != 3 || png_get_bit_depth(png, info) != 8) {
+    return nullptr;
+  }
+  return std::make_unique<PngStripReader>(std::move(decoder));
+}
+
+class TiffStripReader : public StripImageReader {
+ public:
+  TiffStripReader(TIFF *tiff, int64_t width, int64_t height,
+                  int64_t rowsPerStrip) :
+                                StripImageReader(width, height), tiff_(tiff),
+                                rowsPerStrip_(rowsPerStrip),
+                                strip_(width * rowsPerStrip), stripRow_(-1) {}
+
+  ~TiffStripReader() override {
+    TIFFClose(tiff_);
+  }
+
+ protected:
+  bool decodeRows(int64_t rowCount, uint8_t *rgbMemory) override {
+    for (int64_t row = nextRow(); row < nextRow() + rowCount; ++row) {
+      const int64_t stripRow = row - (row % rowsPerStrip_);
+      if (stripRow != stripRow_) {
+        if (!TIFFReadRGBAStrip(tiff_, stripRow, strip_.data())) {
+          BOOST_LOG_TRIVIAL(error) << "Error decoding tiff strip.";
+          return false;
+        }
+        stripRow_ = stripRow;
+      }
+      // Strip raster origin is the lower left corner.
+      const int64_t stripRows = std::min(rowsPerStrip_, height() - stripRow);
+      const uint32_t *raster = strip_.data() +
+                               (stripRows - 1 - (row - stripRow)) * width();
+      uint8_t *rgbRow = rgbMemory + (row - nextRow()) * width() * 3;
+      for (int64_t idx = 0; idx < width(); ++idx) {
+        *rgbRow++ = TIFFGetR(raster[idx]);
+        *rgbRow++ = TIFFGetG(raster[idx]);
+        *rgbRow++ = TIFFGetB(raster[idx]);
+      }
+    }
+    return true;
+  }
+
+ private:
+  TIFF *tiff_;
+  const int64_t rowsPerStrip_;
+  std::vector<uint32_t> strip_;
+  int64_t stripRow_;
+};
+
+std::unique_ptr<StripImageReader> openTiff(const std::string &filePath) {
+  TIFF *tiff = TIFFOpen(filePath.c_str(), "r");
+  if (tiff == nullptr) {
+    return nullptr;
+  }
+  uint32_t width = 0;
+  uint32_t height = 0;
+  uint32_t rowsPerStrip = 0;
+  uint16_t orientation = ORIENTATION_TOPLEFT;
+  char errorMsg[1024];
+  TIFFGetField(tiff, TIFFTAG_IMAGEWIDTH, &width);
+  TIFFGetField(tiff, TIFFTAG_IMAGELENGTH, &height);
+  TIFFGetFieldDefaulted(tiff, TIFFTAG_ROWSPERSTRIP, &rowsPerStrip);
+  TIFFGetFieldDefaulted(tiff, TIFFTAG_ORIENTATION, &orientation);
+  rowsPerStrip = std::min(rowsPerStrip, height);
+  if (TIFFIsTiled(tiff) || width == 0 || height == 0 ||
+      orientation != ORIENTATION_TOPLEFT ||
+      rowsPerStrip > MAX_TIFF_STRIP_ROWS || !TIFFRGBAImageOK(tiff, errorMsg)) {
+    TIFFClose(tiff);
+    return nullptr;
+  }
+  return std::make_unique<TiffStripReader>(tiff, width, height, rowsPerStrip);
+}
+
+}  // namespace
+
+std::unique_ptr<StripImageReader> StripImageReader::open(
+                                                  absl::string_view filePath) {
+  const std::string path = static_cast<std::string>(filePath);
+  FILE *file = fopen(path.c_str(), "rb");
+  if (file == nullptr) {
+    return nullptr;
+  }
+  uint8_t magic[4] = {0, 0, 0, 0};
+  const size_t magicSize = fread(magic, 1, sizeof(magic), file);
+  rewind(file);
+  if (magicSize == sizeof(magic)) {
+    if (magic[0] == 0xFF && magic[1] == 0xD8 && magic[2] == 0xFF) {
+      return openJpeg(file);
+    }
+    if (std::memcmp(magic, "\x89PNG", 4) == 0) {
+      return openPng(file);
+    }
+    if (std::memcmp(magic, "II", 2) == 0 || std::memcmp(magic, "MM", 2) == 0) {
+      fclose(file);
+      return openTiff(path);
+    }
+  }
+  fclose(file);
+  return nullptr;
+}
+
+StripImageReader::StripImageReader(int64_t width, int64_t height) :
+                                   width_(width), height_(height),
+                                   nextRow_(0) {}
+
+StripImageReader::~StripImageReader() {}
+
+int64_t StripImageReader::width() const {
+  return width_;
+}
+
+int64_t StripImageReader::height() const {
+  return height_;
+}
+
+int64_t StripImageReader::nextRow() const {
+  return nextRow_;
+}
+
+bool StripImageReader::readRows(int64_t rowCount, uint8_t *rgbMemory) {
+  if (rowCount < 0 || rowCount > height_ - nextRow_) {
+    return false;
+  }
+  if (!decodeRows(rowCount, rgbMemory)) {
+    // Decoder state is undefined after an error.
+    nextRow_ = height_;
+    return false;
+  }
+  nextRow_ += rowCount;
+  return true;
+}
+
+}  // namespace wsiToDicomConverter
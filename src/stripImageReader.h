@@ -0,0 +1,62 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SRC_STRIPIMAGEREADER_H_
+#define SRC_STRIPIMAGEREADER_H_
+
+#include <absl/strings/string_view.h>
+
+#include <memory>
+
+namespace wsiToDicomConverter {
+
+/* Decodes an untiled image from top to bottom a band of rows at a time.
+
+   Only the rows being decoded are held in memory; the decoder state of
+   baseline JPEG (libjpeg scanlines), non-interlaced PNG (libpng rows) and
+   stripped TIFF (libtiff strips) is proportional to the image width.
+   Rows are returned as 8 bit RGB; grayscale and palette images are
+   expanded and alpha is discarded, as cv::imread(IMREAD_COLOR) does.
+
+   Rows are read sequentially. Reader is not thread safe.
+*/
+class StripImageReader {
+ public:
+  // Returns nullptr if file can not be decoded a row at a time, e.g.
+  // progressive JPEG, interlaced PNG, tiled TIFF, or images which require
+  // rotation to display.
+  static std::unique_ptr<StripImageReader> open(absl::string_view filePath);
+  virtual ~StripImageReader();
+
+  int64_t width() const;
+  int64_t height() const;
+  // Index of next row returned by readRows.
+  int64_t nextRow() const;
+
+  // Decodes next rowCount rows into rgbMemory, rowCount * width * 3 bytes.
+  // Returns false on decode error or if fewer than rowCount rows remain.
+  bool readRows(int64_t rowCount, uint8_t *rgbMemory);
+
+ protected:
+  StripImageReader(int64_t width, int64_t height);
+  virtual bool decodeRows(int64_t rowCount, uint8_t *rgbMemory) = 0;
+
+ private:
+  const int64_t width_;
+  const int64_t height_;
+  int64_t nextRow_;
+};
+
+}  // namespace wsiToDicomConverter
+#endif  // SRC_STRIPIMAGEREADER_H_
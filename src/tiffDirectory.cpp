@@ -209,6 +209,12 @@ bool TiffDirectory::isJpeg2kCompressed() const {
           compression_  == compression_aperio_RGB);
 }
 
+bool TiffDirectory::isJpeg2kYCbCr() const {
+  const int compression_aperio_YCbCr = 33003;
+  return (compression_ == compression_aperio_YCbCr ||
+          (compression_ == COMPRESSION_JP2000 && isPhotoMetricYCBCR()));
+}
+
 bool TiffDirectory::isPhotoMetricRGB() const {
   return (photoMetric_  == PHOTOMETRIC_RGB);
 }
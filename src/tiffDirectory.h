@@ -67,6 +67,8 @@ class TiffDirectory {
   bool isLabelImage() const;
   bool isJpegCompressed() const;
   bool isJpeg2kCompressed() const;
+  // True if JPEG 2000 components are encoded as Y, Cb, Cr.
+  bool isJpeg2kYCbCr() const;
   bool isPhotoMetricRGB() const;
   bool isPhotoMetricYCBCR() const;
   absl::string_view photoMetrIntStr() const;
@@ -13,11 +13,12 @@
 // limitations under the License.
 #include <absl/strings/string_view.h>
 #include <boost/log/trivial.hpp>
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
-#include "src/openslideUtil.h"
 #include "src/tiffFile.h"
 
 
@@ -27,7 +28,6 @@ TiffFile::TiffFile(absl::string_view path, const int32_t dirIndex) :
   tiffFilePath_(path), currentDirectoryIndex_(dirIndex) {
   initalized_ = false;
   tileReadBufSize_  = 0;
-  openslide_level_ = 0;
   std::string path_str = std::move(static_cast<std::string>(path));
   tiffFile_ = TIFFOpen(path_str.c_str(), "r");
   if (tiffFile_ == nullptr) {
@@ -40,6 +40,7 @@ TiffFile::TiffFile(absl::string_view path, const int32_t dirIndex) :
   } while (TIFFReadDirectory(tiffFile_));
   TIFFSetDirectory(tiffFile_, currentDirectoryIndex_);
   tileReadBufSize_ = TIFFTileSize(tiffFile_);
+  tileReader_ = std::make_unique<TiffRawTileReader>(tiffFile_, path_str);
   initalized_ = true;
 }
 
@@ -47,7 +48,6 @@ TiffFile::TiffFile(const TiffFile &tf, const int32_t dirIndex) :
     tiffFilePath_(tf.path()), currentDirectoryIndex_(dirIndex) {
     initalized_ = false;
     tileReadBufSize_  = 0;
-    openslide_level_ = 0;
     tiffFile_ = TIFFOpen(tiffFilePath_.c_str(), "r");
     if (tiffFile_ == nullptr) {
       return;
@@ -59,49 +59,13 @@ TiffFile::TiffFile(const TiffFile &tf, const int32_t dirIndex) :
     }
     TIFFSetDirectory(tiffFile_, currentDirectoryIndex_);
     tileReadBufSize_ = tf.tileReadBufSize_;
-    if (!fileDirectory()->isJpeg2kCompressed()) {
-      osptr_ = nullptr;
-      openslide_level_ = 0;
-    } else {
-      osptr_ = std::make_unique<OpenSlidePtr>(tf.path());
-      openslide_t* opslide = osptr_->osr();
-      int64_t level_width = -1;
-      int64_t level_height = -1;
-      const int64_t targetWidth = fileDirectory()->imageWidth();
-      const int64_t targetHeight = fileDirectory()->imageHeight();
-      if (openslide_get_error(opslide)) {
-        BOOST_LOG_TRIVIAL(error) << openslide_get_error(opslide);
-        throw 1;
-      }
-      const int32_t level_count = openslide_get_level_count(opslide);
-      for (openslide_level_ = 0;
-           openslide_level_ < level_count;
-           ++openslide_level_) {
-        openslide_get_level_dimensions(opslide, openslide_level_,
-                                       &level_width, &level_height);
-        if (level_width == targetWidth && level_height == targetHeight) {
-          break;
-        }
-      }
-      if (level_width != targetWidth && level_height != targetHeight) {
-        BOOST_LOG_TRIVIAL(error) << "Could not find expected level in "
-                                    "JPG2000 encoded tiff.";
-        throw 1;
-      }
-    }
+    tileReader_ = std::make_unique<TiffRawTileReader>(tiffFile_,
+                                                      tiffFilePath_);
     initalized_ = true;
 }
 
-openslide_t * TiffFile::getOpenslidePtr() {
-  return osptr_->osr();
-}
-
-int32_t TiffFile::getOpenslideLevel() const {
-  return openslide_level_;
-}
-
 TiffFile::~TiffFile() {
-  osptr_ = nullptr;
+  tilePrefetcher_ = nullptr;
   close();
 }
 
@@ -109,6 +73,8 @@ void TiffFile::close() {
   if (tiffFile_ == nullptr) {
     return;
   }
+  tilePrefetcher_ = nullptr;
+  tileReader_ = nullptr;
   TIFFClose(tiffFile_);
   tiffFile_ = nullptr;
 }
@@ -164,44 +130,53 @@ uint32_t TiffFile::directoryCount() const {
   return tiffDir_.size();
 }
 
-class TileReadBuffer {
- public:
-  explicit TileReadBuffer(uint64_t size);
-  virtual ~TileReadBuffer();
-  tdata_t buffer_;
-};
-
-TileReadBuffer::TileReadBuffer(uint64_t size) {
-  buffer_ = _TIFFmalloc(size);
+void TiffFile::startTilePrefetch(const std::vector<uint32_t> &tileOrder,
+                                 size_t queueDepth) {
+  tilePrefetcher_ = nullptr;
+  if (queueDepth == 0 || tileOrder.empty()) {
+    return;
+  }
+  if (tileReader_ == nullptr || !tileReader_->isOpen()) {
+    BOOST_LOG_TRIVIAL(debug) << "Tiff tile byte ranges unavailable, tile "
+                                "prefetch disabled.";
+    return;
+  }
+  const size_t ioThreads = std::min<size_t>(queueDepth, 8);
+  tilePrefetcher_ = std::make_unique<TiffTilePrefetcher>(
+      tileReader_.get(), tileOrder, queueDepth, ioThreads);
+  if (!tilePrefetcher_->isOpen()) {
+    tilePrefetcher_ = nullptr;
+  }
 }
 
-TileReadBuffer::~TileReadBuffer() {
-  if (buffer_ != nullptr) {
-    _TIFFfree(buffer_);
+void TiffFile::stopTilePrefetch() {
+  if (tilePrefetcher_ == nullptr) {
+    return;
   }
+  BOOST_LOG_TRIVIAL(debug) << "Tiff tiles prefetched: " <<
+                              tilePrefetcher_->prefetchedTileCount() <<
+                              " read directly: " <<
+                              tilePrefetcher_->directReadTileCount();
+  tilePrefetcher_ = nullptr;
 }
 
 std::unique_ptr<TiffTile> TiffFile::tile(uint32_t tileIndex) {
   if (tiffFile_ == nullptr) {
     return nullptr;
   }
-  TileReadBuffer readBuffer(tileReadBufSize_);
-  if (readBuffer.buffer_ == nullptr) {
-    return nullptr;
+  uint64_t bufferSize;
+  std::unique_ptr<uint8_t[]> mem_buffer;
+  if (tilePrefetcher_ != nullptr) {
+    mem_buffer = tilePrefetcher_->tile(tileIndex, &bufferSize);
   }
-  uint32_t bufferSize = TIFFReadRawTile(tiffFile_,
-                                        static_cast<ttile_t>(tileIndex),
-                                        readBuffer.buffer_,
-                                        tileReadBufSize_);
-  if (bufferSize == 0) {
-    return nullptr;
+  if (mem_buffer == nullptr && tileReader_ != nullptr &&
+      tileReader_->isOpen()) {
+    // Positional read; does not touch shared libtiff handle.
+    mem_buffer = tileReader_->readTile(tileIndex, &bufferSize);
   }
-  std::unique_ptr<uint8_t[]> mem_buffer =
-                                       std::make_unique<uint8_t[]>(bufferSize);
   if (mem_buffer == nullptr) {
     return nullptr;
   }
-  _TIFFmemcpy(mem_buffer.get(), readBuffer.buffer_, bufferSize);
   return std::make_unique<TiffTile>(directory(directoryLevel()), tileIndex,
                                     std::move(mem_buffer), bufferSize);
 }
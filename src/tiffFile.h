@@ -16,16 +16,16 @@
 #define SRC_TIFFFILE_H_
 
 #include <absl/strings/string_view.h>
-#include <openslide.h>
 #include <tiffio.h>
 
 #include <memory>
 #include <string>
 #include <vector>
 
-#include "src/openslideUtil.h"
 #include "src/tiffDirectory.h"
+#include "src/tiffRawTileReader.h"
 #include "src/tiffTile.h"
+#include "src/tiffTilePrefetcher.h"
 
 namespace wsiToDicomConverter {
 
@@ -68,12 +68,16 @@ class TiffFile{
   const TiffDirectory *fileDirectory() const;
   uint32_t directoryCount() const;
   std::string path() const;
+  // Returns raw tile of current directory. Thread safe.
   std::unique_ptr<TiffTile> tile(uint32_t tileIndex);
   int32_t directoryLevel() const;
 
-  // Openslide interfaces. Used to decode JPEG2000
-  openslide_t * getOpenslidePtr();
-  int32_t getOpenslideLevel() const;
+  // Starts reading raw tiles of the current directory ahead of tile()
+  // requests. tileOrder - order tiles will be requested.
+  // queueDepth - maximum tiles read ahead of requests.
+  void startTilePrefetch(const std::vector<uint32_t> &tileOrder,
+                         size_t queueDepth);
+  void stopTilePrefetch();
 
   void close();
 
@@ -85,8 +89,8 @@ class TiffFile{
   const int32_t currentDirectoryIndex_;
   tsize_t tileReadBufSize_;
 
-  std::unique_ptr<OpenSlidePtr> osptr_;
-  int32_t openslide_level_;
+  std::unique_ptr<TiffRawTileReader> tileReader_;
+  std::unique_ptr<TiffTilePrefetcher> tilePrefetcher_;
 };
 
 
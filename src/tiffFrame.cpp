@@ -15,11 +15,11 @@
 #include <boost/log/trivial.hpp>
 #include <jpeglib.h>
 #include <dcmtk/dcmdata/dcdeftag.h>
-#include <openslide.h>
 
 #include <string>
 #include <utility>
 
+#include "src/jpeg2000Util.h"
 #include "src/jpegUtil.h"
 #include "src/tiffDirectory.h"
 #include "src/tiffFrame.h"
@@ -219,6 +219,21 @@ uint64_t frameIndexFromLocation(const TiffFile *tiffFile, const uint64_t level,
            (xLoc /  dir->tileWidth());
 }
 
+std::unique_ptr<uint8_t[]> tiffTileJpeg(TiffFile *tiffFile,
+                                        const uint64_t tileIndex,
+                                        uint64_t *size) {
+  std::unique_ptr<TiffTile> tile = tiffFile->tile(tileIndex);
+  if (tile == nullptr) {
+    *size = 0;
+    return nullptr;
+  }
+  if (tiffFile->fileDirectory()->hasJpegTableData()) {
+    return constructJpeg(tile.get(), size);
+  }
+  *size = tile->rawBufferSize();
+  return tile->getRawBuffer();
+}
+
 TiffFrame::TiffFrame(
     TiffFile *tiffFile, const uint64_t tileIndex, bool storeRawBytes):
     Frame(conFrameLocationX(tiffFile, tiffFile->directoryLevel(), tileIndex),
@@ -275,7 +290,7 @@ void TiffFrame::incSourceFrameReadCounter() {
 
 int64_t TiffFrame::rawABGRFrameBytes(uint8_t *rawMemory,
                                       int64_t memorySize) {
-  // tiff frame data in native format is jpeg encoded.
+  // tiff frame data in native format is jpeg or JPEG 2000 encoded.
   // uncompress and return # of bytes read.
   // return 0 if error occures.
   uint64_t abgrBufferSizeRead = 0;
@@ -286,53 +301,32 @@ int64_t TiffFrame::rawABGRFrameBytes(uint8_t *rawMemory,
                             rawCompressedBytes_.get(),
                             rawCompressedBytesSize_, rawMemory, memorySize)) {
       abgrBufferSizeRead = width * height * 4;
-  } else if (tiffDirectory()->isJpeg2kCompressed()) {
-    // if frame is jpeg2000 decode using OpenSlide.
-     openslide_t *opslide = tiffFile()->getOpenslidePtr();
-    int32_t level = tiffFile()->getOpenslideLevel();
-    uint32_t * buf_bytes = reinterpret_cast<uint32_t*>(rawMemory);
-    int64_t levelZeroWidth;
-    int64_t levelZeroHeight;
-    openslide_get_level0_dimensions(opslide, &levelZeroWidth, &levelZeroHeight);
-    int64_t levelZeroX = locationX() * levelZeroWidth /
-                         tiffDirectory()->imageWidth();
-    int64_t levelZeroY = locationY() * levelZeroHeight /
-                         tiffDirectory()->imageHeight();
-    openslide_read_region(opslide, buf_bytes, levelZeroX, levelZeroY,
-                          level, width, height);
-    if (openslide_get_error(opslide)) {
-       BOOST_LOG_TRIVIAL(error) << openslide_get_error(opslide);
-       throw 1;
-    }
-    // Uncommon, openslide C++ API premults RGB by alpha.
-    // if alpha is not zero reverse transform to get RGB
-    // https://openslide.org/api/openslide_8h.html
-    const uint32_t size = width * height;
-    for (uint32_t x = 0; x < size; ++x) {
-      const uint32_t pixel = buf_bytes[x];  // Pixel value to be downsampled
-      const int alpha = pixel >> 24;            // Alpha value of pixel
-      if (alpha == 0) {                         // If transparent skip
-        continue;
-      }
-      uint32_t red = (pixel >> 16) & 0xFF;  // Get RGB Bytes
-      uint32_t green = (pixel >> 8) & 0xFF;
-      uint32_t blue = pixel & 0xFF;
-      // Uncommon, openslide C++ API premults RGB by alpha.
-      // if alpha is not zero reverse transform to get RGB
-      // https://openslide.org/api/openslide_8h.html
-      if (alpha != 0xFF) {
-        red = red * 255 / alpha;
-        green = green * 255 / alpha;
-        blue = blue * 255 / alpha;
-      }
-      // Swap red and blue channel for dicom compatiability.
-      buf_bytes[x] = (alpha << 24) | (blue << 16) | (green << 8) | red;
-    }
+  } else if (tiffDirectory()->isJpeg2kCompressed() &&
+             jpeg2000Util::decodeJpeg2000(width, height,
+                                          tiffDirectory()->isJpeg2kYCbCr(),
+                                          0, rawCompressedBytes_.get(),
+                                          rawCompressedBytesSize_, rawMemory,
+                                          memorySize)) {
+    abgrBufferSizeRead = width * height * 4;
   }
   decReadCounter();
   return abgrBufferSizeRead;
 }
 
+bool TiffFrame::hasYCbCrFrameBytes() const {
+  return tiffDirectory()->isJpegCompressed() &&
+         jpegDecodeColorSpace() == JCS_YCbCr;
+}
+
+bool TiffFrame::ycbcrFrameBytes(YCbCrImage *image) {
+  const bool result = jpegUtil::decodeJpegToYCbCr(jpegDecodeColorSpace(),
+                                                  rawCompressedBytes_.get(),
+                                                  rawCompressedBytesSize_,
+                                                  image);
+  decReadCounter();
+  return result;
+}
+
 void TiffFrame::setDicomFrameBytes(std::unique_ptr<uint8_t[]> dcmdata,
                                                           uint64_t size) {
   size_ = size;
@@ -343,9 +337,7 @@ void TiffFrame::setDicomFrameBytes(std::unique_ptr<uint8_t[]> dcmdata,
   // ownership of pointer.
   dcmPixelItem_ = std::make_unique<DcmPixelItem>(DcmTag(DCM_Item, EVR_OB));
   dcmPixelItem_->putUint8Array(rawCompressedBytes_.get(), size_);
-  // if frame is jpeg2000 decode don't save encoded tiff.
-  // frame will be read using openslide
-  if (!storeRawBytes_ || tiffDirectory()->isJpeg2kCompressed()) {
+  if (!storeRawBytes_) {
     rawCompressedBytes_ = nullptr;
   }
 }
@@ -364,7 +356,7 @@ void TiffFrame::sliceFrame() {
   setDicomFrameBytes(std::move(mem), size);
   BOOST_LOG_TRIVIAL(debug) << " Tiff extracted frame size: " << size /
                                                                 1024 << "kb";
-  done_ = true;
+  setDone();
 }
 
 }  // namespace wsiToDicomConverter
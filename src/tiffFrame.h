@@ -29,6 +29,13 @@ namespace wsiToDicomConverter {
 uint64_t frameIndexFromLocation(const TiffFile *tiffFile, const uint64_t level,
                                 const int64_t xLoc, const int64_t yLoc);
 
+// Returns complete jpeg of tile in tiff file's current directory. Jpeg
+// tables stored separately in the directory are merged into the jpeg.
+// Returns nullptr if tile could not be read.
+std::unique_ptr<uint8_t[]> tiffTileJpeg(TiffFile *tiffFile,
+                                        const uint64_t tileIndex,
+                                        uint64_t *size);
+
 // TiffFrame represents a image extracted without decompression
 // from a SVS or Tiff file. Enables Tiff files composed of Lossy
 // JPEG images to be added to DICOM directly; avoiding image
@@ -47,6 +54,8 @@ class TiffFrame : public Frame {
   virtual void sliceFrame();
   virtual absl::string_view photoMetrInt() const;
   virtual int64_t rawABGRFrameBytes(uint8_t *raw_memory, int64_t memorysize);
+  virtual bool hasYCbCrFrameBytes() const;
+  virtual bool ycbcrFrameBytes(YCbCrImage *image);
   virtual void incSourceFrameReadCounter();
   TiffFile *tiffFile() const;
   uint64_t tileIndex() const;
@@ -0,0 +1,107 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/tiffRawTileReader.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <boost/log/trivial.hpp>
+
+#include <cerrno>
+#include <string>
+
+namespace wsiToDicomConverter {
+
+TiffRawTileReader::TiffRawTileReader(TIFF *tiff, absl::string_view path) :
+                                     fd_(-1) {
+  if (tiff == nullptr || !TIFFIsTiled(tiff)) {
+    return;
+  }
+  uint64_t *tileOffsets = nullptr;
+  uint64_t *tileByteCounts = nullptr;
+  if (!TIFFGetField(tiff, TIFFTAG_TILEOFFSETS, &tileOffsets) ||
+      !TIFFGetField(tiff, TIFFTAG_TILEBYTECOUNTS, &tileByteCounts) ||
+      tileOffsets == nullptr || tileByteCounts == nullptr) {
+    return;
+  }
+  const uint32_t tileCount = TIFFNumberOfTiles(tiff);
+  tileOffsets_.assign(tileOffsets, tileOffsets + tileCount);
+  tileByteCounts_.assign(tileByteCounts, tileByteCounts + tileCount);
+  const std::string path_str = static_cast<std::string>(path);
+  fd_ = open(path_str.c_str(), O_RDONLY);
+  if (fd_ == -1) {
+    BOOST_LOG_TRIVIAL(error) << "Could not open " << path_str;
+  }
+}
+
+TiffRawTileReader::~TiffRawTileReader() {
+  if (fd_ != -1) {
+    close(fd_);
+  }
+}
+
+bool TiffRawTileReader::isOpen() const {
+  return fd_ != -1;
+}
+
+uint32_t TiffRawTileReader::tileCount() const {
+  return tileOffsets_.size();
+}
+
+uint64_t TiffRawTileReader::tileByteCount(uint32_t tileIndex) const {
+  if (tileIndex >= tileByteCounts_.size()) {
+    return 0;
+  }
+  return tileByteCounts_[tileIndex];
+}
+
+uint64_t TiffRawTileReader::readTile(uint32_t tileIndex, uint8_t *buffer,
+                                     uint64_t bufferSize) const {
+  const uint64_t byteCount = tileByteCount(tileIndex);
+  if (fd_ == -1 || byteCount == 0 || byteCount > bufferSize) {
+    return 0;
+  }
+  const uint64_t offset = tileOffsets_[tileIndex];
+  uint64_t bytesRead = 0;
+  while (bytesRead < byteCount) {
+    const ssize_t result = pread(fd_, buffer + bytesRead,
+                                 byteCount - bytesRead, offset + bytesRead);
+    if (result < 0 && errno == EINTR) {
+      continue;
+    }
+    if (result <= 0) {
+      BOOST_LOG_TRIVIAL(error) << "Error reading tiff tile " << tileIndex;
+      return 0;
+    }
+    bytesRead += result;
+  }
+  return bytesRead;
+}
+
+std::unique_ptr<uint8_t[]> TiffRawTileReader::readTile(uint32_t tileIndex,
+                                                       uint64_t *size) const {
+  *size = 0;
+  const uint64_t byteCount = tileByteCount(tileIndex);
+  if (fd_ == -1 || byteCount == 0) {
+    return nullptr;
+  }
+  std::unique_ptr<uint8_t[]> buffer = std::make_unique<uint8_t[]>(byteCount);
+  if (readTile(tileIndex, buffer.get(), byteCount) != byteCount) {
+    return nullptr;
+  }
+  *size = byteCount;
+  return buffer;
+}
+
+}  // namespace wsiToDicomConverter
@@ -0,0 +1,63 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SRC_TIFFRAWTILEREADER_H_
+#define SRC_TIFFRAWTILEREADER_H_
+
+#include <absl/strings/string_view.h>
+#include <tiffio.h>
+
+#include <memory>
+#include <vector>
+
+namespace wsiToDicomConverter {
+
+/* Reads raw (encoded) tiles of one TIFF directory.
+
+   Tile byte offsets and byte counts are read from the TIFF directory once
+   at construction; tiles are then read with pread on a dedicated file
+   descriptor. Reader holds no mutable state after construction and is safe
+   to use from any number of threads without locking.
+*/
+class TiffRawTileReader {
+ public:
+  // tiff : libtiff handle set to directory to read; only used during
+  //        construction.
+  // path : path of tiff file.
+  TiffRawTileReader(TIFF *tiff, absl::string_view path);
+  TiffRawTileReader(const TiffRawTileReader &) = delete;
+  TiffRawTileReader &operator =(const TiffRawTileReader &) = delete;
+  virtual ~TiffRawTileReader();
+
+  bool isOpen() const;
+  uint32_t tileCount() const;
+  uint64_t tileByteCount(uint32_t tileIndex) const;
+
+  // Reads tile into caller buffer. Returns bytes read, 0 on error or if
+  // buffer is smaller than tile.
+  uint64_t readTile(uint32_t tileIndex, uint8_t *buffer,
+                    uint64_t bufferSize) const;
+
+  // Reads tile into allocated buffer and sets size. nullptr on error.
+  std::unique_ptr<uint8_t[]> readTile(uint32_t tileIndex,
+                                      uint64_t *size) const;
+
+ private:
+  int fd_;
+  std::vector<uint64_t> tileOffsets_;
+  std::vector<uint64_t> tileByteCounts_;
+};
+
+}  // namespace wsiToDicomConverter
+#endif  // SRC_TIFFRAWTILEREADER_H_
@@ -0,0 +1,238 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/tiffRegionReader.h"
+
+#include <boost/log/trivial.hpp>
+#include <jpeglib.h>
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include "src/jpeg2000Util.h"
+#include "src/jpegUtil.h"
+#include "src/tiffFrame.h"
+
+namespace wsiToDicomConverter {
+
+TiffRegionReader::TiffRegionReader(const std::string &path,
+                                   int64_t cacheSizeBytes) :
+                                   cacheSizeBytes_(cacheSizeBytes),
+                                   cachedBytes_(0) {
+  tiffFile_ = std::make_unique<TiffFile>(path);
+  if (tiffFile_->isInitalized()) {
+    directoryFiles_.resize(tiffFile_->directoryCount());
+  }
+}
+
+TiffRegionReader::~TiffRegionReader() {
+  TiffRegionReaderStats readStats = stats();
+  if (readStats.regionReads > 0) {
+    const int64_t tiles = readStats.tileHits + readStats.tileMisses;
+    BOOST_LOG_TRIVIAL(debug) << "Tiff region reads: " <<
+                                readStats.regionReads << "; tile cache "
+                                "hits: " << readStats.tileHits << " / " <<
+                                tiles << "; tiles decoded / unique tiles: " <<
+                                readStats.tileMisses << " / " <<
+                                readStats.uniqueTiles;
+  }
+}
+
+bool TiffRegionReader::isValid() const {
+  return tiffFile_->isInitalized() && tiffFile_->hasExtractablePyramidImages();
+}
+
+int32_t TiffRegionReader::directoryIndex(int64_t width,
+                                         int64_t height) const {
+  if (!isValid()) {
+    return -1;
+  }
+  for (uint32_t idx = 0; idx < tiffFile_->directoryCount(); ++idx) {
+    const TiffDirectory *dir = tiffFile_->directory(idx);
+    if (dir->isExtractablePyramidImage() &&
+        (dir->isJpegCompressed() || dir->isJpeg2kCompressed()) &&
+        dir->imageDepth() <= 1 && dir->doImageDimensionsMatch(width,
+                                                              height)) {
+      return idx;
+    }
+  }
+  return -1;
+}
+
+bool TiffRegionReader::canReadReducedRegion(int32_t dirIndex,
+                                            int32_t reduce) const {
+  if (reduce == 0) {
+    return true;
+  }
+  const TiffDirectory *dir = tiffFile_->directory(dirIndex);
+  const int64_t scale = static_cast<int64_t>(1) << reduce;
+  return reduce > 0 && dir->isJpeg2kCompressed() &&
+         dir->tileWidth() % scale == 0 && dir->tileHeight() % scale == 0;
+}
+
+TiffFile *TiffRegionReader::directoryFile(int32_t dirIndex) {
+  boost::lock_guard<boost::mutex> lock(directoryMutex_);
+  std::unique_ptr<TiffFile> &dirFile = directoryFiles_.at(dirIndex);
+  if (dirFile == nullptr) {
+    dirFile = std::make_unique<TiffFile>(*tiffFile_, dirIndex);
+  }
+  return dirFile.get();
+}
+
+TiffRegionReader::DecodedTile TiffRegionReader::decodeTile(
+                                          TiffFile *tiffFile, int32_t reduce,
+                                          uint64_t tileIndex) const {
+  const TiffDirectory *dir = tiffFile->fileDirectory();
+  const int64_t tileWidth = dir->tileWidth() >> reduce;
+  const int64_t tileHeight = dir->tileHeight() >> reduce;
+  const int64_t pixelCount = tileWidth * tileHeight;
+  std::shared_ptr<std::vector<uint32_t>> tile =
+                       std::make_shared<std::vector<uint32_t>>(pixelCount);
+  uint8_t *tileMemory = reinterpret_cast<uint8_t *>(tile->data());
+  if (dir->isJpeg2kCompressed()) {
+    std::unique_ptr<TiffTile> j2kTile = tiffFile->tile(tileIndex);
+    if (j2kTile == nullptr ||
+        !jpeg2000Util::decodeJpeg2000(tileWidth, tileHeight,
+                                      dir->isJpeg2kYCbCr(), reduce,
+                                      j2kTile->rawBuffer(),
+                                      j2kTile->rawBufferSize(), tileMemory,
+                                      pixelCount * sizeof(uint32_t))) {
+      return nullptr;
+    }
+  } else {
+    uint64_t size;
+    std::unique_ptr<uint8_t[]> jpeg = tiffTileJpeg(tiffFile, tileIndex,
+                                                   &size);
+    if (jpeg == nullptr ||
+        !jpegUtil::decodeJpeg(tileWidth, tileHeight,
+                              dir->isPhotoMetricRGB() ? JCS_RGB : JCS_YCbCr,
+                              jpeg.get(), size, tileMemory,
+                              pixelCount * sizeof(uint32_t))) {
+      return nullptr;
+    }
+  }
+  // Decoded R, G, B, A bytes to openslide ARGB.
+  for (uint32_t &pixel : *tile) {
+    const uint8_t *rgba = reinterpret_cast<const uint8_t *>(&pixel);
+    pixel = 0xFF000000 | (static_cast<uint32_t>(rgba[0]) << 16) |
+            (static_cast<uint32_t>(rgba[1]) << 8) | rgba[2];
+  }
+  return tile;
+}
+
+TiffRegionReader::DecodedTile TiffRegionReader::decodedTile(
+                                    int32_t dirIndex, int32_t reduce,
+                                    uint64_t tileIndex) {
+  const uint64_t key = (static_cast<uint64_t>(dirIndex) << 48) |
+                       (static_cast<uint64_t>(reduce) << 40) | tileIndex;
+  {
+    boost::unique_lock<boost::mutex> lock(cacheMutex_);
+    // Wait if tile is being decoded by another reader.
+    tileDecoded_.wait(lock, [this, key] {
+      return decodingTiles_.find(key) == decodingTiles_.end();
+    });
+    auto found = tileCache_.find(key);
+    if (found != tileCache_.end()) {
+      stats_.tileHits += 1;
+      tileLru_.splice(tileLru_.begin(), tileLru_, found->second.lru);
+      return found->second.tile;
+    }
+    stats_.tileMisses += 1;
+    if (decodedTiles_.insert(key).second) {
+      stats_.uniqueTiles += 1;
+    }
+    decodingTiles_.insert(key);
+  }
+  DecodedTile tile = decodeTile(directoryFile(dirIndex), reduce, tileIndex);
+  {
+    boost::lock_guard<boost::mutex> lock(cacheMutex_);
+    decodingTiles_.erase(key);
+    if (tile != nullptr) {
+      tileLru_.push_front(key);
+      tileCache_[key] = {tileLru_.begin(), tile};
+      cachedBytes_ += tile->size() * sizeof(uint32_t);
+      // Most recently decoded tile is always retained.
+      while (cachedBytes_ > cacheSizeBytes_ && tileLru_.size() > 1) {
+        auto evicted = tileCache_.find(tileLru_.back());
+        cachedBytes_ -= evicted->second.tile->size() * sizeof(uint32_t);
+        tileCache_.erase(evicted);
+        tileLru_.pop_back();
+      }
+    }
+  }
+  tileDecoded_.notify_all();
+  return tile;
+}
+
+bool TiffRegionReader::readRegion(int32_t dirIndex, int64_t x, int64_t y,
+                                  int64_t width, int64_t height,
+                                  uint32_t *dest) {
+  return readReducedRegion(dirIndex, 0, x, y, width, height, dest);
+}
+
+bool TiffRegionReader::readReducedRegion(int32_t dirIndex, int32_t reduce,
+                                         int64_t x, int64_t y, int64_t width,
+                                         int64_t height, uint32_t *dest) {
+  {
+    boost::lock_guard<boost::mutex> lock(cacheMutex_);
+    stats_.regionReads += 1;
+  }
+  const TiffDirectory *dir = tiffFile_->directory(dirIndex);
+  const int64_t scale = static_cast<int64_t>(1) << reduce;
+  const int64_t tileWidth = dir->tileWidth() / scale;
+  const int64_t tileHeight = dir->tileHeight() / scale;
+  const int64_t imageWidth = (dir->imageWidth() + scale - 1) / scale;
+  const int64_t imageHeight = (dir->imageHeight() + scale - 1) / scale;
+  std::memset(dest, 0, width * height * sizeof(uint32_t));
+  // Region clipped to image.
+  const int64_t startX = std::max<int64_t>(x, 0);
+  const int64_t startY = std::max<int64_t>(y, 0);
+  const int64_t endX = std::min<int64_t>(x + width, imageWidth);
+  const int64_t endY = std::min<int64_t>(y + height, imageHeight);
+  if (startX >= endX || startY >= endY) {
+    return true;
+  }
+  for (int64_t tileY = startY / tileHeight; tileY <= (endY - 1) / tileHeight;
+       ++tileY) {
+    for (int64_t tileX = startX / tileWidth; tileX <= (endX - 1) / tileWidth;
+         ++tileX) {
+      DecodedTile tile = decodedTile(dirIndex, reduce,
+                                     tileY * dir->tilesPerRow() + tileX);
+      if (tile == nullptr) {
+        BOOST_LOG_TRIVIAL(error) << "Error decoding tiff tile.";
+        return false;
+      }
+      // Intersection of tile and clipped region.
+      const int64_t copyStartX = std::max(startX, tileX * tileWidth);
+      const int64_t copyEndX = std::min(endX, (tileX + 1) * tileWidth);
+      const int64_t copyStartY = std::max(startY, tileY * tileHeight);
+      const int64_t copyEndY = std::min(endY, (tileY + 1) * tileHeight);
+      for (int64_t row = copyStartY; row < copyEndY; ++row) {
+        std::memcpy(dest + (row - y) * width + (copyStartX - x),
+                    tile->data() + (row - tileY * tileHeight) * tileWidth +
+                    (copyStartX - tileX * tileWidth),
+                    (copyEndX - copyStartX) * sizeof(uint32_t));
+      }
+    }
+  }
+  return true;
+}
+
+TiffRegionReaderStats TiffRegionReader::stats() const {
+  boost::lock_guard<boost::mutex> lock(cacheMutex_);
+  return stats_;
+}
+
+}  // namespace wsiToDicomConverter
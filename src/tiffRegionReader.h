@@ -0,0 +1,134 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SRC_TIFFREGIONREADER_H_
+#define SRC_TIFFREGIONREADER_H_
+
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "src/tiffFile.h"
+
+namespace wsiToDicomConverter {
+
+// Statistics of TiffRegionReader reads.
+struct TiffRegionReaderStats {
+  int64_t regionReads = 0;
+  // Decoded tiles returned from cache, including tiles decoded by another
+  // reader while waiting.
+  int64_t tileHits = 0;
+  // Tiles decoded.
+  int64_t tileMisses = 0;
+  // Distinct tiles decoded; tileMisses / uniqueTiles is the number of
+  // times each tile was decoded.
+  int64_t uniqueTiles = 0;
+};
+
+/* Reads regions of jpeg or JPEG 2000 encoded tiled TIFF/SVS pyramid images
+   without OpenSlide.
+
+   Tiles a region touches are read with TiffFile::tile, decoded with
+   libjpeg or OpenJPEG, and held in a shared LRU cache of decoded tiles so
+   tiles which straddle frame boundaries are decoded once. Tiles are
+   decoded by the requesting thread; a tile requested while another thread
+   is decoding it waits for that decode. Reads are thread safe.
+
+   Regions are returned in openslide_read_region pixel format (ARGB
+   uint32, alpha = 0xFF); pixels outside the image are 0. Reader is a drop
+   in replacement for openslide reads of the levels it supports.
+
+   JPEG 2000 images can also be read at reduced resolution; the highest
+   wavelet resolution levels are not decoded.
+*/
+class TiffRegionReader {
+ public:
+  // path - tiff file to read.
+  // cacheSizeBytes - capacity of decoded tile cache.
+  TiffRegionReader(const std::string &path, int64_t cacheSizeBytes);
+  TiffRegionReader(const TiffRegionReader &) = delete;
+  TiffRegionReader &operator =(const TiffRegionReader &) = delete;
+  virtual ~TiffRegionReader();
+
+  // True if file has pyramid images which can be read.
+  bool isValid() const;
+
+  // Returns index of jpeg or JPEG 2000 encoded pyramid image directory with
+  // dimensions. Returns -1 if no directory can be read.
+  int32_t directoryIndex(int64_t width, int64_t height) const;
+
+  // True if directory can be read at 1 / 2^reduce resolution. Requires
+  // JPEG 2000 tiles with dimensions divisible by 2^reduce.
+  bool canReadReducedRegion(int32_t dirIndex, int32_t reduce) const;
+
+  // Reads region of directory into dest.
+  //
+  // Args:
+  //   dirIndex : directory returned by directoryIndex.
+  //   x, y : upper left coordinate of region in directory image.
+  //   width, height : dimensions of region and dest.
+  //   dest : memory to read into.
+  //
+  // Returns: false if a tile could not be read or decoded.
+  bool readRegion(int32_t dirIndex, int64_t x, int64_t y, int64_t width,
+                  int64_t height, uint32_t *dest);
+
+  // Reads region of directory image at 1 / 2^reduce resolution. x, y,
+  // width, height are in reduced image coordinates. Directory must support
+  // canReadReducedRegion.
+  bool readReducedRegion(int32_t dirIndex, int32_t reduce, int64_t x,
+                         int64_t y, int64_t width, int64_t height,
+                         uint32_t *dest);
+
+  TiffRegionReaderStats stats() const;
+
+ private:
+  typedef std::shared_ptr<const std::vector<uint32_t>> DecodedTile;
+
+  TiffFile *directoryFile(int32_t dirIndex);
+  DecodedTile decodedTile(int32_t dirIndex, int32_t reduce,
+                          uint64_t tileIndex);
+  DecodedTile decodeTile(TiffFile *tiffFile, int32_t reduce,
+                         uint64_t tileIndex) const;
+
+  std::unique_ptr<TiffFile> tiffFile_;
+  // Tiff handle per directory, opened on first read.
+  std::vector<std::unique_ptr<TiffFile>> directoryFiles_;
+  boost::mutex directoryMutex_;
+
+  // Decoded tile LRU cache keyed by directory, resolution and tile index.
+  const int64_t cacheSizeBytes_;
+  int64_t cachedBytes_;
+  std::list<uint64_t> tileLru_;
+  struct CacheEntry {
+    std::list<uint64_t>::iterator lru;
+    DecodedTile tile;
+  };
+  std::unordered_map<uint64_t, CacheEntry> tileCache_;
+  std::unordered_set<uint64_t> decodingTiles_;
+  std::unordered_set<uint64_t> decodedTiles_;
+  mutable boost::mutex cacheMutex_;
+  boost::condition_variable tileDecoded_;
+  TiffRegionReaderStats stats_;
+};
+
+}  // namespace wsiToDicomConverter
+
+#endif  // SRC_TIFFREGIONREADER_H_
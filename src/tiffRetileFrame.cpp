@@ -0,0 +1,163 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/tiffRetileFrame.h"
+
+#include <boost/log/trivial.hpp>
+#include <dcmtk/dcmdata/dcdeftag.h>
+#include <dcmtk/dcmdata/dcpxitem.h>
+
+#include <string>
+#include <utility>
+
+#include "src/jpegUtil.h"
+#include "src/tiffDirectory.h"
+#include "src/tiffFrame.h"
+
+namespace wsiToDicomConverter {
+
+TiffRetileFrame::TiffRetileFrame(TiffFile *tiffFile, int64_t locationX,
+                                 int64_t locationY, int64_t frameWidth,
+                                 int64_t frameHeight, bool storeRawBytes) :
+    Frame(locationX, locationY, frameWidth, frameHeight, NONE, -1,
+          subsample_420, storeRawBytes),
+    tiffFile_(tiffFile) {
+}
+
+TiffRetileFrame::~TiffRetileFrame() {}
+
+const TiffDirectory *TiffRetileFrame::tiffDirectory() const {
+  return tiffFile_->fileDirectory();
+}
+
+J_COLOR_SPACE TiffRetileFrame::jpegDecodeColorSpace() const {
+  return tiffDirectory()->isPhotoMetricRGB() ? JCS_RGB : JCS_YCbCr;
+}
+
+absl::string_view TiffRetileFrame::photoMetrInt() const {
+  return tiffDirectory()->photoMetrIntStr();
+}
+
+void TiffRetileFrame::incSourceFrameReadCounter() {
+  // Reads from Tiff no source frame counter to increment.
+}
+
+std::vector<int64_t> TiffRetileFrame::tileIndexes() const {
+  const TiffDirectory *dir = tiffDirectory();
+  const int64_t firstColumn = locationX() / dir->tileWidth();
+  const int64_t firstRow = locationY() / dir->tileHeight();
+  const int64_t columns = frameWidth() / dir->tileWidth();
+  const int64_t rows = frameHeight() / dir->tileHeight();
+  std::vector<int64_t> indexes;
+  indexes.reserve(columns * rows);
+  for (int64_t row = firstRow; row < firstRow + rows; ++row) {
+    for (int64_t column = firstColumn; column < firstColumn + columns;
+         ++column) {
+      if (row < dir->tilesPerColumn() && column < dir->tilesPerRow()) {
+        indexes.push_back(row * dir->tilesPerRow() + column);
+      } else {
+        indexes.push_back(-1);
+      }
+    }
+  }
+  return indexes;
+}
+
+int64_t TiffRetileFrame::rawABGRFrameBytes(uint8_t *rawMemory,
+                                           int64_t memorySize) {
+  // Retained frame is jpeg encoded.
+  // uncompress and return # of bytes read.
+  // return 0 if error occures.
+  uint64_t abgrBufferSizeRead = 0;
+  const uint64_t width = frameWidth();
+  const uint64_t height = frameHeight();
+  if (jpegUtil::decodeJpeg(width, height, jpegDecodeColorSpace(),
+                           rawCompressedBytes_.get(), rawCompressedBytesSize_,
+                           rawMemory, memorySize)) {
+    abgrBufferSizeRead = width * height * 4;
+  }
+  decReadCounter();
+  return abgrBufferSizeRead;
+}
+
+bool TiffRetileFrame::hasYCbCrFrameBytes() const {
+  return jpegDecodeColorSpace() == JCS_YCbCr;
+}
+
+bool TiffRetileFrame::ycbcrFrameBytes(YCbCrImage *image) {
+  const bool result = jpegUtil::decodeJpegToYCbCr(jpegDecodeColorSpace(),
+                                                  rawCompressedBytes_.get(),
+                                                  rawCompressedBytesSize_,
+                                                  image);
+  decReadCounter();
+  return result;
+}
+
+void TiffRetileFrame::setDicomFrameBytes(std::unique_ptr<uint8_t[]> dcmdata,
+                                         uint64_t size) {
+  size_ = size;
+  // Store a copy of the data for downsampling.
+  rawCompressedBytesSize_ = size;
+  rawCompressedBytes_ = std::move(dcmdata);
+  // Pointer will be handed to DCMTK when frame is written.  DCMTK will take
+  // ownership of pointer.
+  dcmPixelItem_ = std::make_unique<DcmPixelItem>(DcmTag(DCM_Item, EVR_OB));
+  dcmPixelItem_->putUint8Array(rawCompressedBytes_.get(), size_);
+  if (!storeRawBytes_) {
+    rawCompressedBytes_ = nullptr;
+  }
+}
+
+std::string TiffRetileFrame::derivationDescription() const {
+  // Returns frame component of DCM_DerivationDescription
+  // describes in text how frame imaging data was saved in frame.
+  return std::string("embedded as encapsulated JPEG; Imaging bytes"
+                     " re-tiled without decompression.");
+}
+
+void TiffRetileFrame::sliceFrame() {
+  const TiffDirectory *dir = tiffDirectory();
+  const std::vector<int64_t> indexes = tileIndexes();
+  std::vector<std::unique_ptr<uint8_t[]>> tileMem;
+  std::vector<const uint8_t*> tiles;
+  std::vector<uint64_t> tileSizes;
+  for (int64_t tileIndex : indexes) {
+    uint64_t size = 0;
+    if (tileIndex != -1) {
+      tileMem.push_back(tiffTileJpeg(tiffFile_, tileIndex, &size));
+      if (tileMem.back() == nullptr) {
+        BOOST_LOG_TRIVIAL(error) << "Error reading jpeg tile in TIFF file.";
+        throw 1;
+      }
+    } else {
+      tileMem.push_back(nullptr);
+    }
+    tiles.push_back(tileMem.back().get());
+    tileSizes.push_back(size);
+  }
+  uint64_t size;
+  std::unique_ptr<uint8_t[]> mem = jpegUtil::stitchJpegTiles(
+      tiles, tileSizes, frameWidth() / dir->tileWidth(),
+      frameHeight() / dir->tileHeight(), jpegDecodeColorSpace(), &size);
+  if (mem == nullptr) {
+    BOOST_LOG_TRIVIAL(error) << "Error re-tiling jpeg tiles in TIFF file.";
+    throw 1;
+  }
+  setDicomFrameBytes(std::move(mem), size);
+  BOOST_LOG_TRIVIAL(debug) << " Tiff re-tiled frame size: " << size /
+                                                               1024 << "kb";
+  setDone();
+}
+
+}  // namespace wsiToDicomConverter
@@ -0,0 +1,72 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SRC_TIFFRETILEFRAME_H_
+#define SRC_TIFFRETILEFRAME_H_
+#include <absl/strings/string_view.h>
+#include <jpeglib.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "src/frame.h"
+#include "src/tiffFile.h"
+
+namespace wsiToDicomConverter {
+
+// TiffRetileFrame represents a frame joined from a grid of JPEG tiles
+// extracted without decompression from a SVS or Tiff file. Enables frames
+// larger than the scanner's tiles to be added to DICOM without image
+// uncompression & recompression artifacts; tile DCT coefficients are
+// copied into the frame.
+//
+// Frame dimensions must be a multiple of the tile dimensions and tiles
+// must be MCU aligned (see jpegUtil::stitchJpegTiles).
+class TiffRetileFrame : public Frame {
+ public:
+  TiffRetileFrame(TiffFile *tiffFile, int64_t locationX, int64_t locationY,
+                  int64_t frameWidth, int64_t frameHeight,
+                  bool storeRawBytes);
+  TiffRetileFrame(const TiffRetileFrame &frame) = delete;
+  TiffRetileFrame &operator =(const TiffRetileFrame &frame) = delete;
+  virtual ~TiffRetileFrame();
+
+  virtual void sliceFrame();
+  virtual absl::string_view photoMetrInt() const;
+  virtual int64_t rawABGRFrameBytes(uint8_t *raw_memory, int64_t memorysize);
+  virtual bool hasYCbCrFrameBytes() const;
+  virtual bool ycbcrFrameBytes(YCbCrImage *image);
+  virtual void incSourceFrameReadCounter();
+  virtual void setDicomFrameBytes(std::unique_ptr<uint8_t[]> dcmdata,
+                                  uint64_t size);
+
+  // Returns frame component of DCM_DerivationDescription
+  // describes in text how frame imaging data was saved in frame.
+  virtual std::string derivationDescription() const;
+
+  // Index of tiles joined in frame in row major order; -1 for tiles
+  // outside of the image.
+  std::vector<int64_t> tileIndexes() const;
+
+ private:
+  const TiffDirectory *tiffDirectory() const;
+  J_COLOR_SPACE jpegDecodeColorSpace() const;
+
+  TiffFile *tiffFile_;
+};
+
+}  // namespace wsiToDicomConverter
+
+#endif  // SRC_TIFFRETILEFRAME_H_
@@ -0,0 +1,174 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/tiffTilePrefetcher.h"
+
+#include <boost/asio/post.hpp>
+
+#include <algorithm>
+#include <utility>
+
+namespace wsiToDicomConverter {
+
+TiffTilePrefetcher::TiffTilePrefetcher(const TiffRawTileReader *tileReader,
+                                       const std::vector<uint32_t> &tileOrder,
+                                       size_t queueDepth, size_t ioThreads) :
+    tileReader_(tileReader),
+    queueDepth_(std::max<size_t>(queueDepth, 1)),
+    nextScheduledIndex_(0), queuedTileCount_(0), skippedIndex_(0),
+    prefetchedTileCount_(0),
+    directReadTileCount_(0), stopping_(false),
+    ioPool_(std::max<size_t>(ioThreads, 1)) {
+  const uint32_t tileCount = tileReader_->tileCount();
+  tileOrder_.reserve(tileOrder.size());
+  for (uint32_t tileIndex : tileOrder) {
+    // Tiles are prefetched once; repeat requests are read directly.
+    if (tileIndex < tileCount &&
+        tileOrderIndex_.find(tileIndex) == tileOrderIndex_.end()) {
+      tileOrderIndex_[tileIndex] = tileOrder_.size();
+      tileOrder_.push_back(tileIndex);
+    }
+  }
+  tileState_.resize(tileOrder_.size(), PENDING);
+  tileBuffer_.resize(tileOrder_.size());
+  tileBufferSize_.resize(tileOrder_.size(), 0);
+  boost::lock_guard<boost::mutex> lock(mutex_);
+  scheduleReads();
+}
+
+TiffTilePrefetcher::~TiffTilePrefetcher() {
+  {
+    boost::lock_guard<boost::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  ioPool_.join();
+}
+
+bool TiffTilePrefetcher::isOpen() const {
+  return tileReader_->isOpen();
+}
+
+int64_t TiffTilePrefetcher::prefetchedTileCount() const {
+  boost::lock_guard<boost::mutex> lock(mutex_);
+  return prefetchedTileCount_;
+}
+
+int64_t TiffTilePrefetcher::directReadTileCount() const {
+  boost::lock_guard<boost::mutex> lock(mutex_);
+  return directReadTileCount_;
+}
+
+void TiffTilePrefetcher::scheduleReads() {
+  if (!isOpen()) {
+    return;
+  }
+  while (!stopping_ && queuedTileCount_ < queueDepth_ &&
+         nextScheduledIndex_ < tileOrder_.size()) {
+    const size_t orderIndex = nextScheduledIndex_;
+    ++nextScheduledIndex_;
+    if (tileState_[orderIndex] != PENDING) {
+      // Tile was read directly by a worker ahead of prefetch.
+      continue;
+    }
+    tileState_[orderIndex] = READING;
+    ++queuedTileCount_;
+    boost::asio::post(ioPool_, [this, orderIndex]() {
+      readTile(orderIndex);
+    });
+  }
+}
+
+void TiffTilePrefetcher::releaseSkippedTiles(size_t orderIndex) {
+  if (orderIndex < queueDepth_) {
+    return;
+  }
+  const size_t skippedEnd = orderIndex - queueDepth_;
+  for (; skippedIndex_ < skippedEnd; ++skippedIndex_) {
+    if (tileState_[skippedIndex_] == READY) {
+      tileBuffer_[skippedIndex_] = nullptr;
+      tileBufferSize_[skippedIndex_] = 0;
+      tileState_[skippedIndex_] = CONSUMED;
+      --queuedTileCount_;
+    }
+    // Tiles being read are released when their read completes.
+  }
+  // Prefetch continues from consumer rather than tiles behind it.
+  nextScheduledIndex_ = std::max(nextScheduledIndex_, orderIndex);
+}
+
+void TiffTilePrefetcher::readTile(size_t orderIndex) {
+  {
+    boost::lock_guard<boost::mutex> lock(mutex_);
+    if (stopping_) {
+      return;
+    }
+  }
+  uint64_t size = 0;
+  std::unique_ptr<uint8_t[]> buffer = tileReader_->readTile(
+                                                tileOrder_[orderIndex], &size);
+  {
+    boost::lock_guard<boost::mutex> lock(mutex_);
+    if (orderIndex < skippedIndex_) {
+      // Consumer moved past tile while it was read.
+      tileState_[orderIndex] = CONSUMED;
+      --queuedTileCount_;
+      scheduleReads();
+    } else {
+      tileBuffer_[orderIndex] = std::move(buffer);
+      tileBufferSize_[orderIndex] = size;
+      tileState_[orderIndex] = READY;
+    }
+  }
+  tileReady_.notify_all();
+}
+
+std::unique_ptr<uint8_t[]> TiffTilePrefetcher::tile(uint32_t tileIndex,
+                                                    uint64_t *size) {
+  *size = 0;
+  if (!isOpen()) {
+    return nullptr;
+  }
+  std::unordered_map<uint32_t, size_t>::const_iterator orderIndexIter =
+                                               tileOrderIndex_.find(tileIndex);
+  if (orderIndexIter == tileOrderIndex_.end()) {
+    return nullptr;
+  }
+  const size_t orderIndex = orderIndexIter->second;
+  {
+    boost::unique_lock<boost::mutex> lock(mutex_);
+    if (orderIndex > skippedIndex_ + queueDepth_) {
+      releaseSkippedTiles(orderIndex);
+      scheduleReads();
+    }
+    while (tileState_[orderIndex] == READING) {
+      tileReady_.wait(lock);
+    }
+    if (tileState_[orderIndex] == READY) {
+      std::unique_ptr<uint8_t[]> buffer = std::move(tileBuffer_[orderIndex]);
+      *size = tileBufferSize_[orderIndex];
+      tileBufferSize_[orderIndex] = 0;
+      tileState_[orderIndex] = CONSUMED;
+      --queuedTileCount_;
+      ++prefetchedTileCount_;
+      scheduleReads();
+      return buffer;
+    }
+    // Pending (prefetch has not reached tile) or already consumed.
+    tileState_[orderIndex] = CONSUMED;
+    ++directReadTileCount_;
+  }
+  return tileReader_->readTile(tileIndex, size);
+}
+
+}  // namespace wsiToDicomConverter
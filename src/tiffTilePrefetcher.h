@@ -0,0 +1,95 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SRC_TIFFTILEPREFETCHER_H_
+#define SRC_TIFFTILEPREFETCHER_H_
+
+#include <boost/asio/thread_pool.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "src/tiffRawTileReader.h"
+
+namespace wsiToDicomConverter {
+
+/* Reads raw TIFF tiles ahead of the workers which consume them.
+
+   Tiles are read in the order frames of a level are processed, through
+   TiffRawTileReader, using a small pool of I/O threads. At most queueDepth
+   tiles are read or held ahead of consumption. Workers requesting a tile
+   receive the prefetched buffer, wait for an in-flight read, or read the
+   tile directly if prefetching has not reached it. Tiles more than
+   queueDepth behind the furthest tile requested are assumed skipped,
+   e.g. tiles of frames which are not generated; their buffers are
+   released and prefetching continues from the consumer's position.
+*/
+class TiffTilePrefetcher {
+ public:
+  // tileReader : reader of tiles; must outlive prefetcher.
+  // tileOrder : order tiles will be requested.
+  // queueDepth : maximum tiles read ahead of consumption.
+  // ioThreads : threads issuing reads.
+  TiffTilePrefetcher(const TiffRawTileReader *tileReader,
+                     const std::vector<uint32_t> &tileOrder,
+                     size_t queueDepth, size_t ioThreads);
+  TiffTilePrefetcher(const TiffTilePrefetcher &) = delete;
+  TiffTilePrefetcher &operator =(const TiffTilePrefetcher &) = delete;
+  virtual ~TiffTilePrefetcher();
+
+  bool isOpen() const;
+
+  // Returns raw bytes of tile and sets size. Returns nullptr if tile could
+  // not be read or is not part of the prefetch order.
+  std::unique_ptr<uint8_t[]> tile(uint32_t tileIndex, uint64_t *size);
+
+  // Tiles returned from prefetched buffers.
+  int64_t prefetchedTileCount() const;
+  // Tiles read synchronously by the requesting thread.
+  int64_t directReadTileCount() const;
+
+ private:
+  enum TileState {PENDING, READING, READY, CONSUMED};
+
+  // Schedules reads up to queue depth. Requires mutex_ to be held.
+  void scheduleReads();
+  // Releases tiles skipped by consumer at orderIndex. Requires mutex_ to be
+  // held.
+  void releaseSkippedTiles(size_t orderIndex);
+  void readTile(size_t orderIndex);
+
+  const TiffRawTileReader *tileReader_;
+  std::vector<uint32_t> tileOrder_;
+  std::unordered_map<uint32_t, size_t> tileOrderIndex_;
+  std::vector<TileState> tileState_;
+  std::vector<std::unique_ptr<uint8_t[]>> tileBuffer_;
+  std::vector<uint64_t> tileBufferSize_;
+  const size_t queueDepth_;
+  size_t nextScheduledIndex_;
+  size_t queuedTileCount_;
+  // Tiles before this order index are not prefetched or held.
+  size_t skippedIndex_;
+  int64_t prefetchedTileCount_;
+  int64_t directReadTileCount_;
+  bool stopping_;
+  mutable boost::mutex mutex_;
+  boost::condition_variable tileReady_;
+  boost::asio::thread_pool ioPool_;
+};
+
+}  // namespace wsiToDicomConverter
+#endif  // SRC_TIFFTILEPREFETCHER_H_
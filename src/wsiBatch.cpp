@@ -0,0 +1,98 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/wsiBatch.h"
+
+#include <boost/asio/post.hpp>
+#include <boost/asio/thread_pool.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/log/trivial.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <utility>
+
+namespace wsiToDicomConverter {
+
+WsiBatch::WsiBatch(size_t slidesInFlight, int64_t maxMemoryMB) :
+                          slidesInFlight_(std::max<size_t>(slidesInFlight, 1)) {
+  if (maxMemoryMB > 0) {
+    memoryGovernor_ = std::make_unique<MemoryGovernor>(
+                                                  maxMemoryMB * 1024 * 1024);
+  }
+}
+
+bool WsiBatch::addSlide(std::unique_ptr<WsiRequest> request) {
+  if (!request->jsonFile.empty()) {
+    std::unique_ptr<DcmTags> &tags = jsonTags_[request->jsonFile];
+    if (tags == nullptr) {
+      if (!boost::filesystem::is_regular_file(request->jsonFile)) {
+        BOOST_LOG_TRIVIAL(error) << "Could not read json file: " <<
+                                    request->jsonFile;
+        jsonTags_.erase(request->jsonFile);
+        return false;
+      }
+      tags = std::make_unique<DcmTags>();
+      tags->readJsonFile(request->jsonFile);
+    }
+    request->jsonTags = tags.get();
+  }
+  request->memoryGovernor = memoryGovernor_.get();
+  requests_.push_back(std::move(request));
+  return true;
+}
+
+size_t WsiBatch::slideCount() const {
+  return requests_.size();
+}
+
+int64_t WsiBatch::run() {
+  std::atomic<int64_t> failedSlides(0);
+  const size_t slideCount = requests_.size();
+  boost::asio::thread_pool pool(std::min(slidesInFlight_,
+                                         std::max<size_t>(slideCount, 1)));
+  for (size_t slideIndex = 0; slideIndex < slideCount; ++slideIndex) {
+    boost::asio::post(pool, [this, slideIndex, slideCount, &failedSlides]() {
+      WsiRequest *request = requests_[slideIndex].get();
+      if (memoryGovernor_ != nullptr) {
+        memoryGovernor_->waitForBudget(memoryGovernor_->budgetBytes() / 2);
+      }
+      BOOST_LOG_TRIVIAL(info) << "Starting slide " << slideIndex + 1 <<
+                                 " of " << slideCount << ": " <<
+                                 request->inputFile;
+      WsiToDcm converter(request);
+      if (converter.wsi2dcm() != 0) {
+        failedSlides += 1;
+        BOOST_LOG_TRIVIAL(error) << "Failed to convert slide " <<
+                                    slideIndex + 1 << ": " <<
+                                    request->inputFile;
+        return;
+      }
+      BOOST_LOG_TRIVIAL(info) << "Converted slide " << slideIndex + 1 <<
+                                 ": " << request->inputFile;
+    });
+  }
+  pool.join();
+  if (memoryGovernor_ != nullptr) {
+    BOOST_LOG_TRIVIAL(info) << "Batch memory peak reserved: " <<
+        memoryGovernor_->peakReservedBytes() / (1024 * 1024) << " MB of " <<
+        memoryGovernor_->budgetBytes() / (1024 * 1024) << " MB";
+  }
+  BOOST_LOG_TRIVIAL(info) << "Batch converted " <<
+                             slideCount - failedSlides.load() << " of " <<
+                             slideCount << " slides.";
+  return failedSlides.load();
+}
+
+}  // namespace wsiToDicomConverter
@@ -0,0 +1,64 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SRC_WSIBATCH_H_
+#define SRC_WSIBATCH_H_
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "src/dcmTags.h"
+#include "src/memoryGovernor.h"
+#include "src/wsiToDcm.h"
+
+namespace wsiToDicomConverter {
+
+/* Converts slides of a batch in one process.
+
+   Slides are started in the order they are added, slidesInFlight at a
+   time, so the start of a slide overlaps the tail of the slides before
+   it, when few frames remain and cores would otherwise be idle. Slides
+   share one memory governor: a slide is started only when half of the
+   budget is free, and frames of all slides in flight reserve memory from
+   the same budget. DICOM metadata json files are parsed once and shared
+   by the slides that use them.
+*/
+class WsiBatch {
+ public:
+  // slidesInFlight - slides converted at the same time.
+  // maxMemoryMB - memory budget shared by slides, 0 = unbounded.
+  WsiBatch(size_t slidesInFlight, int64_t maxMemoryMB);
+  WsiBatch(const WsiBatch &) = delete;
+  WsiBatch &operator =(const WsiBatch &) = delete;
+
+  // Adds slide to batch. Returns false if request's json file can not be
+  // read.
+  bool addSlide(std::unique_ptr<WsiRequest> request);
+  size_t slideCount() const;
+
+  // Converts slides. Returns number of slides which failed.
+  int64_t run();
+
+ private:
+  const size_t slidesInFlight_;
+  std::unique_ptr<MemoryGovernor> memoryGovernor_;
+  std::map<std::string, std::unique_ptr<DcmTags>> jsonTags_;
+  std::vector<std::unique_ptr<WsiRequest>> requests_;
+};
+
+}  // namespace wsiToDicomConverter
+
+#endif  // SRC_WSIBATCH_H_
@@ -18,33 +18,55 @@
 #include <boost/algorithm/string.hpp>
 #include <boost/asio/post.hpp>
 #include <boost/asio/thread_pool.hpp>
+#include <boost/chrono.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/log/core.hpp>
 #include <boost/log/expressions.hpp>
 #include <boost/log/trivial.hpp>
 #include <boost/thread/thread.hpp>
 #include <dcmtk/dcmdata/dcuid.h>
+#include <dcmtk/dcmdata/dcxfer.h>
 #include <math.h>
 
 #include <algorithm>
+#include <atomic>
 #include <fstream>
+#include <functional>
+#include <map>
 #include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "src/abstractDcmFile.h"
+#include "src/containerResources.h"
+#include "src/conversionCheckpoint.h"
 #include "src/dcmFileDraft.h"
 #include "src/dcmFilePyramidSource.h"
 #include "src/dcmTags.h"
+#include "src/dicomPassthroughFrame.h"
 #include "src/dicom_file_region_reader.h"
+#include "src/framePipeline.h"
 #include "src/geometryUtils.h"
+#include "src/jpeg2000Util.h"
+#include "src/jpegUtil.h"
+#include "src/memoryGovernor.h"
+#include "src/numaWorkerPool.h"
 #include "src/nearestneighborframe.h"
 #include "src/opencvinterpolationframe.h"
 #include "src/tiffFrame.h"
+#include "src/tiffRegionReader.h"
+#include "src/tiffRetileFrame.h"
+#include "src/ycbcrDownsampleFrame.h"
 
 namespace wsiToDicomConverter {
 
+// Decoded tile cache of tiff region reader if openslideCacheMB is not set.
+static const int64_t TIFF_REGION_READER_CACHE_BYTES = 128 * 1024 * 1024;
+// Minimum dimension of level 0 blocks read by fusedPyramid.
+static const int64_t MIP_CHAIN_BLOCK_SIZE = 4096;
+static const char NUMA_NODE_ROOT[] = "/sys/devices/system/node";
+
 inline void isFileExist(absl::string_view name) {
   std::string name_str = std::move(static_cast<std::string>(name));
   if (!boost::filesystem::exists(name_str)) {
@@ -76,8 +98,27 @@ inline DCM_Compression compressionFromString(std::string compressionStr) {
   return compression;
 }
 
+// Returns true if frames encoded in transfer syntax match frames
+// the converter would generate for compression.
+inline bool isTransferSyntaxForCompression(absl::string_view transferSyntaxUID,
+                                           DCM_Compression compression) {
+  switch (compression) {
+    case JPEG:
+      return transferSyntaxUID == DcmXfer(EXS_JPEGProcess1).getXferID();
+    case JPEG2000:
+      return transferSyntaxUID ==
+             DcmXfer(EXS_JPEG2000LosslessOnly).getXferID();
+    case RAW:
+      return transferSyntaxUID == DcmXfer(EXS_LittleEndianExplicit).getXferID();
+    default:
+      return false;
+  }
+}
+
 WsiToDcm::WsiToDcm(WsiRequest *wsiRequest) : wsiRequest_(wsiRequest) {
-  if (!wsiRequest_->genPyramidFromUntiledImage) {
+  // DICOM series directories are validated when indexed.
+  if (!wsiRequest_->genPyramidFromUntiledImage &&
+      !boost::filesystem::is_directory(wsiRequest_->inputFile)) {
     const char *slideFile = wsiRequest_->inputFile.c_str();
     if (!openslide_detect_vendor(slideFile)) {
       BOOST_LOG_TRIVIAL(error) << "File format is not supported by openslide";
@@ -88,6 +129,7 @@ WsiToDcm::WsiToDcm(WsiRequest *wsiRequest) : wsiRequest_(wsiRequest) {
   largestSlideLevelWidth_ = 0;
   largestSlideLevelHeight_ = 0;
   svsLevelCount_ = 0;
+  dicomSeriesPassthrough_ = false;
   initialX_ = 0;
   initialY_ = 0;
   if (wsiRequest_->dropFirstRowAndColumn) {
@@ -172,6 +214,86 @@ std::unique_ptr<DcmFilePyramidSource> WsiToDcm::initDicomIngest(
   return std::move(dicomFile);
 }
 
+void WsiToDcm::initDicomSeriesIngest() {
+  dcmSeriesIndex_ = std::make_unique<DcmSeriesIndex>(wsiRequest_->inputFile);
+  if (!dcmSeriesIndex_->isValid()) {
+    throw 1;
+  }
+  // Instances are copied unchanged only if output would not be given
+  // new identifiers or metadata.
+  dicomSeriesPassthrough_ = (wsiRequest_->studyId.empty() &&
+                             wsiRequest_->seriesId.empty() &&
+                             wsiRequest_->imageName.empty() &&
+                             wsiRequest_->jsonFile.empty());
+  // Series is opened by openslide and metadata initalized from an instance
+  // of the highest magnification level.
+  wsiRequest_->inputFile = dcmSeriesIndex_->level(0).files[0];
+  BOOST_LOG_TRIVIAL(info) << "Reading DICOM series with " <<
+                             dcmSeriesIndex_->levelCount() << " levels.";
+}
+
+bool WsiToDcm::isDicomSeriesLevelPassthrough(
+                                   const SlideLevelDim &slideLevelDim) const {
+  if (!dicomSeriesPassthrough_ || slideLevelDim.dicomSeriesLevel < 0 ||
+      !slideLevelDim.dicomSeriesLevelUnchanged || initialX_ != 0 ||
+      initialY_ != 0) {
+    return false;
+  }
+  const DcmSeriesLevel &seriesLevel = dcmSeriesIndex_->level(
+                                              slideLevelDim.dicomSeriesLevel);
+  if (seriesLevel.dimensionOrganizationType !=
+      (wsiRequest_->tiled ? "TILED_FULL" : "TILED_SPARSE")) {
+    return false;
+  }
+  // Instances are copied only if they are within batch limits.
+  for (size_t idx = 0; idx < seriesLevel.files.size(); ++idx) {
+    if (wsiRequest_->batchLimit > 0 &&
+        seriesLevel.fileFrameCounts[idx] > wsiRequest_->batchLimit) {
+      return false;
+    }
+    boost::system::error_code error;
+    if (wsiRequest_->batchBytesLimit > 0 &&
+        (boost::filesystem::file_size(seriesLevel.files[idx], error) >
+             static_cast<uintmax_t>(wsiRequest_->batchBytesLimit) ||
+         error)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool WsiToDcm::copyDicomSeriesLevel(const SlideLevelDim &slideLevelDim,
+                                    int32_t instanceNumber) {
+  const DcmSeriesLevel &seriesLevel = dcmSeriesIndex_->level(
+                                              slideLevelDim.dicomSeriesLevel);
+  std::vector<std::string> levelFileNames;
+  int64_t frameOffset = 0;
+  for (size_t idx = 0; idx < seriesLevel.files.size(); ++idx) {
+    const int64_t frameCount = seriesLevel.fileFrameCounts[idx];
+    const std::string fileName = DcmFileDraft::levelFileName(
+        slideLevelDim.downsample, frameOffset, frameOffset + frameCount);
+    const std::string outputFile = wsiRequest_->outputFileMask + "/" +
+                                   fileName;
+    // Instance number of copy is that of level in generated pyramid.
+    if (!DcmSeriesIndex::copyInstance(seriesLevel.files[idx], outputFile,
+                                      instanceNumber)) {
+      return false;
+    }
+    if (checkpoint_ != nullptr) {
+      checkpoint_->markFileComplete(outputFile);
+    }
+    levelFileNames.push_back(fileName);
+    frameOffset += frameCount;
+  }
+  if (checkpoint_ != nullptr) {
+    checkpoint_->markLevelComplete(slideLevelDim.downsample, levelFileNames);
+  }
+  BOOST_LOG_TRIVIAL(info) << "Copied DICOM level " << seriesLevel.imageWidth <<
+                             ", " << seriesLevel.imageHeight <<
+                             " without decoding.";
+  return true;
+}
+
 std::unique_ptr<ImageFilePyramidSource> WsiToDcm::initUntiledImageIngest() {
   std::unique_ptr<ImageFilePyramidSource> dicomFile =
                                       std::make_unique<ImageFilePyramidSource>(
@@ -196,6 +318,30 @@ void  WsiToDcm::clearOpenSlidePtr() {
   osptr_ = nullptr;
 }
 
+OpenSlidePool* WsiToDcm::getOpenSlidePool(size_t maxHandles) {
+  if (openslidePool_ == nullptr) {
+    const int64_t cacheSizeBytes = wsiRequest_->openslideCacheMB * 1024 *
+                                   1024;
+    openslidePool_ = std::make_unique<OpenSlidePool>(wsiRequest_->inputFile,
+                               maxHandles, cacheSizeBytes);
+    // Jpeg and JPEG 2000 encoded levels of tiled tiff files are decoded
+    // without openslide.
+    const std::string vendor(openslide_get_property_value(getOpenSlidePtr(),
+                             OPENSLIDE_PROPERTY_NAME_VENDOR));
+    if (vendor == "aperio" || vendor == "generic-tiff") {
+      std::unique_ptr<TiffRegionReader> tiffRegionReader =
+          std::make_unique<TiffRegionReader>(wsiRequest_->inputFile,
+              cacheSizeBytes > 0 ? cacheSizeBytes :
+                                   TIFF_REGION_READER_CACHE_BYTES);
+      if (tiffRegionReader->isValid()) {
+        openslidePool_->setTiffRegionReader(std::move(tiffRegionReader),
+                                    wsiRequest_->jpeg2000ReducedResolution);
+      }
+    }
+  }
+  return openslidePool_.get();
+}
+
 std::string WsiToDcm::initOpenSlide() {
   svsLevelCount_ = openslide_get_level_count(getOpenSlidePtr());
   // Openslide API call 0 returns dimensions of highest resolution image.
@@ -232,17 +378,28 @@ std::string WsiToDcm::initOpenSlide() {
               const TiffDirectory * tiffDir = tiffFile_->directory(level);
               BOOST_LOG_TRIVIAL(info) << "Reading JPEG tiles from SVS with "
                                          "out decoding.";
-              int oldX = wsiRequest_->frameSizeX;
-              int oldY = wsiRequest_->frameSizeY;
-              wsiRequest_->frameSizeX = tiffDir->tileWidth();
-              wsiRequest_->frameSizeY = tiffDir->tileHeight();
-              BOOST_LOG_TRIVIAL(info) << "Changing generated DICOM tile size "
-                                        "to jpeg tile size defined in svs. "
-                                        "Command line specified tile size: " <<
-                                        oldX << ", " << oldY << ". Changed to"
-                                        " svs jpeg tile size: " <<
-                                        wsiRequest_->frameSizeX << ", " <<
-                                        wsiRequest_->frameSizeY;
+              if (wsiRequest_->SVSImportLosslessRetile &&
+                  canRetileTiffLevel(level)) {
+                BOOST_LOG_TRIVIAL(info) << "Joining svs jpeg tiles, size: " <<
+                                          tiffDir->tileWidth() << ", " <<
+                                          tiffDir->tileHeight() << ", into "
+                                          "generated DICOM tiles without "
+                                          "decoding. Tile size: " <<
+                                          wsiRequest_->frameSizeX << ", " <<
+                                          wsiRequest_->frameSizeY;
+              } else {
+                int oldX = wsiRequest_->frameSizeX;
+                int oldY = wsiRequest_->frameSizeY;
+                wsiRequest_->frameSizeX = tiffDir->tileWidth();
+                wsiRequest_->frameSizeY = tiffDir->tileHeight();
+                BOOST_LOG_TRIVIAL(info) << "Changing generated DICOM tile "
+                                          "size to jpeg tile size defined in "
+                                          "svs. Command line specified tile "
+                                          "size: " << oldX << ", " << oldY <<
+                                          ". Changed to svs jpeg tile size: "
+                                          << wsiRequest_->frameSizeX << ", "
+                                          << wsiRequest_->frameSizeY;
+              }
               useSVSTileing = true;
             }
             tiffFile_->close();
@@ -259,6 +416,29 @@ std::string WsiToDcm::initOpenSlide() {
   return vendor;
 }
 
+bool WsiToDcm::canRetileTiffLevel(int32_t level) {
+  // Tiles are joined by copying DCT coefficients; requires tiles share
+  // jpeg tables and frames hold a whole number of MCU aligned tiles.
+  const TiffDirectory *tiffDir = tiffFile_->directory(level);
+  if (!tiffDir->isJpegCompressed() || !tiffDir->hasJpegTableData() ||
+      wsiRequest_->frameSizeX % tiffDir->tileWidth() != 0 ||
+      wsiRequest_->frameSizeY % tiffDir->tileHeight() != 0 ||
+      tiffDir->imageWidth() < wsiRequest_->frameSizeX ||
+      tiffDir->imageHeight() < wsiRequest_->frameSizeY) {
+    return false;
+  }
+  TiffFile levelFile(*tiffFile_, level);
+  uint64_t size;
+  std::unique_ptr<uint8_t[]> jpeg = tiffTileJpeg(&levelFile, 0, &size);
+  int64_t mcuWidth, mcuHeight;
+  if (jpeg == nullptr ||
+      !jpegUtil::jpegMCUSize(jpeg.get(), size, &mcuWidth, &mcuHeight)) {
+    return false;
+  }
+  return (tiffDir->tileWidth() % mcuWidth == 0 &&
+          tiffDir->tileHeight() % mcuHeight == 0);
+}
+
 int32_t WsiToDcm::getOpenslideLevelForDownsample(int64_t downsample) {
   /*
       Openslide API  identifies image closest to the downsampled image in size
@@ -334,6 +514,7 @@ std::unique_ptr<SlideLevelDim> WsiToDcm::getSlideLevelDim(int64_t downsample,
   int64_t sourceLevelWidth, sourceLevelHeight;
   bool generateFromPrimarySource = true;
   bool readFromTiff = false;
+  bool retileFromTiff = false;
   if ((tiffFile_ != nullptr && tiffFile_->isInitalized()) &&
       ((downsample == 1 &&
         wsiRequest_->SVSImportPreferScannerTileingForLargestLevel) ||
@@ -342,6 +523,17 @@ std::unique_ptr<SlideLevelDim> WsiToDcm::getSlideLevelDim(int64_t downsample,
     sourceLevelHeight = largestSlideLevelHeight_ / downsample;
     levelToGet = tiffFile_->getDirectoryIndexMatchingImageDimensions(
                               sourceLevelWidth, sourceLevelHeight);
+    if (levelToGet != -1 && wsiRequest_->SVSImportLosslessRetile) {
+      const TiffDirectory *tiffDir = tiffFile_->directory(levelToGet);
+      if (tiffDir->tileWidth() != wsiRequest_->frameSizeX ||
+          tiffDir->tileHeight() != wsiRequest_->frameSizeY) {
+        // Level is generated from openslide if tiles can not be joined.
+        retileFromTiff = canRetileTiffLevel(levelToGet);
+        if (!retileFromTiff) {
+          levelToGet = -1;
+        }
+      }
+    }
     if (levelToGet != -1) {
       multiplicator = static_cast<double>(downsample);
       downsampleOfLevel = 1.0;
@@ -350,14 +542,60 @@ std::unique_ptr<SlideLevelDim> WsiToDcm::getSlideLevelDim(int64_t downsample,
       // Source component of DCM_DerivationDescription
       // describes in text where imaging data was acquired from.
       sourceDerivationDescription =
-                    std::string("Image frame/tiles extracted without "
-                    "decompression from ") + tiffFile_->path() +
-                    ", file level: " + std::to_string(levelToGet) + ", and ";
+                    std::string(retileFromTiff ? "Image frame/tiles joined "
+                    "from tiles without decompression from " :
+                    "Image frame/tiles extracted without decompression "
+                    "from ") + tiffFile_->path() + ", file level: " +
+                    std::to_string(levelToGet) + ", and ";
+    }
+  }
+  // Read from existing level of DICOM series input.
+  int32_t dicomSeriesLevel = -1;
+  if (!readFromTiff && dcmSeriesIndex_ != nullptr && initialX_ == 0 &&
+      initialY_ == 0) {
+    dicomSeriesLevel = dcmSeriesIndex_->closestLevel(
+                                        largestSlideLevelWidth_ / downsample,
+                                        largestSlideLevelHeight_ / downsample);
+    // Previously generated level is used if it is closer to level
+    // being generated.
+    if (dicomSeriesLevel != -1 && priorLevel != nullptr &&
+        wsiRequest_->preferProgressiveDownsampling &&
+        priorLevel->downsample <= downsample &&
+        priorLevel->downsampledLevelWidth <
+            dcmSeriesIndex_->level(dicomSeriesLevel).imageWidth) {
+      dicomSeriesLevel = -1;
+    }
+  }
+  if (dicomSeriesLevel != -1) {
+    const DcmSeriesLevel &seriesLevel =
+                                    dcmSeriesIndex_->level(dicomSeriesLevel);
+    // Series levels are read through DICOMFileFrameRegionReader.
+    levelToGet = -1;
+    sourceLevelWidth = seriesLevel.imageWidth;
+    sourceLevelHeight = seriesLevel.imageHeight;
+    multiplicator = static_cast<double>(largestSlideLevelWidth_) /
+                    static_cast<double>(seriesLevel.imageWidth);
+    // Level dimensions are >= downsampled dimensions.
+    downsampleOfLevel = std::max(1.0, static_cast<double>(downsample) /
+                                      multiplicator);
+    generateFromPrimarySource = false;
+    // Source component of DCM_DerivationDescription
+    // describes in text where imaging data was acquired from.
+    if (downsampleOfLevel > 1.0) {
+      sourceDerivationDescription =
+        std::string("Image frame/tiles generated by downsampling, ") +
+        std::to_string(downsampleOfLevel) + " times, "
+        "pixel values extracted from DICOM(file: " + seriesLevel.files[0] +
+        ") and ";
+    } else {
+      sourceDerivationDescription =
+        std::string("Image frame/tiles generated from pixel values "
+        "extracted from DICOM(file: ") + seriesLevel.files[0] + ") and ";
     }
   }
   // ProgressiveDownsampling
-  if (!readFromTiff && wsiRequest_->preferProgressiveDownsampling &&
-      priorLevel != nullptr) {
+  if (!readFromTiff && dicomSeriesLevel == -1 &&
+      wsiRequest_->preferProgressiveDownsampling && priorLevel != nullptr) {
     multiplicator = static_cast<double>(priorLevel->downsample);
     downsampleOfLevel = static_cast<double>(downsample) / multiplicator;
     // check that downsampling is going from higher to lower magnification
@@ -384,8 +622,10 @@ std::unique_ptr<SlideLevelDim> WsiToDcm::getSlideLevelDim(int64_t downsample,
     }
   }
   if (generateFromPrimarySource) {
-    // if no higherMagnifcationDicomFiles then downsample from openslide
-    levelToGet = getOpenslideLevelForDownsample(downsample);
+    // if no higherMagnifcationDicomFiles then downsample from openslide;
+    // fused pyramids sample every level from level 0.
+    levelToGet = wsiRequest_->fusedPyramid ? 0 :
+                 getOpenslideLevelForDownsample(downsample);
     multiplicator = openslide_get_level_downsample(getOpenSlidePtr(),
                                                    levelToGet);
     // Downsampling factor required to go from selected
@@ -436,7 +676,29 @@ std::unique_ptr<SlideLevelDim> WsiToDcm::getSlideLevelDim(int64_t downsample,
                         &downsampledLevelHeight,
                         &downsampledLevelFrameWidth,
                         &downsampledLevelFrameHeight);
+  bool dicomSeriesLevelUnchanged = false;
+  if (dicomSeriesLevel != -1) {
+    const DcmSeriesLevel &seriesLevel =
+                                    dcmSeriesIndex_->level(dicomSeriesLevel);
+    dicomSeriesLevelUnchanged = (downsampleOfLevel == 1.0 &&
+        downsampledLevelWidth == seriesLevel.imageWidth &&
+        downsampledLevelHeight == seriesLevel.imageHeight &&
+        downsampledLevelFrameWidth == seriesLevel.frameWidth &&
+        downsampledLevelFrameHeight == seriesLevel.frameHeight &&
+        isTransferSyntaxForCompression(seriesLevel.transferSyntaxUID,
+                                       levelCompression) &&
+        (levelCompression != JPEG || wsiRequest_->dicomJpegPassthrough));
+    if (dicomSeriesLevelUnchanged && levelCompression == JPEG) {
+      sourceDerivationDescription =
+                    std::string("Image frame/tiles extracted without "
+                    "decompression from DICOM(file: ") + seriesLevel.files[0] +
+                    ") and ";
+    }
+  }
   slideLevelDim->readFromTiff = readFromTiff;
+  slideLevelDim->retileFromTiff = retileFromTiff;
+  slideLevelDim->dicomSeriesLevel = dicomSeriesLevel;
+  slideLevelDim->dicomSeriesLevelUnchanged = dicomSeriesLevelUnchanged;
   slideLevelDim->levelToGet = levelToGet;
   slideLevelDim->downsample = downsample;
   slideLevelDim->multiplicator = multiplicator;
@@ -698,6 +960,55 @@ void WsiToDcm::getSlideDownSamplingLevels(
   }
 }
 
+std::unique_ptr<MipChainPyramid> WsiToDcm::initMipChainPyramid(
+                  const std::vector<DownsamplingSlideState> &downsampleSlide,
+                  size_t threads, MemoryGovernor *memoryGovernor) {
+  std::unique_ptr<MipChainPyramid> mipChainPyramid =
+      std::make_unique<MipChainPyramid>(getOpenSlidePool(threads), initialX_,
+          initialY_, largestSlideLevelWidth_ - initialX_,
+          largestSlideLevelHeight_ - initialY_, MIP_CHAIN_BLOCK_SIZE,
+          wsiRequest_->quality, wsiRequest_->jpegSubsampling);
+  mipChainPyramid->setMemoryGovernor(memoryGovernor);
+  bool hasLevels = false;
+  for (size_t levelIndex = 0; levelIndex < downsampleSlide.size();
+       ++levelIndex) {
+    std::unique_ptr<SlideLevelDim> levelDim = getSlideLevelDim(
+                                downsampleSlide[levelIndex].downsample, nullptr);
+    if (levelDim->downsampledLevelWidth == 0 ||
+        levelDim->downsampledLevelHeight == 0) {
+      break;
+    }
+    // Levels completed by an interrupted conversion are not generated.
+    const bool levelComplete = checkpoint_ != nullptr &&
+        downsampleSlide[levelIndex].saveDicom &&
+        checkpoint_->isLevelComplete(downsampleSlide[levelIndex].downsample);
+    if (levelDim->readOpenslide && !levelComplete) {
+      mipChainPyramid->addLevel(levelIndex, levelDim->downsample,
+                                levelDim->downsampledLevelWidth,
+                                levelDim->downsampledLevelHeight,
+                                levelDim->downsampledLevelFrameWidth,
+                                levelDim->downsampledLevelFrameHeight,
+                                levelDim->levelCompression,
+                                downsampleSlide[levelIndex].
+                                    generateCompressedRaw);
+      hasLevels = true;
+    }
+    // Levels after a single frame level are not generated.
+    if (wsiRequest_->stopDownsamplingAtSingleFrame &&
+        levelDim->downsampledLevelWidth <=
+            levelDim->downsampledLevelFrameWidth &&
+        levelDim->downsampledLevelHeight <=
+            levelDim->downsampledLevelFrameHeight) {
+      break;
+    }
+  }
+  if (!hasLevels) {
+    return nullptr;
+  }
+  mipChainPyramid->start(threads);
+  return mipChainPyramid;
+}
+
 double abstractDicomDimensionMM(double imageDimMM, uint64_t imageDim,
                                 int64_t imageDimOffset) {
   if (imageDimOffset <= 0) {
@@ -717,16 +1028,60 @@ int64_t sourceLevelPixelCoord(int64_t source_level_dim,
 }
 
 
+// Reads file written before conversion was interrupted. Returns nullptr if
+// file can not be read.
+std::unique_ptr<AbstractDcmFile> loadCompletedFile(const std::string &path) {
+  std::unique_ptr<DcmFilePyramidSource> dcmFile =
+                                 std::make_unique<DcmFilePyramidSource>(path);
+  if (!dcmFile->isValid() || dcmFile->fileFrameCount() <= 0) {
+    BOOST_LOG_TRIVIAL(error) << "Error reading completed DICOM file: " << path;
+    return nullptr;
+  }
+  return dcmFile;
+}
+
 int WsiToDcm::dicomizeTiff() {
-  std::unique_ptr<DcmTags> tags = std::make_unique<DcmTags>();
-  if (wsiRequest_->jsonFile.size() > 0) {
-    tags->readJsonFile(wsiRequest_->jsonFile);
+  // Tags parsed once by batch are shared by its slides.
+  std::unique_ptr<DcmTags> ownedTags;
+  DcmTags *tags = wsiRequest_->jsonTags;
+  if (tags == nullptr) {
+    ownedTags = std::make_unique<DcmTags>();
+    if (wsiRequest_->jsonFile.size() > 0) {
+      ownedTags->readJsonFile(wsiRequest_->jsonFile);
+    }
+    tags = ownedTags.get();
   }
 
-  int8_t threadsForPool = boost::thread::hardware_concurrency();
+  // Threads are sized from the cores the process may use, which inside a
+  // container is bounded by its cgroup's CPU quota.
+  const int32_t cpuCount = availableCpuCount();
+  const CgroupLimits &cgroupLimits = processCgroupLimits();
+  BOOST_LOG_TRIVIAL(info) << "Available cores: " << cpuCount <<
+                             "; cgroup memory limit: " <<
+                             cgroupLimits.memoryBytes / (1024 * 1024) <<
+                             " MB (0 = unlimited)";
+  int32_t threadsForPool = cpuCount;
   if (wsiRequest_->threads > 0) {
     threadsForPool = std::min(wsiRequest_->threads, threadsForPool);
   }
+  const int64_t maxMemoryMB = wsiRequest_->maxMemoryMB;
+  std::vector<NumaNode> numaNodes;
+  if (wsiRequest_->numaPinning) {
+    numaNodes = readNumaNodes(NUMA_NODE_ROOT);
+    BOOST_LOG_TRIVIAL(info) << "NUMA nodes: " << numaNodes.size();
+    if (numaNodes.size() < 2) {
+      BOOST_LOG_TRIVIAL(info) << "Single NUMA node; workers are not pinned.";
+      numaNodes.clear();
+    }
+  }
+  // Governor of batch bounds memory of all of its slides.
+  std::unique_ptr<MemoryGovernor> ownedMemoryGovernor;
+  MemoryGovernor *memoryGovernor = wsiRequest_->memoryGovernor;
+  if (memoryGovernor == nullptr && maxMemoryMB > 0) {
+    ownedMemoryGovernor = std::make_unique<MemoryGovernor>(
+                                                  maxMemoryMB * 1024 * 1024);
+    memoryGovernor = ownedMemoryGovernor.get();
+  }
   std::unique_ptr<SlideLevelDim> slideLevelDim = nullptr;
   std::unique_ptr<AbstractDcmFile> abstractDicomFile = nullptr;
   double levelWidthMM, levelHeightMM;
@@ -746,6 +1101,9 @@ int WsiToDcm::dicomizeTiff() {
                                             largestSlideLevelHeight_,
                                             initialY_);
   } else {
+    if (boost::filesystem::is_directory(wsiRequest_->inputFile)) {
+      initDicomSeriesIngest();
+    }
     // Initalize openslide
     if (initOpenSlide() == "dicom") {
        // DICOM will be read with openslide. Do not init for reading
@@ -773,15 +1131,38 @@ int WsiToDcm::dicomizeTiff() {
     BOOST_LOG_TRIVIAL(error) << "Input image dimensions are to small.";
     return 1;
   }
+  if (wsiRequest_->resume) {
+    const std::string key = checkpointKey(wsiRequest_->inputFile,
+                                          wsiRequest_->resumeOptions);
+    if (key.empty()) {
+      BOOST_LOG_TRIVIAL(error) << "Could not read input to resume.";
+      return 1;
+    }
+    checkpoint_ = std::make_unique<ConversionCheckpoint>(
+                                          wsiRequest_->outputFileMask, key);
+    if (!checkpoint_->isValid()) {
+      return 1;
+    }
+  }
+  // UIDs of resumed conversion are the same as those of files written
+  // before it was interrupted.
   if (wsiRequest_->studyId.size() < 1) {
     char studyIdGenerated[100];
-    dcmGenerateUniqueIdentifier(studyIdGenerated, SITE_STUDY_UID_ROOT);
-    wsiRequest_->studyId = studyIdGenerated;
+    if (checkpoint_ != nullptr) {
+      wsiRequest_->studyId = checkpoint_->uid("study");
+    } else {
+      dcmGenerateUniqueIdentifier(studyIdGenerated, SITE_STUDY_UID_ROOT);
+      wsiRequest_->studyId = studyIdGenerated;
+    }
   }
   if (wsiRequest_->seriesId.size() < 1) {
     char seriesIdGenerated[100];
-    dcmGenerateUniqueIdentifier(seriesIdGenerated, SITE_SERIES_UID_ROOT);
-    wsiRequest_->seriesId = seriesIdGenerated;
+    if (checkpoint_ != nullptr) {
+      wsiRequest_->seriesId = checkpoint_->uid("series");
+    } else {
+      dcmGenerateUniqueIdentifier(seriesIdGenerated, SITE_SERIES_UID_ROOT);
+      wsiRequest_->seriesId = seriesIdGenerated;
+    }
   }
   std::vector<DownsamplingSlideState> downsampleSlide;
   getSlideDownSamplingLevels(&downsampleSlide,
@@ -793,6 +1174,11 @@ int WsiToDcm::dicomizeTiff() {
     higherMagnifcationDicomFiles.setDicomFiles(std::move(generatedDicomFiles),
                                                nullptr);
   }
+  std::unique_ptr<MipChainPyramid> mipChainPyramid;
+  if (wsiRequest_->fusedPyramid && dcmSeriesIndex_ == nullptr) {
+    mipChainPyramid = initMipChainPyramid(downsampleSlide, threadsForPool,
+                                          memoryGovernor);
+  }
   clearOpenSlidePtr();
   for (size_t levelIndex = 0;
        levelIndex < downsampleSlide.size();
@@ -823,7 +1209,7 @@ int WsiToDcm::dicomizeTiff() {
                     slideLevelDim->downsampledLevelFrameWidth;
     const int64_t downsampledLevelFrameHeight =
                     slideLevelDim->downsampledLevelFrameHeight;
-    const std::string sourceDerivationDescription =
+    std::string sourceDerivationDescription =
                                     slideLevelDim->sourceDerivationDescription;
 
     DCM_Compression levelCompression = slideLevelDim->levelCompression;
@@ -847,15 +1233,97 @@ int WsiToDcm::dicomizeTiff() {
                          static_cast<double>(downsampledLevelHeight) /
                          static_cast<double>(downsampledLevelFrameHeight));
 
+    // Level completed before conversion was interrupted is not generated;
+    // its files are read back if they are the source of the next level.
+    if (checkpoint_ != nullptr && save_dicom_instance_to_disk &&
+        checkpoint_->isLevelComplete(downsample)) {
+      BOOST_LOG_TRIVIAL(info) << "Skipping completed level, downsample: " <<
+                                 downsample;
+      std::vector<std::unique_ptr<AbstractDcmFile>> completedFiles;
+      if (saveCompressedRaw) {
+        for (const std::string &fileName :
+             checkpoint_->levelFiles(downsample)) {
+          std::unique_ptr<AbstractDcmFile> dcmFile =
+                          loadCompletedFile(checkpoint_->path(fileName));
+          if (dcmFile == nullptr) {
+            return 1;
+          }
+          completedFiles.push_back(std::move(dcmFile));
+        }
+      }
+      higherMagnifcationDicomFiles.setDicomFiles(std::move(completedFiles),
+                                                 nullptr);
+      if (wsiRequest_->levelDoneCallback) {
+        wsiRequest_->levelDoneCallback(levelIndex + 1, downsampleSlide.size());
+      }
+      if (wsiRequest_->stopDownsamplingAtSingleFrame && frameX * frameY <= 1) {
+        break;
+      }
+      continue;
+    }
+
+    // JPEG frames of DICOM series level copied without decompression.
+    bool readFromDicom = false;
     if (slideLevelDim->readOpenslide || slideLevelDim->readFromTiff) {
       // If slide level was initalized from openslide or tiff
       // clear higherMagnifcationDicomFiles so
       // level is downsampled from openslide and not
       // prior level if progressiveDownsample is enabled.
       higherMagnifcationDicomFiles.clearDicomFiles();
+    } else if (slideLevelDim->dicomSeriesLevel != -1) {
+      // Level is generated from frames of existing DICOM instances; frames
+      // are also the source for progressive downsampling of next level.
+      higherMagnifcationDicomFiles.setDicomFiles(
+          dcmSeriesIndex_->loadLevel(slideLevelDim->dicomSeriesLevel),
+          nullptr);
+      if (higherMagnifcationDicomFiles.dicomFileCount() == 0) {
+        BOOST_LOG_TRIVIAL(error) << "Error reading DICOM series level.";
+        return 1;
+      }
+      if (save_dicom_instance_to_disk &&
+          isDicomSeriesLevelPassthrough(*slideLevelDim)) {
+        if (!copyDicomSeriesLevel(*slideLevelDim, instanceNumber)) {
+          return 1;
+        }
+        if (wsiRequest_->stopDownsamplingAtSingleFrame &&
+            frameX * frameY <= 1) {
+          break;
+        }
+        continue;
+      }
+      if (slideLevelDim->dicomSeriesLevelUnchanged &&
+          levelCompression == JPEG) {
+        // Frames DCMTK decodes for other JPEG pixel formats are re-encoded.
+        readFromDicom = true;
+        for (int64_t fileIdx = 0;
+             fileIdx < higherMagnifcationDicomFiles.dicomFileCount();
+             ++fileIdx) {
+          if (dynamic_cast<JpegDicomFileFrame *>(
+                  higherMagnifcationDicomFiles.dicomFile(fileIdx)->frame(0)) ==
+              nullptr) {
+            readFromDicom = false;
+            sourceDerivationDescription =
+                std::string("Image frame/tiles generated from pixel values "
+                "extracted from DICOM(file: ") +
+                dcmSeriesIndex_->level(slideLevelDim->dicomSeriesLevel)
+                    .files[0] + ") and ";
+            break;
+          }
+        }
+      }
     }
     BOOST_LOG_TRIVIAL(debug) << "higherMagnifcationDicomFiles " <<
                           higherMagnifcationDicomFiles.dicomFileCount();
+    // Frames read from openslide lease a handle per worker from a pool
+    // which stays open across levels.
+    // Frames of levels generated from level 0 blocks already exist.
+    const bool mipChainLevel = mipChainPyramid != nullptr &&
+                               mipChainPyramid->hasLevel(levelIndex);
+    OpenSlidePool *levelOpenSlidePool = nullptr;
+    if (!slideLevelDim->readFromTiff && !mipChainLevel &&
+        higherMagnifcationDicomFiles.dicomFileCount() == 0) {
+      levelOpenSlidePool = getOpenSlidePool(threadsForPool);
+    }
     std::vector<std::unique_ptr<Frame>> framesInitalizationData;
     // Preallocate vector space for frames
     framesInitalizationData.reserve(frameX * frameY);
@@ -883,9 +1351,37 @@ int WsiToDcm::dicomizeTiff() {
         return 1;
       }
     }
+    // Downsample prior level jpeg frames without conversion to RGB.
+    const bool downsampleYCbCr = wsiRequest_->jpegYCbCrDownsampling &&
+        !wsiRequest_->useOpenCVDownsampling && !readFromDicom &&
+        !slideLevelDim->readFromTiff && levelCompression == JPEG &&
+        higherMagnifcationDicomFiles.dicomFileCount() > 0 &&
+        higherMagnifcationDicomFiles.dicomFile(0)->frame(0)->
+            hasYCbCrFrameBytes();
+    // Order tiles are read from tiff; used to prefetch tiles.
+    std::vector<uint32_t> tiffTileOrder;
+    // Openslide regions grouped into blocks of whole native tiles, each
+    // spanning openslideRegionBandFrames frames of a row, so that each
+    // native tile is decoded once. Frames are grouped into bounding boxes
+    // if the slide does not report native tile dimensions.
+    std::unique_ptr<OpenSlideReadPlan> readPlan;
+    if (levelOpenSlidePool != nullptr &&
+        wsiRequest_->openslideRegionBandFrames > 0) {
+      readPlan = std::make_unique<OpenSlideReadPlan>(levelOpenSlidePool,
+          levelToGet, wsiRequest_->openslideRegionBandFrames *
+          sourceLevelWidth * downsampledLevelFrameWidth /
+          downsampledLevelWidth, sourceLevelHeight *
+          downsampledLevelFrameHeight / downsampledLevelHeight);
+      if (!readPlan->isValid()) {
+        readPlan = nullptr;
+      }
+    }
+    if (mipChainLevel) {
+      framesInitalizationData = mipChainPyramid->takeLevelFrames(levelIndex);
+    }
     // Step across destination imaging height.
     for (int64_t downsampledLevelYCoord = 0;
-        downsampledLevelYCoord < downsampledLevelHeight;
+        !mipChainLevel && downsampledLevelYCoord < downsampledLevelHeight;
         downsampledLevelYCoord += downsampledLevelFrameHeight) {
       // back project from destination to source.
 
@@ -906,10 +1402,21 @@ int WsiToDcm::dicomizeTiff() {
                          downsampledLevelYCoord + downsampledLevelFrameHeight,
                          initialY_) - sourceLevelYCoord;
       }
+      // Openslide region shared by a group of frames in the row.
+      std::shared_ptr<OpenSlideRegionBand> regionBand;
+      int64_t regionBandFrameCount = 0;
       // Step across destination imaging with.
       for (int64_t downsampledLevelXCoord = 0;
           downsampledLevelXCoord < downsampledLevelWidth;
           downsampledLevelXCoord += downsampledLevelFrameWidth) {
+        if (levelOpenSlidePool != nullptr && readPlan == nullptr &&
+            wsiRequest_->openslideRegionBandFrames > 0 &&
+            regionBandFrameCount % wsiRequest_->openslideRegionBandFrames ==
+                0) {
+          regionBand = std::make_shared<OpenSlideRegionBand>(
+              levelOpenSlidePool, levelToGet);
+        }
+        regionBandFrameCount += 1;
         // back project from destination to source.
         const int64_t sourceLevelXCoord = sourceLevelPixelCoord(
                                             sourceLevelWidth,
@@ -932,28 +1439,75 @@ int WsiToDcm::dicomizeTiff() {
         //   ", " << sourceLevelYCoord << " [" << sourceWidth << ", " <<
         //   sourceHeight << "]";
         std::unique_ptr<Frame> frameData;
-        if (slideLevelDim->readFromTiff) {
+        if (slideLevelDim->retileFromTiff) {
+          std::unique_ptr<TiffRetileFrame> retileFrame =
+              std::make_unique<TiffRetileFrame>(tiffFrameFilePtr.get(),
+                  sourceLevelXCoord, sourceLevelYCoord,
+                  downsampledLevelFrameWidth, downsampledLevelFrameHeight,
+                  saveCompressedRaw);
+          for (int64_t tileIndex : retileFrame->tileIndexes()) {
+            if (tileIndex != -1) {
+              tiffTileOrder.push_back(tileIndex);
+            }
+          }
+          frameData = std::move(retileFrame);
+        } else if (slideLevelDim->readFromTiff) {
+          const uint64_t tileIndex = frameIndexFromLocation(
+              tiffFrameFilePtr.get(), levelToGet, sourceLevelXCoord,
+              sourceLevelYCoord);
+          tiffTileOrder.push_back(tileIndex);
           frameData = std::make_unique<TiffFrame>(tiffFrameFilePtr.get(),
-              frameIndexFromLocation(tiffFrameFilePtr.get(), levelToGet,
-              sourceLevelXCoord, sourceLevelYCoord), saveCompressedRaw);
+              tileIndex, saveCompressedRaw);
+        } else if (readFromDicom) {
+          const JpegDicomFileFrame *sourceFrame =
+              static_cast<JpegDicomFileFrame *>(
+                  higherMagnifcationDicomFiles.frame(sourceLevelXCoord,
+                                                     sourceLevelYCoord));
+          if (sourceFrame == nullptr) {
+            BOOST_LOG_TRIVIAL(error) << "DICOM frame missing.";
+            return 1;
+          }
+          frameData = std::make_unique<DicomPassthroughFrame>(
+              downsampledLevelXCoord, downsampledLevelYCoord, sourceFrame,
+              saveCompressedRaw);
+        } else if (downsampleYCbCr) {
+          frameData = std::make_unique<YCbCrDownsampleFrame>(
+              sourceLevelXCoord, sourceLevelYCoord, sourceWidth, sourceHeight,
+              downsampledLevelFrameWidth, downsampledLevelFrameHeight,
+              wsiRequest_->quality, wsiRequest_->jpegSubsampling,
+              saveCompressedRaw, &higherMagnifcationDicomFiles);
         } else if (wsiRequest_->useOpenCVDownsampling) {
-          frameData = std::make_unique<OpenCVInterpolationFrame>(
-              osptr_.get(), sourceLevelXCoord, sourceLevelYCoord, levelToGet,
-              sourceWidth, sourceHeight, downsampledLevelFrameWidth,
+          std::unique_ptr<OpenCVInterpolationFrame> interpolationFrame =
+              std::make_unique<OpenCVInterpolationFrame>(
+              levelOpenSlidePool, sourceLevelXCoord, sourceLevelYCoord,
+              levelToGet, sourceWidth, sourceHeight, downsampledLevelFrameWidth,
               downsampledLevelFrameHeight, levelCompression,
               wsiRequest_->quality, wsiRequest_->jpegSubsampling,
               sourceLevelWidth, sourceLevelHeight, largestSlideLevelWidth_,
               largestSlideLevelHeight_, saveCompressedRaw,
               &higherMagnifcationDicomFiles,
               wsiRequest_->openCVInterpolationMethod);
+          if (readPlan != nullptr) {
+            interpolationFrame->setReadPlan(readPlan.get());
+          } else if (regionBand != nullptr) {
+            interpolationFrame->setRegionBand(regionBand);
+          }
+          frameData = std::move(interpolationFrame);
         } else {
-          frameData = std::make_unique<NearestNeighborFrame>(
-              osptr_.get(), sourceLevelXCoord, sourceLevelYCoord, levelToGet,
-              sourceWidth, sourceHeight, multiplicator,
+          std::unique_ptr<NearestNeighborFrame> nearestNeighborFrame =
+              std::make_unique<NearestNeighborFrame>(
+              levelOpenSlidePool, sourceLevelXCoord, sourceLevelYCoord,
+              levelToGet, sourceWidth, sourceHeight, multiplicator,
               downsampledLevelFrameWidth, downsampledLevelFrameHeight,
               levelCompression, wsiRequest_->quality,
               wsiRequest_->jpegSubsampling, saveCompressedRaw,
               &higherMagnifcationDicomFiles);
+          if (readPlan != nullptr) {
+            nearestNeighborFrame->setReadPlan(readPlan.get());
+          } else if (regionBand != nullptr) {
+            nearestNeighborFrame->setRegionBand(regionBand);
+          }
+          frameData = std::move(nearestNeighborFrame);
         }
         if (higherMagnifcationDicomFiles.dicomFileCount() != 0) {
           frameData->incSourceFrameReadCounter();
@@ -963,7 +1517,125 @@ int WsiToDcm::dicomizeTiff() {
     }
     BOOST_LOG_TRIVIAL(debug) << "Level Frame Count: " <<
                           framesInitalizationData.size();
-    boost::asio::thread_pool pool(threadsForPool);
+    if (readPlan != nullptr) {
+      BOOST_LOG_TRIVIAL(debug) << "Openslide native tiles decoded / unique "
+                                  "tiles; frame reads: " <<
+                                  readPlan->regionTileReads() << " / " <<
+                                  readPlan->uniqueTiles() <<
+                                  "; planned block reads: " <<
+                                  readPlan->blockTileReads() << " / " <<
+                                  readPlan->uniqueTiles();
+    }
+    // Files of level written before conversion was interrupted, by index of
+    // their first frame; their frames are not sliced. Files of levels
+    // sized by byte budget are only resumed with the whole level.
+    const size_t levelFrameCount = framesInitalizationData.size();
+    std::vector<bool> frameCompleted(levelFrameCount, false);
+    std::map<size_t, std::unique_ptr<AbstractDcmFile>> completedFiles;
+    if (checkpoint_ != nullptr && save_dicom_instance_to_disk &&
+        !mipChainLevel && wsiRequest_->batchLimit > 0 &&
+        wsiRequest_->batchBytesLimit == 0) {
+      for (size_t firstFrame = 0; firstFrame < levelFrameCount;
+           firstFrame += wsiRequest_->batchLimit) {
+        const size_t endFrame = std::min<size_t>(
+            firstFrame + wsiRequest_->batchLimit, levelFrameCount);
+        const std::string fileName = DcmFileDraft::levelFileName(
+                                           downsample, firstFrame, endFrame);
+        if (!checkpoint_->isFileComplete(fileName)) {
+          continue;
+        }
+        std::unique_ptr<AbstractDcmFile> dcmFile =
+                          loadCompletedFile(checkpoint_->path(fileName));
+        if (dcmFile == nullptr ||
+            dcmFile->fileFrameCount() !=
+                static_cast<int64_t>(endFrame - firstFrame)) {
+          continue;
+        }
+        completedFiles[firstFrame] = std::move(dcmFile);
+        std::fill(frameCompleted.begin() + firstFrame,
+                  frameCompleted.begin() + endFrame, true);
+      }
+      if (!completedFiles.empty()) {
+        BOOST_LOG_TRIVIAL(info) << "Skipping completed files of level: " <<
+                                   completedFiles.size();
+      }
+    }
+    if (tiffFrameFilePtr != nullptr &&
+        wsiRequest_->tilePrefetchQueueDepth > 0) {
+      tiffFrameFilePtr->startTilePrefetch(tiffTileOrder,
+                                          wsiRequest_->tilePrefetchQueueDepth);
+    }
+    // Staged pipeline runs reading, slicing and writing frames on separate
+    // workers; otherwise a frame is read and sliced by a single worker.
+    std::unique_ptr<FramePipeline> pipeline;
+    if (wsiRequest_->readThreads > 0) {
+      const size_t sliceThreads = wsiRequest_->sliceThreads > 0 ?
+          wsiRequest_->sliceThreads : std::max<int>(threadsForPool, 1);
+      const size_t writeThreads = wsiRequest_->writeThreads > 0 ?
+          wsiRequest_->writeThreads : 1;
+      const size_t queueDepth = wsiRequest_->stageQueueDepth > 0 ?
+          wsiRequest_->stageQueueDepth : 2 * sliceThreads;
+      pipeline = std::make_unique<FramePipeline>(wsiRequest_->readThreads,
+                                                 sliceThreads, writeThreads,
+                                                 queueDepth);
+    }
+    // Frames of a row are generated by the worker group of one NUMA node;
+    // rows are interleaved across nodes.
+    std::unique_ptr<NumaWorkerPool> numaPool;
+    if (pipeline == nullptr && !numaNodes.empty()) {
+      numaPool = std::make_unique<NumaWorkerPool>(numaNodes, threadsForPool);
+    }
+    boost::asio::thread_pool pool(pipeline != nullptr || numaPool != nullptr ?
+                                  1 : threadsForPool);
+    size_t numaFileNode = 0;
+    // Working memory of a frame: source region, raw frame and encoded
+    // frame.
+    const int64_t frameRawBytes = downsampledLevelFrameWidth *
+                                  downsampledLevelFrameHeight *
+                                  sizeof(uint32_t);
+    const int64_t frameWorkBytes = frameRawBytes *
+        (2 + static_cast<int64_t>(ceil(downsampleOfLevel *
+                                       downsampleOfLevel)));
+    ConversionCheckpoint *levelCheckpoint = save_dicom_instance_to_disk ?
+                                            checkpoint_.get() : nullptr;
+    // Set by workers if a file of level could not be written.
+    std::atomic<bool> saveFailed(false);
+    auto saveFile = [governor = memoryGovernor, levelCheckpoint,
+                     &saveFailed](DcmFileDraft *filedraft) {
+      bool saved;
+      if (governor == nullptr) {
+        saved = filedraft->saveFile();
+      } else {
+        // Encoded frames are copied into the file's dataset as it is
+        // written.
+        const int64_t encodedBytes = filedraft->encodedFrameBytes();
+        governor->hold(encodedBytes);
+        saved = filedraft->saveFile();
+        governor->releaseHeld(encodedBytes);
+      }
+      if (!saved) {
+        saveFailed = true;
+        return;
+      }
+      if (levelCheckpoint != nullptr) {
+        levelCheckpoint->markFileComplete(filedraft->outputFileName());
+      }
+    };
+    auto postSaveFile = [&](DcmFileDraft *filedraft) {
+      if (pipeline != nullptr) {
+        pipeline->addWrite([saveFile, filedraft]() { saveFile(filedraft); });
+        return;
+      }
+      if (numaPool != nullptr) {
+        numaPool->post(numaFileNode++, [saveFile, filedraft]() {
+          saveFile(filedraft);
+        });
+        return;
+      }
+      boost::asio::post(pool, [saveFile, filedraft]() {
+        saveFile(filedraft);
+      });
+    };
     std::vector<std::unique_ptr<Frame>> framesData;
     if (wsiRequest_->batchLimit == 0) {
       framesData.reserve(frameX * frameY);
@@ -972,58 +1644,215 @@ int WsiToDcm::dicomizeTiff() {
     }
 
     const size_t total_frame_count = framesInitalizationData.size();
-    for (std::vector<std::unique_ptr<Frame>>::iterator frameData =
-                                             framesInitalizationData.begin();
-                    frameData != framesInitalizationData.end(); ++frameData) {
-      boost::asio::post(
-          pool, [frameData = frameData->get()]() { frameData->sliceFrame(); });
-      framesData.push_back(std::move(*frameData));
-      if (wsiRequest_->batchLimit > 0 &&
-          framesData.size() >= wsiRequest_->batchLimit) {
-        std::unique_ptr<DcmFileDraft> filedraft =
-            std::make_unique<DcmFileDraft>(
-                std::move(framesData), wsiRequest_->outputFileMask,
-                downsampledLevelWidth, downsampledLevelHeight, instanceNumber,
-                wsiRequest_->studyId, wsiRequest_->seriesId,
-                wsiRequest_->imageName, levelCompression, wsiRequest_->tiled,
-                tags.get(), levelWidthMM, levelHeightMM, downsample,
-                &generatedDicomFiles, sourceDerivationDescription,
-                save_dicom_instance_to_disk);
-        boost::asio::post(pool, [th_filedraft = filedraft.get()]() {
-          th_filedraft->saveFile();
-        });
-        generatedDicomFiles.push_back(std::move(filedraft));
-      }
+    // Frames are sliced in frameOrder and assigned to files in raster
+    // order; files wait for frames which complete out of order.
+    std::vector<int64_t> dispatchOrder = frameDispatchOrder(frameX, frameY,
+                                                    wsiRequest_->frameOrder);
+    if (dispatchOrder.size() != total_frame_count) {
+      dispatchOrder = frameDispatchOrder(total_frame_count, 1, RASTER_ORDER);
     }
-    if (framesData.size() > 0) {
+    std::vector<bool> frameDispatched(total_frame_count, false);
+    size_t dispatchedFrameCount = 0;
+    // Posts frames in dispatch order until frame at frameIndex and at least
+    // minFrameCount frames have been posted.
+    auto dispatchFrames = [&](size_t frameIndex, size_t minFrameCount) {
+      while (dispatchedFrameCount < total_frame_count &&
+             (!frameDispatched[frameIndex] ||
+              dispatchedFrameCount < minFrameCount)) {
+        const int64_t nextFrame = dispatchOrder[dispatchedFrameCount];
+        dispatchedFrameCount += 1;
+        frameDispatched[nextFrame] = true;
+        if (frameCompleted[nextFrame]) {
+          continue;
+        }
+        Frame *frameData = framesInitalizationData[nextFrame].get();
+        // Frames are admitted as governor's budget allows. Frames of
+        // levels generated from level 0 blocks are already sliced; their
+        // blocks are admitted by the pyramid.
+        std::function<void()> sliced;
+        if (memoryGovernor != nullptr && !mipChainLevel) {
+          memoryGovernor->reserveWork(frameWorkBytes);
+          sliced = [governor = memoryGovernor, frameWorkBytes]() {
+            governor->releaseWork(frameWorkBytes);
+          };
+        }
+        if (pipeline != nullptr) {
+          pipeline->addFrame(frameData, std::move(sliced));
+          continue;
+        }
+        auto sliceFrame = [frameData, sliced]() {
+          frameData->sliceFrame();
+          if (sliced) {
+            sliced();
+          }
+        };
+        if (numaPool != nullptr) {
+          numaPool->post(nextFrame / std::max<int64_t>(frameX, 1),
+                         sliceFrame);
+        } else {
+          boost::asio::post(pool, sliceFrame);
+        }
+      }
+    };
+    // File names of level in frame order.
+    std::vector<std::string> levelFileNames;
+    auto createFileDraft = [&](std::vector<std::unique_ptr<Frame>> frames) {
       std::unique_ptr<DcmFileDraft> filedraft = std::make_unique<DcmFileDraft>(
-          std::move(framesData), wsiRequest_->outputFileMask,
+          std::move(frames), wsiRequest_->outputFileMask,
           downsampledLevelWidth, downsampledLevelHeight, instanceNumber,
           wsiRequest_->studyId, wsiRequest_->seriesId,
           wsiRequest_->imageName, levelCompression,
-          wsiRequest_->tiled, tags.get(), levelWidthMM, levelHeightMM,
+          wsiRequest_->tiled, tags, levelWidthMM, levelHeightMM,
           downsample, &generatedDicomFiles, sourceDerivationDescription,
           save_dicom_instance_to_disk);
-      boost::asio::post(pool, [th_filedraft = filedraft.get()]() {
-        th_filedraft->saveFile();
-      });
+      filedraft->setOutputFileWriteMode(wsiRequest_->directIOWrite,
+                                        wsiRequest_->dropOutputPageCache);
+      const std::string fileName = boost::filesystem::path(
+                        filedraft->outputFileName()).filename().string();
+      if (checkpoint_ != nullptr) {
+        filedraft->setInstanceUid(checkpoint_->uid(fileName));
+      }
+      levelFileNames.push_back(fileName);
+      return filedraft;
+    };
+    // Adds file completed before conversion was interrupted in place of
+    // frames. Returns false if frames are not those of a completed file.
+    auto addCompletedFile = [&](std::vector<std::unique_ptr<Frame>> *frames,
+                                size_t endFrame) {
+      const size_t firstFrame = endFrame - frames->size();
+      auto completedFile = completedFiles.find(firstFrame);
+      if (completedFile == completedFiles.end() ||
+          completedFile->second->fileFrameCount() !=
+              static_cast<int64_t>(frames->size())) {
+        return false;
+      }
+      levelFileNames.push_back(DcmFileDraft::levelFileName(
+                                         downsample, firstFrame, endFrame));
+      generatedDicomFiles.push_back(std::move(completedFile->second));
+      completedFiles.erase(completedFile);
+      frames->clear();
+      return true;
+    };
+    // Concatenation parts of level sized by encoded byte budget.
+    std::vector<DcmFileDraft *> byteBudgetFileDrafts;
+    if (wsiRequest_->batchBytesLimit > 0) {
+      // Encoded frame size is not known until frame is sliced. Frames are
+      // dispatched a bounded window ahead of the frame being assigned to a
+      // file so completed files can be written while the level is sliced.
+      const size_t dispatchWindow = 4 * static_cast<size_t>(threadsForPool);
+      int64_t batchBytes = 0;
+      for (size_t frameIndex = 0; frameIndex < total_frame_count;
+           ++frameIndex) {
+        dispatchFrames(frameIndex, frameIndex + dispatchWindow + 1);
+        Frame *frame = framesInitalizationData[frameIndex].get();
+        frame->waitDone();
+        batchBytes += frame->dicomFrameBytesSize();
+        framesData.push_back(std::move(framesInitalizationData[frameIndex]));
+        if (batchBytes >= wsiRequest_->batchBytesLimit ||
+            (wsiRequest_->batchLimit > 0 &&
+             framesData.size() >= wsiRequest_->batchLimit)) {
+          std::unique_ptr<DcmFileDraft> filedraft =
+              createFileDraft(std::move(framesData));
+          postSaveFile(filedraft.get());
+          byteBudgetFileDrafts.push_back(filedraft.get());
+          generatedDicomFiles.push_back(std::move(filedraft));
+          framesData.clear();
+          batchBytes = 0;
+        }
+      }
+    } else {
+      for (size_t frameIndex = 0; frameIndex < total_frame_count;
+           ++frameIndex) {
+        dispatchFrames(frameIndex, 0);
+        framesData.push_back(std::move(framesInitalizationData[frameIndex]));
+        if (wsiRequest_->batchLimit > 0 &&
+            framesData.size() >= wsiRequest_->batchLimit &&
+            !addCompletedFile(&framesData, frameIndex + 1)) {
+          std::unique_ptr<DcmFileDraft> filedraft =
+              createFileDraft(std::move(framesData));
+          postSaveFile(filedraft.get());
+          generatedDicomFiles.push_back(std::move(filedraft));
+        }
+      }
+    }
+    if (framesData.size() > 0 &&
+        !addCompletedFile(&framesData, total_frame_count)) {
+      std::unique_ptr<DcmFileDraft> filedraft =
+          createFileDraft(std::move(framesData));
+      postSaveFile(filedraft.get());
+      byteBudgetFileDrafts.push_back(filedraft.get());
       generatedDicomFiles.push_back(std::move(filedraft));
     }
+    if (pipeline != nullptr) {
+      pipeline->join();
+      BOOST_LOG_TRIVIAL(debug) << "Level " << levelIndex << " pipeline "
+                                  "stages; " << pipeline->statsString();
+    }
+    if (numaPool != nullptr) {
+      numaPool->join();
+    }
     pool.join();
-    clearOpenSlidePtr();
+    if (tiffFrameFilePtr != nullptr) {
+      tiffFrameFilePtr->stopTilePrefetch();
+    }
+    if (saveFailed) {
+      BOOST_LOG_TRIVIAL(error) << "Could not write files of level " <<
+                                  levelIndex << ".";
+      return 1;
+    }
+    if (wsiRequest_->batchBytesLimit > 0 && byteBudgetFileDrafts.size() > 1) {
+      // Second phase: number of parts is now known. Last part was drafted
+      // knowing it completed the level; fix up parts written before it.
+      const int64_t concatenationTotalNumber = byteBudgetFileDrafts.size();
+      for (size_t partIndex = 0; partIndex + 1 < byteBudgetFileDrafts.size();
+           ++partIndex) {
+        if (!byteBudgetFileDrafts[partIndex]->updateConcatenationTotalNumber(
+                concatenationTotalNumber)) {
+          return 1;
+        }
+        // Recorded again so the patched file is synced before the level.
+        if (levelCheckpoint != nullptr) {
+          levelCheckpoint->markFileComplete(
+              byteBudgetFileDrafts[partIndex]->outputFileName());
+        }
+      }
+    }
+    if (levelCheckpoint != nullptr) {
+      levelCheckpoint->markLevelComplete(downsample, levelFileNames);
+    }
     if  (!saveCompressedRaw) {
       generatedDicomFiles.clear();
     }
     higherMagnifcationDicomFiles.setDicomFiles(std::move(generatedDicomFiles),
                                                std::move(tiffFrameFilePtr));
+    if (wsiRequest_->levelDoneCallback) {
+      wsiRequest_->levelDoneCallback(levelIndex + 1, downsampleSlide.size());
+    }
     if (wsiRequest_->stopDownsamplingAtSingleFrame && total_frame_count <= 1) {
       break;
     }
   }
+  if (ownedMemoryGovernor != nullptr) {
+    BOOST_LOG_TRIVIAL(info) << "Memory governor peak reserved: " <<
+        memoryGovernor->peakReservedBytes() / (1024 * 1024) << " MB of " <<
+        maxMemoryMB << " MB; frames throttled: " <<
+        memoryGovernor->throttledReservations() << " for " <<
+        memoryGovernor->throttledSeconds() << "s";
+  }
   BOOST_LOG_TRIVIAL(info) << "dicomization is done";
   return 0;
 }
 
+void WsiToDcm::setFrameCodecThreads(int32_t poolThreads) {
+  const int32_t cpuCount = availableCpuCount();
+  if (poolThreads <= 0 || poolThreads > cpuCount) {
+    poolThreads = cpuCount;
+  }
+  const int32_t threadsPerFrame = std::max(cpuCount / poolThreads, 1);
+  jpeg2000Util::setDecodeThreads(threadsPerFrame);
+  cv::setNumThreads(threadsPerFrame);
+}
+
 int WsiToDcm::wsi2dcm() {
   try {
     checkArguments();
@@ -17,17 +17,23 @@
 #include <boost/cstdint.hpp>
 #include <opencv2/opencv.hpp>
 
+#include <functional>
 #include <iostream>
 #include <memory>
 #include <string>
 #include <vector>
 
 #include "src/openslideUtil.h"
+#include "src/conversionCheckpoint.h"
 #include "src/enums.h"
 #include "src/tiffFile.h"
 #include "src/dcmFilePyramidSource.h"
+#include "src/dcmSeriesIndex.h"
 #include "src/imageFilePyramidSource.h"
+#include "src/mipChainPyramid.h"
 #include "src/jpegCompression.h"
+#include "src/dcmTags.h"
+#include "src/memoryGovernor.h"
 
 namespace wsiToDicomConverter {
 
@@ -71,6 +77,16 @@ class SlideLevelDim {
 
   bool readFromTiff = false;
 
+  // True if frames read from tiff are joined from several tiff tiles.
+  bool retileFromTiff = false;
+
+  // Index of DICOM series level being read, -1 if not reading series.
+  int32_t dicomSeriesLevel = -1;
+
+  // True if DICOM series level has the dimensions, frame size, and encoding
+  // of level being generated; frames can be used without decompression.
+  bool dicomSeriesLevelUnchanged = false;
+
   // Source component of DCM_DerivationDescription
   // describes in text where imaging data was acquired from.
   std::string sourceDerivationDescription;
@@ -79,7 +95,7 @@ class SlideLevelDim {
 
 // Structure for wsi2dcm settings
 struct WsiRequest {
-  // wsi input file
+  // wsi input file or directory holding DICOM series
   std::string inputFile = "";
 
   // path to save generated files
@@ -111,6 +127,10 @@ struct WsiRequest {
   // json file with additional DICOM metadata
   std::string jsonFile = "";
 
+  // tags parsed from jsonFile shared by slides of a batch; jsonFile is
+  // read if not set.
+  DcmTags *jsonTags = nullptr;
+
   // number of levels, levels == 0  means number of
   // levels will be readed from wsi file
   int32_t retileLevels = 0;
@@ -132,8 +152,74 @@ struct WsiRequest {
   // eg: 3 files will be generated for batchLimit is 10 and 30 frames in level
   int32_t batchLimit = 0;
 
+  // maximum encoded frame bytes in one file, as limit is exceeded new file
+  // is started. 0 = disabled. When enabled batchLimit caps frame count.
+  int64_t batchBytesLimit = 0;
+
+  // write output files with direct I/O (O_DIRECT), bypassing page cache.
+  bool directIOWrite = false;
+
+  // drop written output files from page cache (posix_fadvise DONTNEED).
+  bool dropOutputPageCache = false;
+
+  // raw tiff tiles read ahead of frame workers, 0 = disabled.
+  int32_t tilePrefetchQueueDepth = 0;
+
+  // size of tile cache shared by openslide handles, 0 = openslide default.
+  int64_t openslideCacheMB = 0;
+
+  // frames whose openslide regions are read with one region read, 0 reads
+  // each frame's region separately.
+  int64_t openslideRegionBandFrames = 0;
+
+  // generate levels read from openslide in one pass over blocks of
+  // level 0 instead of reading each level's source separately.
+  bool fusedPyramid = false;
+
+  // order frames of a level are generated in; frames are written in
+  // raster order.
+  FrameOrder frameOrder = RASTER_ORDER;
+
+  // threads reading frame sources in the staged frame pipeline,
+  // 0 = frames are read and sliced by the same thread.
+  int32_t readThreads = 0;
+
+  // threads resampling and compressing frames in the staged frame
+  // pipeline, 0 = threads.
+  int32_t sliceThreads = 0;
+
+  // threads writing DICOM files in the staged frame pipeline, 0 = 1.
+  int32_t writeThreads = 0;
+
+  // frames read ahead of slicing in the staged frame pipeline,
+  // 0 = twice sliceThreads.
+  int32_t stageQueueDepth = 0;
+
+  // memory budget of frames and files being generated, 0 = unbounded.
+  int64_t maxMemoryMB = 0;
+
+  // governor shared by slides of a batch; created from maxMemoryMB if not
+  // set.
+  MemoryGovernor *memoryGovernor = nullptr;
+
+  // called with levels generated and levels to generate as each level
+  // is completed, e.g. to report progress of daemon jobs.
+  std::function<void(int64_t, int64_t)> levelDoneCallback;
+
+  // resume conversion interrupted before it completed; files recorded in
+  // the output folder's checkpoint are not generated again, and UIDs not
+  // set by options are derived from the input and resumeOptions.
+  bool resume = false;
+
+  // options which change output; identifies conversion with input.
+  std::string resumeOptions;
+
+  // pin frame workers to NUMA nodes, one worker group per node; frames
+  // of a row are generated on one node.
+  bool numaPinning = false;
+
   // threads to consume during execution
-  int8_t threads = -1;
+  int32_t threads = -1;
 
   // start slicing from point (1,1) instead of (0,0) to avoid bug
   //  https://github.com/openslide/openslide/issues/268
@@ -161,10 +247,27 @@ struct WsiRequest {
 
   bool SVSImportPreferScannerTileingForLargestLevel = false;
   bool SVSImportPreferScannerTileingForAllLevels = false;
+
+  // join svs jpeg tiles into frames of frameSizeX, frameSizeY without
+  // decompression; frame size must be a multiple of the svs tile size.
+  bool SVSImportLosslessRetile = false;
+
+  // progressively downsample jpeg levels in YCbCr without converting
+  // frames of prior level to RGB; nearest neighbor downsampling only.
+  bool jpegYCbCrDownsampling = false;
+
+  // downsample JPEG 2000 encoded svs/tiff levels by decoding tiles at
+  // reduced resolution; power of two downsamples only.
+  bool jpeg2000ReducedResolution = false;
   bool genPyramidFromUntiledImage = false;
   double untiledImageHeightMM = 0.0;
   bool includeSingleFrameDownsample = false;
   JpegSubsampling jpegSubsampling = subsample_420;
+
+  // copy JPEG frames of DICOM input levels matching the level being
+  // generated without re-encoding; false re-encodes them at quality and
+  // jpegSubsampling.
+  bool dicomJpegPassthrough = true;
 };
 
 
@@ -187,11 +290,19 @@ class WsiToDcm {
 
   int wsi2dcm();
 
+  // Sets threads OpenJPEG and OpenCV start within a frame; process wide.
+  // poolThreads - frame pool threads of all slides converted at the same
+  //               time, <= 0 uses available cores. Cores not used by frame
+  //               pools are shared by frames, so total threads stay within
+  //               available cores.
+  static void setFrameCodecThreads(int32_t poolThreads);
+
   // Generates tasks and handling thread pool
   double getOpenSlideDimensionMM(const char* openSlideProperty);
   std::string initOpenSlide();
   std::unique_ptr<DcmFilePyramidSource> initDicomIngest(
                                   bool load_frame_data_from_dicom_using_dcmtk);
+  void initDicomSeriesIngest();
   std::unique_ptr<ImageFilePyramidSource> initUntiledImageIngest();
   std::unique_ptr<SlideLevelDim> initAbstractDicomFileSourceLevelDim(
                                                 absl::string_view description);
@@ -222,10 +333,30 @@ class WsiToDcm {
   int64_t largestSlideLevelHeight_;
   int32_t svsLevelCount_;
   std::unique_ptr<OpenSlidePtr> osptr_;
+  std::unique_ptr<OpenSlidePool> openslidePool_;
   std::unique_ptr<TiffFile> tiffFile_;
+  std::unique_ptr<DcmSeriesIndex> dcmSeriesIndex_;
+  // True if levels of DICOM series can be copied to output unchanged.
+  bool dicomSeriesPassthrough_;
+  // Files completed by an interrupted conversion; nullptr if not resuming.
+  std::unique_ptr<ConversionCheckpoint> checkpoint_;
 
   openslide_t* getOpenSlidePtr();
   void clearOpenSlidePtr();
+  OpenSlidePool* getOpenSlidePool(size_t maxHandles);
+  // True if jpeg tiles of tiff level can be joined into frames.
+  bool canRetileTiffLevel(int32_t level);
+  bool isDicomSeriesLevelPassthrough(const SlideLevelDim &slideLevelDim) const;
+  // Copies instances of DICOM series level to output, numbered
+  // instanceNumber, and records them in checkpoint.
+  bool copyDicomSeriesLevel(const SlideLevelDim &slideLevelDim,
+                            int32_t instanceNumber);
+  // Starts generating levels read from openslide from level 0 blocks.
+  // Blocks are admitted by memoryGovernor, if not nullptr. Returns nullptr
+  // if no level is read from openslide.
+  std::unique_ptr<MipChainPyramid> initMipChainPyramid(
+                  const std::vector<DownsamplingSlideState> &downsampleSlide,
+                  size_t threads, MemoryGovernor *memoryGovernor);
 };
 
 }  // namespace wsiToDicomConverter
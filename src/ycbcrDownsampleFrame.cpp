@@ -0,0 +1,126 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/ycbcrDownsampleFrame.h"
+
+#include <boost/log/trivial.hpp>
+
+#include <utility>
+
+#include "src/zlibWrapper.h"
+
+namespace wsiToDicomConverter {
+
+YCbCrDownsampleFrame::YCbCrDownsampleFrame(
+    int64_t locationX, int64_t locationY, int64_t frameWidthDownsampled,
+    int64_t frameHeightDownsampled, int64_t frameWidth, int64_t frameHeight,
+    int quality, JpegSubsampling sampling, bool storeRawBytes,
+    DICOMFileFrameRegionReader *frame_region_reader) : Frame(locationX,
+                                                             locationY,
+                                                             frameWidth,
+                                                             frameHeight,
+                                                             JPEG, quality,
+                                                             sampling,
+                                                             storeRawBytes) {
+  frameWidthDownsampled_ = frameWidthDownsampled;
+  frameHeightDownsampled_ = frameHeightDownsampled;
+  dcmFrameRegionReader_ = frame_region_reader;
+  switch (sampling) {
+    case subsample_440:
+      chromaSubsampleX_ = 1;
+      chromaSubsampleY_ = 2;
+    break;
+    case subsample_422:
+      chromaSubsampleX_ = 2;
+      chromaSubsampleY_ = 1;
+    break;
+    case subsample_420:
+      chromaSubsampleX_ = 2;
+      chromaSubsampleY_ = 2;
+    break;
+    default:
+      chromaSubsampleX_ = 1;
+      chromaSubsampleY_ = 1;
+    break;
+  }
+}
+
+YCbCrDownsampleFrame::~YCbCrDownsampleFrame() {}
+
+void YCbCrDownsampleFrame::incSourceFrameReadCounter() {
+  dcmFrameRegionReader_->incSourceFrameReadCounter(locationX_, locationY_,
+                                                   frameWidthDownsampled_,
+                                                   frameHeightDownsampled_);
+}
+
+void YCbCrDownsampleFrame::sliceFrame() {
+  YCbCrImage image(frameWidth_, frameHeight_, chromaSubsampleX_,
+                   chromaSubsampleY_);
+  if (!dcmFrameRegionReader_->downsampleRegionYCbCr(locationX_, locationY_,
+                                                    frameWidthDownsampled_,
+                                                    frameHeightDownsampled_,
+                                                    &image)) {
+    BOOST_LOG_TRIVIAL(error) << "Error occured decoding YCbCr region from "
+                                "previous level.";
+    throw 1;
+  }
+  if (!storeRawBytes_) {
+    clearRawABGRMem();
+  } else {
+    rawCompressedBytes_ = std::move(compress_memory(image.data(),
+                                                    image.byteSize(),
+                                                    &rawCompressedBytesSize_));
+  }
+  size_t size;
+  // Constructor always creates frame with JPEG compression.
+  JpegCompression *jpegCompressor =
+                             static_cast<JpegCompression *>(compressor_.get());
+  std::unique_ptr<uint8_t[]> mem = std::move(
+                                 jpegCompressor->compressYCbCr(image, &size));
+  setDicomFrameBytes(std::move(mem), size);
+  setDone();
+}
+
+bool YCbCrDownsampleFrame::decompressRawBytes(YCbCrImage *image) {
+  image->resize(frameWidth_, frameHeight_, chromaSubsampleX_,
+                chromaSubsampleY_);
+  return decompress_memory(rawCompressedBytes_.get(), rawCompressedBytesSize_,
+                           image->data(), image->byteSize()) ==
+         image->byteSize();
+}
+
+int64_t YCbCrDownsampleFrame::rawABGRFrameBytes(uint8_t *rawMemory,
+                                                int64_t memorySize) {
+  int64_t memSize = 0;
+  YCbCrImage image;
+  if (memorySize >= frameWidth_ * frameHeight_ * 4 &&
+      decompressRawBytes(&image)) {
+    image.toABGR(rawMemory);
+    memSize = frameWidth_ * frameHeight_ * 4;
+  }
+  decReadCounter();
+  return memSize;
+}
+
+bool YCbCrDownsampleFrame::hasYCbCrFrameBytes() const {
+  return storeRawBytes_;
+}
+
+bool YCbCrDownsampleFrame::ycbcrFrameBytes(YCbCrImage *image) {
+  const bool result = decompressRawBytes(image);
+  decReadCounter();
+  return result;
+}
+
+}  // namespace wsiToDicomConverter
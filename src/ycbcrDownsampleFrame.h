@@ -0,0 +1,71 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SRC_YCBCRDOWNSAMPLEFRAME_H_
+#define SRC_YCBCRDOWNSAMPLEFRAME_H_
+
+#include <memory>
+
+#include "src/dicom_file_region_reader.h"
+#include "src/frame.h"
+#include "src/jpegCompression.h"
+#include "src/ycbcrImage.h"
+
+namespace wsiToDicomConverter {
+
+// Frame downsampled from level captured at higher magnification without
+// leaving the YCbCr color space. Source frames are decoded to planar
+// YCbCr, each plane is nearest neighbor downsampled, and the planes are
+// encoded as jpeg without color conversion. Frame is always jpeg
+// compressed and requires source frames which support ycbcrFrameBytes.
+class YCbCrDownsampleFrame : public Frame {
+ public:
+  // locationX, locationY - top-left corner of frame in source level
+  //                        coordinates
+  // frameWidthDownsampled, frameHeightDownsampled - size of source region
+  // frameWidth, frameHeight - size region is scaled to
+  // quality - jpeg compression quality setting
+  // sampling - jpeg chroma subsampling of frame
+  // storeRawBytes - store planar YCbCr frame pixels in frame in addition
+  //                 to compressed pixel bytes. Required for progressive
+  //                 downsampling.
+  // frame_region_reader - frame reader for frames of prior level.
+  YCbCrDownsampleFrame(int64_t locationX, int64_t locationY,
+                       int64_t frameWidthDownsampled,
+                       int64_t frameHeightDownsampled,
+                       int64_t frameWidth, int64_t frameHeight,
+                       int quality, JpegSubsampling sampling,
+                       bool storeRawBytes,
+                       DICOMFileFrameRegionReader *frame_region_reader);
+
+  virtual ~YCbCrDownsampleFrame();
+  virtual void sliceFrame();
+  virtual void incSourceFrameReadCounter();
+  virtual int64_t rawABGRFrameBytes(uint8_t *rawMemory, int64_t memorySize);
+  virtual bool hasYCbCrFrameBytes() const;
+  virtual bool ycbcrFrameBytes(YCbCrImage *image);
+
+ private:
+  bool decompressRawBytes(YCbCrImage *image);
+
+  int64_t frameWidthDownsampled_;
+  int64_t frameHeightDownsampled_;
+  int chromaSubsampleX_;
+  int chromaSubsampleY_;
+  DICOMFileFrameRegionReader *dcmFrameRegionReader_;
+};
+
+}  // namespace wsiToDicomConverter
+
+#endif  // SRC_YCBCRDOWNSAMPLEFRAME_H_
@@ -0,0 +1,117 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "src/ycbcrImage.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace wsiToDicomConverter {
+
+YCbCrImage::YCbCrImage() : width_(0), height_(0), chromaSubsampleX_(1),
+                           chromaSubsampleY_(1) {}
+
+YCbCrImage::YCbCrImage(int64_t width, int64_t height, int chromaSubsampleX,
+                       int chromaSubsampleY) {
+  resize(width, height, chromaSubsampleX, chromaSubsampleY);
+}
+
+void YCbCrImage::resize(int64_t width, int64_t height, int chromaSubsampleX,
+                        int chromaSubsampleY) {
+  width_ = width;
+  height_ = height;
+  chromaSubsampleX_ = chromaSubsampleX;
+  chromaSubsampleY_ = chromaSubsampleY;
+  data_ = std::make_unique<uint8_t[]>(byteSize());
+}
+
+int64_t YCbCrImage::width() const {
+  return width_;
+}
+
+int64_t YCbCrImage::height() const {
+  return height_;
+}
+
+int YCbCrImage::chromaSubsampleX() const {
+  return chromaSubsampleX_;
+}
+
+int YCbCrImage::chromaSubsampleY() const {
+  return chromaSubsampleY_;
+}
+
+int64_t YCbCrImage::planeWidth(int plane) const {
+  if (plane == 0) {
+    return width_;
+  }
+  return (width_ + chromaSubsampleX_ - 1) / chromaSubsampleX_;
+}
+
+int64_t YCbCrImage::planeHeight(int plane) const {
+  if (plane == 0) {
+    return height_;
+  }
+  return (height_ + chromaSubsampleY_ - 1) / chromaSubsampleY_;
+}
+
+uint8_t *YCbCrImage::plane(int plane) {
+  return const_cast<uint8_t *>(
+                      static_cast<const YCbCrImage *>(this)->plane(plane));
+}
+
+const uint8_t *YCbCrImage::plane(int plane) const {
+  const int64_t chromaSize = planeWidth(1) * planeHeight(1);
+  switch (plane) {
+    case 0:
+      return data_.get();
+    case 1:
+      return data_.get() + width_ * height_;
+    default:
+      return data_.get() + width_ * height_ + chromaSize;
+  }
+}
+
+uint8_t *YCbCrImage::data() {
+  return data_.get();
+}
+
+int64_t YCbCrImage::byteSize() const {
+  return width_ * height_ + 2 * planeWidth(1) * planeHeight(1);
+}
+
+void YCbCrImage::clear() {
+  const int64_t lumaSize = width_ * height_;
+  std::memset(data_.get(), 0, lumaSize);
+  std::memset(data_.get() + lumaSize, 128, byteSize() - lumaSize);
+}
+
+void YCbCrImage::toABGR(uint8_t *abgr) const {
+  const int64_t chromaWidth = planeWidth(1);
+  const uint8_t *yPlane = plane(0);
+  const uint8_t *cbPlane = plane(1);
+  const uint8_t *crPlane = plane(2);
+  for (int64_t y = 0; y < height_; ++y) {
+    const int64_t chromaRow = (y / chromaSubsampleY_) * chromaWidth;
+    for (int64_t x = 0; x < width_; ++x) {
+      const int64_t chromaIndex = chromaRow + x / chromaSubsampleX_;
+      ycbcrToRGB(yPlane[y * width_ + x], cbPlane[chromaIndex],
+                 crPlane[chromaIndex], abgr);
+      abgr[3] = 0xff;  // alpha
+      abgr += 4;
+    }
+  }
+}
+
+}  // namespace wsiToDicomConverter
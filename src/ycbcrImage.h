@@ -0,0 +1,92 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SRC_YCBCRIMAGE_H_
+#define SRC_YCBCRIMAGE_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+
+namespace wsiToDicomConverter {
+
+// Planar 8 bit YCbCr (JFIF, full range) image. Chroma planes are
+// subsampled relative to luma by chromaSubsampleX, chromaSubsampleY; e.g.
+// 2, 2 for 4:2:0. Planes are stored contiguously Y, Cb, Cr so the image
+// can be stored as a single block of memory.
+class YCbCrImage {
+ public:
+  YCbCrImage();
+  YCbCrImage(int64_t width, int64_t height, int chromaSubsampleX,
+             int chromaSubsampleY);
+  YCbCrImage(const YCbCrImage &image) = delete;
+  YCbCrImage &operator =(const YCbCrImage &image) = delete;
+
+  // Allocates image; contents are uninitialized.
+  void resize(int64_t width, int64_t height, int chromaSubsampleX,
+              int chromaSubsampleY);
+
+  int64_t width() const;
+  int64_t height() const;
+  int chromaSubsampleX() const;
+  int chromaSubsampleY() const;
+
+  // Plane index 0 = Y, 1 = Cb, 2 = Cr.
+  int64_t planeWidth(int plane) const;
+  int64_t planeHeight(int plane) const;
+  uint8_t *plane(int plane);
+  const uint8_t *plane(int plane) const;
+
+  // Memory holding all planes.
+  uint8_t *data();
+  int64_t byteSize() const;
+
+  // Fills image with black.
+  void clear();
+
+  // Converts image to 4 byte pixels (R, G, B, A bytes; layout of raw
+  // frame bytes). abgr must hold width * height * 4 bytes.
+  void toABGR(uint8_t *abgr) const;
+
+ private:
+  int64_t width_;
+  int64_t height_;
+  int chromaSubsampleX_;
+  int chromaSubsampleY_;
+  std::unique_ptr<uint8_t[]> data_;
+};
+
+inline uint8_t clampYCbCrSample(int value) {
+  return static_cast<uint8_t>(std::min(255, std::max(0, value)));
+}
+
+// Converts JFIF YCbCr sample (Cb, Cr centered on 128) to R, G, B bytes
+// written to rgb. Fixed point; coefficients scaled by 2^16.
+inline void ycbcrToRGB(int luma, int cb, int cr, uint8_t *rgb) {
+  static const int ONE_HALF = 1 << 15;
+  static const int CR_TO_R = 91881;    // 1.402
+  static const int CB_TO_G = 22554;    // 0.344136
+  static const int CR_TO_G = 46802;    // 0.714136
+  static const int CB_TO_B = 116130;   // 1.772
+  cb -= 128;
+  cr -= 128;
+  rgb[0] = clampYCbCrSample(luma + ((CR_TO_R * cr + ONE_HALF) >> 16));
+  rgb[1] = clampYCbCrSample(luma + ((-CB_TO_G * cb - CR_TO_G * cr +
+                                     ONE_HALF) >> 16));
+  rgb[2] = clampYCbCrSample(luma + ((CB_TO_B * cb + ONE_HALF) >> 16));
+}
+
+}  // namespace wsiToDicomConverter
+
+#endif  // SRC_YCBCRIMAGE_H_
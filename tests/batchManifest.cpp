@@ -0,0 +1,78 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "src/batchManifest.h"
+
+namespace wsiToDicomConverter {
+
+namespace {
+
+std::string writeManifest(const std::string &content) {
+  const std::string path = (boost::filesystem::temp_directory_path() /
+                            boost::filesystem::unique_path()).string() +
+                           ".tsv";
+  std::ofstream(path) << content;
+  return path;
+}
+
+}  // namespace
+
+TEST(batchManifest, readRows) {
+  const std::string path = writeManifest(
+      "# input\toutput\tjson\toptions\n"
+      "\n"
+      "a.svs\tout/a\n"
+      "b.svs\tout/b\tb.json\n"
+      "c.svs\tout/c\t\t--tileWidth 256  --tileHeight 256\r\n");
+  std::vector<BatchManifestRow> rows;
+  std::string errorMsg;
+  ASSERT_TRUE(readBatchManifest(path, &rows, &errorMsg));
+  ASSERT_EQ(rows.size(), 3);
+  EXPECT_EQ(rows[0].lineNumber, 3);
+  EXPECT_EQ(rows[0].inputFile, "a.svs");
+  EXPECT_EQ(rows[0].outputFolder, "out/a");
+  EXPECT_TRUE(rows[0].jsonFile.empty());
+  EXPECT_TRUE(rows[0].options.empty());
+  EXPECT_EQ(rows[1].jsonFile, "b.json");
+  EXPECT_TRUE(rows[2].jsonFile.empty());
+  EXPECT_EQ(rows[2].options, std::vector<std::string>({"--tileWidth", "256",
+                                                       "--tileHeight",
+                                                       "256"}));
+  boost::filesystem::remove(path);
+}
+
+TEST(batchManifest, rejectsRowWithoutOutputFolder) {
+  const std::string path = writeManifest("a.svs\tout/a\nb.svs\n");
+  std::vector<BatchManifestRow> rows;
+  std::string errorMsg;
+  EXPECT_FALSE(readBatchManifest(path, &rows, &errorMsg));
+  EXPECT_NE(errorMsg.find("line 2"), std::string::npos);
+  boost::filesystem::remove(path);
+}
+
+TEST(batchManifest, missingManifest) {
+  std::vector<BatchManifestRow> rows;
+  std::string errorMsg;
+  EXPECT_FALSE(readBatchManifest("/nonexistent/manifest.tsv", &rows,
+                                 &errorMsg));
+}
+
+}  // namespace wsiToDicomConverter
@@ -0,0 +1,117 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "src/containerResources.h"
+
+namespace wsiToDicomConverter {
+
+namespace {
+
+// Creates cgroup directory holding files, given as relative path and
+// content pairs.
+std::string makeCgroupDirectory(
+    const std::vector<std::pair<std::string, std::string>> &files) {
+  const boost::filesystem::path dir = boost::filesystem::temp_directory_path()
+      / boost::filesystem::unique_path();
+  boost::filesystem::create_directories(dir);
+  for (const std::pair<std::string, std::string> &file : files) {
+    const boost::filesystem::path path = dir / file.first;
+    boost::filesystem::create_directories(path.parent_path());
+    std::ofstream(path.string()) << file.second << "\n";
+  }
+  return dir.string();
+}
+
+}  // namespace
+
+TEST(containerResources, readsCgroupV2Limits) {
+  const std::string dir = makeCgroupDirectory({
+      {"cpu.max", "250000 100000"}, {"memory.max", "4294967296"}});
+  const CgroupLimits limits = readCgroupLimits(dir);
+  EXPECT_EQ(limits.cpus, 3);
+  EXPECT_EQ(limits.memoryBytes, 4294967296);
+  boost::filesystem::remove_all(dir);
+}
+
+TEST(containerResources, cgroupV2Unlimited) {
+  const std::string dir = makeCgroupDirectory({
+      {"cpu.max", "max 100000"}, {"memory.max", "max"}});
+  const CgroupLimits limits = readCgroupLimits(dir);
+  EXPECT_EQ(limits.cpus, 0);
+  EXPECT_EQ(limits.memoryBytes, 0);
+  boost::filesystem::remove_all(dir);
+}
+
+TEST(containerResources, readsCgroupV1Limits) {
+  const std::string dir = makeCgroupDirectory({
+      {"cpu/cpu.cfs_quota_us", "200000"},
+      {"cpu/cpu.cfs_period_us", "100000"},
+      {"memory/memory.limit_in_bytes", "1073741824"}});
+  const CgroupLimits limits = readCgroupLimits(dir);
+  EXPECT_EQ(limits.cpus, 2);
+  EXPECT_EQ(limits.memoryBytes, 1073741824);
+  boost::filesystem::remove_all(dir);
+}
+
+TEST(containerResources, cgroupV1Unlimited) {
+  const std::string dir = makeCgroupDirectory({
+      {"cpu/cpu.cfs_quota_us", "-1"},
+      {"cpu/cpu.cfs_period_us", "100000"},
+      {"memory/memory.limit_in_bytes", "9223372036854771712"}});
+  const CgroupLimits limits = readCgroupLimits(dir);
+  EXPECT_EQ(limits.cpus, 0);
+  EXPECT_EQ(limits.memoryBytes, 0);
+  boost::filesystem::remove_all(dir);
+}
+
+TEST(containerResources, readsCgroupV2LimitsOfProcessCgroup) {
+  const std::string dir = makeCgroupDirectory({
+      {"cgroup", "0::/kubepods/pod1/container1"},
+      {"kubepods/pod1/cpu.max", "max 100000"},
+      {"kubepods/pod1/memory.max", "2147483648"},
+      {"kubepods/pod1/container1/cpu.max", "150000 100000"},
+      {"kubepods/pod1/container1/memory.max", "max"}});
+  const CgroupLimits limits = readCgroupLimits(dir, dir + "/cgroup");
+  EXPECT_EQ(limits.cpus, 2);
+  // Limit of parent cgroup applies.
+  EXPECT_EQ(limits.memoryBytes, 2147483648);
+  boost::filesystem::remove_all(dir);
+}
+
+TEST(containerResources, readsCgroupV1LimitsOfProcessCgroup) {
+  const std::string dir = makeCgroupDirectory({
+      {"cgroup", "4:memory:/docker/abc\n3:cpu,cpuacct:/docker/abc"},
+      {"cpu/docker/abc/cpu.cfs_quota_us", "100000"},
+      {"cpu/docker/abc/cpu.cfs_period_us", "100000"},
+      {"memory/memory.limit_in_bytes", "9223372036854771712"},
+      {"memory/docker/abc/memory.limit_in_bytes", "536870912"}});
+  const CgroupLimits limits = readCgroupLimits(dir, dir + "/cgroup");
+  EXPECT_EQ(limits.cpus, 1);
+  EXPECT_EQ(limits.memoryBytes, 536870912);
+  boost::filesystem::remove_all(dir);
+}
+
+TEST(containerResources, availableCpuCountIsPositive) {
+  EXPECT_GE(availableCpuCount(), 1);
+}
+
+}  // namespace wsiToDicomConverter
@@ -0,0 +1,109 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "src/conversionCheckpoint.h"
+
+namespace wsiToDicomConverter {
+
+namespace {
+
+std::string makeTempFolder() {
+  const boost::filesystem::path path =
+      boost::filesystem::temp_directory_path() /
+      boost::filesystem::unique_path();
+  boost::filesystem::create_directories(path);
+  return path.string();
+}
+
+void writeFile(const std::string &path, const std::string &content) {
+  std::ofstream(path, std::ios::binary) << content;
+}
+
+}  // namespace
+
+TEST(conversionCheckpoint, deterministicUid) {
+  // 2.25 UID of UUID v5 of "seed" in the OID namespace.
+  EXPECT_EQ(deterministicUid("seed"),
+            "2.25.275922996587081879436196655988774448701");
+  EXPECT_NE(deterministicUid("seed"), deterministicUid("seed2"));
+  EXPECT_LE(deterministicUid("seed").size(), 64);
+}
+
+TEST(conversionCheckpoint, keyDependsOnInputAndOptions) {
+  const std::string folder = makeTempFolder();
+  const std::string input = folder + "/slide.svs";
+  writeFile(input, "slide");
+  const std::string key = checkpointKey(input, "tileWidth=256");
+  EXPECT_FALSE(key.empty());
+  EXPECT_EQ(key, checkpointKey(input, "tileWidth=256"));
+  EXPECT_NE(key, checkpointKey(input, "tileWidth=512"));
+  writeFile(input, "slide2");
+  EXPECT_NE(key, checkpointKey(input, "tileWidth=256"));
+  EXPECT_TRUE(checkpointKey(folder + "/missing.svs", "").empty());
+  boost::filesystem::remove_all(folder);
+}
+
+TEST(conversionCheckpoint, resumesCompleteFilesAndLevels) {
+  const std::string folder = makeTempFolder();
+  writeFile(folder + "/a.dcm", "aaaa");
+  writeFile(folder + "/b.dcm", "bb");
+  {
+    ConversionCheckpoint checkpoint(folder, "key");
+    ASSERT_TRUE(checkpoint.isValid());
+    EXPECT_EQ(checkpoint.completeFileCount(), 0);
+    checkpoint.markFileComplete(folder + "/a.dcm");
+    checkpoint.markFileComplete(folder + "/b.dcm");
+    checkpoint.markLevelComplete(1, {"a.dcm", "b.dcm"});
+    // Level with a file which was not written is not recorded.
+    checkpoint.markLevelComplete(2, {"c.dcm"});
+    EXPECT_TRUE(checkpoint.isLevelComplete(1));
+    EXPECT_FALSE(checkpoint.isLevelComplete(2));
+  }
+  {
+    ConversionCheckpoint checkpoint(folder, "key");
+    EXPECT_TRUE(checkpoint.isFileComplete("a.dcm"));
+    EXPECT_TRUE(checkpoint.isLevelComplete(1));
+    EXPECT_EQ(checkpoint.levelFiles(1),
+              std::vector<std::string>({"a.dcm", "b.dcm"}));
+    EXPECT_EQ(checkpoint.path("a.dcm"),
+              (boost::filesystem::path(folder) / "a.dcm").string());
+    EXPECT_EQ(checkpoint.uid("study"),
+              ConversionCheckpoint(folder, "key").uid("study"));
+  }
+  // File changed after it was recorded is not complete, nor is its level.
+  writeFile(folder + "/b.dcm", "bbb");
+  {
+    ConversionCheckpoint checkpoint(folder, "key");
+    EXPECT_TRUE(checkpoint.isFileComplete("a.dcm"));
+    EXPECT_FALSE(checkpoint.isFileComplete("b.dcm"));
+    EXPECT_FALSE(checkpoint.isLevelComplete(1));
+  }
+  // Checkpoint of other key is discarded.
+  {
+    ConversionCheckpoint checkpoint(folder, "otherKey");
+    EXPECT_EQ(checkpoint.completeFileCount(), 0);
+    EXPECT_NE(checkpoint.uid("study"),
+              ConversionCheckpoint(folder, "key").uid("study"));
+  }
+  boost::filesystem::remove_all(folder);
+}
+
+}  // namespace wsiToDicomConverter
@@ -0,0 +1,127 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <boost/filesystem.hpp>
+
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "src/conversionDaemon.h"
+
+namespace wsiToDicomConverter {
+
+TEST(conversionDaemon, parseJob) {
+  DaemonJobSpec spec;
+  std::string errorMsg;
+  ASSERT_TRUE(parseDaemonJobSpec(
+      "{\"input\": \"a.svs\", \"outFolder\": \"out\", \"jsonFile\": "
+      "\"a.json\", \"options\": [\"--tileWidth\", \"256\"], \"priority\": 2}",
+      &spec, &errorMsg));
+  EXPECT_EQ(spec.command, "convert");
+  EXPECT_EQ(spec.inputFile, "a.svs");
+  EXPECT_EQ(spec.outputFolder, "out");
+  EXPECT_EQ(spec.jsonFile, "a.json");
+  EXPECT_EQ(spec.options, std::vector<std::string>({"--tileWidth", "256"}));
+  EXPECT_EQ(spec.priority, 2);
+}
+
+TEST(conversionDaemon, parseJobDefaults) {
+  DaemonJobSpec spec;
+  std::string errorMsg;
+  ASSERT_TRUE(parseDaemonJobSpec("{\"input\": \"a.svs\", \"outFolder\": "
+                                 "\"out\"}", &spec, &errorMsg));
+  EXPECT_TRUE(spec.jsonFile.empty());
+  EXPECT_TRUE(spec.options.empty());
+  EXPECT_EQ(spec.priority, 0);
+}
+
+TEST(conversionDaemon, parseCommand) {
+  DaemonJobSpec spec;
+  std::string errorMsg;
+  ASSERT_TRUE(parseDaemonJobSpec("{\"command\": \"shutdown\"}", &spec,
+                                 &errorMsg));
+  EXPECT_EQ(spec.command, "shutdown");
+  ASSERT_TRUE(parseDaemonJobSpec("{\"command\": \"status\"}", &spec,
+                                 &errorMsg));
+  EXPECT_EQ(spec.command, "status");
+}
+
+TEST(conversionDaemon, rejectInvalidJob) {
+  DaemonJobSpec spec;
+  std::string errorMsg;
+  EXPECT_FALSE(parseDaemonJobSpec("{\"input\": \"a.svs\"", &spec,
+                                  &errorMsg));
+  EXPECT_FALSE(parseDaemonJobSpec("[\"a.svs\"]", &spec, &errorMsg));
+  EXPECT_FALSE(parseDaemonJobSpec("{\"input\": \"a.svs\"}", &spec,
+                                  &errorMsg));
+  EXPECT_FALSE(parseDaemonJobSpec("{\"input\": \"a.svs\", \"outFolder\": "
+                                  "\"out\", \"options\": \"--tileWidth\"}",
+                                  &spec, &errorMsg));
+  EXPECT_FALSE(parseDaemonJobSpec("{\"input\": \"a.svs\", \"outFolder\": "
+                                  "\"out\", \"priority\": \"high\"}", &spec,
+                                  &errorMsg));
+  EXPECT_FALSE(parseDaemonJobSpec("{\"command\": \"restart\"}", &spec,
+                                  &errorMsg));
+  EXPECT_FALSE(errorMsg.empty());
+}
+
+TEST(conversionDaemon, socketIsPrivateToUser) {
+  const boost::filesystem::path dir =
+      boost::filesystem::temp_directory_path() /
+      boost::filesystem::unique_path();
+  boost::filesystem::create_directories(dir);
+  const std::string socketPath = (dir / "daemon.sock").string();
+  ConversionDaemon daemon(socketPath, 1, 0,
+                          [](const std::vector<std::string> &,
+                             WsiRequest *) { return false; });
+  int result = -1;
+  std::thread server([&daemon, &result]() { result = daemon.run(); });
+  struct stat socketStat;
+  for (int attempt = 0; attempt < 100 &&
+       stat(socketPath.c_str(), &socketStat) != 0; ++attempt) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  ASSERT_EQ(0, stat(socketPath.c_str(), &socketStat));
+  EXPECT_EQ(static_cast<mode_t>(S_IRUSR | S_IWUSR),
+            socketStat.st_mode & (S_IRWXU | S_IRWXG | S_IRWXO));
+
+  // Connection of daemon's user is served.
+  const int client = socket(AF_UNIX, SOCK_STREAM, 0);
+  sockaddr_un address;
+  std::memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  std::strncpy(address.sun_path, socketPath.c_str(),
+               sizeof(address.sun_path) - 1);
+  ASSERT_EQ(0, connect(client, reinterpret_cast<sockaddr *>(&address),
+                       sizeof(address)));
+  const std::string request = "{\"command\": \"shutdown\"}\n";
+  ASSERT_EQ(static_cast<ssize_t>(request.size()),
+            write(client, request.c_str(), request.size()));
+  char reply[256];
+  EXPECT_GT(read(client, reply, sizeof(reply)), 0);
+  close(client);
+  server.join();
+  EXPECT_EQ(0, result);
+  boost::filesystem::remove_all(dir);
+}
+
+}  // namespace wsiToDicomConverter
@@ -123,10 +123,24 @@ TEST(fileGeneration, fileSave) {
       "study", "series", "image", JPEG2000, true, nullptr, 0.0, 0.0, 1, NULL,
       "FileGeneration fileSave", true);
 
-  draft.saveFile();
+  ASSERT_TRUE(draft.saveFile());
   ASSERT_TRUE(boost::filesystem::exists("./downsample-1-frames-0-100.dcm"));
 }
 
+TEST(fileGeneration, fileSaveFailure) {
+  std::vector<std::unique_ptr<Frame>> framesData;
+  for (int idx = 0; idx < 10; ++idx) {
+      framesData.push_back(std::make_unique<TestFrame>(50, 50, 1));
+  }
+  DcmFileDraft draft(std::move(framesData), "./missingFolder", 500, 500, 0,
+      "study", "series", "image", JPEG2000, true, nullptr, 0.0, 0.0, 1, NULL,
+      "FileGeneration fileSaveFailure", true);
+
+  EXPECT_FALSE(draft.saveFile());
+  EXPECT_FALSE(boost::filesystem::exists(
+      "./missingFolder/downsample-1-frames-0-10.dcm"));
+}
+
 TEST(fileGeneration, fileSaveBatch) {
   // emptyPixelData
   std::vector<std::unique_ptr<AbstractDcmFile>> dicom_file_vec;
@@ -149,8 +163,39 @@ TEST(fileGeneration, fileSaveBatch) {
      "study", "series", "image", JPEG2000, true, nullptr, 0.0, 0.0, 1,
      &dicom_file_vec, "FileGeneration fileSaveBatch 2", true);
 
-  draft.saveFile();
+  ASSERT_TRUE(draft.saveFile());
   ASSERT_TRUE(boost::filesystem::exists("./downsample-1-frames-900-1000.dcm"));
 }
 
+TEST(fileGeneration, updateConcatenationTotalNumber) {
+  std::vector<std::unique_ptr<AbstractDcmFile>> dicom_file_vec;
+  std::vector<std::unique_ptr<Frame>> framesData;
+  for (int idx = 0; idx < 10; ++idx) {
+    framesData.push_back(std::make_unique<TestFrame>(50, 50, 1));
+  }
+  DcmFileDraft draft(std::move(framesData), "./", 5000, 5000, 3, "study",
+                     "series", "image", JPEG2000, true, nullptr, 0.0, 0.0, 4,
+                     &dicom_file_vec, "FileGeneration byte budget", true);
+  ASSERT_TRUE(draft.saveFile());
+  ASSERT_TRUE(boost::filesystem::exists("./downsample-4-frames-0-10.dcm"));
+  DcmFileFormat dcmFileFormat;
+  Uint16 concatenationTotal;
+  ASSERT_TRUE(dcmFileFormat.loadFile("./downsample-4-frames-0-10.dcm").good());
+  findElement(dcmFileFormat.getDataset(), DCM_InConcatenationTotalNumber)
+      ->getUint16(concatenationTotal);
+  EXPECT_EQ(1000, concatenationTotal);
+
+  EXPECT_TRUE(draft.updateConcatenationTotalNumber(7));
+  DcmFileFormat updatedFileFormat;
+  ASSERT_TRUE(
+      updatedFileFormat.loadFile("./downsample-4-frames-0-10.dcm").good());
+  findElement(updatedFileFormat.getDataset(), DCM_InConcatenationTotalNumber)
+      ->getUint16(concatenationTotal);
+  EXPECT_EQ(7, concatenationTotal);
+  Uint16 concatenationNumber;
+  findElement(updatedFileFormat.getDataset(), DCM_InConcatenationNumber)
+      ->getUint16(concatenationNumber);
+  EXPECT_EQ(1, concatenationNumber);
+}
+
 }  // namespace wsiToDicomConverter
@@ -0,0 +1,69 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include "src/dcmFileMap.h"
+
+namespace wsiToDicomConverter {
+
+TEST(dcmFileMap, jpegFragments) {
+  DcmFileMap map("../tests/jpeg.dicom");
+  ASSERT_TRUE(map.isValid());
+  EXPECT_EQ(map.transferSyntaxUID(), "1.2.840.10008.1.2.4.50");
+  EXPECT_TRUE(map.encapsulated());
+  ASSERT_EQ(map.fragmentCount(), 12);
+  for (size_t idx = 0; idx < map.fragmentCount(); ++idx) {
+    uint64_t size;
+    const uint8_t *fragment = map.fragment(idx, &size);
+    ASSERT_TRUE(fragment != nullptr);
+    ASSERT_GT(size, 2);
+    // JPEG start of image marker.
+    EXPECT_EQ(fragment[0], 0xFF);
+    EXPECT_EQ(fragment[1], 0xD8);
+  }
+  uint64_t size;
+  EXPECT_TRUE(map.fragment(12, &size) == nullptr);
+  EXPECT_EQ(size, 0);
+}
+
+TEST(dcmFileMap, jpeg2kFragments) {
+  DcmFileMap map("../tests/jpeg2000.dicom");
+  ASSERT_TRUE(map.isValid());
+  EXPECT_TRUE(map.encapsulated());
+  ASSERT_EQ(map.fragmentCount(), 12);
+  uint64_t size;
+  const uint8_t *fragment = map.fragment(0, &size);
+  // JPEG2000 codestream start marker.
+  EXPECT_EQ(fragment[0], 0xFF);
+  EXPECT_EQ(fragment[1], 0x4F);
+}
+
+TEST(dcmFileMap, nativePixelData) {
+  DcmFileMap map("../tests/raw.dicom");
+  ASSERT_TRUE(map.isValid());
+  EXPECT_EQ(map.transferSyntaxUID(), "1.2.840.10008.1.2.1");
+  EXPECT_FALSE(map.encapsulated());
+  EXPECT_EQ(map.fragmentCount(), 0);
+  EXPECT_TRUE(map.pixelData() != nullptr);
+  EXPECT_EQ(map.pixelDataSize(), 12 * 256 * 256 * 3);
+}
+
+TEST(dcmFileMap, notDicom) {
+  DcmFileMap map("../tests/bone.jpeg");
+  EXPECT_FALSE(map.isValid());
+  EXPECT_TRUE(map.pixelData() == nullptr);
+}
+
+}  // namespace wsiToDicomConverter
@@ -13,6 +13,7 @@
 // limitations under the License.
 #include <gtest/gtest.h>
 #include <dcmtk/dcmdata/dcxfer.h>
+#include <memory>
 #include <string>
 #include "src/dcmFilePyramidSource.h"
 
@@ -99,4 +100,17 @@ TEST(dcmFilePyramidSource, readRAWDicom) {
   EXPECT_EQ(img.seriesDescription(), "test12");
 }
 
+TEST(dcmFilePyramidSource, decodeRAWDicomFrame) {
+  DcmFilePyramidSource img("../tests/raw.dicom");
+  ASSERT_TRUE(img.isValid());
+  const int64_t size = img.frameWidth() * img.frameHeight() * 4;
+  std::unique_ptr<uint8_t[]> raw = std::make_unique<uint8_t[]>(size);
+  EXPECT_EQ(img.frame(0)->rawABGRFrameBytes(raw.get(), size), size);
+  for (int64_t idx = 3; idx < size; idx += 4) {
+    ASSERT_EQ(raw[idx], 0xff);
+  }
+  // Buffer too small for frame.
+  EXPECT_EQ(img.frame(0)->rawABGRFrameBytes(raw.get(), size - 1), 0);
+}
+
 }  // namespace wsiToDicomConverter
@@ -0,0 +1,84 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <gtest/gtest.h>
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+#include "src/dcmOutputDirectFileStream.h"
+#include "src/dcmFileDraft.h"
+#include "tests/test_frame.h"
+
+namespace wsiToDicomConverter {
+
+TEST(dcmOutputDirectFileStream, writeUnalignedSize) {
+  const char *fileName = "./directIOWriteUnalignedSize.bin";
+  // Larger than one write chunk and not a multiple of the I/O alignment.
+  std::vector<uint8_t> data(9 * 1024 * 1024 + 123);
+  for (size_t idx = 0; idx < data.size(); ++idx) {
+    data[idx] = static_cast<uint8_t>(idx * 7);
+  }
+  {
+    DcmDirectFileConsumer consumer(fileName, data.size(), true, true);
+    ASSERT_TRUE(consumer.good());
+    size_t offset = 0;
+    while (offset < data.size()) {
+      const size_t size = std::min<size_t>(100000, data.size() - offset);
+      EXPECT_EQ(consumer.write(&data[offset], size), size);
+      offset += size;
+    }
+    EXPECT_TRUE(consumer.close().good());
+    EXPECT_TRUE(consumer.good());
+  }
+  ASSERT_EQ(boost::filesystem::file_size(fileName), data.size());
+  std::ifstream file(fileName, std::ios::binary);
+  std::vector<uint8_t> readBack((std::istreambuf_iterator<char>(file)),
+                                std::istreambuf_iterator<char>());
+  EXPECT_TRUE(readBack == data);
+}
+
+TEST(dcmOutputDirectFileStream, dropPageCacheWritesBuffered) {
+  const char *fileName = "./dropPageCacheBuffered.bin";
+  std::vector<uint8_t> data(4096 + 17, 42);
+  {
+    DcmDirectFileConsumer consumer(fileName, data.size(), false, true);
+    ASSERT_TRUE(consumer.good());
+    EXPECT_FALSE(consumer.isDirectIO());
+    EXPECT_EQ(consumer.write(data.data(), data.size()), data.size());
+    EXPECT_TRUE(consumer.close().good());
+  }
+  ASSERT_EQ(boost::filesystem::file_size(fileName), data.size());
+  boost::filesystem::remove(fileName);
+}
+
+TEST(dcmOutputDirectFileStream, fileDraftSave) {
+  std::vector<std::unique_ptr<Frame>> framesData;
+  for (int idx = 0; idx < 100; ++idx) {
+    framesData.push_back(std::make_unique<TestFrame>(50, 50, 1));
+  }
+  DcmFileDraft draft(std::move(framesData), "./", 5000, 5000, 0, "study",
+                     "series", "image", JPEG2000, true, nullptr, 0.0, 0.0, 8,
+                     NULL, "FileGeneration direct I/O", true);
+  draft.setOutputFileWriteMode(true, true);
+  ASSERT_TRUE(draft.saveFile());
+  ASSERT_TRUE(boost::filesystem::exists("./downsample-8-frames-0-100.dcm"));
+  EXPECT_GT(boost::filesystem::file_size("./downsample-8-frames-0-100.dcm"),
+            0);
+}
+
+}  // namespace wsiToDicomConverter
@@ -0,0 +1,61 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "src/dcmRleDecoder.h"
+
+namespace wsiToDicomConverter {
+
+// 4 pixel RGB frame; each segment mixes replicate and literal runs.
+static std::vector<uint8_t> rleFrame() {
+  std::vector<uint8_t> frame(64, 0);
+  frame[0] = 3;
+  const std::vector<std::vector<uint8_t>> segments = {
+    {0xFD, 0x10},                    // R: 0x10 repeated 4 times
+    {0x03, 0x01, 0x02, 0x03, 0x04},  // G: literal 1, 2, 3, 4
+    {0xFF, 0x20, 0x01, 0x30, 0x40},  // B: 0x20 twice, literal 0x30, 0x40
+  };
+  for (size_t segment = 0; segment < segments.size(); ++segment) {
+    frame[4 * (segment + 1)] = static_cast<uint8_t>(frame.size());
+    frame.insert(frame.end(), segments[segment].begin(),
+                 segments[segment].end());
+  }
+  return frame;
+}
+
+TEST(dcmRleDecoder, decodeRGBToABGR) {
+  std::vector<uint8_t> frame = rleFrame();
+  std::vector<uint8_t> abgr(16);
+  ASSERT_TRUE(DcmRleDecoder::decodeRGBToABGR(frame.data(), frame.size(), 4,
+                                             abgr.data()));
+  const std::vector<uint8_t> expected = {0x10, 0x01, 0x20, 0xff,
+                                         0x10, 0x02, 0x20, 0xff,
+                                         0x10, 0x03, 0x30, 0xff,
+                                         0x10, 0x04, 0x40, 0xff};
+  EXPECT_EQ(abgr, expected);
+}
+
+TEST(dcmRleDecoder, truncatedFrame) {
+  std::vector<uint8_t> frame = rleFrame();
+  std::vector<uint8_t> abgr(16);
+  EXPECT_FALSE(DcmRleDecoder::decodeRGBToABGR(frame.data(), frame.size() - 1,
+                                              4, abgr.data()));
+  EXPECT_FALSE(DcmRleDecoder::decodeRGBToABGR(frame.data(), 32, 4,
+                                              abgr.data()));
+}
+
+}  // namespace wsiToDicomConverter
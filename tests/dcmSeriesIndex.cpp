@@ -0,0 +1,101 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <boost/filesystem.hpp>
+#include <dcmtk/dcmdata/dcdeftag.h>
+#include <dcmtk/dcmdata/dcfilefo.h>
+
+#include <string>
+#include <vector>
+
+#include "src/dcmSeriesIndex.h"
+
+namespace wsiToDicomConverter {
+
+namespace {
+
+std::string makeSeriesDirectory(const std::vector<std::string> &files) {
+  const boost::filesystem::path dir = boost::filesystem::temp_directory_path()
+      / boost::filesystem::unique_path();
+  boost::filesystem::create_directories(dir);
+  for (const std::string &file : files) {
+    boost::filesystem::copy_file(file,
+        dir / boost::filesystem::path(file).filename());
+  }
+  return dir.string();
+}
+
+}  // namespace
+
+TEST(dcmSeriesIndex, indexSingleInstanceLevel) {
+  const std::string dir = makeSeriesDirectory({"../tests/jpeg.dicom",
+                                               "../tests/bone.jpeg"});
+  DcmSeriesIndex index(dir);
+  ASSERT_TRUE(index.isValid());
+  EXPECT_EQ(index.seriesInstanceUID(),
+    "1.2.276.0.7230010.3.1.3.296485632.4444.1646683084.97878");
+  ASSERT_EQ(index.levelCount(), 1);
+  const DcmSeriesLevel &level = index.level(0);
+  EXPECT_EQ(level.imageWidth, 957);
+  EXPECT_EQ(level.imageHeight, 715);
+  EXPECT_EQ(level.frameWidth, 256);
+  EXPECT_EQ(level.frameHeight, 256);
+  EXPECT_EQ(level.frameCount, 12);
+  EXPECT_EQ(level.transferSyntaxUID, "1.2.840.10008.1.2.4.50");
+  EXPECT_EQ(level.dimensionOrganizationType, "TILED_FULL");
+  ASSERT_EQ(level.files.size(), 1);
+  EXPECT_EQ(index.closestLevel(478, 357), 0);
+  EXPECT_EQ(index.closestLevel(957, 715), 0);
+  EXPECT_EQ(index.closestLevel(958, 715), -1);
+  EXPECT_EQ(index.loadLevel(0).size(), 1);
+  boost::filesystem::remove_all(dir);
+}
+
+TEST(dcmSeriesIndex, copyInstanceSetsInstanceNumber) {
+  const std::string dir = makeSeriesDirectory({});
+  const std::string copy = dir + "/copy.dcm";
+  ASSERT_TRUE(DcmSeriesIndex::copyInstance("../tests/jpeg.dicom", copy, 7));
+  DcmFileFormat dcmFile;
+  ASSERT_TRUE(dcmFile.loadFile(copy.c_str()).good());
+  Sint32 instanceNumber = 0;
+  ASSERT_TRUE(dcmFile.getDataset()->findAndGetSint32(DCM_InstanceNumber,
+                                                     instanceNumber).good());
+  EXPECT_EQ(instanceNumber, 7);
+  // Copy is indexed as the same level as its source.
+  DcmSeriesIndex index(dir);
+  ASSERT_TRUE(index.isValid());
+  ASSERT_EQ(index.levelCount(), 1);
+  EXPECT_EQ(index.level(0).frameCount, 12);
+  EXPECT_EQ(index.level(0).transferSyntaxUID, "1.2.840.10008.1.2.4.50");
+  boost::filesystem::remove_all(dir);
+}
+
+TEST(dcmSeriesIndex, rejectMultipleSeries) {
+  const std::string dir = makeSeriesDirectory({"../tests/jpeg.dicom",
+                                               "../tests/jpeg2000.dicom"});
+  DcmSeriesIndex index(dir);
+  EXPECT_FALSE(index.isValid());
+  boost::filesystem::remove_all(dir);
+}
+
+TEST(dcmSeriesIndex, rejectDirectoryWithoutDicom) {
+  const std::string dir = makeSeriesDirectory({"../tests/bone.jpeg"});
+  DcmSeriesIndex index(dir);
+  EXPECT_FALSE(index.isValid());
+  EXPECT_EQ(index.levelCount(), 0);
+  boost::filesystem::remove_all(dir);
+}
+
+}  // namespace wsiToDicomConverter
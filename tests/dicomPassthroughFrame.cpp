@@ -0,0 +1,59 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <memory>
+
+#include "src/dcmFilePyramidSource.h"
+#include "src/dicomPassthroughFrame.h"
+
+namespace wsiToDicomConverter {
+
+TEST(dicomPassthroughFrame, copiesJpegWithoutDecoding) {
+  DcmFilePyramidSource img("../tests/jpeg.dicom");
+  const JpegDicomFileFrame *sourceFrame =
+                              dynamic_cast<JpegDicomFileFrame *>(img.frame(0));
+  ASSERT_TRUE(sourceFrame != nullptr);
+  DicomPassthroughFrame frame(0, 0, sourceFrame, true);
+  frame.sliceFrame();
+  EXPECT_TRUE(frame.isDone());
+  EXPECT_EQ(frame.dicomFrameBytesSize(), sourceFrame->dicomFrameBytesSize());
+  EXPECT_EQ(frame.photoMetrInt(), "YBR_FULL_422");
+  EXPECT_TRUE(frame.hasDcmPixelItem());
+  ASSERT_TRUE(frame.hasRawABGRFrameBytes());
+
+  const int64_t size = 256 * 256 * 4;
+  std::unique_ptr<uint8_t[]> expected = std::make_unique<uint8_t[]>(size);
+  std::unique_ptr<uint8_t[]> decoded = std::make_unique<uint8_t[]>(size);
+  ASSERT_EQ(img.frame(0)->rawABGRFrameBytes(expected.get(), size), size);
+  frame.incReadCounter();
+  ASSERT_EQ(frame.rawABGRFrameBytes(decoded.get(), size), size);
+  EXPECT_EQ(std::memcmp(expected.get(), decoded.get(), size), 0);
+}
+
+TEST(dicomPassthroughFrame, releasesJpegIfNotStored) {
+  DcmFilePyramidSource img("../tests/jpeg.dicom");
+  const JpegDicomFileFrame *sourceFrame =
+                              dynamic_cast<JpegDicomFileFrame *>(img.frame(1));
+  ASSERT_TRUE(sourceFrame != nullptr);
+  DicomPassthroughFrame frame(256, 0, sourceFrame, false);
+  frame.sliceFrame();
+  EXPECT_EQ(frame.dicomFrameBytesSize(), sourceFrame->dicomFrameBytesSize());
+  EXPECT_TRUE(frame.hasDcmPixelItem());
+  EXPECT_FALSE(frame.hasRawABGRFrameBytes());
+}
+
+}  // namespace wsiToDicomConverter
@@ -165,4 +165,53 @@ TEST(DICOMFileRegionReader, read_multi_files) {
   }
 }
 
+TEST(DICOMFileRegionReader, downsampleRegionYCbCr) {
+  std::vector<std::unique_ptr<Frame>> framesData;
+  for (int index = 1; index <= 4; ++index) {
+    framesData.push_back(std::move(std::make_unique<TestFrame>(2, 2, index)));
+  }
+  std::vector<std::unique_ptr<AbstractDcmFile>> dcm_file_vec;
+  std::unique_ptr<DcmFileDraft> dcm_file = std::make_unique<DcmFileDraft>(
+      std::move(framesData), "./", 4, 4, 0, "study", "series", "image",
+      JPEG, true, nullptr, 0.0, 0.0, 5, &dcm_file_vec,
+      "DICOMFileRegionReader downsampleRegionYCbCr", true);
+  dcm_file_vec.push_back(std::move(dcm_file));
+
+  DICOMFileFrameRegionReader region_reader;
+  YCbCrImage image(2, 2, 2, 2);
+  EXPECT_FALSE(region_reader.downsampleRegionYCbCr(0, 0, 4, 4, &image));
+  region_reader.setDicomFiles(std::move(dcm_file_vec), nullptr);
+  ASSERT_TRUE(region_reader.downsampleRegionYCbCr(0, 0, 4, 4, &image));
+  uint8_t test_luma[4] = {1, 2, 3, 4};
+  for (size_t idx = 0; idx < 4; ++idx) {
+    EXPECT_EQ(test_luma[idx], image.plane(0)[idx]);
+  }
+  // Single chroma sample taken from center of region.
+  EXPECT_EQ(image.plane(1)[0], 132);
+  EXPECT_EQ(image.plane(2)[0], 124);
+}
+
+TEST(DICOMFileRegionReader, downsampleRegionYCbCrBeyondImage) {
+  std::vector<std::unique_ptr<Frame>> framesData;
+  framesData.push_back(std::move(std::make_unique<TestFrame>(2, 2, 7)));
+  std::vector<std::unique_ptr<AbstractDcmFile>> dcm_file_vec;
+  std::unique_ptr<DcmFileDraft> dcm_file = std::make_unique<DcmFileDraft>(
+      std::move(framesData), "./", 2, 2, 0, "study", "series", "image",
+      JPEG, true, nullptr, 0.0, 0.0, 5, &dcm_file_vec,
+      "DICOMFileRegionReader downsampleRegionYCbCrBeyondImage", true);
+  dcm_file_vec.push_back(std::move(dcm_file));
+
+  DICOMFileFrameRegionReader region_reader;
+  region_reader.setDicomFiles(std::move(dcm_file_vec), nullptr);
+  YCbCrImage image(4, 4, 1, 1);
+  ASSERT_TRUE(region_reader.downsampleRegionYCbCr(0, 0, 4, 4, &image));
+  for (int64_t y = 0; y < 4; ++y) {
+    for (int64_t x = 0; x < 4; ++x) {
+      const bool inImage = x < 2 && y < 2;
+      EXPECT_EQ(image.plane(0)[y * 4 + x], inImage ? 7 : 0);
+      EXPECT_EQ(image.plane(1)[y * 4 + x], inImage ? 135 : 128);
+    }
+  }
+}
+
 }  // namespace wsiToDicomConverter
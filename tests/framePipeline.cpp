@@ -0,0 +1,91 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "src/framePipeline.h"
+#include "tests/test_frame.h"
+
+namespace wsiToDicomConverter {
+
+namespace {
+
+// Counts frames read ahead of slicing.
+class PipelineTestFrame : public TestFrame {
+ public:
+  PipelineTestFrame(std::atomic<int> *readAhead, std::atomic<int> *maxReadAhead)
+      : TestFrame(1, 1), readAhead_(readAhead), maxReadAhead_(maxReadAhead) {
+    done_ = false;
+  }
+
+  virtual void readFrameSource() {
+    read_ = true;
+    const int readAhead = ++(*readAhead_);
+    int maxReadAhead = maxReadAhead_->load();
+    while (readAhead > maxReadAhead &&
+           !maxReadAhead_->compare_exchange_weak(maxReadAhead, readAhead)) {
+    }
+  }
+
+  virtual void sliceFrame() {
+    slicedAfterRead_ = read_;
+    --(*readAhead_);
+    setDone();
+  }
+
+  bool slicedAfterRead() const { return slicedAfterRead_; }
+
+ private:
+  std::atomic<int> *readAhead_;
+  std::atomic<int> *maxReadAhead_;
+  bool read_ = false;
+  bool slicedAfterRead_ = false;
+};
+
+}  // namespace
+
+TEST(FramePipeline, readsBeforeSlicing) {
+  std::atomic<int> readAhead(0);
+  std::atomic<int> maxReadAhead(0);
+  std::vector<std::unique_ptr<PipelineTestFrame>> frames;
+  std::atomic<int> writes(0);
+  {
+    FramePipeline pipeline(4, 2, 1, 3);
+    for (int idx = 0; idx < 64; ++idx) {
+      frames.push_back(std::make_unique<PipelineTestFrame>(&readAhead,
+                                                           &maxReadAhead));
+      pipeline.addFrame(frames.back().get());
+    }
+    pipeline.addWrite([&writes]() { writes += 1; });
+    pipeline.join();
+    EXPECT_EQ(64, pipeline.readStats().tasks);
+    EXPECT_EQ(64, pipeline.sliceStats().tasks);
+    EXPECT_EQ(1, pipeline.writeStats().tasks);
+    EXPECT_LE(pipeline.sliceStats().maxQueueDepth, 3);
+  }
+  EXPECT_EQ(1, writes.load());
+  EXPECT_EQ(0, readAhead.load());
+  // Frames read ahead of slicing are bounded by queue depth.
+  EXPECT_LE(maxReadAhead.load(), 3);
+  for (const std::unique_ptr<PipelineTestFrame> &frame : frames) {
+    EXPECT_TRUE(frame->isDone());
+    EXPECT_TRUE(frame->slicedAfterRead());
+  }
+}
+
+}  // namespace wsiToDicomConverter
@@ -14,6 +14,10 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
 #include "src/geometryUtils.h"
 
 TEST(geometryTest, frameSizeWithoutRetile) {
@@ -89,3 +93,38 @@ TEST(geometryTest, frameSizeWithRetile) {
   EXPECT_EQ(50, level_frameWidth);
   EXPECT_EQ(42, level_frameHeight);
 }
+
+TEST(geometryTest, rasterFrameOrder) {
+  std::vector<int64_t> order = wsiToDicomConverter::frameDispatchOrder(
+      3, 2, RASTER_ORDER);
+  EXPECT_EQ(std::vector<int64_t>({0, 1, 2, 3, 4, 5}), order);
+}
+
+TEST(geometryTest, mortonFrameOrder) {
+  // 3 x 3 frames; raster index = row * 3 + column.
+  std::vector<int64_t> order = wsiToDicomConverter::frameDispatchOrder(
+      3, 3, MORTON_ORDER);
+  EXPECT_EQ(std::vector<int64_t>({0, 1, 3, 4, 2, 5, 6, 7, 8}), order);
+}
+
+TEST(geometryTest, hilbertFrameOrderVisitsNeighbors) {
+  const int64_t framesPerRow = 5;
+  std::vector<int64_t> order = wsiToDicomConverter::frameDispatchOrder(
+      framesPerRow, 4, HILBERT_ORDER);
+  ASSERT_EQ(20u, order.size());
+  EXPECT_EQ(0, order[0]);
+  std::vector<int64_t> sorted = order;
+  std::sort(sorted.begin(), sorted.end());
+  for (int64_t idx = 0; idx < 20; ++idx) {
+    EXPECT_EQ(idx, sorted[idx]);
+  }
+  // Within the 4 x 4 grid covered by the curve consecutive frames are
+  // adjacent.
+  for (size_t idx = 1; idx < 16; ++idx) {
+    const int64_t dx = std::abs(order[idx] % framesPerRow -
+                                order[idx - 1] % framesPerRow);
+    const int64_t dy = std::abs(order[idx] / framesPerRow -
+                                order[idx - 1] / framesPerRow);
+    EXPECT_EQ(1, dx + dy);
+  }
+}
@@ -12,7 +12,10 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 #include <gtest/gtest.h>
+#include <boost/filesystem.hpp>
+#include <opencv2/opencv.hpp>
 #include <string>
+#include <vector>
 #include "src/imageFilePyramidSource.h"
 
 namespace wsiToDicomConverter {
@@ -35,4 +38,58 @@ TEST(imageFilePyramidSource, readJpeg) {
   }
 }
 
+TEST(imageFilePyramidSource, streamFramesInBands) {
+  cv::Mat image(150, 200, CV_8UC3);
+  for (int y = 0; y < image.rows; ++y) {
+    for (int x = 0; x < image.cols; ++x) {
+      image.at<cv::Vec3b>(y, x) = cv::Vec3b(x, y, x + y);
+    }
+  }
+  const std::string path = (boost::filesystem::temp_directory_path() /
+                            boost::filesystem::unique_path()).string() +
+                           ".png";
+  cv::imwrite(path, image);
+  ImageFilePyramidSource img(path, 64, 64, 1.0);
+  ASSERT_TRUE(img.isStreamed());
+  EXPECT_EQ(img.imageWidth(), 200);
+  EXPECT_EQ(img.imageHeight(), 150);
+  ASSERT_EQ(img.fileFrameCount(), 12);
+  for (size_t idx = 0; idx < img.fileFrameCount(); ++idx) {
+    img.frame(idx)->incReadCounter();
+  }
+  std::vector<uint8_t> frame(64 * 64 * 4);
+  const int64_t frameSize = frame.size();
+  for (size_t idx = 0; idx < img.fileFrameCount(); ++idx) {
+    ImageFileFrame *imageFrame = img.frame(idx);
+    EXPECT_EQ(imageFrame->locationX(), (idx % 4) * 64);
+    EXPECT_EQ(imageFrame->locationY(), (idx / 4) * 64);
+    ASSERT_EQ(imageFrame->rawABGRFrameBytes(frame.data(), frameSize),
+              frameSize);
+    for (int y = 0; y < 64; ++y) {
+      for (int x = 0; x < 64; ++x) {
+        const int imageX = imageFrame->locationX() + x;
+        const int imageY = imageFrame->locationY() + y;
+        const uint8_t *pixel = frame.data() + (y * 64 + x) * 4;
+        cv::Vec3b bgr(0, 0, 0);
+        if (imageX < image.cols && imageY < image.rows) {
+          bgr = image.at<cv::Vec3b>(imageY, imageX);
+        }
+        ASSERT_EQ(pixel[0], bgr[2]);
+        ASSERT_EQ(pixel[1], bgr[1]);
+        ASSERT_EQ(pixel[2], bgr[0]);
+        ASSERT_EQ(pixel[3], 0xFF);
+      }
+    }
+    // Band is released once each frame in it has been read.
+    EXPECT_EQ(img.decodedBandCount(), idx % 4 == 3 ? 0 : 1);
+  }
+  // Released band is decoded again if read again.
+  ASSERT_EQ(img.frame(5)->rawABGRFrameBytes(frame.data(), frameSize),
+            frameSize);
+  EXPECT_EQ(frame[0], 128);
+  EXPECT_EQ(frame[1], 64);
+  EXPECT_EQ(frame[2], 64);
+  boost::filesystem::remove(path);
+}
+
 }  // namespace wsiToDicomConverter
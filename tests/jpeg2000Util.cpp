@@ -0,0 +1,106 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+#include "src/jpeg2000Compression.h"
+#include "src/jpeg2000Util.h"
+
+namespace wsiToDicomConverter {
+
+// Encodes gradient test image as lossless JPEG 2000 codestream.
+std::unique_ptr<uint8_t[]> encodeTestJpeg2000(int width, int height,
+                                              std::vector<uint8_t> *rgb,
+                                              size_t *size) {
+  rgb->resize(width * height * 3);
+  for (int y = 0; y < height; ++y) {
+    for (int x = 0; x < width; ++x) {
+      uint8_t *pixel = &(*rgb)[(y * width + x) * 3];
+      pixel[0] = (x * 4) & 0xFF;
+      pixel[1] = (y * 4) & 0xFF;
+      pixel[2] = ((x + y) * 2) & 0xFF;
+    }
+  }
+  Jpeg2000Compression compression;
+  return compression.writeToMemory(width, height, rgb->data(), size);
+}
+
+TEST(jpeg2000Util, decodeLosslessJpeg2000) {
+  std::vector<uint8_t> rgb;
+  size_t size;
+  std::unique_ptr<uint8_t[]> j2k = encodeTestJpeg2000(64, 64, &rgb, &size);
+  std::vector<uint8_t> decoded(64 * 64 * 4);
+  ASSERT_TRUE(jpeg2000Util::decodeJpeg2000(64, 64, false, 0, j2k.get(), size,
+                                           decoded.data(), decoded.size()));
+  for (int idx = 0; idx < 64 * 64; ++idx) {
+    ASSERT_EQ(decoded[idx * 4], rgb[idx * 3]);
+    ASSERT_EQ(decoded[idx * 4 + 1], rgb[idx * 3 + 1]);
+    ASSERT_EQ(decoded[idx * 4 + 2], rgb[idx * 3 + 2]);
+    ASSERT_EQ(decoded[idx * 4 + 3], 0xFF);
+  }
+}
+
+TEST(jpeg2000Util, decodeReducedResolution) {
+  std::vector<uint8_t> rgb;
+  size_t size;
+  std::unique_ptr<uint8_t[]> j2k = encodeTestJpeg2000(64, 64, &rgb, &size);
+  std::vector<uint8_t> decoded(32 * 32 * 4);
+  ASSERT_TRUE(jpeg2000Util::decodeJpeg2000(32, 32, false, 1, j2k.get(), size,
+                                           decoded.data(), decoded.size()));
+  // Reduced image is low pass of gradient; compare to 2x2 pixel average.
+  for (int y = 0; y < 31; ++y) {
+    for (int x = 0; x < 31; ++x) {
+      const int expected = (rgb[((2 * y) * 64 + 2 * x) * 3 + 1] +
+                            rgb[((2 * y + 1) * 64 + 2 * x) * 3 + 1]) / 2;
+      EXPECT_NEAR(decoded[(y * 32 + x) * 4 + 1], expected, 4);
+    }
+  }
+}
+
+TEST(jpeg2000Util, rejectsUnexpectedDimensions) {
+  std::vector<uint8_t> rgb;
+  size_t size;
+  std::unique_ptr<uint8_t[]> j2k = encodeTestJpeg2000(64, 64, &rgb, &size);
+  std::vector<uint8_t> decoded(64 * 64 * 4);
+  EXPECT_FALSE(jpeg2000Util::decodeJpeg2000(32, 32, false, 0, j2k.get(), size,
+                                            decoded.data(), decoded.size()));
+  EXPECT_FALSE(jpeg2000Util::decodeJpeg2000(64, 64, false, 0, j2k.get(), size,
+                                            decoded.data(), 64));
+}
+
+TEST(jpeg2000Util, rejectsInvalidJpeg2000) {
+  std::vector<uint8_t> invalid(256, 0x55);
+  std::vector<uint8_t> decoded(16 * 16 * 4);
+  EXPECT_FALSE(jpeg2000Util::decodeJpeg2000(16, 16, false, 0, invalid.data(),
+                                            invalid.size(), decoded.data(),
+                                            decoded.size()));
+}
+
+TEST(jpeg2000Util, decodeThreads) {
+  jpeg2000Util::setDecodeThreads(0);
+  EXPECT_EQ(jpeg2000Util::decodeThreads(), 1);
+  jpeg2000Util::setDecodeThreads(4);
+  EXPECT_EQ(jpeg2000Util::decodeThreads(), 4);
+  std::vector<uint8_t> rgb;
+  size_t size;
+  std::unique_ptr<uint8_t[]> j2k = encodeTestJpeg2000(64, 64, &rgb, &size);
+  std::vector<uint8_t> decoded(64 * 64 * 4);
+  EXPECT_TRUE(jpeg2000Util::decodeJpeg2000(64, 64, false, 0, j2k.get(), size,
+                                           decoded.data(), decoded.size()));
+  jpeg2000Util::setDecodeThreads(1);
+}
+
+}  // namespace wsiToDicomConverter
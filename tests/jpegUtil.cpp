@@ -14,9 +14,12 @@
 #include <gtest/gtest.h>
 #include <jpeglib.h>
 
+#include <cstdlib>
 #include <memory>
 #include <utility>
+#include <vector>
 
+#include "src/jpegCompression.h"
 #include "src/jpegUtil.h"
 #include "src/tiffDirectory.h"
 #include "src/tiffFile.h"
@@ -24,6 +27,44 @@
 
 namespace wsiToDicomConverter {
 
+// Encodes gradient test image as jpeg.
+std::vector<uint8_t> encodeTestJpeg(int width, int height, int quality,
+                                    bool subsample420, int seed) {
+  struct jpeg_compress_struct cinfo;
+  struct jpeg_error_mgr jerr;
+  cinfo.err = jpeg_std_error(&jerr);
+  jpeg_create_compress(&cinfo);
+  unsigned char *buffer = nullptr;
+  unsigned long bufferSize = 0;  // NOLINT
+  jpeg_mem_dest(&cinfo, &buffer, &bufferSize);
+  cinfo.image_width = width;
+  cinfo.image_height = height;
+  cinfo.input_components = 3;
+  cinfo.in_color_space = JCS_RGB;
+  jpeg_set_defaults(&cinfo);
+  jpeg_set_quality(&cinfo, quality, TRUE);
+  if (!subsample420) {
+    cinfo.comp_info[0].h_samp_factor = 1;
+    cinfo.comp_info[0].v_samp_factor = 1;
+  }
+  jpeg_start_compress(&cinfo, TRUE);
+  std::vector<uint8_t> row(width * 3);
+  while (cinfo.next_scanline < cinfo.image_height) {
+    for (int x = 0; x < width; ++x) {
+      row[x * 3] = (x * 7 + seed * 50) & 0xFF;
+      row[x * 3 + 1] = (cinfo.next_scanline * 5 + seed * 30) & 0xFF;
+      row[x * 3 + 2] = ((x + cinfo.next_scanline) * 3 + seed * 90) & 0xFF;
+    }
+    JSAMPROW rowPtr = row.data();
+    jpeg_write_scanlines(&cinfo, &rowPtr, 1);
+  }
+  jpeg_finish_compress(&cinfo);
+  jpeg_destroy_compress(&cinfo);
+  std::vector<uint8_t> jpeg(buffer, buffer + bufferSize);
+  free(buffer);
+  return jpeg;
+}
+
 TEST(jpegUtil, canDecodeJpegValidJpeg) {
   FILE *file = fopen("../tests/bone.jpeg", "rb");
   fseek(file , 0 , SEEK_END);
@@ -90,4 +131,183 @@ TEST(jpegUtil, decodeJpegValidJpeg) {
   EXPECT_EQ(returnMemoryBuffer[4*957*715 + 2], 0x0d);
 }
 
+TEST(jpegUtil, jpegMCUSize) {
+  std::vector<uint8_t> jpeg420 = encodeTestJpeg(32, 32, 90, true, 0);
+  std::vector<uint8_t> jpeg444 = encodeTestJpeg(32, 32, 90, false, 0);
+  int64_t mcuWidth, mcuHeight;
+  ASSERT_TRUE(jpegUtil::jpegMCUSize(jpeg420.data(), jpeg420.size(),
+                                    &mcuWidth, &mcuHeight));
+  EXPECT_EQ(mcuWidth, 16);
+  EXPECT_EQ(mcuHeight, 16);
+  ASSERT_TRUE(jpegUtil::jpegMCUSize(jpeg444.data(), jpeg444.size(),
+                                    &mcuWidth, &mcuHeight));
+  EXPECT_EQ(mcuWidth, 8);
+  EXPECT_EQ(mcuHeight, 8);
+}
+
+TEST(jpegUtil, stitchJpegTilesMatchesDecodedTiles) {
+  const int tileWidth = 24;
+  const int tileHeight = 16;
+  std::vector<std::vector<uint8_t>> tileJpegs;
+  std::vector<const uint8_t*> tiles;
+  std::vector<uint64_t> tileSizes;
+  for (int idx = 0; idx < 4; ++idx) {
+    tileJpegs.push_back(encodeTestJpeg(tileWidth, tileHeight, 90, false,
+                                       idx));
+  }
+  for (const std::vector<uint8_t> &jpeg : tileJpegs) {
+    tiles.push_back(jpeg.data());
+    tileSizes.push_back(jpeg.size());
+  }
+  uint64_t size;
+  std::unique_ptr<uint8_t[]> stitched = jpegUtil::stitchJpegTiles(
+      tiles, tileSizes, 2, 2, JCS_YCbCr, &size);
+  ASSERT_NE(stitched, nullptr);
+  const int width = tileWidth * 2;
+  const int height = tileHeight * 2;
+  std::unique_ptr<uint8_t[]> stitchedPixels =
+                              std::make_unique<uint8_t[]>(width * height * 4);
+  ASSERT_TRUE(jpegUtil::decodeJpeg(width, height, JCS_YCbCr, stitched.get(),
+                                   size, stitchedPixels.get(),
+                                   width * height * 4));
+  std::unique_ptr<uint8_t[]> tilePixels =
+                    std::make_unique<uint8_t[]>(tileWidth * tileHeight * 4);
+  for (int idx = 0; idx < 4; ++idx) {
+    ASSERT_TRUE(jpegUtil::decodeJpeg(tileWidth, tileHeight, JCS_YCbCr,
+                                     tiles[idx], tileSizes[idx],
+                                     tilePixels.get(),
+                                     tileWidth * tileHeight * 4));
+    const int offsetX = (idx % 2) * tileWidth;
+    const int offsetY = (idx / 2) * tileHeight;
+    for (int y = 0; y < tileHeight; ++y) {
+      ASSERT_EQ(0, memcmp(&tilePixels[y * tileWidth * 4],
+                          &stitchedPixels[((offsetY + y) * width + offsetX) *
+                                          4], tileWidth * 4));
+    }
+  }
+}
+
+TEST(jpegUtil, stitchJpegTilesFillsMissingTilesWithWhite) {
+  std::vector<uint8_t> jpeg = encodeTestJpeg(16, 16, 90, true, 1);
+  std::vector<const uint8_t*> tiles = {jpeg.data(), nullptr};
+  std::vector<uint64_t> tileSizes = {jpeg.size(), 0};
+  uint64_t size;
+  std::unique_ptr<uint8_t[]> stitched = jpegUtil::stitchJpegTiles(
+      tiles, tileSizes, 2, 1, JCS_YCbCr, &size);
+  ASSERT_NE(stitched, nullptr);
+  std::unique_ptr<uint8_t[]> pixels = std::make_unique<uint8_t[]>(32 * 16 *
+                                                                   4);
+  ASSERT_TRUE(jpegUtil::decodeJpeg(32, 16, JCS_YCbCr, stitched.get(), size,
+                                   pixels.get(), 32 * 16 * 4));
+  for (int y = 0; y < 16; ++y) {
+    // Skip columns next to tile edge; chroma upsampling crosses edge.
+    for (int x = 20; x < 32; ++x) {
+      for (int channel = 0; channel < 3; ++channel) {
+        EXPECT_GE(pixels[(y * 32 + x) * 4 + channel], 250);
+      }
+    }
+  }
+}
+
+TEST(jpegUtil, stitchJpegTilesRejectsDifferentQuantization) {
+  std::vector<uint8_t> jpeg1 = encodeTestJpeg(16, 16, 90, true, 0);
+  std::vector<uint8_t> jpeg2 = encodeTestJpeg(16, 16, 50, true, 0);
+  std::vector<const uint8_t*> tiles = {jpeg1.data(), jpeg2.data()};
+  std::vector<uint64_t> tileSizes = {jpeg1.size(), jpeg2.size()};
+  uint64_t size;
+  EXPECT_EQ(jpegUtil::stitchJpegTiles(tiles, tileSizes, 2, 1, JCS_YCbCr,
+                                      &size), nullptr);
+}
+
+TEST(jpegUtil, stitchJpegTilesRejectsTilesNotMCUAligned) {
+  std::vector<uint8_t> jpeg1 = encodeTestJpeg(20, 16, 90, true, 0);
+  std::vector<uint8_t> jpeg2 = encodeTestJpeg(20, 16, 90, true, 1);
+  std::vector<const uint8_t*> tiles = {jpeg1.data(), jpeg2.data()};
+  std::vector<uint64_t> tileSizes = {jpeg1.size(), jpeg2.size()};
+  uint64_t size;
+  EXPECT_EQ(jpegUtil::stitchJpegTiles(tiles, tileSizes, 2, 1, JCS_YCbCr,
+                                      &size), nullptr);
+}
+
+TEST(jpegUtil, decodeJpegToYCbCrMatchesDecodeJpeg) {
+  std::vector<uint8_t> jpeg = encodeTestJpeg(24, 16, 90, false, 2);
+  YCbCrImage image;
+  ASSERT_TRUE(jpegUtil::decodeJpegToYCbCr(JCS_YCbCr, jpeg.data(), jpeg.size(),
+                                          &image));
+  EXPECT_EQ(image.width(), 24);
+  EXPECT_EQ(image.height(), 16);
+  EXPECT_EQ(image.chromaSubsampleX(), 1);
+  EXPECT_EQ(image.chromaSubsampleY(), 1);
+  std::unique_ptr<uint8_t[]> decoded = std::make_unique<uint8_t[]>(24 * 16 *
+                                                                    4);
+  ASSERT_TRUE(jpegUtil::decodeJpeg(24, 16, JCS_YCbCr, jpeg.data(),
+                                   jpeg.size(), decoded.get(), 24 * 16 * 4));
+  std::unique_ptr<uint8_t[]> converted = std::make_unique<uint8_t[]>(24 * 16 *
+                                                                      4);
+  image.toABGR(converted.get());
+  for (int idx = 0; idx < 24 * 16 * 4; ++idx) {
+    ASSERT_NEAR(decoded[idx], converted[idx], 1);
+  }
+}
+
+TEST(jpegUtil, decodeJpegToYCbCrSubsampledChroma) {
+  // Image dimensions are not a multiple of the MCU size.
+  std::vector<uint8_t> jpeg = encodeTestJpeg(21, 37, 90, true, 3);
+  YCbCrImage image;
+  ASSERT_TRUE(jpegUtil::decodeJpegToYCbCr(JCS_YCbCr, jpeg.data(), jpeg.size(),
+                                          &image));
+  EXPECT_EQ(image.width(), 21);
+  EXPECT_EQ(image.height(), 37);
+  EXPECT_EQ(image.chromaSubsampleX(), 2);
+  EXPECT_EQ(image.chromaSubsampleY(), 2);
+  EXPECT_EQ(image.planeWidth(1), 11);
+  EXPECT_EQ(image.planeHeight(1), 19);
+  std::unique_ptr<uint8_t[]> decoded = std::make_unique<uint8_t[]>(21 * 37 *
+                                                                    4);
+  ASSERT_TRUE(jpegUtil::decodeJpeg(21, 37, JCS_YCbCr, jpeg.data(),
+                                   jpeg.size(), decoded.get(), 21 * 37 * 4));
+  std::unique_ptr<uint8_t[]> converted = std::make_unique<uint8_t[]>(21 * 37 *
+                                                                      4);
+  image.toABGR(converted.get());
+  // Chroma is replicated rather than interpolated; compare mean error.
+  int64_t error = 0;
+  for (int idx = 0; idx < 21 * 37 * 4; ++idx) {
+    error += std::abs(decoded[idx] - converted[idx]);
+  }
+  EXPECT_LT(error / (21 * 37 * 4), 4);
+}
+
+TEST(jpegUtil, decodeJpegToYCbCrRejectsRGB) {
+  std::vector<uint8_t> jpeg = encodeTestJpeg(16, 16, 90, false, 0);
+  YCbCrImage image;
+  EXPECT_FALSE(jpegUtil::decodeJpegToYCbCr(JCS_RGB, jpeg.data(), jpeg.size(),
+                                           &image));
+}
+
+TEST(jpegUtil, compressYCbCrRoundTrip) {
+  YCbCrImage image(30, 20, 2, 2);
+  for (int plane = 0; plane < 3; ++plane) {
+    for (int64_t y = 0; y < image.planeHeight(plane); ++y) {
+      for (int64_t x = 0; x < image.planeWidth(plane); ++x) {
+        image.plane(plane)[y * image.planeWidth(plane) + x] =
+                                            64 + plane * 20 + x * 2 + y;
+      }
+    }
+  }
+  JpegCompression compression(95, subsample_420);
+  size_t size;
+  std::unique_ptr<uint8_t[]> jpeg = compression.compressYCbCr(image, &size);
+  ASSERT_NE(jpeg, nullptr);
+  YCbCrImage decoded;
+  ASSERT_TRUE(jpegUtil::decodeJpegToYCbCr(JCS_YCbCr, jpeg.get(), size,
+                                          &decoded));
+  ASSERT_EQ(decoded.width(), 30);
+  ASSERT_EQ(decoded.height(), 20);
+  ASSERT_EQ(decoded.chromaSubsampleX(), 2);
+  ASSERT_EQ(decoded.chromaSubsampleY(), 2);
+  for (int64_t idx = 0; idx < image.byteSize(); ++idx) {
+    ASSERT_NEAR(image.data()[idx], decoded.data()[idx], 3);
+  }
+}
+
 }  // namespace wsiToDicomConverter
@@ -0,0 +1,73 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "src/memoryGovernor.h"
+
+namespace wsiToDicomConverter {
+
+TEST(MemoryGovernor, reserveWorkBlocksUntilReleased) {
+  MemoryGovernor governor(100);
+  governor.reserveWork(60);
+  std::atomic<bool> reserved(false);
+  std::thread worker([&governor, &reserved]() {
+    governor.reserveWork(60);
+    reserved = true;
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_FALSE(reserved.load());
+  governor.releaseWork(60);
+  worker.join();
+  EXPECT_TRUE(reserved.load());
+  EXPECT_EQ(60, governor.reservedBytes());
+  EXPECT_EQ(1, governor.throttledReservations());
+  governor.releaseWork(60);
+  EXPECT_EQ(0, governor.reservedBytes());
+}
+
+TEST(MemoryGovernor, admitsWorkWhenOnlyHeldMemoryExceedsBudget) {
+  MemoryGovernor governor(100);
+  governor.hold(150);
+  // No work outstanding to release memory; work must still progress.
+  governor.reserveWork(10);
+  EXPECT_EQ(160, governor.reservedBytes());
+  EXPECT_EQ(160, governor.peakReservedBytes());
+  EXPECT_EQ(0, governor.throttledReservations());
+  governor.releaseWork(10);
+  governor.releaseHeld(150);
+  EXPECT_EQ(0, governor.reservedBytes());
+  EXPECT_EQ(160, governor.peakReservedBytes());
+}
+
+TEST(MemoryGovernor, heldMemoryDoesNotSerializeWork) {
+  MemoryGovernor governor(100);
+  governor.hold(150);
+  governor.reserveWork(40);
+  // Second reservation fits the budget with first; held memory is not
+  // counted against admission.
+  governor.reserveWork(40);
+  EXPECT_EQ(230, governor.reservedBytes());
+  EXPECT_EQ(0, governor.throttledReservations());
+  governor.releaseWork(40);
+  governor.releaseWork(40);
+  governor.releaseHeld(150);
+  EXPECT_EQ(0, governor.reservedBytes());
+}
+
+}  // namespace wsiToDicomConverter
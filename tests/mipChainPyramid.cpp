@@ -0,0 +1,101 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "src/memoryGovernor.h"
+#include "src/mipChainPyramid.h"
+#include "src/openslideUtil.h"
+#include "tests/testUtils.h"
+
+namespace wsiToDicomConverter {
+
+TEST(MipChainPyramid, framesSampleLevel0) {
+  OpenSlidePool pool(tiffFileName, 2, 0);
+  // Level 0 of test slide is 2220 x 2967. Small blocks force frames to
+  // straddle blocks.
+  MipChainPyramid pyramid(&pool, 0, 0, 2220, 2967, 500, 80, subsample_420);
+  pyramid.addLevel(0, 1, 2220, 2967, 256, 256, JPEG, true);
+  pyramid.addLevel(1, 4, 555, 741, 256, 256, JPEG, true);
+  EXPECT_TRUE(pyramid.hasLevel(1));
+  EXPECT_FALSE(pyramid.hasLevel(2));
+  pyramid.start(2);
+  EXPECT_EQ(500, pyramid.blockSize());
+  std::vector<std::unique_ptr<Frame>> level0 = pyramid.takeLevelFrames(0);
+  std::vector<std::unique_ptr<Frame>> level1 = pyramid.takeLevelFrames(1);
+  pyramid.join();
+  ASSERT_EQ(9u * 12u, level0.size());
+  ASSERT_EQ(3u * 3u, level1.size());
+  for (const auto &frame : level0) {
+    EXPECT_TRUE(frame->isDone());
+  }
+
+  // Center frame of downsampled level straddles blocks.
+  Frame *frame = level1[4].get();
+  ASSERT_TRUE(frame->isDone());
+  EXPECT_EQ(256, frame->locationX());
+  EXPECT_EQ(256, frame->locationY());
+  std::vector<uint32_t> pixels(256 * 256);
+  frame->incReadCounter();
+  EXPECT_EQ(256 * 256 * 4, frame->rawABGRFrameBytes(
+      reinterpret_cast<uint8_t *>(pixels.data()), 256 * 256 * 4));
+  std::vector<uint32_t> region(1024 * 1024);
+  pool.readRegion(region.data(), 1024, 1024, 0, 1024, 1024);
+  for (int64_t y = 0; y < 256; y += 15) {
+    for (int64_t x = 0; x < 256; x += 15) {
+      const int64_t sampleX = ((256 + x) * 2220) / 555 - 1024;
+      const int64_t sampleY = ((256 + y) * 2967) / 741 - 1024;
+      ASSERT_EQ(region[sampleY * 1024 + sampleX], pixels[y * 256 + x]);
+    }
+  }
+}
+
+TEST(MipChainPyramid, blocksReserveMemoryFromGovernor) {
+  OpenSlidePool pool(tiffFileName, 2, 0);
+  // Budget admits two 500 x 500 blocks at a time.
+  MemoryGovernor governor(2 * 500 * 500 * 4);
+  MipChainPyramid pyramid(&pool, 0, 0, 2220, 2967, 500, 80, subsample_420);
+  pyramid.addLevel(1, 4, 555, 741, 256, 256, JPEG, false);
+  pyramid.setMemoryGovernor(&governor);
+  std::atomic<bool> running(true);
+  std::atomic<int64_t> minReservedBytes(0);
+  std::thread monitor([&governor, &running, &minReservedBytes]() {
+    while (running) {
+      const int64_t reservedBytes = governor.reservedBytes();
+      if (reservedBytes < minReservedBytes) {
+        minReservedBytes = reservedBytes;
+      }
+      std::this_thread::yield();
+    }
+  });
+  pyramid.start(4);
+  std::vector<std::unique_ptr<Frame>> level1 = pyramid.takeLevelFrames(1);
+  pyramid.join();
+  running = false;
+  monitor.join();
+  for (const auto &frame : level1) {
+    EXPECT_TRUE(frame->isDone());
+  }
+  EXPECT_EQ(0, minReservedBytes.load());
+  EXPECT_EQ(0, governor.reservedBytes());
+  EXPECT_GT(governor.peakReservedBytes(), 0);
+  EXPECT_LE(governor.peakReservedBytes(), governor.budgetBytes());
+}
+
+}  // namespace wsiToDicomConverter
@@ -26,8 +26,8 @@ namespace wsiToDicomConverter {
 
 TEST(NearestNeighborFrame, jpeg) {
   DICOMFileFrameRegionReader dicom_frame_reader;
-  OpenSlidePtr osptr = OpenSlidePtr(tiffFileName);
-  NearestNeighborFrame frame(&osptr, 0, 0, 0, 100, 100, 1, 100, 100, JPEG, 1,
+  OpenSlidePool osPool(tiffFileName, 1, 0);
+  NearestNeighborFrame frame(&osPool, 0, 0, 0, 100, 100, 1, 100, 100, JPEG, 1,
                              subsample_420, false, &dicom_frame_reader);
   frame.sliceFrame();
   ASSERT_TRUE(frame.isDone());
@@ -37,9 +37,10 @@ TEST(NearestNeighborFrame, jpeg) {
 
 TEST(NearestNeighborFrame, jpeg2000Scaling) {
   DICOMFileFrameRegionReader dicom_frame_reader;
-  OpenSlidePtr osptr = OpenSlidePtr(tiffFileName);
-  NearestNeighborFrame frame(&osptr, 0, 0, 0, 1000, 1000, 1, 100, 100, JPEG2000,
-                             1, subsample_420, true, &dicom_frame_reader);
+  OpenSlidePool osPool(tiffFileName, 1, 0);
+  NearestNeighborFrame frame(&osPool, 0, 0, 0, 1000, 1000, 1, 100, 100,
+                             JPEG2000, 1, subsample_420, true,
+                             &dicom_frame_reader);
   frame.sliceFrame();
   ASSERT_TRUE(frame.isDone());
   EXPECT_TRUE(frame.hasRawABGRFrameBytes());
@@ -49,8 +50,8 @@ TEST(NearestNeighborFrame, jpeg2000Scaling) {
 TEST(NearestNeighborFrame, rawData) {
   // all black except first pixel
   DICOMFileFrameRegionReader dicom_frame_reader;
-  OpenSlidePtr osptr = OpenSlidePtr(tiffFileName);
-  NearestNeighborFrame frame(&osptr, 2219, 2966, 0, 100, 100, 1, 100, 100,
+  OpenSlidePool osPool(tiffFileName, 1, 0);
+  NearestNeighborFrame frame(&osPool, 2219, 2966, 0, 100, 100, 1, 100, 100,
                              RAW, 1, subsample_420, true, &dicom_frame_reader);
   frame.sliceFrame();
   ASSERT_TRUE(frame.isDone());
@@ -0,0 +1,93 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <sched.h>
+#include <boost/filesystem.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "src/numaWorkerPool.h"
+
+namespace wsiToDicomConverter {
+
+TEST(numaWorkerPool, parseCpuList) {
+  std::vector<int32_t> cpus;
+  ASSERT_TRUE(parseCpuList("0-3,8,10-11\n", &cpus));
+  EXPECT_EQ(cpus, std::vector<int32_t>({0, 1, 2, 3, 8, 10, 11}));
+  ASSERT_TRUE(parseCpuList("", &cpus));
+  EXPECT_TRUE(cpus.empty());
+  EXPECT_FALSE(parseCpuList("3-1", &cpus));
+  EXPECT_FALSE(parseCpuList("0-", &cpus));
+  EXPECT_FALSE(parseCpuList("a", &cpus));
+}
+
+TEST(numaWorkerPool, readNumaNodes) {
+  const boost::filesystem::path dir = boost::filesystem::temp_directory_path()
+      / boost::filesystem::unique_path();
+  boost::filesystem::create_directories(dir / "node0");
+  boost::filesystem::create_directories(dir / "node1");
+  boost::filesystem::create_directories(dir / "power");
+  std::ofstream((dir / "node0" / "cpulist").string()) << "0\n";
+  // CPU outside any affinity mask.
+  std::ofstream((dir / "node1" / "cpulist").string()) << "100000\n";
+  const std::vector<NumaNode> nodes = readNumaNodes(dir.string());
+  cpu_set_t affinity;
+  CPU_ZERO(&affinity);
+  ASSERT_EQ(sched_getaffinity(0, sizeof(affinity), &affinity), 0);
+  if (CPU_ISSET(0, &affinity)) {
+    ASSERT_EQ(nodes.size(), 1);
+    EXPECT_EQ(nodes[0].id, 0);
+    EXPECT_EQ(nodes[0].cpus, std::vector<int32_t>({0}));
+  } else {
+    EXPECT_TRUE(nodes.empty());
+  }
+  boost::filesystem::remove_all(dir);
+}
+
+TEST(numaWorkerPool, workersRunOnNodeCpus) {
+  cpu_set_t affinity;
+  CPU_ZERO(&affinity);
+  ASSERT_EQ(sched_getaffinity(0, sizeof(affinity), &affinity), 0);
+  NumaNode node;
+  node.id = 0;
+  for (int32_t cpu = 0; cpu < CPU_SETSIZE && node.cpus.empty(); ++cpu) {
+    if (CPU_ISSET(cpu, &affinity)) {
+      node.cpus.push_back(cpu);
+    }
+  }
+  NumaWorkerPool pool({node, node}, 4);
+  ASSERT_EQ(pool.nodeCount(), 2);
+  EXPECT_EQ(pool.nodeThreads(0), 2);
+  EXPECT_EQ(pool.nodeThreads(1), 2);
+  std::atomic<int> offNode(0);
+  std::atomic<int> tasks(0);
+  for (int idx = 0; idx < 32; ++idx) {
+    pool.post(idx, [&offNode, &tasks, &node]() {
+      if (sched_getcpu() != node.cpus[0]) {
+        offNode += 1;
+      }
+      tasks += 1;
+    });
+  }
+  pool.join();
+  EXPECT_EQ(tasks.load(), 32);
+  EXPECT_EQ(offNode.load(), 0);
+}
+
+}  // namespace wsiToDicomConverter
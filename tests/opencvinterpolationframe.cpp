@@ -26,8 +26,8 @@ namespace wsiToDicomConverter {
 
 TEST(OpenCVInterpolationFrame, jpeg) {
   DICOMFileFrameRegionReader dicom_frame_reader;
-  OpenSlidePtr osptr = OpenSlidePtr(tiffFileName);
-  OpenCVInterpolationFrame frame(&osptr, 0, 0, 0, 100, 100, 100, 100, JPEG, 1,
+  OpenSlidePool osPool(tiffFileName, 1, 0);
+  OpenCVInterpolationFrame frame(&osPool, 0, 0, 0, 100, 100, 100, 100, JPEG, 1,
                                    subsample_420, 1000, 1000, 2000, 2000,
                                    false, &dicom_frame_reader,
                                    cv::INTER_LANCZOS4);
@@ -39,8 +39,8 @@ TEST(OpenCVInterpolationFrame, jpeg) {
 
 TEST(OpenCVInterpolationFrame, jpeg2000Scaling) {
   DICOMFileFrameRegionReader dicom_frame_reader;
-  OpenSlidePtr osptr = OpenSlidePtr(tiffFileName);
-  OpenCVInterpolationFrame frame(&osptr, 0, 0, 0, 1000, 1000, 100, 100,
+  OpenSlidePool osPool(tiffFileName, 1, 0);
+  OpenCVInterpolationFrame frame(&osPool, 0, 0, 0, 1000, 1000, 100, 100,
                                    JPEG2000, 1, subsample_420, 1000, 1000, 2000,
                                    2000, true, &dicom_frame_reader,
                                    cv::INTER_LANCZOS4);
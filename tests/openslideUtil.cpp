@@ -0,0 +1,111 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <boost/asio/post.hpp>
+#include <boost/asio/thread_pool.hpp>
+
+#include <memory>
+#include <vector>
+
+#include "src/openslideUtil.h"
+#include "tests/testUtils.h"
+
+namespace wsiToDicomConverter {
+
+TEST(OpenSlidePool, readRegionMatchesSingleHandle) {
+  OpenSlidePtr osptr(tiffFileName);
+  std::vector<uint32_t> expected(100 * 100);
+  openslide_read_region(osptr.osr(), expected.data(), 2219, 2966, 0, 100,
+                        100);
+
+  OpenSlidePool pool(tiffFileName, 4, 16 * 1024 * 1024);
+  boost::asio::thread_pool threads(4);
+  std::vector<std::vector<uint32_t>> regions(16);
+  for (auto &region : regions) {
+    boost::asio::post(threads, [&pool, &region] {
+      region.resize(100 * 100);
+      pool.readRegion(region.data(), 2219, 2966, 0, 100, 100);
+    });
+  }
+  threads.join();
+  for (const auto &region : regions) {
+    EXPECT_EQ(expected, region);
+  }
+  EXPECT_GE(pool.openHandleCount(), 1u);
+  EXPECT_LE(pool.openHandleCount(), 4u);
+  OpenSlideCacheStats stats = pool.cacheStats();
+  EXPECT_EQ(16, stats.regionReads);
+  // Same region is read repeatedly; all but first touch of tiles hit.
+  EXPECT_GT(stats.tileHits, stats.tileMisses);
+}
+
+TEST(OpenSlidePool, leaseReturnsHandle) {
+  OpenSlidePool pool(tiffFileName, 1, 0);
+  openslide_t *osr;
+  {
+    OpenSlidePoolLease lease(&pool);
+    osr = lease.osr();
+    EXPECT_NE(nullptr, osr);
+  }
+  OpenSlidePoolLease lease(&pool);
+  EXPECT_EQ(osr, lease.osr());
+  EXPECT_EQ(1u, pool.openHandleCount());
+}
+
+TEST(OpenSlideRegionBand, regionsMatchSeparateReads) {
+  OpenSlidePool pool(tiffFileName, 2, 0);
+  std::vector<uint32_t> expectedLeft(100 * 80);
+  std::vector<uint32_t> expectedRight(120 * 90);
+  pool.readRegion(expectedLeft.data(), 500, 600, 0, 100, 80);
+  pool.readRegion(expectedRight.data(), 590, 610, 0, 120, 90);
+
+  OpenSlideRegionBand band(&pool, 0);
+  band.addRegion(500, 600, 100, 80, 500, 600);
+  band.addRegion(590, 610, 120, 90, 590, 610);
+  band.addRegion(710, 600, 100, 100, 710, 600);
+  std::vector<uint32_t> left(100 * 80);
+  std::vector<uint32_t> right(120 * 90);
+  band.readRegion(right.data(), 590, 610, 120, 90);
+  band.readRegion(left.data(), 500, 600, 100, 80);
+  band.skipRegion();
+  EXPECT_EQ(expectedLeft, left);
+  EXPECT_EQ(expectedRight, right);
+  // Band is read with a single region read.
+  EXPECT_EQ(3, pool.cacheStats().regionReads);
+}
+
+TEST(OpenSlideReadPlan, blocksAlignToNativeTiles) {
+  OpenSlidePool pool(tiffFileName, 2, 0);
+  std::vector<uint32_t> expected(100 * 50);
+  pool.readRegion(expected.data(), 450, 230, 0, 100, 50);
+
+  // Slide tiles are 240 x 240; blocks are 480 x 240.
+  OpenSlideReadPlan plan(&pool, 0, 300, 100);
+  ASSERT_TRUE(plan.isValid());
+  std::vector<std::shared_ptr<OpenSlideRegionBand>> blocks =
+                                          plan.addRegion(450, 230, 100, 50);
+  EXPECT_EQ(4u, blocks.size());
+  EXPECT_EQ(1u, plan.addRegion(500, 250, 100, 50).size());
+  EXPECT_EQ(5, plan.regionTileReads());
+  EXPECT_EQ(4, plan.uniqueTiles());
+  EXPECT_EQ(8, plan.blockTileReads());
+  std::vector<uint32_t> region(100 * 50);
+  for (const auto &block : blocks) {
+    block->readRegion(region.data(), 450, 230, 100, 50);
+  }
+  EXPECT_EQ(expected, region);
+}
+
+}  // namespace wsiToDicomConverter
@@ -0,0 +1,41 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "src/pixelUtil.h"
+
+TEST(pixelUtil, rgbToABGR) {
+  // Pixel counts around vector block sizes.
+  for (uint64_t pixelCount : {0, 1, 15, 16, 17, 18, 35, 1000}) {
+    std::vector<uint8_t> rgb(pixelCount * 3);
+    for (size_t idx = 0; idx < rgb.size(); ++idx) {
+      rgb[idx] = static_cast<uint8_t>(idx * 7);
+    }
+    // Extra bytes detect writes past end.
+    std::vector<uint8_t> abgr(pixelCount * 4 + 4, 0x11);
+    pixelUtil::rgbToABGR(rgb.data(), abgr.data(), pixelCount);
+    for (uint64_t pixel = 0; pixel < pixelCount; ++pixel) {
+      EXPECT_EQ(abgr[pixel * 4], rgb[pixel * 3]);
+      EXPECT_EQ(abgr[pixel * 4 + 1], rgb[pixel * 3 + 1]);
+      EXPECT_EQ(abgr[pixel * 4 + 2], rgb[pixel * 3 + 2]);
+      EXPECT_EQ(abgr[pixel * 4 + 3], 0xff);
+    }
+    for (uint64_t idx = pixelCount * 4; idx < abgr.size(); ++idx) {
+      EXPECT_EQ(abgr[idx], 0x11);
+    }
+  }
+}
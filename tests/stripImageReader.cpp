@@ -0,0 +1,117 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <boost/filesystem.hpp>
+#include <opencv2/opencv.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "src/stripImageReader.h"
+#include "tests/testUtils.h"
+
+namespace wsiToDicomConverter {
+
+namespace {
+
+// Writes smooth BGR gradient to temporary file with extension.
+std::string writeTestImage(const std::string &extension, cv::Mat *image) {
+  *image = cv::Mat(45, 67, CV_8UC3);
+  for (int y = 0; y < image->rows; ++y) {
+    for (int x = 0; x < image->cols; ++x) {
+      image->at<cv::Vec3b>(y, x) = cv::Vec3b(x * 3, y * 5, 128 + x - y);
+    }
+  }
+  const std::string path = (boost::filesystem::temp_directory_path() /
+                            boost::filesystem::unique_path()).string() +
+                           extension;
+  cv::imwrite(path, *image);
+  // Compare against image as decoded by OpenCV.
+  *image = cv::imread(path, cv::IMREAD_COLOR);
+  return path;
+}
+
+// Reads image in bands and returns max difference from BGR image.
+int readBandsMaxDifference(StripImageReader *reader, const cv::Mat &image) {
+  std::vector<uint8_t> rgb(reader->width() * reader->height() * 3);
+  for (int64_t row = 0; row < reader->height(); row += 16) {
+    const int64_t rowCount = std::min<int64_t>(16,
+                                               reader->height() - row);
+    EXPECT_EQ(reader->nextRow(), row);
+    EXPECT_TRUE(reader->readRows(rowCount, rgb.data() +
+                                           row * reader->width() * 3));
+  }
+  int maxDifference = 0;
+  for (int y = 0; y < image.rows; ++y) {
+    for (int x = 0; x < image.cols; ++x) {
+      const cv::Vec3b bgr = image.at<cv::Vec3b>(y, x);
+      const uint8_t *pixel = rgb.data() + (y * image.cols + x) * 3;
+      for (int channel = 0; channel < 3; ++channel) {
+        maxDifference = std::max(maxDifference,
+                                 std::abs(pixel[channel] - bgr[2 - channel]));
+      }
+    }
+  }
+  return maxDifference;
+}
+
+}  // namespace
+
+TEST(stripImageReader, readPng) {
+  cv::Mat image;
+  const std::string path = writeTestImage(".png", &image);
+  std::unique_ptr<StripImageReader> reader = StripImageReader::open(path);
+  ASSERT_TRUE(reader != nullptr);
+  EXPECT_EQ(reader->width(), 67);
+  EXPECT_EQ(reader->height(), 45);
+  EXPECT_EQ(readBandsMaxDifference(reader.get(), image), 0);
+  EXPECT_FALSE(reader->readRows(1, nullptr));
+  boost::filesystem::remove(path);
+}
+
+TEST(stripImageReader, readTiff) {
+  cv::Mat image;
+  const std::string path = writeTestImage(".tif", &image);
+  std::unique_ptr<StripImageReader> reader = StripImageReader::open(path);
+  ASSERT_TRUE(reader != nullptr);
+  EXPECT_EQ(readBandsMaxDifference(reader.get(), image), 0);
+  boost::filesystem::remove(path);
+}
+
+TEST(stripImageReader, readJpeg) {
+  cv::Mat image;
+  const std::string path = writeTestImage(".jpg", &image);
+  std::unique_ptr<StripImageReader> reader = StripImageReader::open(path);
+  ASSERT_TRUE(reader != nullptr);
+  // Allows for IDCT rounding differences between libjpeg builds.
+  EXPECT_LE(readBandsMaxDifference(reader.get(), image), 2);
+  boost::filesystem::remove(path);
+}
+
+TEST(stripImageReader, rejectProgressiveJpeg) {
+  EXPECT_TRUE(StripImageReader::open("../tests/bone.jpeg") == nullptr);
+}
+
+TEST(stripImageReader, rejectTiledTiff) {
+  EXPECT_TRUE(StripImageReader::open(tiffFileName) == nullptr);
+}
+
+TEST(stripImageReader, rejectMissingFile) {
+  EXPECT_TRUE(StripImageReader::open("../tests/missing.png") == nullptr);
+}
+
+}  // namespace wsiToDicomConverter
@@ -86,6 +86,21 @@ bool TestFrame::hasRawABGRFrameBytes() const {
   return true;
 }
 
+bool TestFrame::hasYCbCrFrameBytes() const {
+  return true;
+}
+
+bool TestFrame::ycbcrFrameBytes(YCbCrImage *image) {
+  // Y = value, Cb = 128 + value, Cr = 128 - value; chroma 4:4:4.
+  const uint8_t value = rawValue_[0] & 0xFF;
+  image->resize(frameWidth_, frameHeight_, 1, 1);
+  const int64_t planeSize = frameWidth_ * frameHeight_;
+  std::memset(image->plane(0), value, planeSize);
+  std::memset(image->plane(1), 128 + value, planeSize);
+  std::memset(image->plane(2), 128 - value, planeSize);
+  return true;
+}
+
 std::string TestFrame::derivationDescription() const {
   return std::string("test frame.");
 }
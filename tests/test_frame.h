@@ -29,6 +29,8 @@ class TestFrame : public Frame {
 
   virtual int64_t rawABGRFrameBytes(uint8_t *rawMemory, int64_t memorySize);
   virtual bool hasRawABGRFrameBytes() const;
+  virtual bool hasYCbCrFrameBytes() const;
+  virtual bool ycbcrFrameBytes(YCbCrImage *image);
   virtual std::string derivationDescription() const;
   virtual void incSourceFrameReadCounter();
 
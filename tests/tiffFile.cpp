@@ -13,6 +13,10 @@
 // limitations under the License.
 #include <gtest/gtest.h>
 
+#include <cstring>
+#include <memory>
+#include <vector>
+
 #include "src/tiffDirectory.h"
 #include "tests/testUtils.h"
 
@@ -127,4 +131,24 @@ TEST(tiffFile, getTile) {
     }
 }
 
+TEST(tiffFile, getPrefetchedTile) {
+    TiffFile tfile(tiffFileName, 0);
+    TiffFile prefetchFile(tfile, 0);
+    const int tileCount = tfile.directory(0)->tileCount();
+    std::vector<uint32_t> tileOrder;
+    for (int tileIndex = 0; tileIndex < tileCount; ++tileIndex) {
+      tileOrder.push_back(tileIndex);
+    }
+    prefetchFile.startTilePrefetch(tileOrder, 4);
+    for (int tileIndex = 0; tileIndex < tileCount; ++tileIndex) {
+      std::unique_ptr<TiffTile> tile = tfile.tile(tileIndex);
+      std::unique_ptr<TiffTile> prefetched = prefetchFile.tile(tileIndex);
+      ASSERT_NE(prefetched, nullptr);
+      ASSERT_EQ(tile->rawBufferSize(), prefetched->rawBufferSize());
+      EXPECT_EQ(0, memcmp(tile->rawBuffer(), prefetched->rawBuffer(),
+                          tile->rawBufferSize()));
+    }
+    prefetchFile.stopTilePrefetch();
+}
+
 }  // namespace wsiToDicomConverter
@@ -0,0 +1,105 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <gtest/gtest.h>
+#include <tiffio.h>
+
+#include <boost/asio/post.hpp>
+#include <boost/asio/thread_pool.hpp>
+
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "src/tiffRawTileReader.h"
+#include "src/tiffTilePrefetcher.h"
+#include "tests/testUtils.h"
+
+namespace wsiToDicomConverter {
+
+TEST(tiffRawTileReader, matchesLibtiffRawTile) {
+  TIFF *tiff = TIFFOpen(tiffFileName, "r");
+  ASSERT_NE(tiff, nullptr);
+  TiffRawTileReader reader(tiff, tiffFileName);
+  ASSERT_TRUE(reader.isOpen());
+  ASSERT_EQ(reader.tileCount(), TIFFNumberOfTiles(tiff));
+  for (uint32_t tileIndex = 0; tileIndex < reader.tileCount(); ++tileIndex) {
+    const uint64_t byteCount = reader.tileByteCount(tileIndex);
+    std::vector<uint8_t> libtiffTile(byteCount);
+    ASSERT_EQ(TIFFReadRawTile(tiff, tileIndex, libtiffTile.data(), byteCount),
+              byteCount);
+    uint64_t size;
+    std::unique_ptr<uint8_t[]> tile = reader.readTile(tileIndex, &size);
+    ASSERT_NE(tile, nullptr);
+    ASSERT_EQ(size, byteCount);
+    EXPECT_EQ(0, memcmp(tile.get(), libtiffTile.data(), size));
+  }
+  TIFFClose(tiff);
+}
+
+TEST(tiffRawTileReader, concurrentReads) {
+  TIFF *tiff = TIFFOpen(tiffFileName, "r");
+  ASSERT_NE(tiff, nullptr);
+  TiffRawTileReader reader(tiff, tiffFileName);
+  TIFFClose(tiff);
+  ASSERT_TRUE(reader.isOpen());
+  std::vector<std::unique_ptr<uint8_t[]>> expected;
+  for (uint32_t tileIndex = 0; tileIndex < reader.tileCount(); ++tileIndex) {
+    uint64_t size;
+    expected.push_back(reader.readTile(tileIndex, &size));
+  }
+  std::atomic<int> mismatches(0);
+  boost::asio::thread_pool pool(8);
+  for (int repeat = 0; repeat < 10; ++repeat) {
+    for (uint32_t tileIndex = 0; tileIndex < reader.tileCount(); ++tileIndex) {
+      boost::asio::post(pool, [&, tileIndex]() {
+        const uint64_t size = reader.tileByteCount(tileIndex);
+        std::vector<uint8_t> buffer(size);
+        if (reader.readTile(tileIndex, buffer.data(), size) != size ||
+            memcmp(buffer.data(), expected[tileIndex].get(), size) != 0) {
+          ++mismatches;
+        }
+      });
+    }
+  }
+  pool.join();
+  EXPECT_EQ(mismatches, 0);
+}
+
+TEST(tiffTilePrefetcher, skippedTilesDoNotStallPrefetch) {
+  TIFF *tiff = TIFFOpen(tiffFileName, "r");
+  ASSERT_NE(tiff, nullptr);
+  TiffRawTileReader reader(tiff, tiffFileName);
+  TIFFClose(tiff);
+  ASSERT_TRUE(reader.isOpen());
+  const uint32_t queueDepth = 2;
+  ASSERT_GT(reader.tileCount(), 4 * queueDepth);
+  std::vector<uint32_t> tileOrder;
+  for (uint32_t tileIndex = 0; tileIndex < reader.tileCount(); ++tileIndex) {
+    tileOrder.push_back(tileIndex);
+  }
+  TiffTilePrefetcher prefetcher(&reader, tileOrder, queueDepth, 1);
+  // Tiles at start of order are prefetched but never requested.
+  const uint32_t firstTile = reader.tileCount() / 2;
+  for (uint32_t tileIndex = firstTile; tileIndex < reader.tileCount();
+       ++tileIndex) {
+    uint64_t size;
+    std::unique_ptr<uint8_t[]> tile = prefetcher.tile(tileIndex, &size);
+    ASSERT_NE(tile, nullptr);
+    ASSERT_EQ(size, reader.tileByteCount(tileIndex));
+  }
+  EXPECT_GT(prefetcher.prefetchedTileCount(), 0);
+}
+
+}  // namespace wsiToDicomConverter
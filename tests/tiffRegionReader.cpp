@@ -0,0 +1,118 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+#include "tests/testUtils.h"
+
+#include "src/tiffFile.h"
+#include "src/tiffFrame.h"
+#include "src/tiffRegionReader.h"
+
+namespace wsiToDicomConverter {
+
+TEST(tiffRegionReader, directoryIndex) {
+  TiffRegionReader reader(tiffFileName, 1024 * 1024);
+  ASSERT_TRUE(reader.isValid());
+  EXPECT_EQ(reader.directoryIndex(2220, 2967), 0);
+  EXPECT_EQ(reader.directoryIndex(2220, 2968), -1);
+}
+
+TEST(tiffRegionReader, reducedResolutionRequiresJpeg2000) {
+  TiffRegionReader reader(tiffFileName, 1024 * 1024);
+  EXPECT_TRUE(reader.canReadReducedRegion(0, 0));
+  // Jpeg tiles can not be decoded at reduced resolution.
+  EXPECT_FALSE(reader.canReadReducedRegion(0, 1));
+}
+
+TEST(tiffRegionReader, regionMatchesDecodedTiles) {
+  TiffRegionReader reader(tiffFileName, 16 * 1024 * 1024);
+  // Region straddles tiles 0, 1, 10, 11.
+  const int64_t x = 200;
+  const int64_t y = 100;
+  const int64_t width = 100;
+  const int64_t height = 300;
+  std::vector<uint32_t> region(width * height);
+  ASSERT_TRUE(reader.readRegion(0, x, y, width, height, region.data()));
+
+  TiffFile tf(tiffFileName, 0);
+  const int64_t tileSize = 240 * 240 * 4;
+  std::unique_ptr<uint8_t[]> tile = std::make_unique<uint8_t[]>(tileSize);
+  const std::vector<int64_t> tileIndexes = {0, 1, 10, 11};
+  for (size_t idx = 0; idx < tileIndexes.size(); ++idx) {
+    TiffFrame tiffFrame(&tf, tileIndexes[idx], true);
+    tiffFrame.sliceFrame();
+    tiffFrame.incReadCounter();
+    ASSERT_EQ(tiffFrame.rawABGRFrameBytes(tile.get(), tileSize), tileSize);
+    const int64_t tileX = (idx % 2) * 240;
+    const int64_t tileY = (idx / 2) * 240;
+    for (int64_t ry = 0; ry < height; ++ry) {
+      for (int64_t rx = 0; rx < width; ++rx) {
+        const int64_t px = x + rx - tileX;
+        const int64_t py = y + ry - tileY;
+        if (px < 0 || px >= 240 || py < 0 || py >= 240) {
+          continue;
+        }
+        // Region is openslide ARGB; decoded tile is R, G, B, A bytes.
+        const uint8_t *rgba = &tile[(py * 240 + px) * 4];
+        const uint32_t argb = 0xFF000000 | (rgba[0] << 16) |
+                              (rgba[1] << 8) | rgba[2];
+        ASSERT_EQ(region[ry * width + rx], argb);
+      }
+    }
+  }
+  TiffRegionReaderStats stats = reader.stats();
+  EXPECT_EQ(stats.regionReads, 1);
+  EXPECT_EQ(stats.tileMisses, 4);
+}
+
+TEST(tiffRegionReader, pixelsOutsideImageAreZero) {
+  TiffRegionReader reader(tiffFileName, 16 * 1024 * 1024);
+  std::vector<uint32_t> region(20 * 20, 1);
+  ASSERT_TRUE(reader.readRegion(0, 2210, 2957, 20, 20, region.data()));
+  for (int64_t ry = 0; ry < 20; ++ry) {
+    for (int64_t rx = 0; rx < 20; ++rx) {
+      if (rx < 10 && ry < 10) {
+        EXPECT_EQ(region[ry * 20 + rx] >> 24, 0xFF);
+      } else {
+        EXPECT_EQ(region[ry * 20 + rx], 0);
+      }
+    }
+  }
+}
+
+TEST(tiffRegionReader, reusesCachedTiles) {
+  TiffRegionReader reader(tiffFileName, 16 * 1024 * 1024);
+  std::vector<uint32_t> region(100 * 100);
+  ASSERT_TRUE(reader.readRegion(0, 0, 0, 100, 100, region.data()));
+  ASSERT_TRUE(reader.readRegion(0, 100, 100, 100, 100, region.data()));
+  TiffRegionReaderStats stats = reader.stats();
+  EXPECT_EQ(stats.regionReads, 2);
+  EXPECT_EQ(stats.tileMisses, 1);
+  EXPECT_EQ(stats.tileHits, 1);
+}
+
+TEST(tiffRegionReader, evictsTilesBeyondCacheSize) {
+  // Cache holds one decoded 240 x 240 tile.
+  TiffRegionReader reader(tiffFileName, 240 * 240 * 4);
+  std::vector<uint32_t> region(10 * 10);
+  ASSERT_TRUE(reader.readRegion(0, 0, 0, 10, 10, region.data()));
+  ASSERT_TRUE(reader.readRegion(0, 240, 0, 10, 10, region.data()));
+  ASSERT_TRUE(reader.readRegion(0, 0, 0, 10, 10, region.data()));
+  EXPECT_EQ(reader.stats().tileMisses, 3);
+}
+
+}  // namespace wsiToDicomConverter
@@ -0,0 +1,86 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <gtest/gtest.h>
+#include <jpeglib.h>
+
+#include <memory>
+#include <vector>
+
+#include "tests/testUtils.h"
+
+#include "src/tiffDirectory.h"
+#include "src/tiffFile.h"
+#include "src/tiffFrame.h"
+#include "src/tiffRetileFrame.h"
+
+namespace wsiToDicomConverter {
+
+TEST(tiffRetileFrame, tileIndexes) {
+  TiffFile tf(tiffFileName, 0);
+  TiffRetileFrame frame(&tf, 480, 240, 480, 480, false);
+  EXPECT_EQ(frame.tileIndexes(), std::vector<int64_t>({12, 13, 22, 23}));
+  // Tiles past edge of image.
+  TiffRetileFrame edgeFrame(&tf, 1920, 2880, 480, 480, false);
+  EXPECT_EQ(edgeFrame.tileIndexes(),
+            std::vector<int64_t>({128, 129, -1, -1}));
+}
+
+TEST(tiffRetileFrame, joinsTilesWithoutDecoding) {
+  TiffFile tf(tiffFileName, 0);
+  TiffRetileFrame frame(&tf, 0, 0, 480, 480, true);
+  frame.sliceFrame();
+  EXPECT_TRUE(frame.isDone());
+  EXPECT_TRUE(frame.hasDcmPixelItem());
+  EXPECT_EQ(frame.photoMetrInt(), tf.fileDirectory()->photoMetrIntStr());
+  ASSERT_TRUE(frame.hasRawABGRFrameBytes());
+
+  const int64_t size = 480 * 480 * 4;
+  std::unique_ptr<uint8_t[]> decoded = std::make_unique<uint8_t[]>(size);
+  frame.incReadCounter();
+  ASSERT_EQ(frame.rawABGRFrameBytes(decoded.get(), size), size);
+  const int64_t tileSize = 240 * 240 * 4;
+  std::unique_ptr<uint8_t[]> tile = std::make_unique<uint8_t[]>(tileSize);
+  const std::vector<int64_t> tileIndexes = {0, 1, 10, 11};
+  for (size_t idx = 0; idx < tileIndexes.size(); ++idx) {
+    TiffFrame tiffFrame(&tf, tileIndexes[idx], true);
+    tiffFrame.sliceFrame();
+    tiffFrame.incReadCounter();
+    ASSERT_EQ(tiffFrame.rawABGRFrameBytes(tile.get(), tileSize), tileSize);
+    const int64_t offsetX = (idx % 2) * 240;
+    const int64_t offsetY = (idx / 2) * 240;
+    // Chroma upsampling interpolates across tile edges; pixels at edges
+    // are not compared.
+    for (int64_t y = 2; y < 238; ++y) {
+      for (int64_t x = 2; x < 238; ++x) {
+        for (int64_t channel = 0; channel < 4; ++channel) {
+          ASSERT_EQ(tile[(y * 240 + x) * 4 + channel],
+                    decoded[((offsetY + y) * 480 + offsetX + x) * 4 +
+                            channel]);
+        }
+      }
+    }
+  }
+}
+
+TEST(tiffRetileFrame, releasesJpegIfNotStored) {
+  TiffFile tf(tiffFileName, 0);
+  TiffRetileFrame frame(&tf, 1920, 2880, 480, 480, false);
+  frame.sliceFrame();
+  EXPECT_TRUE(frame.isDone());
+  EXPECT_TRUE(frame.hasDcmPixelItem());
+  EXPECT_GT(frame.dicomFrameBytesSize(), 0);
+  EXPECT_FALSE(frame.hasRawABGRFrameBytes());
+}
+
+}  // namespace wsiToDicomConverter
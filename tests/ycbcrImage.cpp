@@ -0,0 +1,79 @@
+// Copyright 2026 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <gtest/gtest.h>
+
+#include <memory>
+
+#include "src/ycbcrImage.h"
+
+namespace wsiToDicomConverter {
+
+TEST(YCbCrImage, planeDimensions) {
+  YCbCrImage image(5, 3, 2, 2);
+  EXPECT_EQ(image.planeWidth(0), 5);
+  EXPECT_EQ(image.planeHeight(0), 3);
+  EXPECT_EQ(image.planeWidth(1), 3);
+  EXPECT_EQ(image.planeHeight(1), 2);
+  EXPECT_EQ(image.planeWidth(2), 3);
+  EXPECT_EQ(image.planeHeight(2), 2);
+  EXPECT_EQ(image.byteSize(), 5 * 3 + 2 * 3 * 2);
+  EXPECT_EQ(image.plane(1), image.data() + 15);
+  EXPECT_EQ(image.plane(2), image.data() + 21);
+}
+
+TEST(YCbCrImage, resize) {
+  YCbCrImage image;
+  EXPECT_EQ(image.byteSize(), 0);
+  image.resize(4, 4, 2, 1);
+  EXPECT_EQ(image.width(), 4);
+  EXPECT_EQ(image.height(), 4);
+  EXPECT_EQ(image.chromaSubsampleX(), 2);
+  EXPECT_EQ(image.chromaSubsampleY(), 1);
+  EXPECT_EQ(image.byteSize(), 16 + 2 * 8);
+}
+
+TEST(YCbCrImage, clearIsBlack) {
+  YCbCrImage image(3, 3, 2, 2);
+  image.clear();
+  std::unique_ptr<uint8_t[]> abgr = std::make_unique<uint8_t[]>(3 * 3 * 4);
+  image.toABGR(abgr.get());
+  for (int idx = 0; idx < 3 * 3; ++idx) {
+    EXPECT_EQ(abgr[idx * 4], 0);
+    EXPECT_EQ(abgr[idx * 4 + 1], 0);
+    EXPECT_EQ(abgr[idx * 4 + 2], 0);
+    EXPECT_EQ(abgr[idx * 4 + 3], 0xff);
+  }
+}
+
+TEST(YCbCrImage, toABGR) {
+  // 2x1 image with one chroma sample shared by both pixels.
+  YCbCrImage image(2, 1, 2, 1);
+  image.plane(0)[0] = 76;   // Red
+  image.plane(0)[1] = 150;
+  image.plane(1)[0] = 85;
+  image.plane(2)[0] = 255;
+  uint8_t abgr[8];
+  image.toABGR(abgr);
+  EXPECT_NEAR(abgr[0], 254, 1);
+  EXPECT_NEAR(abgr[1], 0, 1);
+  EXPECT_NEAR(abgr[2], 0, 1);
+  EXPECT_EQ(abgr[3], 0xff);
+  // Luma differs, chroma is shared.
+  EXPECT_EQ(abgr[4], 255);
+  EXPECT_NEAR(abgr[5], 74, 1);
+  EXPECT_NEAR(abgr[6], 74, 1);
+  EXPECT_EQ(abgr[7], 0xff);
+}
+
+}  // namespace wsiToDicomConverter